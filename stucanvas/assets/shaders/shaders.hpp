@@ -14,6 +14,7 @@ namespace StuCanvas::Shaders
         VkShaderStageFlagBits stage;        ///< 着色器流水线阶段 (如 VERTEX, FRAGMENT 等)
         std::span< const uint32_t > code;   ///< 🚀 核心：通过 C++20 span 隐式转换，完美擦除了不同数组的长度差异 [1.1.1]
         uint32_t slot;                      ///< 🚀 用户指定的唯一顺序槽位索引 (0, 1, 2...)
+        bool lazy = false;                  ///< 罕用槽位：启动时跳过，首次 acquireShader 时才创建
     };
 
     // =========================================================================
@@ -0,0 +1,387 @@
+/****************************************************************************
+ * Copyright (c) 2025-2026 Tian Yuxuan (Friendships666)                     *
+ *                                                                          *
+ * StuCanvas is licensed under Mulan PSL v2.                                *
+ * You can use this software according to the terms and conditions of the   *
+ * Mulan PSL v2.                                                            *
+ * You may obtain a copy of Mulan PSL v2 at:                                *
+ *          http://license.coscl.org.cn/MulanPSL2                           *
+ *                                                                          *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF     *
+ * ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO        *
+ * NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.       *
+ * See the Mulan PSL v2 for more details.                                   *
+ ***************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <eigen3/Eigen/Dense>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "../objects/appearance/appearance.hpp"
+#include "../objects/dag/instance.hpp"
+#include "../objects/dag/object.hpp"
+#include "../utils2/flat_map.hpp"
+
+namespace StuCanvas
+{
+    // =========================================================================
+    // 🚀 修复点 2：前置定义提取局部点坐标的内联辅助函数
+    // =========================================================================
+    inline Eigen::Vector3d extractLocalPoint ( const DAGObject& object )
+    {
+        Eigen::Vector3d local_pt = Eigen::Vector3d::Zero ();
+        switch ( object.type )
+        {
+            case NodeType::POINT_2D_FREE:
+            case NodeType::POINT_2D_MID:
+            case NodeType::POINT_2D_SECTION:
+            case NodeType::POINT_2D_INTERSECT:
+            {
+                local_pt.x () = object.data.point_2d.x;
+                local_pt.y () = object.data.point_2d.y;
+                local_pt.z () = 0.0;
+                break;
+            }
+            case NodeType::POINT_2D_SNAP:
+            {
+                local_pt.x () = object.data.snap_2d.x;
+                local_pt.y () = object.data.snap_2d.y;
+                local_pt.z () = 0.0;
+                break;
+            }
+            case NodeType::POINT_3D_FREE:
+            case NodeType::POINT_3D_MID:
+            case NodeType::POINT_3D_SECTION:
+            case NodeType::POINT_3D_INTERSECT:
+            {
+                local_pt.x () = object.data.point_3d.x;
+                local_pt.y () = object.data.point_3d.y;
+                local_pt.z () = object.data.point_3d.z;
+                break;
+            }
+            case NodeType::POINT_3D_SNAP:
+            {
+                local_pt.x () = object.data.snap_3d.x;
+                local_pt.y () = object.data.snap_3d.y;
+                local_pt.z () = object.data.snap_3d.z;
+                break;
+            }
+            default:
+                break;
+        }
+        return local_pt;
+    }
+
+    /// 判断节点是否由点 SDF 管线绘制
+    [[nodiscard]] inline bool isPointNodeType ( NodeType type ) noexcept
+    {
+        switch ( type )
+        {
+            case NodeType::POINT_2D_FREE:
+            case NodeType::POINT_2D_MID:
+            case NodeType::POINT_2D_SECTION:
+            case NodeType::POINT_2D_INTERSECT:
+            case NodeType::POINT_2D_SNAP:
+            case NodeType::POINT_3D_FREE:
+            case NodeType::POINT_3D_MID:
+            case NodeType::POINT_3D_SECTION:
+            case NodeType::POINT_3D_INTERSECT:
+            case NodeType::POINT_3D_SNAP:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief 同一外观下的一组点实例 (一次实例化绘制)
+     */
+    struct PointDrawBatch
+    {
+        const AppearanceSimplePoint* appearance = nullptr;   ///< 外观 (颜色、半径在录制时实时读取)
+        std::vector< uint32_t > entries;                     ///< 属于该批次的缓存条目 (布局变化时才重建)
+        std::vector< uint32_t > visible;                     ///< 本帧通过视锥剔除的条目 (逐帧复用容量)
+    };
+
+    /**
+     * @brief 持久化点绘制批次缓存
+     *
+     * 1. 布局 (实例集合 + 外观指针) 不变时，外观哈希表与批次成员表原样复用，逐帧零分组开销。
+     * 2. 每个条目以 SoA 双精度数组缓存实例局部点经 R·S·p + t 变换后的世界中心；
+     *    只有修订号变化的实例才会被收集起来，按 8 路一组批量重算 (定长内层循环由编译器自动向量化)。
+     *    修订号只在 DAGraph 的求值、touchGeometry 与 modifyInstanceTransform 中递增：源对象 data
+     *    若在这些入口之外被直接改写，对应条目的世界中心会保持旧值，直到调用 DAGraph::touchGeometry
+     *    (零散实例路径不信任修订号，可见条目逐帧全部重算，不受此约束)。
+     * 3. 世界中心保持双精度，逐帧的 RTE 归一化 (减相机、乘 2 的幂次缩放) 在写入上传环时才降为 float。
+     */
+    class PointBatchCache
+    {
+    public:
+
+        static constexpr uint32_t invalid_slot = 0xFFFFFFFFu;
+
+        /**
+         * @brief 图路径：仅当来源图或其实例布局修订号变化时重建批次
+         */
+        inline void syncLayout ( const void* owner, uint64_t layout_revision,
+                                 std::span< DAGObjectInstance* const > instances )
+        {
+            if ( layout_valid && owner == layout_owner && layout_revision == layout_owner_revision )
+            {
+                return;
+            }
+            rebuildLayout ( instances );
+            layout_owner = owner;
+            layout_owner_revision = layout_revision;
+            layout_instances.clear ();
+            layout_appearances.clear ();
+        }
+
+        /**
+         * @brief 零散实例路径：无修订号可依赖，逐项比对实例与外观指针，一致则复用批次
+         */
+        inline void syncLayout ( std::span< DAGObjectInstance* const > instances )
+        {
+            if ( layout_valid && layout_owner == nullptr && layout_instances.size () == instances.size () )
+            {
+                bool same = true;
+                for ( size_t i = 0; i < instances.size () && same; ++i )
+                {
+                    same = layout_instances[ i ] == instances[ i ] &&
+                           ( !instances[ i ] || layout_appearances[ i ] == instances[ i ]->appearance );
+                }
+                if ( same )
+                {
+                    return;
+                }
+            }
+
+            rebuildLayout ( instances );
+            layout_owner = nullptr;
+            layout_owner_revision = 0;
+            layout_instances.assign ( instances.begin (), instances.end () );
+            layout_appearances.resize ( instances.size () );
+            for ( size_t i = 0; i < instances.size (); ++i )
+            {
+                layout_appearances[ i ] = instances[ i ] ? instances[ i ]->appearance : nullptr;
+            }
+        }
+
+        /**
+         * @brief 把本帧可见实例分派到各自批次，并批量重算失效条目的世界中心
+         * @param visible 视锥剔除后的可见实例 (非点类型实例自动忽略)
+         * @param trust_revisions true 时仅重算修订号变化的条目；false 时 (零散实例) 可见条目全部重算
+         */
+        inline void collectVisible ( std::span< DAGObjectInstance* const > visible, bool trust_revisions )
+        {
+            for ( PointDrawBatch& batch : batch_list )
+            {
+                batch.visible.clear ();
+            }
+            dirty_entries.clear ();
+
+            for ( DAGObjectInstance* instance : visible )
+            {
+                const uint32_t e = instance->draw_slot;
+                if ( e >= entry_instance.size () || entry_instance[ e ] != instance ) [[unlikely]]
+                {
+                    continue;   // 非点类型，或槽位属于其他缓存
+                }
+
+                batch_list[ entry_batch[ e ] ].visible.push_back ( e );
+
+                if ( !trust_revisions || !entry_ready[ e ] || entry_revision[ e ] != instance->revision )
+                {
+                    dirty_entries.push_back ( e );
+                }
+            }
+
+            recomputeDirty ();
+        }
+
+        [[nodiscard]] inline std::span< const PointDrawBatch > batches () const noexcept
+        {
+            return batch_list;
+        }
+
+        [[nodiscard]] inline const double* centreX () const noexcept
+        {
+            return centre_x.data ();
+        }
+
+        [[nodiscard]] inline const double* centreY () const noexcept
+        {
+            return centre_y.data ();
+        }
+
+        [[nodiscard]] inline const double* centreZ () const noexcept
+        {
+            return centre_z.data ();
+        }
+
+    private:
+
+        static constexpr size_t lane_count = 8;
+
+        utils::FlatMap< const void*, uint32_t > batch_of_appearance;   ///< 外观指针 -> 批次下标
+        std::vector< PointDrawBatch > batch_list;
+
+        // 条目 SoA (下标即 DAGObjectInstance::draw_slot)
+        std::vector< DAGObjectInstance* > entry_instance;
+        std::vector< uint32_t > entry_batch;
+        std::vector< uint32_t > entry_revision;
+        std::vector< uint8_t > entry_ready;   ///< 世界中心是否已计算过
+        std::vector< double > centre_x;
+        std::vector< double > centre_y;
+        std::vector< double > centre_z;
+
+        std::vector< uint32_t > dirty_entries;
+
+        // 布局校验状态
+        bool layout_valid = false;
+        const void* layout_owner = nullptr;
+        uint64_t layout_owner_revision = 0;
+        std::vector< DAGObjectInstance* > layout_instances;   ///< 零散实例路径的比对快照
+        std::vector< void* > layout_appearances;
+
+        inline void rebuildLayout ( std::span< DAGObjectInstance* const > instances )
+        {
+            for ( const PointDrawBatch& batch : batch_list )
+            {
+                batch_of_appearance.erase ( batch.appearance );
+            }
+            batch_list.clear ();
+
+            entry_instance.clear ();
+            entry_batch.clear ();
+
+            for ( DAGObjectInstance* instance : instances )
+            {
+                if ( !instance || !instance->source || !isPointNodeType ( instance->source->type ) )
+                {
+                    continue;
+                }
+
+                if ( !instance->appearance ) [[unlikely]]
+                {
+                    throw std::runtime_error (
+                        "PointBatchCache::rebuildLayout: DAGObjectInstance has a null appearance pointer." );
+                }
+
+                const auto* app = static_cast< const AppearanceSimplePoint* > ( instance->appearance );
+
+                uint32_t batch_index;
+                auto it = batch_of_appearance.find ( app );
+                if ( it != batch_of_appearance.end () )
+                {
+                    batch_index = it->second;
+                }
+                else
+                {
+                    batch_index = static_cast< uint32_t > ( batch_list.size () );
+                    batch_of_appearance.insert ( app, batch_index );
+                    batch_list.emplace_back ().appearance = app;
+                }
+
+                const uint32_t e = static_cast< uint32_t > ( entry_instance.size () );
+                instance->draw_slot = e;
+                entry_instance.push_back ( instance );
+                entry_batch.push_back ( batch_index );
+                batch_list[ batch_index ].entries.push_back ( e );
+            }
+
+            const size_t n = entry_instance.size ();
+            entry_revision.assign ( n, 0 );
+            entry_ready.assign ( n, 0 );
+            centre_x.assign ( n, 0.0 );
+            centre_y.assign ( n, 0.0 );
+            centre_z.assign ( n, 0.0 );
+
+            layout_valid = true;
+        }
+
+        /// 🚀 8 路一组：收集 → 定长 SoA 计算 (四元数归一化、R·S·p + t) → 写回
+        inline void recomputeDirty ()
+        {
+            for ( size_t base = 0; base < dirty_entries.size (); base += lane_count )
+            {
+                const size_t n = std::min ( lane_count, dirty_entries.size () - base );
+
+                alignas ( 64 ) double qx[ lane_count ], qy[ lane_count ], qz[ lane_count ], qw[ lane_count ];
+                alignas ( 64 ) double px[ lane_count ], py[ lane_count ], pz[ lane_count ];
+                alignas ( 64 ) double tx[ lane_count ], ty[ lane_count ], tz[ lane_count ];
+
+                for ( size_t l = 0; l < lane_count; ++l )
+                {
+                    // 尾部空闲通道填充单位变换，保证定长循环无分支
+                    const DAGObjectInstance* instance =
+                        l < n ? entry_instance[ dirty_entries[ base + l ] ] : nullptr;
+                    if ( instance )
+                    {
+                        const Eigen::Vector3d local_pt = extractLocalPoint ( *instance->source );
+                        qx[ l ] = instance->world_rotation[ 0 ];
+                        qy[ l ] = instance->world_rotation[ 1 ];
+                        qz[ l ] = instance->world_rotation[ 2 ];
+                        qw[ l ] = instance->world_rotation[ 3 ];
+                        px[ l ] = local_pt.x () * instance->world_scales[ 0 ];
+                        py[ l ] = local_pt.y () * instance->world_scales[ 1 ];
+                        pz[ l ] = local_pt.z () * instance->world_scales[ 2 ];
+                        tx[ l ] = instance->world_position[ 0 ];
+                        ty[ l ] = instance->world_position[ 1 ];
+                        tz[ l ] = instance->world_position[ 2 ];
+                    }
+                    else
+                    {
+                        qx[ l ] = qy[ l ] = qz[ l ] = 0.0;
+                        qw[ l ] = 1.0;
+                        px[ l ] = py[ l ] = pz[ l ] = 0.0;
+                        tx[ l ] = ty[ l ] = tz[ l ] = 0.0;
+                    }
+                }
+
+                alignas ( 64 ) double wx[ lane_count ], wy[ lane_count ], wz[ lane_count ];
+                for ( size_t l = 0; l < lane_count; ++l )
+                {
+                    const double inv_norm =
+                        1.0 / std::sqrt ( qx[ l ] * qx[ l ] + qy[ l ] * qy[ l ] + qz[ l ] * qz[ l ] + qw[ l ] * qw[ l ] );
+                    const double x = qx[ l ] * inv_norm;
+                    const double y = qy[ l ] * inv_norm;
+                    const double z = qz[ l ] * inv_norm;
+                    const double w = qw[ l ] * inv_norm;
+
+                    const double r00 = 1.0 - 2.0 * ( y * y + z * z );
+                    const double r01 = 2.0 * ( x * y - z * w );
+                    const double r02 = 2.0 * ( x * z + y * w );
+                    const double r10 = 2.0 * ( x * y + z * w );
+                    const double r11 = 1.0 - 2.0 * ( x * x + z * z );
+                    const double r12 = 2.0 * ( y * z - x * w );
+                    const double r20 = 2.0 * ( x * z - y * w );
+                    const double r21 = 2.0 * ( y * z + x * w );
+                    const double r22 = 1.0 - 2.0 * ( x * x + y * y );
+
+                    wx[ l ] = r00 * px[ l ] + r01 * py[ l ] + r02 * pz[ l ] + tx[ l ];
+                    wy[ l ] = r10 * px[ l ] + r11 * py[ l ] + r12 * pz[ l ] + ty[ l ];
+                    wz[ l ] = r20 * px[ l ] + r21 * py[ l ] + r22 * pz[ l ] + tz[ l ];
+                }
+
+                for ( size_t l = 0; l < n; ++l )
+                {
+                    const uint32_t e = dirty_entries[ base + l ];
+                    centre_x[ e ] = wx[ l ];
+                    centre_y[ e ] = wy[ l ];
+                    centre_z[ e ] = wz[ l ];
+                    entry_revision[ e ] = entry_instance[ e ]->revision;
+                    entry_ready[ e ] = 1;
+                }
+            }
+            dirty_entries.clear ();
+        }
+    };
+}   // namespace StuCanvas
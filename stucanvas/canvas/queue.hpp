@@ -18,21 +18,41 @@
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_core.h>
 
+#include <fcntl.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <eigen3/Eigen/Dense>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
 #include <vector>
 
 #include "../assets/shaders/shaders.hpp"
 #include "../objects/appearance/appearance.hpp"
 #include "../objects/dag/AABB.hpp"
+#include "../objects/dag/bvh.hpp"
 #include "../objects/dag/graph.hpp"
+#include "../utils2/qoi_writer.hpp"
 #include "cameras.hpp"
+#include "draw_batches.hpp"
 #include "pinned_vector.hpp"
 #include "stb/stb_image_write.h"
 #include "vulkan/vk_ctx.hpp"
@@ -55,68 +75,64 @@ namespace StuCanvas
         VkDeviceAddress cloud;   ///< 🚀 64位 GPU 物理指针 (8 字节)，对应 Slang 的 PointData* points
     };
 
-    // =========================================================================
-    // 🚀 修复点 2：前置定义提取局部点坐标的内联辅助函数
-    // =========================================================================
-    inline Eigen::Vector3d extractLocalPoint ( const DAGObject& object )
-    {
-        Eigen::Vector3d local_pt = Eigen::Vector3d::Zero ();
-        switch ( object.type )
-        {
-            case NodeType::POINT_2D_FREE:
-            case NodeType::POINT_2D_MID:
-            case NodeType::POINT_2D_SECTION:
-            case NodeType::POINT_2D_INTERSECT:
-            {
-                local_pt.x () = object.data.point_2d.x;
-                local_pt.y () = object.data.point_2d.y;
-                local_pt.z () = 0.0;
-                break;
-            }
-            case NodeType::POINT_2D_SNAP:
-            {
-                local_pt.x () = object.data.snap_2d.x;
-                local_pt.y () = object.data.snap_2d.y;
-                local_pt.z () = 0.0;
-                break;
-            }
-            case NodeType::POINT_3D_FREE:
-            case NodeType::POINT_3D_MID:
-            case NodeType::POINT_3D_SECTION:
-            case NodeType::POINT_3D_INTERSECT:
-            {
-                local_pt.x () = object.data.point_3d.x;
-                local_pt.y () = object.data.point_3d.y;
-                local_pt.z () = object.data.point_3d.z;
-                break;
-            }
-            case NodeType::POINT_3D_SNAP:
-            {
-                local_pt.x () = object.data.snap_3d.x;
-                local_pt.y () = object.data.snap_3d.y;
-                local_pt.z () = object.data.snap_3d.z;
-                break;
-            }
-            default:
-                break;
-        }
-        return local_pt;
-    }
     /**
      * @brief 渲染与计算调度指令队列 (VulkanQueue)
      *
      * 内置了极速 Vulkan 运行时上下文，并管理独立的图形与异步计算命令通道。
      */
 
-    // 🚀 内部安全数据结构：缓存头校验
+    // 🚀 内部安全数据结构：单文件着色器缓存的文件头校验
+    //
+    // 文件布局 (全部小端、可直接 mmap 原位读取)：
+    //   [ShaderCacheHeader][ShaderCacheEntry x entry_count][二进制数据区 ...]
+    // 每个条目以文件起始处为基准记录其二进制数据的偏移与长度。
     struct ShaderCacheHeader
     {
-        uint8_t pipelineCacheUUID[ VK_UUID_SIZE ];   ///< 显卡设备硬件唯一标识
-        uint32_t driverVersion;                      ///< 显卡驱动程序版本
-        uint64_t spirv_hash;                         ///< 原始 SPIR-V 字节码哈希
-        uint64_t binary_size;                        ///< 原生机器码二进制字节大小
+        uint32_t magic;                              ///< 文件魔数 shader_cache_magic
+        uint32_t version;                            ///< 文件布局版本 shader_cache_version
+        uint8_t shaderBinaryUUID[ VK_UUID_SIZE ];   ///< VK_EXT_shader_object 定义的着色器二进制兼容标识
+        uint32_t shaderBinaryVersion;               ///< 同一 UUID 下的二进制版本 (驱动只保证读取不高于自身版本的二进制)
+        uint32_t driverVersion;                     ///< 显卡驱动程序版本
+        uint32_t vendorID;                          ///< 显卡厂商 ID
+        uint32_t deviceID;                          ///< 显卡设备 ID
+        uint32_t entry_count;                       ///< 索引表条目数
+        uint32_t reserved;                          ///< 补齐到 8 字节，使索引表在 mmap 中自然对齐
+    };
+
+    // 🚀 单文件着色器缓存的索引表条目
+    struct ShaderCacheEntry
+    {
+        uint32_t slot;          ///< 着色器槽位
+        uint32_t stage;         ///< VkShaderStageFlagBits
+        uint64_t spirv_hash;    ///< 原始 SPIR-V 字节码哈希
+        uint64_t offset;        ///< 二进制数据相对文件起始的字节偏移
+        uint64_t binary_size;   ///< 原生机器码二进制字节大小
     };
 
+    inline constexpr uint32_t shader_cache_magic = 0x43535453;   ///< "STSC"
+    inline constexpr uint32_t shader_cache_version = 2;
+    inline constexpr const char* shader_cache_path = "shader_cache/shaders.cache";
+
+    static_assert ( sizeof ( ShaderCacheHeader ) % alignof ( ShaderCacheEntry ) == 0,
+                    "ShaderCacheEntry table must be naturally aligned when read in place from the mmap" );
+
+    // 🚀 着色器二进制的兼容性身份：按 VK_EXT_shader_object 规范取 shaderBinaryUUID / shaderBinaryVersion，
+    //    并附带驱动版本与厂商 / 设备 ID 作为额外保险 (pipelineCacheUUID 只约束 VkPipelineCache，不适用于此)
+    static inline void queryShaderBinaryIdentity ( VkPhysicalDevice physical_device, ShaderCacheHeader& header ) noexcept
+    {
+        VkPhysicalDeviceShaderObjectPropertiesEXT shaderObjectProps{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_PROPERTIES_EXT };
+        VkPhysicalDeviceProperties2 deviceProps2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+        deviceProps2.pNext = &shaderObjectProps;
+        vkGetPhysicalDeviceProperties2 ( physical_device, &deviceProps2 );
+
+        std::memcpy ( header.shaderBinaryUUID, shaderObjectProps.shaderBinaryUUID, VK_UUID_SIZE );
+        header.shaderBinaryVersion = shaderObjectProps.shaderBinaryVersion;
+        header.driverVersion = deviceProps2.properties.driverVersion;
+        header.vendorID = deviceProps2.properties.vendorID;
+        header.deviceID = deviceProps2.properties.deviceID;
+    }
+
     // FNV-1a 64位无损极速哈希计算器 (0 第三方库依赖)
     static inline uint64_t computeSpirvHash ( std::span< const uint32_t > code ) noexcept
     {
@@ -140,6 +156,17 @@ namespace StuCanvas
         // 在合成器（Compute Shader）阶段，用于在常数时间内快速读取其百分比范围 [x, y, w, h] 及外观 transition 效果
         ViewPort* viewport = nullptr;
     };
+
+    /**
+     * @brief 画面导出的磁盘编码格式
+     */
+    enum class ImageExportFormat : uint8_t
+    {
+        PNG,   ///< stb deflate 压缩，体积最小但编码最慢
+        QOI,   ///< QOI 无损编码，吞吐量约为 PNG 的 10 倍以上，适合离线序列帧
+        RAW    ///< 紧密排列的 RGBA8 原始字节，零编码开销
+    };
+
     class VulkanQueue
     {
     public:
@@ -333,23 +360,21 @@ namespace StuCanvas
         }
 
         /**
-         * @brief 创建、编译并物理缓存一个现代着色器对象，并直接返回其物理句柄 (VkShaderEXT)
+         * @brief 创建一个现代着色器对象，并直接返回其物理句柄 (VkShaderEXT)
+         *
+         * 若提供了与当前设备匹配的原生二进制，则直接以 BINARY 方式加载 (热启动，微秒级)；
+         * 否则回退为 SPIR-V 冷编译。本函数不触碰磁盘，可在多个线程上并发调用。
          *
          * @param stage 着色器流水线阶段 (如 VK_SHADER_STAGE_VERTEX_BIT / VK_SHADER_STAGE_FRAGMENT_BIT)
          * @param spirv_code 原始 SPIR-V 编译后的 32位字节码切片
-         * @param cache_path 磁盘缓存文件路径。若传入 nullptr 则不启用磁盘缓存
+         * @param cached_binary 单文件缓存中该槽位的原生二进制 (可为空)
+         * @param loaded_from_cache 输出：是否命中二进制缓存 (可为 nullptr)
          * @return 成功创建或从二进制缓存加载的着色器对象句柄 (VkShaderEXT)
          */
         VkShaderEXT createShader ( VkShaderStageFlagBits stage, std::span< const uint32_t > spirv_code,
-                                   const char* cache_path )
+                                   std::span< const uint8_t > cached_binary = {}, bool* loaded_from_cache = nullptr )
         {
-            const auto& primaryDevice = ctx.getPrimaryDevice ();
-            VkDevice device = primaryDevice.get ();
-            VkPhysicalDevice physDevice = primaryDevice.getPhysicalDevice ();
-
-            // 获取当前显卡设备的硬件属性 (用于版本与 UUID 的安全校验)
-            VkPhysicalDeviceProperties deviceProps;
-            vkGetPhysicalDeviceProperties ( physDevice, &deviceProps );
+            VkDevice device = ctx.getPrimaryDevice ().get ();
 
             // 使用构造函数中已加载的函数指针成员，无需重复动态查询
             if ( !pfnCreateShaders || !pfnGetShaderBinaryData ) [[unlikely]]
@@ -365,48 +390,30 @@ namespace StuCanvas
             VkShaderEXT shader = VK_NULL_HANDLE;
             VkShaderStageFlags next_stage = ( stage == VK_SHADER_STAGE_VERTEX_BIT ) ? VK_SHADER_STAGE_FRAGMENT_BIT : 0;
             bool cache_loaded = false;
-            const uint64_t current_spirv_hash = computeSpirvHash ( spirv_code );
-            const char* entry_name = ( stage == VK_SHADER_STAGE_VERTEX_BIT ) ? "vertexMain" : "fragmentMain";
+
+            VkShaderCreateInfoEXT createInfo{};
+            createInfo.sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT;
+            createInfo.stage = stage;
+            createInfo.pName = "main";
+            createInfo.nextStage = next_stage;             // 🚀 绑定衔接阶段
+            createInfo.setLayoutCount = 0;
+            createInfo.pSetLayouts = nullptr;
+            createInfo.pushConstantRangeCount = 1;         // 🚀 绑定常量范围
+            createInfo.pPushConstantRanges = &pushRange;   // 🚀 绑定
 
             // =====================================================================
-            // 1. 尝试从磁盘读取缓存 (热启动检测)
+            // 1. 尝试直接加载缓存中的原生机器码 (热启动)
             // =====================================================================
-            if ( cache_path )
+            if ( !cached_binary.empty () ) [[likely]]
             {
-                std::ifstream in ( cache_path, std::ios::binary );
-                if ( in )
-                {
-                    ShaderCacheHeader header{};
-                    in.read ( reinterpret_cast< char* > ( &header ), sizeof ( ShaderCacheHeader ) );
+                createInfo.codeType = VK_SHADER_CODE_TYPE_BINARY_EXT;   // 🚀 使用二进制原生机器码加载
+                createInfo.codeSize = cached_binary.size ();
+                createInfo.pCode = cached_binary.data ();
 
-                    // 核心安全校验：当且仅当 硬件UUID、驱动版本 以及 SPIR-V 哈希值完全一致时，缓存才可用
-                    if ( std::memcmp ( header.pipelineCacheUUID, deviceProps.pipelineCacheUUID, VK_UUID_SIZE ) == 0 &&
-                         header.driverVersion == deviceProps.driverVersion && header.spirv_hash == current_spirv_hash )
-                        [[likely]]
-                    {
-                        std::vector< uint8_t > binary_data ( header.binary_size );
-                        in.read ( reinterpret_cast< char* > ( binary_data.data () ), header.binary_size );
-
-                        VkShaderCreateInfoEXT createInfo{};
-                        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT;
-                        createInfo.stage = stage;
-                        createInfo.codeType = VK_SHADER_CODE_TYPE_BINARY_EXT;   // 🚀 使用二进制原生机器码加载
-                        createInfo.codeSize = header.binary_size;
-                        createInfo.pCode = binary_data.data ();
-                        createInfo.pName = "main";
-                        createInfo.nextStage = next_stage;   // 🚀 绑定衔接阶段
-                        createInfo.setLayoutCount = 0;
-                        createInfo.pSetLayouts = nullptr;
-                        createInfo.pushConstantRangeCount = 1;         // 🚀 绑定常量范围
-                        createInfo.pPushConstantRanges = &pushRange;   // 🚀 绑定
-
-
-                        // 显卡驱动直接加载原生指令，跳过编译与优化阶段，时间缩短至微秒级
-                        if ( pfnCreateShaders ( device, 1, &createInfo, nullptr, &shader ) == VK_SUCCESS )
-                        {
-                            cache_loaded = true;
-                        }
-                    }
+                // 显卡驱动直接加载原生指令，跳过编译与优化阶段，时间缩短至微秒级
+                if ( pfnCreateShaders ( device, 1, &createInfo, nullptr, &shader ) == VK_SUCCESS )
+                {
+                    cache_loaded = true;
                 }
             }
 
@@ -417,70 +424,33 @@ namespace StuCanvas
             {
                 std::cout << "正在以冷启动方式编译并分析着色器字节码...\n";
 
-                VkShaderCreateInfoEXT createInfo{};
-                createInfo.sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT;
-                createInfo.stage = stage;
                 createInfo.codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT;   // 🚀 使用标准的 SPIR-V 编译
                 createInfo.codeSize = spirv_code.size () * sizeof ( uint32_t );
                 createInfo.pCode = spirv_code.data ();
-                createInfo.pName = "main";
-                createInfo.setLayoutCount = 0;
-                createInfo.pSetLayouts = nullptr;
-                createInfo.nextStage = next_stage;             // 🚀 绑定衔接阶段
-                createInfo.pushConstantRangeCount = 1;         // 🚀 绑定常量范围
-                createInfo.pPushConstantRanges = &pushRange;   // 🚀 绑定
-
 
                 if ( pfnCreateShaders ( device, 1, &createInfo, nullptr, &shader ) != VK_SUCCESS )
                 {
                     throw std::runtime_error ( "VulkanQueue::createShader: Failed to compile shader from SPIR-V." );
                 }
+            }
 
-                // =================================================================
-                // 3. 提取编译完成的原生 GPU ISA 并回写磁盘
-                // =================================================================
-                if ( cache_path )
-                {
-                    // 🚀 核心修改：使用 C++17 std::filesystem 自动检查并创建缓存父文件夹 [1]
-                    // 这能防止由于文件夹不存在而导致 std::ofstream 静默创建文件失败的问题 [1]
-                    std::filesystem::path path_checker ( cache_path );
-                    if ( path_checker.has_parent_path () ) [[likely]]
-                    {
-                        std::filesystem::create_directories ( path_checker.parent_path () );
-                    }
-
-                    size_t binary_size = 0;
-                    // 获取二进制数据实际大小
-                    if ( pfnGetShaderBinaryData ( device, shader, &binary_size, nullptr ) == VK_SUCCESS &&
-                         binary_size > 0 )
-                    {
-                        std::vector< uint8_t > binary_data ( binary_size );
-                        if ( pfnGetShaderBinaryData ( device, shader, &binary_size, binary_data.data () ) ==
-                             VK_SUCCESS )
-                        {
-                            // 写入磁盘 (此时由于文件夹已被 std::filesystem 物理创建，写入必然成功) [1]
-                            std::ofstream out ( cache_path, std::ios::binary );
-                            if ( out )
-                            {
-                                ShaderCacheHeader header{};
-                                std::memcpy ( header.pipelineCacheUUID, deviceProps.pipelineCacheUUID, VK_UUID_SIZE );
-                                header.driverVersion = deviceProps.driverVersion;
-                                header.spirv_hash = current_spirv_hash;
-                                header.binary_size = binary_size;
-
-                                out.write ( reinterpret_cast< const char* > ( &header ), sizeof ( ShaderCacheHeader ) );
-                                out.write ( reinterpret_cast< const char* > ( binary_data.data () ), binary_size );
-                            }
-                        }
-                    }
-                }
+            if ( loaded_from_cache )
+            {
+                *loaded_from_cache = cache_loaded;
             }
 
-            // 4. 直接返回成功创建的着色器对象句柄
+            // 3. 直接返回成功创建的着色器对象句柄
             return shader;
-        } /**
-           * @brief 自动遍历静态着色器资产表，零多余转换，极速完成硬件载入与 O(1) 物理索引对齐
-           */
+        }
+
+        /**
+         * @brief 自动遍历静态着色器资产表，并行完成硬件载入与 O(1) 物理索引对齐
+         *
+         * - 所有非惰性槽位在 TBB 线程池上并行创建 (vkCreateShadersEXT 对 VkDevice 无外部同步要求)；
+         * - 二进制缓存统一存放于 shader_cache_path 单文件中，以 mmap 原位读取，不做额外拷贝；
+         * - 标记为 lazy 的槽位推迟到首次 acquireShader 时才创建；
+         * - 任一槽位发生冷编译时，整体重写一次缓存文件。
+         */
         void initializeAllShaders ()
         {
             // 1. 物理探测用户注册的最高 slot 索引，以此来规划 shader_objects 的容量
@@ -492,18 +462,200 @@ namespace StuCanvas
 
             // 2. 🚀 强行重置大小。这保证了未来通过索引 `shader_objects[slot]` 访问时，绝不发生越界
             shader_objects.resize ( max_slot + 1, VK_NULL_HANDLE );
+            shader_spirv_hashes.resize ( max_slot + 1, 0 );
+
+            for ( const auto& asset : Shaders::g_shader_assets )
+            {
+                shader_spirv_hashes[ asset.slot ] = computeSpirvHash ( asset.code );
+            }
+
+            // 3. 一次性映射单文件缓存 (校验失败时视为空缓存)
+            openShaderCache ();
+
+            // 4. 🚀 跨槽位并行创建全部非惰性着色器
+            std::atomic< bool > any_miss{ false };
+            oneapi::tbb::parallel_for ( oneapi::tbb::blocked_range< size_t > ( 0, Shaders::g_shader_assets_count, 1 ),
+                                        [ & ] ( const oneapi::tbb::blocked_range< size_t >& range )
+                                        {
+                                            for ( size_t i = range.begin (); i != range.end (); ++i )
+                                            {
+                                                const auto& asset = Shaders::g_shader_assets[ i ];
+                                                if ( asset.lazy )
+                                                {
+                                                    continue;
+                                                }
+
+                                                bool hit = false;
+                                                shader_objects[ asset.slot ] = createShader (
+                                                    asset.stage, asset.code,
+                                                    findCachedBinary ( asset.slot, asset.stage,
+                                                                       shader_spirv_hashes[ asset.slot ] ),
+                                                    &hit );
+
+                                                if ( !hit )
+                                                {
+                                                    any_miss.store ( true, std::memory_order_relaxed );
+                                                }
+                                            }
+                                        } );
+
+            if ( any_miss.load ( std::memory_order_relaxed ) ) [[unlikely]]
+            {
+                shader_cache_dirty = true;
+                saveShaderCache ();
+            }
+        }
 
-            // 3. 循环遍历一键加载
+        /**
+         * @brief 按槽位获取着色器对象；惰性槽位在首次使用时才创建 (之后 O(1) 直寻址)
+         *
+         * @param slot 着色器资产表中的槽位索引
+         */
+        VkShaderEXT acquireShader ( uint32_t slot )
+        {
+            if ( slot >= shader_objects.size () ) [[unlikely]]
+            {
+                throw std::out_of_range ( "VulkanQueue::acquireShader: slot out of range." );
+            }
+
+            if ( shader_objects[ slot ] != VK_NULL_HANDLE ) [[likely]]
+            {
+                return shader_objects[ slot ];
+            }
+
+            for ( const auto& asset : Shaders::g_shader_assets )
+            {
+                if ( asset.slot != slot )
+                {
+                    continue;
+                }
+
+                bool hit = false;
+                shader_objects[ slot ] = createShader (
+                    asset.stage, asset.code, findCachedBinary ( slot, asset.stage, shader_spirv_hashes[ slot ] ),
+                    &hit );
+
+                if ( !hit ) [[unlikely]]
+                {
+                    shader_cache_dirty = true;
+                }
+                return shader_objects[ slot ];
+            }
+
+            throw std::runtime_error ( "VulkanQueue::acquireShader: No shader asset registered for this slot." );
+        }
+
+        /**
+         * @brief 将全部已创建的着色器二进制写回单文件缓存
+         *
+         * 尚未被创建的惰性槽位会原样沿用旧缓存中的条目。先写临时文件再原子 rename，
+         * 因此即便写入中途失败，也不会破坏仍被 mmap 映射着的旧缓存。
+         */
+        void saveShaderCache ()
+        {
+            if ( !shader_cache_dirty )
+            {
+                return;
+            }
+
+            const auto& primaryDevice = ctx.getPrimaryDevice ();
+            VkDevice device = primaryDevice.get ();
+
+            std::vector< ShaderCacheEntry > entries;
+            std::vector< std::vector< uint8_t > > blobs;
+
+            // 1. 收集每个槽位的原生二进制 (已创建的从驱动导出，未创建的沿用旧缓存)
             for ( const auto& asset : Shaders::g_shader_assets )
             {
-                // 为每个 Slot 生成其专属且独立的磁盘缓存路径 (如 "shader_cache/slot_0.cache")
-                std::string cache_path = "shader_cache/slot_" + std::to_string ( asset.slot ) + ".cache";
+                std::vector< uint8_t > blob;
+                const VkShaderEXT shader = shader_objects[ asset.slot ];
+
+                if ( shader != VK_NULL_HANDLE )
+                {
+                    size_t binary_size = 0;
+                    if ( pfnGetShaderBinaryData ( device, shader, &binary_size, nullptr ) == VK_SUCCESS &&
+                         binary_size > 0 )
+                    {
+                        blob.resize ( binary_size );
+                        if ( pfnGetShaderBinaryData ( device, shader, &binary_size, blob.data () ) != VK_SUCCESS )
+                        {
+                            blob.clear ();
+                        }
+                    }
+                }
+                else
+                {
+                    const std::span< const uint8_t > old =
+                        findCachedBinary ( asset.slot, asset.stage, shader_spirv_hashes[ asset.slot ] );
+                    blob.assign ( old.begin (), old.end () );
+                }
+
+                if ( blob.empty () )
+                {
+                    continue;
+                }
+
+                entries.push_back ( { asset.slot, static_cast< uint32_t > ( asset.stage ),
+                                      shader_spirv_hashes[ asset.slot ], 0, blob.size () } );
+                blobs.push_back ( std::move ( blob ) );
+            }
+
+            // 2. 计算每个数据块的偏移 (按 16 字节对齐，方便驱动原位读取)
+            ShaderCacheHeader header{};
+            header.magic = shader_cache_magic;
+            header.version = shader_cache_version;
+            queryShaderBinaryIdentity ( primaryDevice.getPhysicalDevice (), header );
+            header.entry_count = static_cast< uint32_t > ( entries.size () );
+
+            uint64_t cursor = sizeof ( ShaderCacheHeader ) + entries.size () * sizeof ( ShaderCacheEntry );
+            for ( auto& entry : entries )
+            {
+                cursor = ( cursor + 15 ) & ~uint64_t ( 15 );
+                entry.offset = cursor;
+                cursor += entry.binary_size;
+            }
+
+            // 3. 写入临时文件后原子替换
+            std::filesystem::path final_path ( shader_cache_path );
+            if ( final_path.has_parent_path () ) [[likely]]
+            {
+                std::filesystem::create_directories ( final_path.parent_path () );
+            }
+            std::filesystem::path temp_path = final_path;
+            temp_path += ".tmp";
+
+            {
+                std::ofstream out ( temp_path, std::ios::binary | std::ios::trunc );
+                if ( !out )
+                {
+                    return;   // 缓存只是加速手段，写入失败不影响渲染
+                }
+
+                out.write ( reinterpret_cast< const char* > ( &header ), sizeof ( ShaderCacheHeader ) );
+                out.write ( reinterpret_cast< const char* > ( entries.data () ),
+                            static_cast< std::streamsize > ( entries.size () * sizeof ( ShaderCacheEntry ) ) );
+
+                static constexpr char padding[ 16 ] = {};
+                uint64_t written = sizeof ( ShaderCacheHeader ) + entries.size () * sizeof ( ShaderCacheEntry );
+                for ( size_t i = 0; i < entries.size (); ++i )
+                {
+                    out.write ( padding, static_cast< std::streamsize > ( entries[ i ].offset - written ) );
+                    out.write ( reinterpret_cast< const char* > ( blobs[ i ].data () ),
+                                static_cast< std::streamsize > ( blobs[ i ].size () ) );
+                    written = entries[ i ].offset + entries[ i ].binary_size;
+                }
 
-                // 执行冷/热启动编译 (createShader 此时直接返回生成的 VkShaderEXT 句柄) [1.1.1]
-                VkShaderEXT compiled_shader = createShader ( asset.stage, asset.code, cache_path.c_str () );
+                if ( !out )
+                {
+                    return;
+                }
+            }
 
-                // 🚀 极致性能对齐：直接用用户的递增 slot 作为下标物理托管，实现真正的 O(1) 物理直寻址！
-                shader_objects[ asset.slot ] = compiled_shader;
+            std::error_code ec;
+            std::filesystem::rename ( temp_path, final_path, ec );
+            if ( !ec )
+            {
+                shader_cache_dirty = false;
             }
         }
 
@@ -639,6 +791,14 @@ namespace StuCanvas
             pfnGetBufferDeviceAddress =
                 ( PFN_vkGetBufferDeviceAddress ) vkGetDeviceProcAddr ( device, "vkGetBufferDeviceAddress" );
 
+            // 上传环子分配对齐：满足 std430 中 float4/float4x4 的 16 字节对齐，同时兼容设备的存储缓冲偏移约束
+            {
+                VkPhysicalDeviceProperties deviceProps;
+                vkGetPhysicalDeviceProperties ( primaryDevice.getPhysicalDevice (), &deviceProps );
+                upload_alignment =
+                    std::max< VkDeviceSize > ( 16, deviceProps.limits.minStorageBufferOffsetAlignment );
+            }
+
             const uint32_t graphics_family = primaryDevice.getGraphicsQueue ().familyIndex;
             const uint32_t compute_family = primaryDevice.getComputeQueue ().familyIndex;
 
@@ -730,6 +890,10 @@ namespace StuCanvas
                 // 🚀 新增：安全释放全局 8x MSAA 颜色附件与深度附件，防范显存泄漏 [1]
                 // =================================================================
                 //
+                destroyReadbackRing ();
+                destroyUploadFrames ();
+                cleanupGarbage ();
+                retireGarbage ();
                 cleanupGarbage ();
                 for ( auto& frame : frames )
                 {
@@ -785,6 +949,16 @@ namespace StuCanvas
                 // =================================================================
                 // 后续其他缓存资源的释放 (按逆序完美流转) [1]
                 // =================================================================
+                // 惰性槽位在运行期间发生的冷编译结果，在着色器销毁前写回单文件缓存
+                try
+                {
+                    saveShaderCache ();
+                }
+                catch ( ... )
+                {
+                }
+                closeShaderCache ();
+
                 // 使用构造函数中已加载的函数指针成员销毁 Shader Objects
                 for ( VkShaderEXT shader : shader_objects )
                 {
@@ -796,12 +970,6 @@ namespace StuCanvas
                 }
                 shader_objects.clear ();
 
-                if ( pipeline_cache != VK_NULL_HANDLE )
-                {
-                    vkDestroyPipelineCache ( device, pipeline_cache, nullptr );
-                    pipeline_cache = VK_NULL_HANDLE;
-                }
-
                 if ( compute_pool != VK_NULL_HANDLE )
                 {
                     vkDestroyCommandPool ( device, compute_pool, nullptr );
@@ -823,94 +991,133 @@ namespace StuCanvas
 
 
         /**
-         * @brief 🚀 显存物理画面一键安全导出为 PNG 磁盘文件
+         * @brief 🚀 显存物理画面一键安全导出为 PNG 磁盘文件 (同步版本)
+         *
+         * 内部复用异步导出流水线：提交回读后立即等待全部在途帧编码落盘，
+         * 因此调用返回时文件必然已写入完毕。
          *
          * @param image_slot 目标导出的 RenderFrame 槽位索引
          * @param file_path 物理磁盘的写入目标路径 (如 "output/frame_0001.png")
          */
         inline void exportImage ( uint32_t image_slot, const std::string& file_path )
+        {
+            exportImageAsync ( image_slot, file_path, ImageExportFormat::PNG );
+            flushExports ();
+        }
+
+        /**
+         * @brief 🚀 异步流水线导出：GPU 回读、CPU 编码与渲染三者并行
+         *
+         * 拷贝命令被提交到常驻映射的回读环形缓冲中的下一个槽位，随后立即返回。
+         * 栅栏只在调用线程上查询：每次调用 (以及 flushExports) 都会把拷贝已完成的槽位移交给
+         * 回读环专属的编码线程，PNG/QOI 编码与落盘在那里完成。环形缓冲的槽位数即在途帧上限，
+         * 轮到的槽位仍在拷贝时调用线程等待其栅栏，仍在编码时等待编码线程归还 (有界队列背压)。
+         * 编码线程独立于 TBB 线程池，因此单核容器或在 TBB 任务中调用时同样不会死锁。
+         *
+         * @note 调用前 image_slot 对应图片须处于 COLOR_ATTACHMENT_OPTIMAL 布局 (即 submitGraphics 之后)。
+         *       同一队列上的提交顺序保证拷贝一定发生在渲染写入之后，无需再等待 garbage_fence。
+         *
+         * @param image_slot 目标导出的 RenderFrame 槽位索引
+         * @param file_path 物理磁盘的写入目标路径
+         * @param format 磁盘编码格式
+         */
+        inline void exportImageAsync ( uint32_t image_slot, std::string file_path,
+                                       ImageExportFormat format = ImageExportFormat::PNG )
         {
             if ( image_slot >= frames.size () ) [[unlikely]]
             {
-                throw std::out_of_range ( "VulkanQueue::exportImage: image_slot out of range." );
+                throw std::out_of_range ( "VulkanQueue::exportImageAsync: image_slot out of range." );
+            }
+
+            const RenderFrame& frame = frames[ image_slot ];
+            if ( frame.image == VK_NULL_HANDLE ) [[unlikely]]
+            {
+                throw std::runtime_error ( "VulkanQueue::exportImageAsync: Target image is uninitialized." );
             }
 
             const auto& primaryDevice = ctx.getPrimaryDevice ();
             VkDevice device = primaryDevice.get ();
             VmaAllocator allocator = primaryDevice.getAllocator ();
 
-            // =====================================================================
-            // 1. 🚀 先读取并等待成员的 garbage_fence 确定是绿灯状态，直接阻断以确保安全
-            // =====================================================================
-            if ( garbage_fence != VK_NULL_HANDLE ) [[likely]]
+            if ( !readback_ring ) [[unlikely]]
             {
-                vkWaitForFences ( device, 1, &garbage_fence, VK_TRUE, UINT64_MAX );
+                initializeReadbackRing ();
             }
 
-            const RenderFrame& frame = frames[ image_slot ];
-            const uint32_t width = frame.width;
-            const uint32_t height = frame.height;
-            VkImage src_image = frame.image;
+            // =====================================================================
+            // 1. 轮转取出下一个槽位；若其仍在拷贝/编码中则等待回收 (有界队列背压)
+            // =====================================================================
+            ReadbackRing& ring = *readback_ring;
+            pollReadbackRing ( ring, device, allocator, false );
 
-            if ( src_image == VK_NULL_HANDLE ) [[unlikely]]
+            ReadbackSlot& slot = ring.slots[ ring.cursor ];
+            ring.cursor = ( ring.cursor + 1 ) % readback_ring_size;
+
+            if ( slot.state.load ( std::memory_order_acquire ) == ReadbackState::Copying )
             {
-                throw std::runtime_error ( "VulkanQueue::exportImage: Target image is uninitialized." );
+                handOffReadbackSlot ( ring, slot, device, allocator, true );
             }
+            slot.state.wait ( ReadbackState::Encoding, std::memory_order_acquire );
 
             // =====================================================================
-            // 2. 在 CPU 侧利用 VMA 分配一块相同尺寸的可读写 Staging 内存 [1.1.2]
+            // 2. 容量不足时才重建回读缓冲 (同分辨率序列导出只在首帧分配一次)
             // =====================================================================
-            VkDeviceSize buffer_size = static_cast< VkDeviceSize > ( width ) * height * 4;   // RGBA8 格式
-            VkBuffer staging_buffer = VK_NULL_HANDLE;
-            VmaAllocation staging_allocation = VK_NULL_HANDLE;
+            const VkDeviceSize buffer_size = static_cast< VkDeviceSize > ( frame.width ) * frame.height * 4;
+            if ( slot.capacity < buffer_size ) [[unlikely]]
+            {
+                if ( slot.buffer != VK_NULL_HANDLE )
+                {
+                    vmaDestroyBuffer ( allocator, slot.buffer, slot.allocation );
+                    slot.buffer = VK_NULL_HANDLE;
+                    slot.allocation = VK_NULL_HANDLE;
+                    slot.mapped = nullptr;
+                    slot.capacity = 0;
+                }
 
-            VkBufferCreateInfo bufferInfo{};
-            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-            bufferInfo.size = buffer_size;
-            bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                VkBufferCreateInfo bufferInfo{};
+                bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+                bufferInfo.size = buffer_size;
+                bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-            VmaAllocationCreateInfo allocInfo{};
-            allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-            // 开启主机随机访问与一键自动内存映射标志，保障 CPU 读取效率 [1.1.2, 1.2.6]
-            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+                VmaAllocationCreateInfo allocInfo{};
+                allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+                // 主机随机访问 + 常驻映射：整个生命周期只 map 一次 [1.1.2, 1.2.6]
+                allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
-            VmaAllocationInfo allocationInfo{};
-            if ( vmaCreateBuffer ( allocator, &bufferInfo, &allocInfo, &staging_buffer, &staging_allocation,
-                                   &allocationInfo ) != VK_SUCCESS )
-            {
-                throw std::runtime_error ( "VulkanQueue::exportImage: Failed to allocate CPU staging buffer." );
+                VmaAllocationInfo allocationInfo{};
+                if ( vmaCreateBuffer ( allocator, &bufferInfo, &allocInfo, &slot.buffer, &slot.allocation,
+                                       &allocationInfo ) != VK_SUCCESS )
+                {
+                    throw std::runtime_error ( "VulkanQueue::exportImageAsync: Failed to allocate readback buffer." );
+                }
+
+                slot.mapped = allocationInfo.pMappedData;
+                slot.capacity = buffer_size;
             }
 
+            slot.width = frame.width;
+            slot.height = frame.height;
+            slot.format = format;
+            slot.file_path = std::move ( file_path );
+
             // =====================================================================
-            // 3. 录制一次性 DMA 拷贝命令
+            // 3. 在槽位专属命令缓冲区中录制 DMA 拷贝 (布局切换 -> 拷贝 -> 布局还原)
             // =====================================================================
-            VkCommandBufferAllocateInfo cmdAllocInfo{};
-            cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            cmdAllocInfo.commandPool = graphics_pool;
-            cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            cmdAllocInfo.commandBufferCount = 1;
-
-            VkCommandBuffer copy_cmd = VK_NULL_HANDLE;
-            if ( vkAllocateCommandBuffers ( device, &cmdAllocInfo, &copy_cmd ) != VK_SUCCESS )
-            {
-                vmaDestroyBuffer ( allocator, staging_buffer, staging_allocation );
-                throw std::runtime_error ( "VulkanQueue::exportImage: Failed to allocate copy command buffer." );
-            }
+            vkResetCommandBuffer ( slot.cmd, 0 );
 
             VkCommandBufferBeginInfo beginInfo{};
             beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
             beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            vkBeginCommandBuffer ( copy_cmd, &beginInfo );
+            vkBeginCommandBuffer ( slot.cmd, &beginInfo );
 
-            // 🚀 A. 内存屏障过渡：将图片布局从 COLOR_ATTACHMENT_OPTIMAL 切换至 TRANSFER_SRC_OPTIMAL [1.1.1, 1.1.2]
             VkImageMemoryBarrier barrier{};
             barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
             barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.image = src_image;
+            barrier.image = frame.image;
             barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
             barrier.subresourceRange.baseMipLevel = 0;
             barrier.subresourceRange.levelCount = 1;
@@ -919,10 +1126,9 @@ namespace StuCanvas
             barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
             barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
-            vkCmdPipelineBarrier ( copy_cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            vkCmdPipelineBarrier ( slot.cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
                                    VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier );
 
-            // 🚀 B. 执行硬件级极速图像拷贝
             VkBufferImageCopy region{};
             region.bufferOffset = 0;
             region.bufferRowLength = 0;
@@ -932,69 +1138,79 @@ namespace StuCanvas
             region.imageSubresource.baseArrayLayer = 0;
             region.imageSubresource.layerCount = 1;
             region.imageOffset = { 0, 0, 0 };
-            region.imageExtent = { width, height, 1 };
+            region.imageExtent = { frame.width, frame.height, 1 };
 
-            vkCmdCopyImageToBuffer ( copy_cmd, src_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging_buffer, 1,
+            vkCmdCopyImageToBuffer ( slot.cmd, frame.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.buffer, 1,
                                      &region );
 
-            // 🚀 C. 内存屏障还原：为了不污染后续渲染，将图片布局还原回 COLOR_ATTACHMENT_OPTIMAL [1.1.1]
             barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
             barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
-            vkCmdPipelineBarrier ( copy_cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vkCmdPipelineBarrier ( slot.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
                                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1,
                                    &barrier );
 
-            vkEndCommandBuffer ( copy_cmd );
+            // 🚀 额外的 HOST 屏障：保证拷贝写入对 CPU 映射读取可见
+            VkMemoryBarrier hostBarrier{};
+            hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+            vkCmdPipelineBarrier ( slot.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1,
+                                   &hostBarrier, 0, nullptr, 0, nullptr );
+
+            vkEndCommandBuffer ( slot.cmd );
 
             // =====================================================================
-            // 4. 提交拷贝任务，并使用临时 Fence 确保 CPU 阻断完成
+            // 4. 以槽位专属栅栏提交；渲染线程到此即可返回，继续录制下一帧
             // =====================================================================
+            vkResetFences ( device, 1, &slot.fence );
+
             VkSubmitInfo submitInfo{};
             submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
             submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &copy_cmd;
-
-            VkFenceCreateInfo fenceInfo{};
-            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-            VkFence copy_fence = VK_NULL_HANDLE;
-            vkCreateFence ( device, &fenceInfo, nullptr, &copy_fence );
+            submitInfo.pCommandBuffers = &slot.cmd;
 
             VkQueue graphics_queue = primaryDevice.getGraphicsQueue ().handle;
-            if ( vkQueueSubmit ( graphics_queue, 1, &submitInfo, copy_fence ) != VK_SUCCESS )
+            if ( vkQueueSubmit ( graphics_queue, 1, &submitInfo, slot.fence ) != VK_SUCCESS )
             {
-                vkDestroyFence ( device, copy_fence, nullptr );
-                vkFreeCommandBuffers ( device, graphics_pool, 1, &copy_cmd );
-                vmaDestroyBuffer ( allocator, staging_buffer, staging_allocation );
-                throw std::runtime_error ( "VulkanQueue::exportImage: Failed to submit copy command buffer." );
+                throw std::runtime_error ( "VulkanQueue::exportImageAsync: Failed to submit copy command buffer." );
             }
 
-            // 阻塞等待显卡内部数据拷贝动作 100% 结束 [1.1.1, 1.2.4]
-            vkWaitForFences ( device, 1, &copy_fence, VK_TRUE, UINT64_MAX );
-
-            // 清理临时分配的同步句柄 [1]
-            vkDestroyFence ( device, copy_fence, nullptr );
-            vkFreeCommandBuffers ( device, graphics_pool, 1, &copy_cmd );
+            slot.state.store ( ReadbackState::Copying, std::memory_order_release );
 
             // =====================================================================
-            // 5. 🚀 物理写入磁盘：使用 stb 库直接导出为高精度 PNG
+            // 5. 🚀 顺带把此前已完成拷贝的槽位交给编码线程 (不阻塞)
             // =====================================================================
-            // 由于 VMA 开启了 MAPPED 属性，直接通过 mapped 物理指针安全读取 [1.1.2]
-            const int stride_in_bytes = static_cast< int > ( width ) * 4;
+            pollReadbackRing ( ring, device, allocator, false );
+        }
 
-            int write_result =
-                stbi_write_png ( file_path.c_str (), static_cast< int > ( width ), static_cast< int > ( height ),
-                                 4,   // 4个通道 (RGBA)
-                                 allocationInfo.pMappedData, stride_in_bytes );
+        /**
+         * @brief 等待所有在途导出帧完成编码与落盘
+         *
+         * 序列导出结束时或需要读取导出结果前调用。若期间有任一帧写入失败，则统一抛出异常。
+         */
+        inline void flushExports ()
+        {
+            if ( !readback_ring )
+            {
+                return;
+            }
 
-            // 6. 物理销毁临时 staging buffer，内存归还显存池 [1.1.2, 1.2.6]
-            vmaDestroyBuffer ( allocator, staging_buffer, staging_allocation );
+            const auto& primaryDevice = ctx.getPrimaryDevice ();
+            ReadbackRing& ring = *readback_ring;
+            pollReadbackRing ( ring, primaryDevice.get (), primaryDevice.getAllocator (), true );
+            for ( ReadbackSlot& slot : ring.slots )
+            {
+                slot.state.wait ( ReadbackState::Encoding, std::memory_order_acquire );
+            }
 
-            if ( write_result == 0 ) [[unlikely]]
+            const uint32_t failures = readback_ring->failures.exchange ( 0, std::memory_order_relaxed );
+            if ( failures > 0 ) [[unlikely]]
             {
-                throw std::runtime_error ( "VulkanQueue::exportImage: Failed to write PNG file to disk." );
+                throw std::runtime_error ( "VulkanQueue::flushExports: Failed to write " + std::to_string ( failures ) +
+                                           " exported image(s) to disk." );
             }
         }
 
@@ -1176,7 +1392,7 @@ namespace StuCanvas
         inline void cleanupGarbage ()
         {
             // 🚀 若垃圾账本本就为空，直接秒退，0 开销
-            if ( garbage_buffers.empty () ) [[unlikely]]
+            if ( inflight_garbage_buffers.empty () ) [[unlikely]]
             {
                 return;
             }
@@ -1184,15 +1400,26 @@ namespace StuCanvas
             const auto& primaryDevice = ctx.getPrimaryDevice ();
             VmaAllocator allocator = primaryDevice.getAllocator ();   // 🚀 仅获取 VMA 分配器即可 [2]
 
-            // 1. 顺着 std::vector 账本，一键物理释放所有 Staging Buffers 显存
-            for ( size_t i = 0; i < garbage_buffers.size (); ++i )
+            // 1. 顺着 std::vector 账本，一键物理释放上一次提交所引用的全部 Staging Buffers 显存
+            for ( size_t i = 0; i < inflight_garbage_buffers.size (); ++i )
             {
-                vmaDestroyBuffer ( allocator, garbage_buffers[ i ], garbage_allocations[ i ] );
+                vmaDestroyBuffer ( allocator, inflight_garbage_buffers[ i ], inflight_garbage_allocations[ i ] );
             }
 
             // 2. 清空账本，等待下一次垃圾收集
-            garbage_buffers.clear ();
-            garbage_allocations.clear ();
+            inflight_garbage_buffers.clear ();
+            inflight_garbage_allocations.clear ();
+        }
+
+        /**
+         * @brief 将本帧录制期间登记的垃圾移交给在途账本 (提交之后调用)
+         *
+         * 本帧的缓冲仍被刚提交的命令引用，只能等下一次 garbage_fence 变绿后由 cleanupGarbage 释放。
+         */
+        inline void retireGarbage ()
+        {
+            inflight_garbage_buffers.swap ( garbage_buffers );
+            inflight_garbage_allocations.swap ( garbage_allocations );
         }
         inline void ensureEndRecording ()
         {
@@ -1250,6 +1477,9 @@ namespace StuCanvas
             VkDevice device = primaryDevice.get ();
             VkQueue graphics_queue = primaryDevice.getGraphicsQueue ().handle;
 
+            // 🚀 本帧全部环形子分配与独立上传只做一次批量刷新
+            flushUploadFrame ();
+
             // 2. 🚀 物理挂起 CPU：等待上一次动作彻底画完，避免发生任何形式的 GPU 读写冲突
             vkWaitForFences ( device, 1, &garbage_fence, VK_TRUE, UINT64_MAX );
 
@@ -1269,19 +1499,21 @@ namespace StuCanvas
             {
                 throw std::runtime_error ( "VulkanQueue::submitGraphics: Failed to submit graphics command buffer." );
             }
+
+            // 6. 🚀 本帧垃圾转入在途账本；上传环切换到另一帧区域 (其上一位使用者已在步骤 2 中被栅栏确认完成)
+            retireGarbage ();
+            advanceUploadFrame ();
         }
 
 
         /**
          * @brief 核心录制函数：执行 AABB 空间收敛、RTE + 2的幂次双精度归一化、以及影子相机重构
+         *
+         * 零散实例列表入口：逐实例计算包围盒并线性视锥剔除。图内实例请优先使用 DAGraph 重载 (BVH 加速)。
          */
         void recordImage_DAGInst ( std::span< DAGObjectInstance* > instances, uint32_t image_slot, Camera& camera )
         {
-            if ( instances.empty () ) [[unlikely]]
-            {
-                return;
-            }
-
+            // 空列表不提前返回：仍需走到录制主体清空目标图像，否则上一帧的内容会残留
             // =====================================================================
             // 1. 累积场景中所有物体的世界空间包围盒 (不进行 std::isinf 过滤，保留无限长物体)
             // =====================================================================
@@ -1295,15 +1527,18 @@ namespace StuCanvas
 
             bool has_valid_bounds = false;
 
-            for ( const DAGObjectInstance* instance : instances )
+            std::vector< AABB3D > instance_boxes ( instances.size () );
+
+            for ( size_t i = 0; i < instances.size (); ++i )
             {
+                const DAGObjectInstance* instance = instances[ i ];
                 if ( !instance || !instance->source ) [[unlikely]]
                 {
                     continue;
                 }
 
                 // 直接通过 CPU 侧双精度提取原始拓扑 AABB
-                AABB3D inst_aabb = computeInstanceAABB ( *instance );
+                const AABB3D& inst_aabb = instance_boxes[ i ] = computeInstanceAABB ( *instance );
 
                 total_min_x = std::min ( total_min_x, inst_aabb.min_x );
                 total_min_y = std::min ( total_min_y, inst_aabb.min_y );
@@ -1326,6 +1561,67 @@ namespace StuCanvas
                 scene_aabb = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
             }
 
+            // 线性剔除：复用步骤 1 已算出的实例包围盒；含 inf/NaN 的无限长物体恒可见
+            auto cull = [ & ] ( const Frustum3D& frustum, std::vector< DAGObjectInstance* >& visible )
+            {
+                for ( size_t i = 0; i < instances.size (); ++i )
+                {
+                    DAGObjectInstance* instance = instances[ i ];
+                    if ( !instance || !instance->source ) [[unlikely]]
+                    {
+                        continue;
+                    }
+
+                    const AABB3D& box = instance_boxes[ i ];
+                    const bool bounded = std::isfinite ( box.min_x ) && std::isfinite ( box.min_y ) &&
+                                         std::isfinite ( box.min_z ) && std::isfinite ( box.max_x ) &&
+                                         std::isfinite ( box.max_y ) && std::isfinite ( box.max_z );
+                    if ( !bounded || frustum.classify ( box ) != Frustum3D::Overlap::Outside )
+                    {
+                        visible.push_back ( instance );
+                    }
+                }
+            };
+
+            // 零散实例没有修订号可依赖：批次布局靠指针比对复用，世界中心逐帧重算
+            point_batches.syncLayout ( instances );
+            recordImage_DAGInstCulled ( scene_aabb, cull, false, image_slot, camera );
+        }
+
+        /**
+         * @brief 图内实例录制入口：场景包围盒取自 DAGraph 缓存 BVH 的根节点 (O(1))，并在分组前执行 BVH 视锥剔除
+         *
+         * 放大查看大型构造时，屏幕外的子树整棵跳过，不再为不可见实例支付包围盒计算与绘制录制开销。
+         */
+        void recordImage_DAGInst ( DAGraph& graph, uint32_t image_slot, Camera& camera )
+        {
+            // 空场景 (例如刚删除最后一个实例) 同样落入录制主体：包围盒为全零盒、剔除结果为空，目标照常被清空
+            const InstanceBVH& bvh = graph.instanceBVH ();
+
+            auto cull = [ &bvh ] ( const Frustum3D& frustum, std::vector< DAGObjectInstance* >& visible )
+            {
+                bvh.cull ( frustum, visible );
+            };
+
+            // 布局修订号不变时批次原样复用，只有被重新解算 / 移动过的实例会重算世界中心
+            point_batches.syncLayout ( &graph, graph.instanceLayoutRevision (), bvh.instances () );
+            recordImage_DAGInstCulled ( bvh.bounds (), cull, true, image_slot, camera );
+        }
+
+    private:
+
+        /**
+         * @brief 录制主体：相机视锥求交、RTE 归一化、视锥剔除、按对象分发
+         * @param scene_aabb 场景世界包围盒 (允许含 inf，会被相机视锥 AABB 裁剪)
+         * @param cull 剔除回调 (const Frustum3D&, std::vector<DAGObjectInstance*>& visible)，向 visible 追加可见实例
+         * @param trust_revisions 实例修订号是否可信 (仅 DAGraph 维护的实例为 true)
+         */
+        template < typename CullFn >
+        void recordImage_DAGInstCulled ( const AABB3D& scene_aabb, CullFn&& cull, bool trust_revisions,
+                                         uint32_t image_slot, Camera& camera )
+        {
+            constexpr double inf = std::numeric_limits< double >::infinity ();
+
             // =====================================================================
             // 2. 提取并计算相机视锥体在世界空间中的有限 AABB (Frustum World AABB)
             // =====================================================================
@@ -1424,9 +1720,15 @@ namespace StuCanvas
             double cam_min_x = inf, cam_min_y = inf, cam_min_z = inf;
             double cam_max_x = -inf, cam_max_y = -inf, cam_max_z = -inf;
 
+            double world_corners[ 8 ][ 3 ];
+
             for ( int i = 0; i < 8; ++i )
             {
                 Eigen::Vector4d w_pt = inv_view * view_corners[ i ];
+                world_corners[ i ][ 0 ] = w_pt.x ();
+                world_corners[ i ][ 1 ] = w_pt.y ();
+                world_corners[ i ][ 2 ] = w_pt.z ();
+
                 cam_min_x = std::min ( cam_min_x, w_pt.x () );
                 cam_min_y = std::min ( cam_min_y, w_pt.y () );
                 cam_min_z = std::min ( cam_min_z, w_pt.z () );
@@ -1581,24 +1883,12 @@ namespace StuCanvas
                 default:
                     break;
             }
-            std::vector< DAGObject* > unique_objects;
-            unique_objects.reserve ( instances.size () );   // 预留最大可能容量
-
-            for ( const DAGObjectInstance* instance : instances )
-            {
-                if ( !instance || !instance->source ) [[unlikely]]
-                {
-                    continue;
-                }
-
-                DAGObject* obj = instance->source;
+            // =====================================================================
+            // 5. 🚀 视锥剔除：在分批之前丢弃完全位于视锥外的实例
+            // =====================================================================
+            visible_instances.clear ();
+            cull ( Frustum3D::fromCorners ( world_corners ), visible_instances );
 
-                // 极速去重查询 (对于小规模物体，std::find 线性扫描具有最佳的 CPU 缓存局域性)
-                if ( std::find ( unique_objects.begin (), unique_objects.end (), obj ) == unique_objects.end () )
-                {
-                    unique_objects.push_back ( obj );
-                }
-            }
             const RenderFrame& target_frame = frames[ image_slot ];
             const uint32_t width = target_frame.width;
             const uint32_t height = target_frame.height;
@@ -1606,41 +1896,15 @@ namespace StuCanvas
 
             // 🚀 核心改动：在下面使用全局附件变量之前，运行此自适应函数对齐附件尺寸
             prepareDynamicAttachments ( width, height );
+
             const Eigen::Matrix4f VP_norm_float = ( proj_mat_norm * view_mat_norm ).cast< float > ();
             // =====================================================================
-            // 6. 🚀 核心：直接派发 Object 本身，不触碰任何 instances 提取
+            // 6. 🚀 核心：点类实例走持久化外观批次，每个外观一次实例化绘制
             // =====================================================================
-            for ( DAGObject* obj : unique_objects )
-            {
-                switch ( obj->type )
-                {
-                    case NodeType::POINT_2D_FREE:
-                    case NodeType::POINT_2D_MID:
-                    case NodeType::POINT_2D_SECTION:
-                    case NodeType::POINT_2D_INTERSECT:
-                    case NodeType::POINT_2D_SNAP:
-                    case NodeType::POINT_3D_FREE:
-                    case NodeType::POINT_3D_MID:
-                    case NodeType::POINT_3D_SECTION:
-                    case NodeType::POINT_3D_INTERSECT:
-                    case NodeType::POINT_3D_SNAP:
-                    {
-                        // 🚀 1. 派发 Object 对象本身（通过引用）
-                        // 内部会自己去提取 obj->instances 数组并执行离散化、配置模型矩阵、绑定着色器
-                        recordImage_DAGInstPoint ( *obj, M_norm, VP_norm_float, image_slot );
-                        break;
-                    }
-                    case NodeType::LINE_2D_SEGMENT:
-                    case NodeType::LINE_3D_SEGMENT:
-                    {
-                        // 🚀 2. 派发线段 Object 录制（后续实现）
-                        // recordImage_DAGInstLine ( *obj, final_aabb, camera, image_slot );
-                        break;
-                    }
-                    default:
-                        break;
-                }
-            }
+            recordImage_DAGInstPoints ( visible_instances, trust_revisions, M_norm, VP_norm_float, image_slot );
+
+            // 🚀 线段等其他类型的批次录制（后续实现）
+            // recordImage_DAGInstLines ( visible_instances, final_aabb, camera, image_slot );
         }
 
 
@@ -1666,15 +1930,104 @@ namespace StuCanvas
         uint32_t current_msaa_w = 0;   ///< 当前草稿纸物理宽度
         uint32_t current_msaa_h = 0;   ///< 当前草稿纸物理高度
 
-        VkPipelineCache pipeline_cache = VK_NULL_HANDLE;   ///< 传统管线缓存 (用于光追/计算管线)
         std::vector< VkShaderEXT > shader_objects;         ///< 现代着色器对象缓存 (VkShaderEXT 集合) [1.1.3]
+        std::vector< uint64_t > shader_spirv_hashes;       ///< 各槽位 SPIR-V 哈希 (启动时计算一次)
+
+        std::vector< DAGObjectInstance* > visible_instances;   ///< 视锥剔除结果 (逐帧复用容量)
+        PointBatchCache point_batches;                          ///< 持久化点绘制批次 (按外观分组)
+
+        const uint8_t* shader_cache_data = nullptr;   ///< 单文件缓存的只读 mmap 映射 (校验通过时非空)
+        size_t shader_cache_size = 0;                 ///< 映射字节数
+        bool shader_cache_dirty = false;              ///< 存在冷编译结果尚未写回磁盘
 
         VkCommandPool graphics_pool = VK_NULL_HANDLE;
         VkCommandPool compute_pool = VK_NULL_HANDLE;
 
         std::vector< VkBuffer > garbage_buffers;            ///< 🚀 统一使用 std::vector 承载的垃圾 Buffer 句柄列表
         std::vector< VmaAllocation > garbage_allocations;   ///< 🚀 统一使用 std::vector 承载的垃圾内存分配句柄列表
+        std::vector< VkBuffer > inflight_garbage_buffers;            ///< 已随上一次提交送出、等待栅栏的垃圾
+        std::vector< VmaAllocation > inflight_garbage_allocations;   ///< 与 inflight_garbage_buffers 一一对应
         VkFence garbage_fence = VK_NULL_HANDLE;             ///< 🚀 唯一的硬件监控栅栏
+
+        // =====================================================================
+        // 🚀 线性上传环：每个在途帧一块常驻映射的存储缓冲，逐次上传只做指针碰撞式子分配
+        // =====================================================================
+        static constexpr uint32_t upload_frames_in_flight = 2;   ///< 录制帧 + GPU 执行帧
+        static constexpr VkDeviceSize upload_block_initial_size = 4ull * 1024 * 1024;   ///< 单块初始容量 4 MB
+
+        struct UploadSpan
+        {
+            void* mapped = nullptr;        ///< CPU 侧可直接写入的映射地址
+            VkDeviceAddress address = 0;   ///< 着色器通过 BDA 读取的 GPU 设备地址
+        };
+
+        struct UploadBlock
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VmaAllocation allocation = VK_NULL_HANDLE;
+            uint8_t* mapped = nullptr;
+            VkDeviceAddress address = 0;
+            VkDeviceSize capacity = 0;
+        };
+
+        struct UploadFrame
+        {
+            UploadBlock block;                   ///< 当前线性分配块
+            VkDeviceSize head = 0;               ///< 下一个可用字节偏移
+            std::vector< UploadBlock > retired;  ///< 本帧写满后被替换下的旧块，待栅栏确认后释放
+        };
+
+        std::array< UploadFrame, upload_frames_in_flight > upload_frames;
+        uint32_t upload_frame_index = 0;
+        VkDeviceSize upload_alignment = 16;   ///< 子分配对齐：max(16, minStorageBufferOffsetAlignment)
+        std::vector< VmaAllocation > dedicated_uploads_pending;   ///< 本帧待刷新的独立上传缓冲
+
+        // =====================================================================
+        // 🚀 异步导出回读环：常驻映射的回读缓冲 + 专属命令缓冲 + 专属栅栏
+        // =====================================================================
+        static constexpr uint32_t readback_ring_size = 4;   ///< 在途导出帧上限 (有界队列深度)
+
+        enum class ReadbackState : uint8_t
+        {
+            Idle,      ///< 空闲，可录制新的拷贝
+            Copying,   ///< 拷贝已提交，栅栏尚未由渲染线程确认
+            Encoding   ///< 已移交编码线程，编码落盘后归还为 Idle
+        };
+
+        struct ReadbackSlot
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VmaAllocation allocation = VK_NULL_HANDLE;
+            void* mapped = nullptr;         ///< 常驻映射指针，生命周期内只 map 一次
+            VkDeviceSize capacity = 0;      ///< 当前缓冲字节容量，仅在分辨率变大时重建
+            VkCommandBuffer cmd = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+
+            uint32_t width = 0;
+            uint32_t height = 0;
+            ImageExportFormat format = ImageExportFormat::PNG;
+            std::string file_path;
+
+            std::atomic< ReadbackState > state{ ReadbackState::Idle };   ///< 非 Idle 时渲染线程不得复用
+        };
+
+        struct ReadbackRing
+        {
+            std::array< ReadbackSlot, readback_ring_size > slots;
+            uint32_t cursor = 0;
+            std::atomic< uint32_t > failures{ 0 };   ///< 自上次 flushExports 以来的写盘失败数
+
+            // 专属编码线程：只消费已完成拷贝的槽位，从不等待 GPU，也不占用 TBB 工作线程
+            std::vector< std::thread > encoders;
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::deque< ReadbackSlot* > jobs;   ///< 待编码槽位 (受 mutex 保护)
+            bool stopping = false;              ///< 受 mutex 保护；置位后编码线程清空队列即退出
+        };
+
+        // 持有于 unique_ptr 中：既保持 VulkanQueue 可移动，又让从不导出的场景零开销
+        std::unique_ptr< ReadbackRing > readback_ring;
+
         enum class RecordState : uint8_t
         {
             Initial,    ///< 初始静默状态（已提交或已重置，未开启录制）
@@ -1698,18 +2051,361 @@ namespace StuCanvas
         PFN_vkCmdBindShadersEXT pfnCmdBindShaders = nullptr;
         PFN_vkGetBufferDeviceAddress pfnGetBufferDeviceAddress = nullptr;
 
-        struct AppearanceGroup
+        /**
+         * @brief 以只读 mmap 打开单文件着色器缓存，并校验文件头与索引表
+         *
+         * 魔数、版本、着色器二进制 UUID / 版本、驱动版本或索引越界任一不符时，整个文件视为失效 (等价于空缓存)。
+         */
+        inline void openShaderCache ()
         {
-            AppearanceType type;
-            const AppearanceSimplePoint* appearance_ptr = nullptr;
-            std::vector< DAGObjectInstance* > instances;
-        };
+            closeShaderCache ();
+
+            const int fd = ::open ( shader_cache_path, O_RDONLY | O_CLOEXEC );
+            if ( fd < 0 )
+            {
+                return;
+            }
+
+            struct stat st{};
+            if ( ::fstat ( fd, &st ) != 0 || static_cast< size_t > ( st.st_size ) < sizeof ( ShaderCacheHeader ) )
+            {
+                ::close ( fd );
+                return;
+            }
+
+            const size_t file_size = static_cast< size_t > ( st.st_size );
+            void* mapped = ::mmap ( nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            ::close ( fd );   // 映射建立后文件描述符即可关闭
+            if ( mapped == MAP_FAILED )
+            {
+                return;
+            }
+
+            const auto* bytes = static_cast< const uint8_t* > ( mapped );
+
+            ShaderCacheHeader expected{};
+            queryShaderBinaryIdentity ( ctx.getPrimaryDevice ().getPhysicalDevice (), expected );
+
+            ShaderCacheHeader header{};
+            std::memcpy ( &header, bytes, sizeof ( ShaderCacheHeader ) );
+
+            const size_t table_end =
+                sizeof ( ShaderCacheHeader ) + static_cast< size_t > ( header.entry_count ) * sizeof ( ShaderCacheEntry );
+
+            // 核心安全校验：文件格式一致、shaderBinaryUUID 相同且文件中的二进制版本不高于驱动版本时，缓存才可用
+            bool valid = header.magic == shader_cache_magic && header.version == shader_cache_version &&
+                         std::memcmp ( header.shaderBinaryUUID, expected.shaderBinaryUUID, VK_UUID_SIZE ) == 0 &&
+                         header.shaderBinaryVersion <= expected.shaderBinaryVersion &&
+                         header.driverVersion == expected.driverVersion && header.vendorID == expected.vendorID &&
+                         header.deviceID == expected.deviceID && table_end <= file_size;
+
+            if ( valid )
+            {
+                const auto* entries = reinterpret_cast< const ShaderCacheEntry* > ( bytes + sizeof ( ShaderCacheHeader ) );
+                for ( uint32_t i = 0; i < header.entry_count; ++i )
+                {
+                    if ( entries[ i ].offset > file_size || entries[ i ].binary_size > file_size - entries[ i ].offset )
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+            }
+
+            if ( !valid ) [[unlikely]]
+            {
+                ::munmap ( mapped, file_size );
+                return;
+            }
 
-        struct InstanceTransformData
+            shader_cache_data = bytes;
+            shader_cache_size = file_size;
+        }
+
+        inline void closeShaderCache () noexcept
         {
-            Eigen::Vector3d local_pt;
-            Eigen::Matrix4f M_norm_model_float;
-        };
+            if ( shader_cache_data )
+            {
+                ::munmap ( const_cast< uint8_t* > ( shader_cache_data ), shader_cache_size );
+                shader_cache_data = nullptr;
+                shader_cache_size = 0;
+            }
+        }
+
+        /**
+         * @brief 在映射的索引表中查找槽位对应的原生二进制 (零拷贝，直接指向映射内存)
+         *
+         * @param slot 槽位
+         * @param stage 期望的着色器阶段
+         * @param spirv_hash 期望的 SPIR-V 哈希，不一致即视为过期
+         * @return 命中时返回映射内存中的只读视图，否则返回空 span
+         */
+        inline std::span< const uint8_t > findCachedBinary ( uint32_t slot, VkShaderStageFlagBits stage,
+                                                             uint64_t spirv_hash ) const noexcept
+        {
+            if ( !shader_cache_data )
+            {
+                return {};
+            }
+
+            ShaderCacheHeader header{};
+            std::memcpy ( &header, shader_cache_data, sizeof ( ShaderCacheHeader ) );
+            const auto* entries =
+                reinterpret_cast< const ShaderCacheEntry* > ( shader_cache_data + sizeof ( ShaderCacheHeader ) );
+
+            for ( uint32_t i = 0; i < header.entry_count; ++i )
+            {
+                const ShaderCacheEntry& entry = entries[ i ];
+                if ( entry.slot != slot )
+                {
+                    continue;
+                }
+
+                if ( entry.stage != static_cast< uint32_t > ( stage ) || entry.spirv_hash != spirv_hash )
+                {
+                    return {};
+                }
+
+                return { shader_cache_data + entry.offset, static_cast< size_t > ( entry.binary_size ) };
+            }
+            return {};
+        }
+
+        /**
+         * @brief 首次异步导出时惰性创建回读环：每个槽位一条命令缓冲与一个初始为绿灯的栅栏
+         *
+         * 回读缓冲本身延迟到首次使用时按帧尺寸分配。
+         */
+        inline void initializeReadbackRing ()
+        {
+            VkDevice device = ctx.getPrimaryDevice ().get ();
+
+            auto ring = std::make_unique< ReadbackRing > ();
+
+            std::array< VkCommandBuffer, readback_ring_size > cmds{};
+            VkCommandBufferAllocateInfo cmdAllocInfo{};
+            cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            cmdAllocInfo.commandPool = graphics_pool;
+            cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            cmdAllocInfo.commandBufferCount = readback_ring_size;
+
+            if ( vkAllocateCommandBuffers ( device, &cmdAllocInfo, cmds.data () ) != VK_SUCCESS )
+            {
+                throw std::runtime_error ( "VulkanQueue::initializeReadbackRing: Failed to allocate command buffers." );
+            }
+
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+            for ( uint32_t i = 0; i < readback_ring_size; ++i )
+            {
+                ring->slots[ i ].cmd = cmds[ i ];
+                if ( vkCreateFence ( device, &fenceInfo, nullptr, &ring->slots[ i ].fence ) != VK_SUCCESS )
+                {
+                    for ( uint32_t j = 0; j < i; ++j )
+                    {
+                        vkDestroyFence ( device, ring->slots[ j ].fence, nullptr );
+                    }
+                    vkFreeCommandBuffers ( device, graphics_pool, readback_ring_size, cmds.data () );
+                    throw std::runtime_error ( "VulkanQueue::initializeReadbackRing: Failed to create readback VkFence." );
+                }
+            }
+
+            readback_ring = std::move ( ring );
+
+            // 编码线程数不超过槽位数；单核机器上也至少保留一条，保证编码总能推进
+            const uint32_t encoder_count =
+                std::clamp< uint32_t > ( std::thread::hardware_concurrency (), 1, readback_ring_size );
+            ReadbackRing* raw = readback_ring.get ();
+            try
+            {
+                for ( uint32_t i = 0; i < encoder_count; ++i )
+                {
+                    raw->encoders.emplace_back ( [ raw ] { runReadbackEncoder ( *raw ); } );
+                }
+            }
+            catch ( const std::system_error& )
+            {
+                // 部分线程创建成功即可工作；一条都没有时回滚整个回读环
+                if ( raw->encoders.empty () )
+                {
+                    destroyReadbackRing ();
+                    throw std::runtime_error ( "VulkanQueue::initializeReadbackRing: Failed to start encoder thread." );
+                }
+            }
+        }
+
+        /**
+         * @brief 编码线程主循环：取出已完成拷贝的槽位，编码落盘后归还
+         */
+        static void runReadbackEncoder ( ReadbackRing& ring )
+        {
+            for ( ;; )
+            {
+                ReadbackSlot* slot = nullptr;
+                {
+                    std::unique_lock lock ( ring.mutex );
+                    ring.ready.wait ( lock, [ &ring ] { return ring.stopping || !ring.jobs.empty (); } );
+                    if ( ring.jobs.empty () )
+                    {
+                        return;
+                    }
+                    slot = ring.jobs.front ();
+                    ring.jobs.pop_front ();
+                }
+
+                bool ok = false;
+                try
+                {
+                    ok = encodeReadbackSlot ( *slot );
+                }
+                catch ( ... )
+                {
+                    ok = false;
+                }
+
+                if ( !ok ) [[unlikely]]
+                {
+                    ring.failures.fetch_add ( 1, std::memory_order_relaxed );
+                }
+
+                slot->state.store ( ReadbackState::Idle, std::memory_order_release );
+                slot->state.notify_all ();
+            }
+        }
+
+        /**
+         * @brief 在渲染线程上确认槽位的拷贝栅栏，并把它移交给编码线程
+         * @param wait true 时阻塞等待栅栏；false 时栅栏未就绪则直接返回
+         * @return 槽位是否已移交
+         */
+        static bool handOffReadbackSlot ( ReadbackRing& ring, ReadbackSlot& slot, VkDevice device,
+                                          VmaAllocator allocator, bool wait )
+        {
+            const VkResult status = wait ? vkWaitForFences ( device, 1, &slot.fence, VK_TRUE, UINT64_MAX )
+                                         : vkGetFenceStatus ( device, slot.fence );
+            if ( status == VK_NOT_READY || status == VK_TIMEOUT )
+            {
+                return false;
+            }
+
+            if ( status == VK_SUCCESS )
+            {
+                vmaInvalidateAllocation ( allocator, slot.allocation, 0, VK_WHOLE_SIZE );
+                slot.state.store ( ReadbackState::Encoding, std::memory_order_release );
+                {
+                    std::lock_guard lock ( ring.mutex );
+                    ring.jobs.push_back ( &slot );
+                }
+                ring.ready.notify_one ();
+            }
+            else
+            {
+                // 设备丢失等错误：该帧计为失败并直接归还槽位
+                ring.failures.fetch_add ( 1, std::memory_order_relaxed );
+                slot.state.store ( ReadbackState::Idle, std::memory_order_release );
+            }
+            return true;
+        }
+
+        /**
+         * @brief 按提交顺序把拷贝已完成的槽位移交给编码线程
+         * @param wait true 时等待全部在途拷贝完成 (flushExports / 析构)；false 时遇到未完成的栅栏即停止
+         */
+        static void pollReadbackRing ( ReadbackRing& ring, VkDevice device, VmaAllocator allocator, bool wait )
+        {
+            for ( uint32_t i = 0; i < readback_ring_size; ++i )
+            {
+                ReadbackSlot& slot = ring.slots[ ( ring.cursor + i ) % readback_ring_size ];
+                if ( slot.state.load ( std::memory_order_acquire ) == ReadbackState::Copying &&
+                     !handOffReadbackSlot ( ring, slot, device, allocator, wait ) )
+                {
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief 等待全部在途拷贝与编码完成、回收编码线程后释放回读环 (析构时调用，不抛出异常)
+         */
+        inline void destroyReadbackRing () noexcept
+        {
+            if ( !readback_ring )
+            {
+                return;
+            }
+
+            const auto& primaryDevice = ctx.getPrimaryDevice ();
+            VkDevice device = primaryDevice.get ();
+            VmaAllocator allocator = primaryDevice.getAllocator ();
+
+            ReadbackRing& ring = *readback_ring;
+            pollReadbackRing ( ring, device, allocator, true );
+            {
+                std::lock_guard lock ( ring.mutex );
+                ring.stopping = true;
+            }
+            ring.ready.notify_all ();
+            for ( std::thread& encoder : ring.encoders )
+            {
+                encoder.join ();
+            }
+
+            for ( ReadbackSlot& slot : readback_ring->slots )
+            {
+                if ( slot.buffer != VK_NULL_HANDLE )
+                {
+                    vmaDestroyBuffer ( allocator, slot.buffer, slot.allocation );
+                }
+                if ( slot.fence != VK_NULL_HANDLE )
+                {
+                    vkDestroyFence ( device, slot.fence, nullptr );
+                }
+                if ( slot.cmd != VK_NULL_HANDLE )
+                {
+                    vkFreeCommandBuffers ( device, graphics_pool, 1, &slot.cmd );
+                }
+            }
+
+            readback_ring.reset ();
+        }
+
+        /**
+         * @brief 在编码线程上将已回读的槽位像素编码并写入磁盘
+         * @return 写入成功返回 true
+         */
+        static bool encodeReadbackSlot ( const ReadbackSlot& slot )
+        {
+            const auto* pixels = static_cast< const uint8_t* > ( slot.mapped );
+
+            switch ( slot.format )
+            {
+                case ImageExportFormat::PNG:
+                {
+                    const int stride_in_bytes = static_cast< int > ( slot.width ) * 4;
+                    return stbi_write_png ( slot.file_path.c_str (), static_cast< int > ( slot.width ),
+                                            static_cast< int > ( slot.height ), 4, pixels, stride_in_bytes ) != 0;
+                }
+                case ImageExportFormat::QOI:
+                {
+                    return writeQOI ( slot.file_path, pixels, slot.width, slot.height );
+                }
+                case ImageExportFormat::RAW:
+                {
+                    std::ofstream out ( slot.file_path, std::ios::binary );
+                    if ( !out )
+                    {
+                        return false;
+                    }
+                    out.write ( static_cast< const char* > ( slot.mapped ),
+                                static_cast< std::streamsize > ( slot.width ) * slot.height * 4 );
+                    return static_cast< bool > ( out );
+                }
+                default:
+                    return false;
+            }
+        }
 
         /**
          * @brief 将 MSAA 颜色/深度图像及解析目标图像从 VK_IMAGE_LAYOUT_UNDEFINED
@@ -1773,83 +2469,55 @@ namespace StuCanvas
         }
 
         /**
-         * @brief 将实例列表按外观类型 (AppearanceType) 分组为二维列表
-         * @param instances 实例指针列表
-         * @return 按 AppearanceType 分组后的 AppearanceGroup 向量
+         * @brief 独立专用上传缓冲：分配、常驻映射、获取显存地址、注册为垃圾
+         *
+         * 仅作为线性上传环的兜底路径，用于超过单块容量一半的大体积上传 (如百万级点云)，
+         * 避免一次大上传把整块环形内存挤占或迫使其成倍扩容。
+         *
+         * @param allocator  VMA 分配器
+         * @param device     Vulkan 逻辑设备
+         * @param buffer_size 缓冲区总字节数
+         * @return UploadSpan 可直接写入的映射指针与 GPU 可寻址设备地址
          */
-        inline std::vector< AppearanceGroup > groupInstancesByAppearance (
-            utils::TinyVector< DAGObjectInstance* >& instances ) const
+        inline UploadSpan createDedicatedUploadBuffer ( VmaAllocator allocator, VkDevice device, size_t buffer_size )
         {
-            std::vector< AppearanceGroup > groups;
-            groups.reserve ( 4 );
+            VkBuffer staging_buffer = VK_NULL_HANDLE;
+            VmaAllocation staging_allocation = VK_NULL_HANDLE;
 
-            for ( DAGObjectInstance* instance : instances )
-            {
-                if ( !instance )
-                    continue;
+            VkBufferCreateInfo bufferInfo{};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = buffer_size;
+            bufferInfo.usage =
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-                // 🚀 如果 instance->appearance 为空，直接抛出异常，不再执行默认外观兜底
-                if ( !instance->appearance ) [[unlikely]]
-                {
-                    throw std::runtime_error (
-                        "VulkanQueue::groupInstancesByAppearance: DAGObjectInstance has a null appearance pointer." );
-                }
+            VmaAllocationCreateInfo allocInfo{};
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                              VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
-                const auto* app = static_cast< const AppearanceSimplePoint* > ( instance->appearance );
+            VmaAllocationInfo allocationInfo{};
+            if ( vmaCreateBuffer ( allocator, &bufferInfo, &allocInfo, &staging_buffer,
+                                   &staging_allocation, &allocationInfo ) != VK_SUCCESS )
+            {
+                throw std::runtime_error (
+                    "VulkanQueue::createDedicatedUploadBuffer: Failed to allocate GPU staging buffer." );
+            }
 
-                auto it = std::find_if ( groups.begin (), groups.end (),
-                                         [ app ] ( const AppearanceGroup& g ) { return g.type == app->type; } );
+            VkBufferDeviceAddressInfo addressInfo{};
+            addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+            addressInfo.buffer = staging_buffer;
 
-                if ( it != groups.end () )
-                {
-                    it->instances.push_back ( instance );
-                }
-                else
-                {
-                    AppearanceGroup new_group{};
-                    new_group.type = app->type;
-                    new_group.appearance_ptr = app;
-                    new_group.instances.push_back ( instance );
-                    groups.push_back ( std::move ( new_group ) );
-                }
-            }
+            VkDeviceAddress gpu_address = pfnGetBufferDeviceAddress ( device, &addressInfo );
 
-            return groups;
-        }
+            registerTransientBuffer ( staging_buffer, staging_allocation );
+            dedicated_uploads_pending.push_back ( staging_allocation );
 
-        inline InstanceTransformData computeInstanceTransform ( DAGObjectInstance* instance,
-                                                                const DAGObject& object,
-                                                                const Eigen::Matrix4d& M_norm ) const
-        {
-            const Eigen::Vector3d local_pt = extractLocalPoint ( object );
-
-            const Eigen::Quaterniond rot_q ( instance->world_rotation[ 3 ],   // w
-                                             instance->world_rotation[ 0 ],   // x
-                                             instance->world_rotation[ 1 ],   // y
-                                             instance->world_rotation[ 2 ]    // z
-            );
-            const Eigen::Matrix3d S_mat =
-                Eigen::Vector3d ( instance->world_scales[ 0 ], instance->world_scales[ 1 ],
-                                  instance->world_scales[ 2 ] )
-                    .asDiagonal ();
-
-            Eigen::Matrix4d M_world = Eigen::Matrix4d::Identity ();
-            M_world.block< 3, 3 > ( 0, 0 ) = rot_q.normalized ().toRotationMatrix () * S_mat;
-            M_world.block< 3, 1 > ( 0, 3 ) =
-                Eigen::Vector3d ( instance->world_position[ 0 ], instance->world_position[ 1 ],
-                                  instance->world_position[ 2 ] );
-
-            Eigen::Matrix4d M_norm_model = M_norm * M_world;
-            Eigen::Matrix4f M_norm_model_float = M_norm_model.cast< float > ();
-
-            return { local_pt, M_norm_model_float };
+            return { allocationInfo.pMappedData, gpu_address };
         }
 
         /**
-         * @brief 通用 GPU staging buffer 创建与上传：分配、拷贝、获取显存地址、注册为垃圾
-         *
-         * 封装 VMA buffer 创建、数据上传、vmaMapMemory/设备地址查询、临时生存期注册的完整流程。
-         * 调用方预先将数据打包为连续内存块传入即可。
+         * @brief 通用 GPU staging buffer 创建与上传 (独立缓冲兜底路径 + 数据拷贝)
          *
          * @param allocator  VMA 分配器
          * @param device     Vulkan 逻辑设备
@@ -1860,40 +2528,162 @@ namespace StuCanvas
         inline VkDeviceAddress createAndUploadStagingBuffer ( VmaAllocator allocator, VkDevice device,
                                                               size_t buffer_size, const void* data )
         {
-            VkBuffer staging_buffer = VK_NULL_HANDLE;
-            VmaAllocation staging_allocation = VK_NULL_HANDLE;
+            const UploadSpan span = createDedicatedUploadBuffer ( allocator, device, buffer_size );
+            std::memcpy ( span.mapped, data, buffer_size );
+            return span.address;
+        }
+
+        /**
+         * @brief 创建一块常驻映射、支持设备地址的线性上传块
+         */
+        inline UploadBlock createUploadBlock ( VkDeviceSize capacity )
+        {
+            const auto& primaryDevice = ctx.getPrimaryDevice ();
+            VkDevice device = primaryDevice.get ();
+            VmaAllocator allocator = primaryDevice.getAllocator ();
 
             VkBufferCreateInfo bufferInfo{};
             bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-            bufferInfo.size = buffer_size;
-            bufferInfo.usage =
-                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+            bufferInfo.size = capacity;
+            bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
             bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
             VmaAllocationCreateInfo allocInfo{};
             allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
-                              VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
+            UploadBlock block{};
             VmaAllocationInfo allocationInfo{};
-            if ( vmaCreateBuffer ( allocator, &bufferInfo, &allocInfo, &staging_buffer,
-                                   &staging_allocation, &allocationInfo ) != VK_SUCCESS )
+            if ( vmaCreateBuffer ( allocator, &bufferInfo, &allocInfo, &block.buffer, &block.allocation,
+                                   &allocationInfo ) != VK_SUCCESS )
             {
-                throw std::runtime_error (
-                    "VulkanQueue::createAndUploadStagingBuffer: Failed to allocate GPU staging buffer." );
+                throw std::runtime_error ( "VulkanQueue::createUploadBlock: Failed to allocate upload ring block." );
             }
 
-            std::memcpy ( allocationInfo.pMappedData, data, buffer_size );
-
             VkBufferDeviceAddressInfo addressInfo{};
             addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
-            addressInfo.buffer = staging_buffer;
+            addressInfo.buffer = block.buffer;
 
-            VkDeviceAddress gpu_address = pfnGetBufferDeviceAddress ( device, &addressInfo );
+            block.mapped = static_cast< uint8_t* > ( allocationInfo.pMappedData );
+            block.address = pfnGetBufferDeviceAddress ( device, &addressInfo );
+            block.capacity = capacity;
+            return block;
+        }
 
-            registerTransientBuffer ( staging_buffer, staging_allocation );
+        inline void destroyUploadBlock ( UploadBlock& block ) noexcept
+        {
+            if ( block.buffer != VK_NULL_HANDLE )
+            {
+                vmaDestroyBuffer ( ctx.getPrimaryDevice ().getAllocator (), block.buffer, block.allocation );
+            }
+            block = UploadBlock{};
+        }
+
+        /**
+         * @brief 🚀 从当前帧的线性上传环中子分配一段对齐内存 (热路径：仅一次指针碰撞)
+         *
+         * - 常规上传：在当前帧的常驻映射块上按 upload_alignment 对齐后线性推进 head；
+         * - 块已写满：将旧块退役 (待栅栏确认后释放)，换上容量翻倍的新块，下一帧起稳定为单块；
+         * - 超大上传：超过块容量一半时回退到独立专用缓冲，不污染环形内存。
+         *
+         * 返回的内存在本帧提交并被栅栏确认完成前保持有效，调用方直接写入映射指针即可，无需中转拷贝。
+         *
+         * @param size 需要的字节数
+         * @return UploadSpan 可直接写入的映射指针与 GPU 可寻址设备地址
+         */
+        inline UploadSpan allocateUpload ( size_t size )
+        {
+            UploadFrame& frame = upload_frames[ upload_frame_index ];
 
-            return gpu_address;
+            if ( size > upload_block_initial_size / 2 ) [[unlikely]]
+            {
+                const auto& primaryDevice = ctx.getPrimaryDevice ();
+                return createDedicatedUploadBuffer ( primaryDevice.getAllocator (), primaryDevice.get (), size );
+            }
+
+            VkDeviceSize offset = ( frame.head + upload_alignment - 1 ) & ~( upload_alignment - 1 );
+
+            if ( offset + size > frame.block.capacity ) [[unlikely]]
+            {
+                if ( frame.block.buffer != VK_NULL_HANDLE )
+                {
+                    // 旧块中已写入的数据仍需随本帧提交：先刷新，再退役等待栅栏回收
+                    vmaFlushAllocation ( ctx.getPrimaryDevice ().getAllocator (), frame.block.allocation, 0,
+                                         frame.head );
+                    frame.retired.push_back ( frame.block );
+                }
+
+                const VkDeviceSize new_capacity =
+                    std::max< VkDeviceSize > ( upload_block_initial_size, frame.block.capacity * 2 );
+                frame.block = createUploadBlock ( new_capacity );
+                frame.head = 0;
+                offset = 0;
+            }
+
+            frame.head = offset + size;
+            return { frame.block.mapped + offset, frame.block.address + offset };
+        }
+
+        /**
+         * @brief 拷贝式上传便捷接口：子分配后一次 memcpy，返回 GPU 设备地址
+         */
+        inline VkDeviceAddress uploadTransient ( const void* data, size_t size )
+        {
+            const UploadSpan span = allocateUpload ( size );
+            std::memcpy ( span.mapped, data, size );
+            return span.address;
+        }
+
+        /**
+         * @brief 提交前对本帧全部上传做一次批量刷新 (非一致性内存下生效，一致性内存下 VMA 自动跳过)
+         */
+        inline void flushUploadFrame ()
+        {
+            VmaAllocator allocator = ctx.getPrimaryDevice ().getAllocator ();
+            UploadFrame& frame = upload_frames[ upload_frame_index ];
+
+            if ( frame.head > 0 )
+            {
+                vmaFlushAllocation ( allocator, frame.block.allocation, 0, frame.head );
+            }
+
+            for ( VmaAllocation allocation : dedicated_uploads_pending )
+            {
+                vmaFlushAllocation ( allocator, allocation, 0, VK_WHOLE_SIZE );
+            }
+            dedicated_uploads_pending.clear ();
+        }
+
+        /**
+         * @brief 切换到下一个在途帧的上传区域，并回收其内存
+         *
+         * 必须在 garbage_fence 等待之后调用：该区域的上一位使用者正是刚被栅栏确认完成的那次提交。
+         */
+        inline void advanceUploadFrame () noexcept
+        {
+            upload_frame_index = ( upload_frame_index + 1 ) % upload_frames_in_flight;
+
+            UploadFrame& frame = upload_frames[ upload_frame_index ];
+            for ( UploadBlock& block : frame.retired )
+            {
+                destroyUploadBlock ( block );
+            }
+            frame.retired.clear ();
+            frame.head = 0;
+        }
+
+        inline void destroyUploadFrames () noexcept
+        {
+            for ( UploadFrame& frame : upload_frames )
+            {
+                for ( UploadBlock& block : frame.retired )
+                {
+                    destroyUploadBlock ( block );
+                }
+                frame.retired.clear ();
+                destroyUploadBlock ( frame.block );
+                frame.head = 0;
+            }
         }
 
         /**
@@ -2009,28 +2799,29 @@ namespace StuCanvas
         /**
          * @brief 点云材质一键批量录制函数 (SDF Billboarding 实例化分发)
          *
-         * @param object 当前被派发的点几何对象 (内含 utils::TinyVector<DAGObjectInstance*> instances) [1]
+         * 可见点实例经持久化批次缓存按外观归组，每个外观只上传一段 [单位包头 | N × PointData]
+         * 并发出一次 vkCmdDraw(3, N)。RTE 归一化已在 CPU 侧以双精度完成，因此包头模型矩阵恒为单位阵。
+         *
+         * @param visible 本帧通过视锥剔除的实例 (非点类型自动忽略)
+         * @param trust_revisions 是否依据实例修订号跳过未变化实例的世界中心重算
          * @param M_norm 图像下统一共享的 3D RTE 归一化平移缩放矩阵 (double 精度)
          * @param VP_norm_float 归一化影子相机的单精度观察-投影矩阵 (float 精度)
          * @param image_slot 目标写入的 RenderFrame 插槽索引
          */
-        inline void recordImage_DAGInstPoint ( DAGObject& object, const Eigen::Matrix4d& M_norm,
-                                               const Eigen::Matrix4f& VP_norm_float, uint32_t image_slot )
+        inline void recordImage_DAGInstPoints ( std::span< DAGObjectInstance* const > visible, bool trust_revisions,
+                                                const Eigen::Matrix4d& M_norm, const Eigen::Matrix4f& VP_norm_float,
+                                                uint32_t image_slot )
         {
-            if ( graphics == VK_NULL_HANDLE || object.instances.empty () ) [[unlikely]]
+            if ( graphics == VK_NULL_HANDLE ) [[unlikely]]
             {
                 return;
             }
 
             if ( image_slot >= frames.size () ) [[unlikely]]
             {
-                throw std::out_of_range ( "VulkanQueue::recordImage_DAGInstPoint: image_slot out of range." );
+                throw std::out_of_range ( "VulkanQueue::recordImage_DAGInstPoints: image_slot out of range." );
             }
 
-            const auto& primaryDevice = ctx.getPrimaryDevice ();
-            VkDevice device = primaryDevice.get ();
-            VmaAllocator allocator = primaryDevice.getAllocator ();
-
             // =====================================================================
             // 🚀 核心改动：直接从指定 slot 槽位的 RenderFrame 中，提取其物理图片真实的宽和高 [2]
             // =====================================================================
@@ -2038,87 +2829,89 @@ namespace StuCanvas
             const uint32_t width = target_frame.width;
             const uint32_t height = target_frame.height;
 
-
             // =====================================================================
-            // 1. 提取 Instances 列表并根据外观 (Appearance) 进行归类分组 (构造二维数组) [1]
+            // 1. 可见实例落入持久化外观批次，仅重算失效实例的世界中心
             // =====================================================================
-            std::vector< AppearanceGroup > groups = groupInstancesByAppearance ( object.instances );
+            point_batches.collectVisible ( visible, trust_revisions );
 
             // =====================================================================
-            // 2. 循环遍历二维分组，执行基于材质状态的分发与绘制
+            // 2. 单次渲染通道：清屏一次，绑定一次着色器，每个外观批次一次实例化绘制
+            //    (即使没有任何可见点也会清屏，避免目标图像残留上一帧内容)
             // =====================================================================
-            for ( const auto& group : groups )
+            setupSimplePointRenderPass ( width, height, target_frame );
+
+            // 绑定着色器：顶点是 0 号，片元是 1 号
+            VkShaderStageFlagBits stages[ 2 ] = { VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT };
+            VkShaderEXT bound_shaders[ 2 ] = { acquireShader ( 0 ), acquireShader ( 1 ) };
+
+            if ( !pfnCmdBindShaders ) [[unlikely]]
             {
-                switch ( group.type )
-                {
-                    // 点外观：SimplePoint 分支 case (兼容 SimpleLine 命名)
-                    // =====================================================================
-                    // 🚀 点外观分发：完美兼容 SimplePoint 和 SimpleLine 穿透，绝不漏掉任何默认粒子
-                    // =====================================================================
+                throw std::runtime_error ( "VulkanQueue: Driver does not support vkCmdBindShadersEXT." );
+            }
+            pfnCmdBindShaders ( graphics, 2, stages, bound_shaders );
 
-                    case AppearanceType::SimplePoint:
-                    {
-                        setupSimplePointRenderPass ( width, height, target_frame );
+            // M_norm 为纯缩放 + 平移：p_norm = scale · p + offset
+            const double scale = M_norm ( 0, 0 );
+            const double offset_x = M_norm ( 0, 3 );
+            const double offset_y = M_norm ( 1, 3 );
+            const double offset_z = M_norm ( 2, 3 );
 
-                        // 绑定着色器：顶点是 0 号，片元是 1 号
-                        VkShaderStageFlagBits stages[ 2 ] = { VK_SHADER_STAGE_VERTEX_BIT,
-                                                              VK_SHADER_STAGE_FRAGMENT_BIT };
-                        VkShaderEXT bound_shaders[ 2 ] = { shader_objects[ 0 ], shader_objects[ 1 ] };
+            const double* cx = point_batches.centreX ();
+            const double* cy = point_batches.centreY ();
+            const double* cz = point_batches.centreZ ();
 
-                        if ( !pfnCmdBindShaders ) [[unlikely]]
-                        {
-                            throw std::runtime_error ( "VulkanQueue: Driver does not support vkCmdBindShadersEXT." );
-                        }
-                        pfnCmdBindShaders ( graphics, 2, stages, bound_shaders );
+            static const Eigen::Matrix4f identity_header = Eigen::Matrix4f::Identity ();
 
-                        // 开始顺序录制并绘制该外观下的每个实例
-                        for ( DAGObjectInstance* instance : group.instances )
-                        {
-                            auto [ local_pt, M_norm_model_float ] = computeInstanceTransform ( instance, object, M_norm );
-
-                            PointData pt{};
-                            pt.worldPos[ 0 ] = static_cast< float > ( local_pt.x () );
-                            pt.worldPos[ 1 ] = static_cast< float > ( local_pt.y () );
-                            pt.worldPos[ 2 ] = static_cast< float > ( local_pt.z () );
-                            pt._pad0 = 0.0f;
-                            pt.color[ 0 ] = group.appearance_ptr->red;
-                            pt.color[ 1 ] = group.appearance_ptr->green;
-                            pt.color[ 2 ] = group.appearance_ptr->blue;
-                            pt.color[ 3 ] = group.appearance_ptr->alpha;
-
-                            constexpr size_t header_size = 64;
-                            constexpr size_t payload_size = sizeof ( PointData );
-                            constexpr size_t total_size = header_size + payload_size;
-
-                            std::array< char, total_size > staging_data;
-                            std::memcpy ( staging_data.data (), M_norm_model_float.data (), header_size );
-                            std::memcpy ( staging_data.data () + header_size, &pt, payload_size );
-
-                            VkDeviceAddress gpu_address = createAndUploadStagingBuffer (
-                                allocator, device, total_size, staging_data.data () );
-
-                            PointSDFConstants pc{};
-                            std::memcpy ( pc.vp, VP_norm_float.data (), 16 * sizeof ( float ) );
-                            pc.imageSize[ 0 ] = static_cast< float > ( width );
-                            pc.imageSize[ 1 ] = static_cast< float > ( height );
-                            pc.pointRadius = group.appearance_ptr->radius;
-                            pc.cloud = gpu_address;
-
-                            vkCmdPushConstants ( graphics, pipeline_layout,
-                                                 static_cast< VkShaderStageFlags > ( VK_SHADER_STAGE_VERTEX_BIT |
-                                                                                     VK_SHADER_STAGE_FRAGMENT_BIT ),
-                                                 0, sizeof ( PointSDFConstants ), &pc );
-
-                            vkCmdDraw ( graphics, 3, 1, 0, 0 );
-                        }
+            for ( const PointDrawBatch& batch : point_batches.batches () )
+            {
+                // 点外观：SimplePoint (其他外观类型暂无点管线实现)
+                if ( batch.visible.empty () || batch.appearance->type != AppearanceType::SimplePoint )
+                {
+                    continue;
+                }
 
-                        vkCmdEndRendering ( graphics );
-                        break;
-                    }
-                    default:
-                        break;
+                const AppearanceSimplePoint& app = *batch.appearance;
+                const uint32_t point_count = static_cast< uint32_t > ( batch.visible.size () );
+
+                constexpr size_t header_size = 64;
+                const size_t total_size = header_size + sizeof ( PointData ) * point_count;
+
+                // 🚀 直接写入上传环的映射内存：包头 + 紧密排列的点载荷
+                const UploadSpan upload = allocateUpload ( total_size );
+                std::memcpy ( upload.mapped, identity_header.data (), header_size );
+
+                auto* points = reinterpret_cast< PointData* > ( static_cast< char* > ( upload.mapped ) + header_size );
+                for ( uint32_t i = 0; i < point_count; ++i )
+                {
+                    const uint32_t e = batch.visible[ i ];
+
+                    PointData pt{};
+                    pt.worldPos[ 0 ] = static_cast< float > ( cx[ e ] * scale + offset_x );
+                    pt.worldPos[ 1 ] = static_cast< float > ( cy[ e ] * scale + offset_y );
+                    pt.worldPos[ 2 ] = static_cast< float > ( cz[ e ] * scale + offset_z );
+                    pt.color[ 0 ] = app.red;
+                    pt.color[ 1 ] = app.green;
+                    pt.color[ 2 ] = app.blue;
+                    pt.color[ 3 ] = app.alpha;
+                    points[ i ] = pt;
                 }
+
+                PointSDFConstants pc{};
+                std::memcpy ( pc.vp, VP_norm_float.data (), 16 * sizeof ( float ) );
+                pc.imageSize[ 0 ] = static_cast< float > ( width );
+                pc.imageSize[ 1 ] = static_cast< float > ( height );
+                pc.pointRadius = app.radius;
+                pc.cloud = upload.address;
+
+                vkCmdPushConstants (
+                    graphics, pipeline_layout,
+                    static_cast< VkShaderStageFlags > ( VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT ), 0,
+                    sizeof ( PointSDFConstants ), &pc );
+
+                vkCmdDraw ( graphics, 3, point_count, 0, 0 );
             }
+
+            vkCmdEndRendering ( graphics );
         }
     };
 }   // namespace StuCanvas
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <eigen3/Eigen/Dense>
 #include <limits>
 
@@ -38,11 +39,88 @@ namespace StuCanvas
         double max_z;
     };
 
+    /**
+     * @brief 对象上挂载的离散几何资产 (绘图器输出) 的统一只读视图
+     *
+     * 按 网格 → 3D 折线 → 2D 折线 → 3D 点云 → 2D 点云 → 64 位变体 的优先级取第一个存在的资产；2D 资产的 z 为空指针 (视为 0)。
+     */
+    struct GeometryAssetView
+    {
+        enum class Kind : uint8_t
+        {
+            None,
+            Points,
+            LineStrip,
+            Triangles
+        };
+
+        Kind kind = Kind::None;
+        const void* asset = nullptr;   ///< 资产地址 (缓存键)
+        const double* x = nullptr;
+        const double* y = nullptr;
+        const double* z = nullptr;
+        uint64_t vertex_count = 0;   ///< 64 位计数，兼容 *_SoA64 大规模资产
+        const uint32_t* indices = nullptr;
+        uint64_t index_count = 0;
+    };
+
+    [[nodiscard]] inline GeometryAssetView findGeometryAsset ( const DAGObject& node ) noexcept
+    {
+        GeometryAssetView view;
+        if ( node.assets.empty () )
+        {
+            return view;
+        }
+
+        if ( const auto* mesh = node.assets.get< DAGAssets::TriangleMesh3D_SoA > () )
+        {
+            view = { GeometryAssetView::Kind::Triangles, mesh, mesh->x.data (), mesh->y.data (), mesh->z.data (),
+                     mesh->x.size (), mesh->indices.data (), mesh->indices.size () };
+        }
+        else if ( const auto* strip3 = node.assets.get< DAGAssets::LineStrip3D_SoA > () )
+        {
+            view = { GeometryAssetView::Kind::LineStrip, strip3, strip3->x.data (), strip3->y.data (), strip3->z.data (),
+                     strip3->x.size () };
+        }
+        else if ( const auto* strip2 = node.assets.get< DAGAssets::LineStrip2D_SoA > () )
+        {
+            view = { GeometryAssetView::Kind::LineStrip, strip2, strip2->x.data (), strip2->y.data (), nullptr,
+                     strip2->x.size () };
+        }
+        else if ( const auto* cloud3 = node.assets.get< DAGAssets::PointCloud3D_SoA > () )
+        {
+            view = { GeometryAssetView::Kind::Points, cloud3, cloud3->x.data (), cloud3->y.data (), cloud3->z.data (),
+                     cloud3->x.size () };
+        }
+        else if ( const auto* cloud2 = node.assets.get< DAGAssets::PointCloud2D_SoA > () )
+        {
+            view = { GeometryAssetView::Kind::Points, cloud2, cloud2->x.data (), cloud2->y.data (), nullptr,
+                     cloud2->x.size () };
+        }
+        else if ( const auto* mesh64 = node.assets.get< DAGAssets::TriangleMesh3D_SoA64 > () )
+        {
+            view = { GeometryAssetView::Kind::Triangles, mesh64, mesh64->x.data (), mesh64->y.data (), mesh64->z.data (),
+                     mesh64->x.size (), mesh64->indices.data (), mesh64->indices.size () };
+        }
+        else if ( const auto* cloud3_64 = node.assets.get< DAGAssets::PointCloud3D_SoA64 > () )
+        {
+            view = { GeometryAssetView::Kind::Points, cloud3_64, cloud3_64->x.data (), cloud3_64->y.data (),
+                     cloud3_64->z.data (), cloud3_64->x.size () };
+        }
+        else if ( const auto* cloud2_64 = node.assets.get< DAGAssets::PointCloud2D_SoA64 > () )
+        {
+            view = { GeometryAssetView::Kind::Points, cloud2_64, cloud2_64->x.data (), cloud2_64->y.data (), nullptr,
+                     cloud2_64->x.size () };
+        }
+        return view;
+    }
+
     /**
      * @brief 计算 DAGObjectInstance 变换后的 Axis-Aligned Bounding Box (AABB 3D)
      *
      * 算法原理：
-     * 1. 0 资产依赖：直接通过 switch-case 提取 NodeData union 原始拓扑。对于 2D 对象，其本地坐标 z 轴天然初始化为 0.0。
+     * 1. 解析几何直接通过 switch-case 提取 NodeData union 原始拓扑。对于 2D 对象，其本地坐标 z 轴天然初始化为 0.0。
+     *    函数图像等非解析节点若挂载了离散几何资产，则取资产顶点的局部包围盒 (跳过 NaN / inf 断点)。
      * 2. 构造仿射变换矩阵 A = Rotation * Scale，并使用 Arvo 快速轴向区间投影算法
      *    在 O(1) 复杂度内将 local AABB 映射到 world AABB。
      * 3. 2D/3D 统一判定：不进行任何手动的条件判定，通过矩阵变换自然产生正确的 3D 空间包围盒。
@@ -187,8 +265,12 @@ namespace StuCanvas
             case NodeType::PLANE_3D_PERPENDICULAR:
             case NodeType::LINE_2D_STRAIGHT:
             case NodeType::LINE_2D_RAY:
+            case NodeType::LINE_2D_PERPENDICULAR:
+            case NodeType::LINE_2D_PARALLEL:
             case NodeType::LINE_3D_STRAIGHT:
             case NodeType::LINE_3D_RAY:
+            case NodeType::LINE_3D_PERPENDICULAR:
+            case NodeType::LINE_3D_PARALLEL:
             {
                 L_min = Eigen::Vector3d ( -inf, -inf, -inf );
                 L_max = Eigen::Vector3d ( inf, inf, inf );
@@ -199,6 +281,28 @@ namespace StuCanvas
                 // 默认降级为物理零点盒（函数、标量等非几何属性节点）
                 L_min = Eigen::Vector3d::Zero ();
                 L_max = Eigen::Vector3d::Zero ();
+
+                const GeometryAssetView geometry = findGeometryAsset ( *node );
+                double lo[ 3 ] = { inf, inf, inf };
+                double hi[ 3 ] = { -inf, -inf, -inf };
+                for ( uint64_t i = 0; i < geometry.vertex_count; ++i )
+                {
+                    const double p[ 3 ] = { geometry.x[ i ], geometry.y[ i ], geometry.z ? geometry.z[ i ] : 0.0 };
+                    if ( !std::isfinite ( p[ 0 ] ) || !std::isfinite ( p[ 1 ] ) || !std::isfinite ( p[ 2 ] ) )
+                    {
+                        continue;
+                    }
+                    for ( int a = 0; a < 3; ++a )
+                    {
+                        lo[ a ] = std::min ( lo[ a ], p[ a ] );
+                        hi[ a ] = std::max ( hi[ a ], p[ a ] );
+                    }
+                }
+                if ( lo[ 0 ] <= hi[ 0 ] )
+                {
+                    L_min = Eigen::Vector3d ( lo[ 0 ], lo[ 1 ], lo[ 2 ] );
+                    L_max = Eigen::Vector3d ( hi[ 0 ], hi[ 1 ], hi[ 2 ] );
+                }
                 break;
             }
         }
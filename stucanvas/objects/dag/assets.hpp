@@ -535,6 +535,33 @@ namespace StuCanvas::DAGAssets
         utils::TinyVector< uint32_t > indices;
     };
 
+    // -------------------------------------------------------------------------
+    // 64 位计数变体：超大点云 / 网格按需启用，突破单容器 2^32 个元素的上限
+    // 💡 句柄仍为 8 字节，仅堆头的 size / capacity 加宽；顶点编号保持 uint32_t 以匹配 Index Buffer
+    // -------------------------------------------------------------------------
+    struct PointCloud2D_SoA64
+    {
+        utils::TinyVector64< double > x;
+        utils::TinyVector64< double > y;
+    };
+
+    struct PointCloud3D_SoA64
+    {
+        utils::TinyVector64< double > x;
+        utils::TinyVector64< double > y;
+        utils::TinyVector64< double > z;
+    };
+
+    struct TriangleMesh3D_SoA64
+    {
+        utils::TinyVector64< double > x;
+        utils::TinyVector64< double > y;
+        utils::TinyVector64< double > z;
+
+        // 面片数可超过 2^32 / 3，索引元素本身仍是 32 位顶点编号
+        utils::TinyVector64< uint32_t > indices;
+    };
+
     // 并行 CPU 核心数量配置资产
     struct CpuCoreCount
     {
@@ -0,0 +1,617 @@
+/****************************************************************************
+ * Copyright (c) 2025-2026 Tian Yuxuan (Friendships666)                     *
+ *                                                                          *
+ * StuCanvas is licensed under Mulan PSL v2.                                *
+ * You can use this software according to the terms and conditions of the   *
+ * Mulan PSL v2.                                                            *
+ * You may obtain a copy of Mulan PSL v2 at:                                *
+ *          http://license.coscl.org.cn/MulanPSL2                           *
+ *                                                                          *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF     *
+ * ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO        *
+ * NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.       *
+ * See the Mulan PSL v2 for more details.                                   *
+ ***************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "AABB.hpp"
+#include "instance.hpp"
+
+namespace StuCanvas
+{
+    /**
+     * @brief 世界空间视锥体：6 个朝内的平面 (n·p + d >= 0 表示位于内侧)
+     */
+    struct Frustum3D
+    {
+        double planes[ 6 ][ 4 ];
+
+        /// AABB 与视锥体的相交判定结果
+        enum class Overlap : uint8_t
+        {
+            Outside,
+            Intersect,
+            Inside
+        };
+
+        /**
+         * @brief 由 8 个世界空间视锥角点构造平面
+         *
+         * 角点顺序：[0..3] 为近平面 (左下、右下、左上、右上)，[4..7] 为远平面同序。
+         * 平面朝向不依赖角点绕序，统一以视锥体质心所在一侧作为内侧，正交与透视镜头通用。
+         */
+        [[nodiscard]] static Frustum3D fromCorners ( const double ( &corners )[ 8 ][ 3 ] ) noexcept
+        {
+            constexpr int face[ 6 ][ 3 ] = {
+                { 0, 1, 2 },   // near
+                { 4, 6, 5 },   // far
+                { 0, 2, 4 },   // left
+                { 1, 5, 3 },   // right
+                { 0, 4, 1 },   // bottom
+                { 2, 3, 6 }    // top
+            };
+
+            double center[ 3 ] = { 0.0, 0.0, 0.0 };
+            for ( const auto& c : corners )
+            {
+                center[ 0 ] += c[ 0 ] * 0.125;
+                center[ 1 ] += c[ 1 ] * 0.125;
+                center[ 2 ] += c[ 2 ] * 0.125;
+            }
+
+            Frustum3D frustum{};
+            for ( int i = 0; i < 6; ++i )
+            {
+                const double* a = corners[ face[ i ][ 0 ] ];
+                const double* b = corners[ face[ i ][ 1 ] ];
+                const double* c = corners[ face[ i ][ 2 ] ];
+
+                const double u[ 3 ] = { b[ 0 ] - a[ 0 ], b[ 1 ] - a[ 1 ], b[ 2 ] - a[ 2 ] };
+                const double v[ 3 ] = { c[ 0 ] - a[ 0 ], c[ 1 ] - a[ 1 ], c[ 2 ] - a[ 2 ] };
+
+                double n[ 3 ] = { u[ 1 ] * v[ 2 ] - u[ 2 ] * v[ 1 ], u[ 2 ] * v[ 0 ] - u[ 0 ] * v[ 2 ],
+                                  u[ 0 ] * v[ 1 ] - u[ 1 ] * v[ 0 ] };
+                double d = -( n[ 0 ] * a[ 0 ] + n[ 1 ] * a[ 1 ] + n[ 2 ] * a[ 2 ] );
+
+                if ( n[ 0 ] * center[ 0 ] + n[ 1 ] * center[ 1 ] + n[ 2 ] * center[ 2 ] + d < 0.0 )
+                {
+                    n[ 0 ] = -n[ 0 ];
+                    n[ 1 ] = -n[ 1 ];
+                    n[ 2 ] = -n[ 2 ];
+                    d = -d;
+                }
+
+                frustum.planes[ i ][ 0 ] = n[ 0 ];
+                frustum.planes[ i ][ 1 ] = n[ 1 ];
+                frustum.planes[ i ][ 2 ] = n[ 2 ];
+                frustum.planes[ i ][ 3 ] = d;
+            }
+            return frustum;
+        }
+
+        /**
+         * @brief p/n 顶点法判定 AABB 与视锥体的关系 (保守：可能把视锥角附近的盒子判为 Intersect)
+         */
+        [[nodiscard]] Overlap classify ( const AABB3D& box ) const noexcept
+        {
+            Overlap result = Overlap::Inside;
+            for ( const auto& p : planes )
+            {
+                const double px = p[ 0 ] >= 0.0 ? box.max_x : box.min_x;
+                const double py = p[ 1 ] >= 0.0 ? box.max_y : box.min_y;
+                const double pz = p[ 2 ] >= 0.0 ? box.max_z : box.min_z;
+                if ( p[ 0 ] * px + p[ 1 ] * py + p[ 2 ] * pz + p[ 3 ] < 0.0 )
+                {
+                    return Overlap::Outside;
+                }
+
+                const double nx = p[ 0 ] >= 0.0 ? box.min_x : box.max_x;
+                const double ny = p[ 1 ] >= 0.0 ? box.min_y : box.max_y;
+                const double nz = p[ 2 ] >= 0.0 ? box.min_z : box.max_z;
+                if ( p[ 0 ] * nx + p[ 1 ] * ny + p[ 2 ] * nz + p[ 3 ] < 0.0 )
+                {
+                    result = Overlap::Intersect;
+                }
+            }
+            return result;
+        }
+    };
+
+    /**
+     * @brief DAG 实例层级包围盒 (BVH)，由 DAGraph 持有并随求值增量维护
+     *
+     * 1. 有界实例组成一棵前序排列的二叉树 (左孩子紧随父节点，子节点下标恒大于父节点)，叶子至多容纳 4 个实例。
+     * 2. 无限长实例 (直线、射线、平面等，AABB 含 inf/NaN) 单独放入常驻可见列表，不参与树的划分。
+     * 3. 拓扑不变时只对脏实例重算叶子包围盒并沿父链打标，再按下标降序合并一次祖先，开销 O(k · 深度)，与场景规模无关。
+     * 4. 插入新实例、或实例在有界/无界之间切换时，下次 update() 退化为一次 O(N log N) 的中位数重建。
+     */
+    class InstanceBVH
+    {
+    public:
+
+        static constexpr uint32_t invalid_slot = 0xFFFFFFFFu;
+
+        /// 登记新实例 (延迟到下一次 update() 重建)
+        inline void insert ( DAGObjectInstance& instance )
+        {
+            all_instances.push_back ( &instance );
+            instance.bvh_slot = invalid_slot;
+            structure_dirty = true;
+        }
+
+        /// 标记实例的包围盒已失效 (源对象被重新解算，或实例变换被修改)
+        inline void markDirty ( DAGObjectInstance& instance )
+        {
+            if ( structure_dirty )
+            {
+                return;   // 即将整体重建，无需逐个记账
+            }
+            dirty_instances.push_back ( &instance );
+        }
+
+        inline void clear () noexcept
+        {
+            all_instances.clear ();
+            dirty_instances.clear ();
+            nodes.clear ();
+            items.clear ();
+            item_boxes.clear ();
+            item_leaf.clear ();
+            unbounded.clear ();
+            unbounded_boxes.clear ();
+            refit_queue.clear ();
+            structure_dirty = false;
+            scene_bounds = empty_bounds ();
+        }
+
+        /// 按需重建或增量重拟合，确保后续查询结果与实例状态一致
+        inline void update ()
+        {
+            if ( structure_dirty )
+            {
+                rebuild ();
+                return;
+            }
+            if ( dirty_instances.empty () )
+            {
+                return;
+            }
+            refit ();
+        }
+
+        [[nodiscard]] inline bool empty () const noexcept
+        {
+            return all_instances.empty ();
+        }
+
+        [[nodiscard]] inline size_t size () const noexcept
+        {
+            return all_instances.size ();
+        }
+
+        /// 全部登记实例 (按插入顺序)
+        [[nodiscard]] inline std::span< DAGObjectInstance* const > instances () const noexcept
+        {
+            return all_instances;
+        }
+
+        /// 🚀 O(1) 场景包围盒：根节点与无界实例包围盒的并集 (空场景返回全零盒)
+        [[nodiscard]] inline const AABB3D& bounds () const noexcept
+        {
+            return scene_bounds;
+        }
+
+        /**
+         * @brief 视锥剔除：把可见实例追加到 out (无界实例恒可见)
+         *
+         * 完全位于视锥内的子树整段输出，不再逐节点测试。
+         */
+        inline void cull ( const Frustum3D& frustum, std::vector< DAGObjectInstance* >& out ) const
+        {
+            out.insert ( out.end (), unbounded.begin (), unbounded.end () );
+            if ( nodes.empty () )
+            {
+                return;
+            }
+
+            uint32_t stack[ 64 ];
+            uint32_t top = 0;
+            stack[ top++ ] = 0;
+
+            while ( top > 0 )
+            {
+                const uint32_t index = stack[ --top ];
+                const Node& node = nodes[ index ];
+
+                const Frustum3D::Overlap overlap = frustum.classify ( node.box );
+                if ( overlap == Frustum3D::Overlap::Outside )
+                {
+                    continue;
+                }
+
+                if ( overlap == Frustum3D::Overlap::Inside )
+                {
+                    const uint32_t end = index + node.subtree_size;
+                    const uint32_t first = firstItem ( index );
+                    const uint32_t last = lastItem ( end - 1 );
+                    out.insert ( out.end (), items.begin () + first, items.begin () + last );
+                    continue;
+                }
+
+                if ( node.count > 0 )
+                {
+                    for ( uint32_t i = node.first; i < node.first + node.count; ++i )
+                    {
+                        if ( frustum.classify ( item_boxes[ i ] ) != Frustum3D::Overlap::Outside )
+                        {
+                            out.push_back ( items[ i ] );
+                        }
+                    }
+                    continue;
+                }
+
+                stack[ top++ ] = node.first;   // 右孩子
+                stack[ top++ ] = index + 1;    // 左孩子
+            }
+        }
+
+        /**
+         * @brief 通用层级遍历 (拾取、区域查询等)
+         *
+         * @param test  bool(const AABB3D&)：节点 / 实例包围盒是否可能命中，可读取调用方随遍历收紧的状态
+         * @param visit void(DAGObjectInstance*, const AABB3D&)：通过测试的实例；无界实例只经过 visit 不经过 test
+         */
+        template < typename BoxTest, typename Visit >
+        inline void traverse ( BoxTest&& test, Visit&& visit ) const
+        {
+            for ( size_t i = 0; i < unbounded.size (); ++i )
+            {
+                visit ( unbounded[ i ], unbounded_boxes[ i ] );
+            }
+            if ( nodes.empty () )
+            {
+                return;
+            }
+
+            uint32_t stack[ 64 ];
+            uint32_t top = 0;
+            stack[ top++ ] = 0;
+
+            while ( top > 0 )
+            {
+                const uint32_t index = stack[ --top ];
+                const Node& node = nodes[ index ];
+                if ( !test ( node.box ) )
+                {
+                    continue;
+                }
+
+                if ( node.count > 0 )
+                {
+                    for ( uint32_t i = node.first; i < node.first + node.count; ++i )
+                    {
+                        if ( test ( item_boxes[ i ] ) )
+                        {
+                            visit ( items[ i ], item_boxes[ i ] );
+                        }
+                    }
+                    continue;
+                }
+
+                stack[ top++ ] = node.first;   // 右孩子
+                stack[ top++ ] = index + 1;    // 左孩子
+            }
+        }
+
+    private:
+
+        static constexpr uint32_t leaf_capacity = 4;
+        static constexpr uint32_t unbounded_bit = 0x80000000u;
+
+        struct Node
+        {
+            AABB3D box;
+            uint32_t first;           ///< 叶子：items 起始下标；内部节点：右孩子下标 (左孩子恒为 index + 1)
+            uint32_t count;           ///< 叶子实例数，0 表示内部节点
+            uint32_t parent;          ///< 父节点下标 (根节点为 invalid_slot)
+            uint32_t subtree_size;    ///< 以该节点为根的子树节点数 (前序区间 [index, index + subtree_size))
+            bool needs_refit;
+        };
+
+        std::vector< DAGObjectInstance* > all_instances;     ///< 全部登记实例 (重建输入)
+        std::vector< DAGObjectInstance* > dirty_instances;   ///< 自上次 update() 以来失效的实例
+
+        std::vector< Node > nodes;
+        std::vector< DAGObjectInstance* > items;   ///< 叶子顺序排列的有界实例
+        std::vector< AABB3D > item_boxes;          ///< 与 items 并行的实例包围盒缓存
+        std::vector< uint32_t > item_leaf;         ///< 与 items 并行的所属叶子下标
+
+        std::vector< DAGObjectInstance* > unbounded;   ///< 无限长实例 (恒可见)
+        std::vector< AABB3D > unbounded_boxes;
+        std::vector< uint32_t > refit_queue;   ///< 本次重拟合打标的节点下标 (复用容量)
+
+        AABB3D scene_bounds = empty_bounds ();
+        bool structure_dirty = false;
+
+        [[nodiscard]] static constexpr AABB3D empty_bounds () noexcept
+        {
+            return { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        }
+
+        [[nodiscard]] static bool isBounded ( const AABB3D& box ) noexcept
+        {
+            return std::isfinite ( box.min_x ) && std::isfinite ( box.min_y ) && std::isfinite ( box.min_z ) &&
+                   std::isfinite ( box.max_x ) && std::isfinite ( box.max_y ) && std::isfinite ( box.max_z );
+        }
+
+        /// 无界包围盒中 0·inf 产生的 NaN 分量保守地展开为 ±inf
+        [[nodiscard]] static AABB3D sanitizeUnbounded ( AABB3D box ) noexcept
+        {
+            constexpr double inf = std::numeric_limits< double >::infinity ();
+            if ( std::isnan ( box.min_x ) ) box.min_x = -inf;
+            if ( std::isnan ( box.min_y ) ) box.min_y = -inf;
+            if ( std::isnan ( box.min_z ) ) box.min_z = -inf;
+            if ( std::isnan ( box.max_x ) ) box.max_x = inf;
+            if ( std::isnan ( box.max_y ) ) box.max_y = inf;
+            if ( std::isnan ( box.max_z ) ) box.max_z = inf;
+            return box;
+        }
+
+        static void merge ( AABB3D& dst, const AABB3D& src ) noexcept
+        {
+            dst.min_x = std::min ( dst.min_x, src.min_x );
+            dst.min_y = std::min ( dst.min_y, src.min_y );
+            dst.min_z = std::min ( dst.min_z, src.min_z );
+            dst.max_x = std::max ( dst.max_x, src.max_x );
+            dst.max_y = std::max ( dst.max_y, src.max_y );
+            dst.max_z = std::max ( dst.max_z, src.max_z );
+        }
+
+        [[nodiscard]] static AABB3D inverted_bounds () noexcept
+        {
+            constexpr double inf = std::numeric_limits< double >::infinity ();
+            return { inf, inf, inf, -inf, -inf, -inf };
+        }
+
+        /// 前序子树的第一个实例下标：沿左孩子一路下降到叶子
+        [[nodiscard]] uint32_t firstItem ( uint32_t index ) const noexcept
+        {
+            while ( nodes[ index ].count == 0 )
+            {
+                ++index;
+            }
+            return nodes[ index ].first;
+        }
+
+        /// 前序区间的最后一个节点必为叶子，其末尾即子树实例区间的终点
+        [[nodiscard]] uint32_t lastItem ( uint32_t last_node ) const noexcept
+        {
+            return nodes[ last_node ].first + nodes[ last_node ].count;
+        }
+
+        inline void recomputeSceneBounds ()
+        {
+            if ( nodes.empty () && unbounded.empty () )
+            {
+                scene_bounds = empty_bounds ();
+                return;
+            }
+
+            AABB3D total = nodes.empty () ? inverted_bounds () : nodes[ 0 ].box;
+            for ( const AABB3D& box : unbounded_boxes )
+            {
+                merge ( total, box );
+            }
+            scene_bounds = total;
+        }
+
+        inline void rebuild ()
+        {
+            structure_dirty = false;
+            dirty_instances.clear ();
+            nodes.clear ();
+            items.clear ();
+            item_boxes.clear ();
+            unbounded.clear ();
+            unbounded_boxes.clear ();
+
+            for ( DAGObjectInstance* instance : all_instances )
+            {
+                const AABB3D box = computeInstanceAABB ( *instance );
+                if ( isBounded ( box ) ) [[likely]]
+                {
+                    items.push_back ( instance );
+                    item_boxes.push_back ( box );
+                }
+                else
+                {
+                    instance->bvh_slot = unbounded_bit | static_cast< uint32_t > ( unbounded.size () );
+                    unbounded.push_back ( instance );
+                    unbounded_boxes.push_back ( sanitizeUnbounded ( box ) );
+                }
+            }
+
+            item_leaf.assign ( items.size (), invalid_slot );
+
+            if ( !items.empty () )
+            {
+                // 以下标排列间接排序，实例与包围盒在最后一次性重排
+                std::vector< uint32_t > order ( items.size () );
+                for ( uint32_t i = 0; i < order.size (); ++i )
+                {
+                    order[ i ] = i;
+                }
+                nodes.reserve ( 2 * ( items.size () / leaf_capacity + 1 ) );
+                buildRecursive ( order, 0, static_cast< uint32_t > ( order.size () ), invalid_slot );
+
+                std::vector< DAGObjectInstance* > sorted_items ( items.size () );
+                std::vector< AABB3D > sorted_boxes ( items.size () );
+                for ( uint32_t i = 0; i < order.size (); ++i )
+                {
+                    sorted_items[ i ] = items[ order[ i ] ];
+                    sorted_boxes[ i ] = item_boxes[ order[ i ] ];
+                }
+                items.swap ( sorted_items );
+                item_boxes.swap ( sorted_boxes );
+
+                for ( uint32_t n = 0; n < nodes.size (); ++n )
+                {
+                    if ( nodes[ n ].count == 0 )
+                    {
+                        continue;
+                    }
+                    for ( uint32_t i = nodes[ n ].first; i < nodes[ n ].first + nodes[ n ].count; ++i )
+                    {
+                        item_leaf[ i ] = n;
+                        items[ i ]->bvh_slot = i;
+                    }
+                }
+            }
+
+            recomputeSceneBounds ();
+        }
+
+        /// 最长轴中位数划分，返回新节点下标
+        uint32_t buildRecursive ( std::vector< uint32_t >& order, uint32_t begin, uint32_t end, uint32_t parent )
+        {
+            const uint32_t index = static_cast< uint32_t > ( nodes.size () );
+            nodes.push_back ( Node{ inverted_bounds (), 0, 0, parent, 1, false } );
+
+            AABB3D box = inverted_bounds ();
+            AABB3D centroids = inverted_bounds ();
+            for ( uint32_t i = begin; i < end; ++i )
+            {
+                const AABB3D& b = item_boxes[ order[ i ] ];
+                merge ( box, b );
+                const double cx = 0.5 * ( b.min_x + b.max_x );
+                const double cy = 0.5 * ( b.min_y + b.max_y );
+                const double cz = 0.5 * ( b.min_z + b.max_z );
+                merge ( centroids, AABB3D{ cx, cy, cz, cx, cy, cz } );
+            }
+            nodes[ index ].box = box;
+
+            if ( end - begin <= leaf_capacity )
+            {
+                nodes[ index ].first = begin;
+                nodes[ index ].count = end - begin;
+                return index;
+            }
+
+            const double ex = centroids.max_x - centroids.min_x;
+            const double ey = centroids.max_y - centroids.min_y;
+            const double ez = centroids.max_z - centroids.min_z;
+            const int axis = ( ex >= ey && ex >= ez ) ? 0 : ( ey >= ez ? 1 : 2 );
+
+            auto centroid = [ this, axis ] ( uint32_t item )
+            {
+                const AABB3D& b = item_boxes[ item ];
+                switch ( axis )
+                {
+                    case 0:
+                        return b.min_x + b.max_x;
+                    case 1:
+                        return b.min_y + b.max_y;
+                    default:
+                        return b.min_z + b.max_z;
+                }
+            };
+
+            const uint32_t mid = begin + ( end - begin ) / 2;
+            std::nth_element ( order.begin () + begin, order.begin () + mid, order.begin () + end,
+                               [ &centroid ] ( uint32_t a, uint32_t b ) { return centroid ( a ) < centroid ( b ); } );
+
+            buildRecursive ( order, begin, mid, index );
+            const uint32_t right = buildRecursive ( order, mid, end, index );
+
+            nodes[ index ].first = right;
+            nodes[ index ].subtree_size = static_cast< uint32_t > ( nodes.size () ) - index;
+            return index;
+        }
+
+        inline void refit ()
+        {
+            for ( DAGObjectInstance* instance : dirty_instances )
+            {
+                const uint32_t slot = instance->bvh_slot;
+                if ( slot == invalid_slot ) [[unlikely]]
+                {
+                    continue;
+                }
+
+                const AABB3D box = computeInstanceAABB ( *instance );
+                const bool bounded = isBounded ( box );
+
+                // 有界性改变 (如缩放被置为 inf)，树结构必须重建
+                if ( bounded == ( ( slot & unbounded_bit ) != 0 ) ) [[unlikely]]
+                {
+                    structure_dirty = true;
+                    break;
+                }
+
+                if ( !bounded )
+                {
+                    unbounded_boxes[ slot & ~unbounded_bit ] = sanitizeUnbounded ( box );
+                    continue;
+                }
+
+                item_boxes[ slot ] = box;
+
+                // 沿父链打标，遇到已打标的祖先即可停止 (其上方路径已被其他脏实例登记)
+                for ( uint32_t n = item_leaf[ slot ]; n != invalid_slot && !nodes[ n ].needs_refit;
+                      n = nodes[ n ].parent )
+                {
+                    nodes[ n ].needs_refit = true;
+                    refit_queue.push_back ( n );
+                }
+            }
+            dirty_instances.clear ();
+
+            if ( structure_dirty ) [[unlikely]]
+            {
+                for ( uint32_t n : refit_queue )
+                {
+                    nodes[ n ].needs_refit = false;
+                }
+                refit_queue.clear ();
+                rebuild ();
+                return;
+            }
+
+            // 🚀 子节点下标恒大于父节点：按下标降序处理即为自底向上，每个受影响节点只合并一次
+            std::sort ( refit_queue.begin (), refit_queue.end (), std::greater<> () );
+            for ( uint32_t n : refit_queue )
+            {
+                Node& node = nodes[ n ];
+                node.needs_refit = false;
+
+                AABB3D box = inverted_bounds ();
+                if ( node.count > 0 )
+                {
+                    for ( uint32_t i = node.first; i < node.first + node.count; ++i )
+                    {
+                        merge ( box, item_boxes[ i ] );
+                    }
+                }
+                else
+                {
+                    merge ( box, nodes[ n + 1 ].box );
+                    merge ( box, nodes[ node.first ].box );
+                }
+                node.box = box;
+            }
+            refit_queue.clear ();
+
+            recomputeSceneBounds ();
+        }
+    };
+}   // namespace StuCanvas
@@ -12,15 +12,24 @@
 #include <array>
 #include <bitset>
 #include <cstdint>
+#include <limits>
 #include <span>
 #include <vector>
 
+#include "bvh.hpp"
 #include "flex_vector.hpp"
 #include "instance.hpp"
 #include "object.hpp"
+#include "picking.hpp"
 #include "pinned_vector.hpp"
+#include "profiling.hpp"
 #include "tiny_vector.hpp"
 
+// 置 1 时 DAG 节点池 / 实例池使用 2 MB 大页并按 NUMA 节点交错（面向超大场景）
+#ifndef STUCANVAS_DAG_LARGE_SCENE_POOLS
+#define STUCANVAS_DAG_LARGE_SCENE_POOLS 0
+#endif
+
  
 namespace StuCanvas
 {
@@ -47,9 +56,16 @@ namespace StuCanvas
         inline GraphQuery& findByName ( std::string_view name )
         {
             utils::TinyVector< DAGObject* > filtered;
+            // 名称只查一次驻留表，之后逐节点比较 32 位 id；从未驻留过的名称必然无匹配
+            const utils::InternedString key = utils::InternedString::lookup ( name );
+            if ( key.empty () && !name.empty () )
+            {
+                m_candidates = std::move ( filtered );
+                return *this;
+            }
             for ( DAGObject* node : m_candidates )
             {
-                if ( static_cast< std::string_view > ( node->name ) == name )
+                if ( node->name == key )
                 {
                     filtered.push_back ( node );
                 }
@@ -103,6 +119,17 @@ namespace StuCanvas
 
     struct DAGObjectInstance;
 
+    /// 节点池 / 实例池的物理内存策略。默认与系统行为一致；大场景可以 STUCANVAS_DAG_LARGE_SCENE_POOLS=1 编译：
+    /// 2 MB 透明大页降低遍历时的 TLB 压力，页面在在线节点间交错，多插槽工作站上各插槽的求值线程不会全部落到远端内存。
+    /// 💡 大页模式下每个池至少提交 2 MB，小场景 / 大量小图时得不偿失，因此不默认开启
+#if STUCANVAS_DAG_LARGE_SCENE_POOLS
+    inline constexpr utils::PinnedPolicy dag_pool_policy { .huge_pages = true,
+                                                           .prefault = false,
+                                                           .numa = utils::NumaPlacement::Interleave };
+#else
+    inline constexpr utils::PinnedPolicy dag_pool_policy {};
+#endif
+
     struct DAGraph
     {
     private:
@@ -110,10 +137,13 @@ namespace StuCanvas
         std::bitset< 64 > flag;
         utils::TinyVector< utils::TinyVector< DAGObject* > > dirty_double_list;
 
-        utils::PinnedVector< DAGObject, 32 > node_pool;
+        utils::PinnedVector< DAGObject, 32, dag_pool_policy > node_pool;
         utils::TinyVector< DAGObject* > dirty_nodes;
-        utils::PinnedVector< DAGObjectInstance, 32 > instance_pool;
+        utils::PinnedVector< DAGObjectInstance, 32, dag_pool_policy > instance_pool;
         utils::FlexVector<> appearance_pool;
+        InstanceBVH instance_bvh;   ///< 🚀 实例包围盒层级，求值后仅对受波及实例增量重拟合
+        InstancePicker instance_picker;   ///< 两级拾取：实例层复用 instance_bvh，图元层按资产惰性建树
+        uint64_t instance_layout_revision = 0;   ///< 实例增删或外观切换时递增，渲染侧据此重建绘制批次
 
 
         inline DAGObjectInstance& createInstance ( DAGObject& object )
@@ -121,9 +151,18 @@ namespace StuCanvas
             DAGObjectInstance& instance = instance_pool.emplace_back ();
             instance.source = &object;
             object.instances.emplace_back ( &instance );
+            instance_bvh.insert ( instance );
+            ++instance_layout_revision;
             return instance;
         }
 
+        // 实例的几何结果或变换已改变：递增修订号并使其 BVH 叶子失效
+        inline void touchInstance ( DAGObjectInstance& instance )
+        {
+            ++instance.revision;
+            instance_bvh.markDirty ( instance );
+        }
+
         // 🚀 辅助函数：判断 TinyVector 中是否已包含某个节点指针（L1 缓存极速扫视）
         [[nodiscard]] inline bool contains ( const utils::TinyVector< DAGObject* >& vec, DAGObject* val ) const noexcept
         {
@@ -158,6 +197,7 @@ namespace StuCanvas
         // 🚀 核心：利用成员变量 dirty_double_list 以及并行数组，进行无指针追逐的 ASAP 脏双重表构建
         inline utils::TinyVector< utils::TinyVector< DAGObject* > >& buildDirtyDoubleList ()
         {
+            STU_PROFILE_ZONE ( "DAGraph::buildDirtyDoubleList" );
             dirty_double_list.clear ();
 
             if ( dirty_nodes.empty () )
@@ -278,9 +318,14 @@ namespace StuCanvas
         [[nodiscard]] inline GraphQuery findByName ( std::string_view name )
         {
             utils::TinyVector< DAGObject* > candidates;
+            const utils::InternedString key = utils::InternedString::lookup ( name );
+            if ( key.empty () && !name.empty () )
+            {
+                return GraphQuery ( std::move ( candidates ) );
+            }
             for ( auto& node : node_pool )
             {
-                if ( static_cast< std::string_view > ( node.name ) == name )
+                if ( node.name == key )
                 {
                     candidates.push_back ( &node );
                 }
@@ -322,6 +367,7 @@ namespace StuCanvas
             {
                 return;
             }
+            STU_PROFILE_ZONE ( "DAGraph::evaluate" );
 
             // 🚀 1. 延迟一键去重：利用连续内存进行极速排序 + 去重，消除高频 markDirty 中的线性 contains 压力
             std::sort ( dirty_nodes.begin (), dirty_nodes.end () );
@@ -346,17 +392,104 @@ namespace StuCanvas
 
             // 🚀 4. 全部解算结束后，局部遍历脏双重表，一键清洗已求值节点的 Solved 标记，恢复干净状态
             //    只访问受波及的子图（O(D) 复杂度），绝对不进行 O(N) 的 node_pool 全图重置
+            //    同一趟遍历顺带登记受波及节点的实例，供 BVH 只重拟合这些叶子
             for ( auto& rank_list : dirty_double_list )
             {
                 for ( DAGObject* node : rank_list )
                 {
                     node->flag.reset ( static_cast< size_t > ( NodeProperty::Solved ) );
+                    ++node->geometry_revision;
+
+                    for ( DAGObjectInstance* instance : node->instances )
+                    {
+                        touchInstance ( *instance );
+                    }
                 }
             }
+            {
+                STU_PROFILE_ZONE ( "DAGraph::evaluate/bvh_update" );
+                instance_bvh.update ();
+            }
 
             // 5. 清空脏节点队列，等待下一次属性/关系变更触发
             dirty_nodes.clear ();
         }
+        // 🚀 实例 BVH 访问：先补齐未求值期间的插入与变换修改，再返回可直接用于剔除 / 场景包围盒查询的树
+        [[nodiscard]] inline const InstanceBVH& instanceBVH ()
+        {
+            instance_bvh.update ();
+            return instance_bvh;
+        }
+
+        /**
+         * @brief 拾取射线命中的最近实例与图元 (用法见 PickRay)
+         *
+         * 离散几何资产的图元层级在首次被触及、或资产 / 几何修订号变化后的首次触及时重建。
+         */
+        [[nodiscard]] inline PickHit pick ( const PickRay& ray )
+        {
+            instance_bvh.update ();
+            return instance_picker.pick ( instance_bvh, ray );
+        }
+
+        // 2D 画布拾取：光标 (x, y) 处、世界空间容差 tolerance 内离光标最近的实例与图元
+        [[nodiscard]] inline PickHit pick2D ( double x, double y, double tolerance )
+        {
+            PickRay ray;
+            ray.origin[ 0 ] = x;
+            ray.origin[ 1 ] = y;
+            ray.t_min = -std::numeric_limits< double >::infinity ();
+            ray.radius = tolerance;
+            return pick ( ray );
+        }
+
+        /**
+         * @brief 对象数据 (data) 或离散几何资产在 modify* / evaluate 之外被直接改写后的唯一登记入口
+         *
+         * 递增几何修订号并经 touchInstance 递增其全部实例的修订号，使实例包围盒、拾取图元层级与
+         * 渲染侧点批次缓存的世界中心一并失效。绕过本函数直接写 node.data 的改动不会被任何派生缓存察觉。
+         */
+        inline void touchGeometry ( DAGObject& node )
+        {
+            ++node.geometry_revision;
+            for ( DAGObjectInstance* instance : node.instances )
+            {
+                touchInstance ( *instance );
+            }
+        }
+
+        // 为对象创建一个带外观的放置实例，并登记到实例 BVH
+        inline DAGObjectInstance& createObjectInstance ( DAGObject& object, void* appearance )
+        {
+            DAGObjectInstance& instance = createInstance ( object );
+            instance.appearance = appearance;
+            return instance;
+        }
+
+        // 修改实例的世界变换 (T / R / S)，仅使该实例在 BVH 中的叶子失效
+        inline void modifyInstanceTransform ( DAGObjectInstance& instance, const double ( &position )[ 3 ],
+                                              const float ( &rotation )[ 4 ], const double ( &scales )[ 3 ] )
+        {
+            std::copy ( std::begin ( position ), std::end ( position ), instance.world_position );
+            std::copy ( std::begin ( rotation ), std::end ( rotation ), instance.world_rotation );
+            std::copy ( std::begin ( scales ), std::end ( scales ), instance.world_scales );
+
+            touchInstance ( instance );
+        }
+
+        // 切换实例外观 (绘制批次按外观划分，因此递增布局修订号)
+        inline void modifyInstanceAppearance ( DAGObjectInstance& instance, void* appearance )
+        {
+            instance.appearance = appearance;
+            ++instance_layout_revision;
+        }
+
+        // 实例布局修订号：仅在实例增删或外观切换时变化
+        [[nodiscard]] inline uint64_t instanceLayoutRevision () const noexcept
+        {
+            return instance_layout_revision;
+        }
+
         inline void modifyName ( DAGObject& node, std::string_view new_name )
         {
             node.name = new_name;
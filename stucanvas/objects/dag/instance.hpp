@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <eigen3/Eigen/Dense>
 
 namespace StuCanvas
@@ -17,5 +18,15 @@ namespace StuCanvas
 
         // 世界非等比缩放 (S) (3个double，共 24 字节)
         double world_scales[ 3 ] = { 1.0, 1.0, 1.0 };
+
+        // 所属 InstanceBVH 中的槽位 (由 BVH 维护，外部勿写)
+        uint32_t bvh_slot = 0xFFFFFFFFu;
+
+        // 修订号：仅由 DAGraph::touchInstance 递增 (源对象被重新解算、touchGeometry 登记的数据改写、实例变换被修改)，
+        // 渲染侧缓存据此判断是否需要重算；直接改写源对象 data 而不登记不会使其变化
+        uint32_t revision = 0;
+
+        // 渲染侧点批次缓存中的条目下标 (由 PointBatchCache 维护，外部勿写)
+        uint32_t draw_slot = 0xFFFFFFFFu;
     };
 }   // namespace StuCanvas
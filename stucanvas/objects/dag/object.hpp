@@ -4,11 +4,11 @@
 #include <string>
 
 #include "assets.hpp"
-#include "compact_string.hpp"
 #include "data.hpp"
 #include "flex_vector.hpp"
 #include "node_types.hpp"
 #include "instance.hpp"
+#include "intern_table.hpp"
 #include "tiny_vector.hpp"
 
 namespace StuCanvas
@@ -25,14 +25,17 @@ namespace StuCanvas
     {
         NodeType type;
         std::bitset< 64 > flag;
-        NodeData data;
+        NodeData data;   ///< 仅经 DAGraph::modify* / 求值器写入；在此之外直接改写后必须调用 DAGraph::touchGeometry
         utils::FlexVector<> assets;
         utils::TinyVector< DAGObject* > parents;
         utils::TinyVector< DAGObject* > children;
-        utils::CompactString name;
+        utils::InternedString name;   ///< 驻留符号：名称比较只比 id，同名节点共享同一份字节
         uint32_t id;
         DAGraph* graph;
         utils::TinyVector< DAGObjectInstance*> instances;
+
+        // 几何修订号：对象被重新解算或其离散几何资产被改写时递增，拾取等派生缓存据此判断是否需要重建
+        uint32_t geometry_revision = 0;
     };
 
 
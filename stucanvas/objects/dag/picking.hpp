@@ -0,0 +1,918 @@
+/****************************************************************************
+ * Copyright (c) 2025-2026 Tian Yuxuan (Friendships666)                     *
+ *                                                                          *
+ * StuCanvas is licensed under Mulan PSL v2.                                *
+ * You can use this software according to the terms and conditions of the   *
+ * Mulan PSL v2.                                                            *
+ * You may obtain a copy of Mulan PSL v2 at:                                *
+ *          http://license.coscl.org.cn/MulanPSL2                           *
+ *                                                                          *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF     *
+ * ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO        *
+ * NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.       *
+ * See the Mulan PSL v2 for more details.                                   *
+ ***************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <oneapi/tbb/parallel_invoke.h>
+
+#include "../../utils2/flat_map.hpp"
+#include "AABB.hpp"
+#include "bvh.hpp"
+#include "instance.hpp"
+#include "object.hpp"
+
+namespace StuCanvas
+{
+    /**
+     * @brief 世界空间拾取射线 (带随深度线性增长的容差)
+     *
+     * 命中条件：图元到射线上深度 t 处的距离 ≤ radius + radius_per_distance · max(t, 0)。
+     * 2D 画布拾取令射线沿 -z 穿过光标、t_min = -inf，radius 为像素容差换算后的世界长度；
+     * 3D 透视拾取令 radius_per_distance = 像素容差 · 2·tan(fov / 2) / 视口高度 (像素)。
+     */
+    struct PickRay
+    {
+        double origin[ 3 ] = { 0.0, 0.0, 0.0 };
+        double dir[ 3 ] = { 0.0, 0.0, -1.0 };   ///< 无需归一化
+        double t_min = 0.0;
+        double t_max = std::numeric_limits< double >::infinity ();
+        double radius = 0.0;
+        double radius_per_distance = 0.0;
+    };
+
+    /// 命中图元的类别：解析几何整体命中为 Object，离散几何资产命中为具体图元
+    enum class PickPrimitive : uint8_t
+    {
+        Object,
+        Point,
+        Segment,
+        Triangle
+    };
+
+    struct PickHit
+    {
+        DAGObjectInstance* instance = nullptr;
+        PickPrimitive kind = PickPrimitive::Object;
+        uint32_t primitive = 0;   ///< 点序号 / 折线段起点序号 / 三角形序号
+        double t = std::numeric_limits< double >::infinity ();          ///< 沿 (归一化) 射线的深度
+        double distance = std::numeric_limits< double >::infinity ();   ///< 到射线的世界距离 (三角形为 0)
+
+        [[nodiscard]] explicit operator bool () const noexcept
+        {
+            return instance != nullptr;
+        }
+    };
+
+    namespace detail::pick
+    {
+        /// 实例的 R·S 线性部分与平移 (world = m · local + t)
+        struct Affine
+        {
+            double m[ 3 ][ 3 ];
+            double t[ 3 ];
+        };
+
+        [[nodiscard]] inline Affine instanceAffine ( const DAGObjectInstance& instance )
+        {
+            const Eigen::Quaterniond q ( instance.world_rotation[ 3 ], instance.world_rotation[ 0 ],
+                                         instance.world_rotation[ 1 ], instance.world_rotation[ 2 ] );
+            const Eigen::Matrix3d rot = q.normalized ().toRotationMatrix ();
+
+            Affine affine{};
+            for ( int i = 0; i < 3; ++i )
+            {
+                for ( int j = 0; j < 3; ++j )
+                {
+                    affine.m[ i ][ j ] = rot ( i, j ) * instance.world_scales[ j ];
+                }
+                affine.t[ i ] = instance.world_position[ i ];
+            }
+            return affine;
+        }
+
+        inline void apply ( const Affine& a, const double ( &p )[ 3 ], double ( &out )[ 3 ] ) noexcept
+        {
+            for ( int i = 0; i < 3; ++i )
+            {
+                out[ i ] = a.t[ i ] + a.m[ i ][ 0 ] * p[ 0 ] + a.m[ i ][ 1 ] * p[ 1 ] + a.m[ i ][ 2 ] * p[ 2 ];
+            }
+        }
+
+        /// Arvo 区间投影：局部包围盒 -> 世界包围盒
+        [[nodiscard]] inline AABB3D transformBox ( const Affine& a, const AABB3D& box ) noexcept
+        {
+            const double lo[ 3 ] = { box.min_x, box.min_y, box.min_z };
+            const double hi[ 3 ] = { box.max_x, box.max_y, box.max_z };
+            double out_lo[ 3 ] = { a.t[ 0 ], a.t[ 1 ], a.t[ 2 ] };
+            double out_hi[ 3 ] = { a.t[ 0 ], a.t[ 1 ], a.t[ 2 ] };
+            for ( int i = 0; i < 3; ++i )
+            {
+                for ( int j = 0; j < 3; ++j )
+                {
+                    const double u = a.m[ i ][ j ] * lo[ j ];
+                    const double v = a.m[ i ][ j ] * hi[ j ];
+                    out_lo[ i ] += std::min ( u, v );
+                    out_hi[ i ] += std::max ( u, v );
+                }
+            }
+            return { out_lo[ 0 ], out_lo[ 1 ], out_lo[ 2 ], out_hi[ 0 ], out_hi[ 1 ], out_hi[ 2 ] };
+        }
+
+        /// 归一化后的查询射线
+        struct Ray
+        {
+            double o[ 3 ];
+            double d[ 3 ];
+            double t0, t1;
+            double radius, slope;
+
+            [[nodiscard]] double radiusAt ( double t ) const noexcept
+            {
+                return radius + slope * std::max ( t, 0.0 );
+            }
+        };
+
+        /**
+         * @brief 射线段 [t0, t_hi] 与按最大容差膨胀后的包围盒求交，命中时输出进入深度
+         *
+         * 膨胀量取盒内最远点在射线上投影处的容差，对圆锥形容差是保守的。
+         */
+        [[nodiscard]] inline bool slab ( const Ray& ray, const AABB3D& box, double t_hi, double& t_enter ) noexcept
+        {
+            const double lo[ 3 ] = { box.min_x, box.min_y, box.min_z };
+            const double hi[ 3 ] = { box.max_x, box.max_y, box.max_z };
+
+            double far_proj = 0.0;
+            for ( int a = 0; a < 3; ++a )
+            {
+                far_proj += ( ray.d[ a ] >= 0.0 ? hi[ a ] - ray.o[ a ] : lo[ a ] - ray.o[ a ] ) * ray.d[ a ];
+            }
+            const double e = ray.radiusAt ( std::min ( t_hi, far_proj ) );
+
+            double tn = ray.t0;
+            double tf = t_hi;
+            for ( int a = 0; a < 3; ++a )
+            {
+                const double l = lo[ a ] - e;
+                const double h = hi[ a ] + e;
+                if ( std::abs ( ray.d[ a ] ) < 1e-300 )
+                {
+                    if ( ray.o[ a ] < l || ray.o[ a ] > h )
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                const double inv = 1.0 / ray.d[ a ];
+                double ta = ( l - ray.o[ a ] ) * inv;
+                double tb = ( h - ray.o[ a ] ) * inv;
+                if ( ta > tb )
+                {
+                    std::swap ( ta, tb );
+                }
+                tn = std::max ( tn, ta );
+                tf = std::min ( tf, tb );
+                if ( !( tn <= tf ) )
+                {
+                    return false;
+                }
+            }
+            t_enter = tn;
+            return true;
+        }
+
+        /// 点 (或半径为 extra 的球) 与射线
+        [[nodiscard]] inline bool testPoint ( const Ray& ray, const double ( &w )[ 3 ], double extra, double t_hi,
+                                              double& t, double& dist ) noexcept
+        {
+            const double v[ 3 ] = { w[ 0 ] - ray.o[ 0 ], w[ 1 ] - ray.o[ 1 ], w[ 2 ] - ray.o[ 2 ] };
+            t = v[ 0 ] * ray.d[ 0 ] + v[ 1 ] * ray.d[ 1 ] + v[ 2 ] * ray.d[ 2 ];
+            if ( t < ray.t0 || t > t_hi )
+            {
+                return false;
+            }
+            const double d2 = std::max ( 0.0, v[ 0 ] * v[ 0 ] + v[ 1 ] * v[ 1 ] + v[ 2 ] * v[ 2 ] - t * t );
+            const double r = ray.radiusAt ( t ) + extra;
+            dist = std::max ( 0.0, std::sqrt ( d2 ) - extra );
+            return d2 <= r * r;
+        }
+
+        /**
+         * @brief 线段 a + s·(b - a), s ∈ [s_lo, s_hi] 与射线的最近距离 (s 取 ±inf 即射线 / 直线)
+         */
+        [[nodiscard]] inline bool testSegment ( const Ray& ray, const double ( &a )[ 3 ], const double ( &b )[ 3 ],
+                                                double s_lo, double s_hi, double extra, double t_hi, double& t,
+                                                double& dist ) noexcept
+        {
+            const double u[ 3 ] = { b[ 0 ] - a[ 0 ], b[ 1 ] - a[ 1 ], b[ 2 ] - a[ 2 ] };
+            const double w0[ 3 ] = { a[ 0 ] - ray.o[ 0 ], a[ 1 ] - ray.o[ 1 ], a[ 2 ] - ray.o[ 2 ] };
+            const double uu = u[ 0 ] * u[ 0 ] + u[ 1 ] * u[ 1 ] + u[ 2 ] * u[ 2 ];
+            if ( uu < 1e-300 )
+            {
+                return testPoint ( ray, a, extra, t_hi, t, dist );
+            }
+
+            const double ud = u[ 0 ] * ray.d[ 0 ] + u[ 1 ] * ray.d[ 1 ] + u[ 2 ] * ray.d[ 2 ];
+            const double uw = u[ 0 ] * w0[ 0 ] + u[ 1 ] * w0[ 1 ] + u[ 2 ] * w0[ 2 ];
+            const double dw = ray.d[ 0 ] * w0[ 0 ] + ray.d[ 1 ] * w0[ 1 ] + ray.d[ 2 ] * w0[ 2 ];
+            const double denom = uu - ud * ud;
+
+            // 先解无约束的两直线最近点，再依次钳制线段参数与射线深度
+            double s = denom > 1e-12 * uu ? ( ud * dw - uw ) / denom : 0.0;
+            s = std::clamp ( s, s_lo, s_hi );
+            t = std::clamp ( dw + s * ud, ray.t0, t_hi );
+            s = std::clamp ( ( t * ud - uw ) / uu, s_lo, s_hi );
+            t = std::clamp ( dw + s * ud, ray.t0, t_hi );
+
+            double d2 = 0.0;
+            for ( int i = 0; i < 3; ++i )
+            {
+                const double q = w0[ i ] + s * u[ i ] - t * ray.d[ i ];
+                d2 += q * q;
+            }
+            if ( !std::isfinite ( t ) )
+            {
+                return false;
+            }
+            const double r = ray.radiusAt ( t ) + extra;
+            dist = std::max ( 0.0, std::sqrt ( d2 ) - extra );
+            return d2 <= r * r;
+        }
+
+        /// Möller–Trumbore 射线-三角形求交 (双面)
+        [[nodiscard]] inline bool testTriangle ( const Ray& ray, const double ( &p0 )[ 3 ], const double ( &p1 )[ 3 ],
+                                                 const double ( &p2 )[ 3 ], double t_hi, double& t ) noexcept
+        {
+            const double e1[ 3 ] = { p1[ 0 ] - p0[ 0 ], p1[ 1 ] - p0[ 1 ], p1[ 2 ] - p0[ 2 ] };
+            const double e2[ 3 ] = { p2[ 0 ] - p0[ 0 ], p2[ 1 ] - p0[ 1 ], p2[ 2 ] - p0[ 2 ] };
+            const double p[ 3 ] = { ray.d[ 1 ] * e2[ 2 ] - ray.d[ 2 ] * e2[ 1 ], ray.d[ 2 ] * e2[ 0 ] - ray.d[ 0 ] * e2[ 2 ],
+                                    ray.d[ 0 ] * e2[ 1 ] - ray.d[ 1 ] * e2[ 0 ] };
+            const double det = e1[ 0 ] * p[ 0 ] + e1[ 1 ] * p[ 1 ] + e1[ 2 ] * p[ 2 ];
+            if ( std::abs ( det ) < 1e-300 )
+            {
+                return false;
+            }
+            const double inv = 1.0 / det;
+            const double s[ 3 ] = { ray.o[ 0 ] - p0[ 0 ], ray.o[ 1 ] - p0[ 1 ], ray.o[ 2 ] - p0[ 2 ] };
+            const double u = ( s[ 0 ] * p[ 0 ] + s[ 1 ] * p[ 1 ] + s[ 2 ] * p[ 2 ] ) * inv;
+            if ( u < 0.0 || u > 1.0 )
+            {
+                return false;
+            }
+            const double q[ 3 ] = { s[ 1 ] * e1[ 2 ] - s[ 2 ] * e1[ 1 ], s[ 2 ] * e1[ 0 ] - s[ 0 ] * e1[ 2 ],
+                                    s[ 0 ] * e1[ 1 ] - s[ 1 ] * e1[ 0 ] };
+            const double v = ( ray.d[ 0 ] * q[ 0 ] + ray.d[ 1 ] * q[ 1 ] + ray.d[ 2 ] * q[ 2 ] ) * inv;
+            if ( v < 0.0 || u + v > 1.0 )
+            {
+                return false;
+            }
+            t = ( e2[ 0 ] * q[ 0 ] + e2[ 1 ] * q[ 1 ] + e2[ 2 ] * q[ 2 ] ) * inv;
+            return t >= ray.t0 && t <= t_hi;
+        }
+    }   // namespace detail::pick
+
+    /**
+     * @brief 单个离散几何资产的局部空间图元层级包围盒 (点 / 折线段 / 三角形)
+     *
+     * 与 InstanceBVH 相同的前序布局：左孩子紧随父节点，内部节点的 first 为右孩子下标；叶子至多 8 个图元。
+     * 含 NaN / inf 顶点的图元 (折线断点等) 在构建时剔除。
+     */
+    class PrimitiveBVH
+    {
+    public:
+
+        static constexpr uint32_t leaf_capacity = 8;
+
+        inline void build ( const GeometryAssetView& view )
+        {
+            nodes.clear ();
+            prims.clear ();
+
+            std::vector< AABB3D > boxes;
+            std::vector< uint32_t > candidates;
+            std::vector< BuildRef > refs;
+            const uint32_t count = primitiveCount ( view );
+            boxes.reserve ( count );
+            candidates.reserve ( count );
+            refs.reserve ( count );
+
+            for ( uint32_t p = 0; p < count; ++p )
+            {
+                uint32_t v[ 3 ];
+                const uint32_t n = primitiveVertices ( view, p, v );
+                AABB3D box{ inf, inf, inf, -inf, -inf, -inf };
+                bool finite = true;
+                for ( uint32_t k = 0; k < n && finite; ++k )
+                {
+                    if ( v[ k ] >= view.vertex_count )
+                    {
+                        finite = false;
+                        break;
+                    }
+                    const double x = view.x[ v[ k ] ];
+                    const double y = view.y[ v[ k ] ];
+                    const double z = view.z ? view.z[ v[ k ] ] : 0.0;
+                    finite = std::isfinite ( x ) && std::isfinite ( y ) && std::isfinite ( z );
+                    box = { std::min ( box.min_x, x ), std::min ( box.min_y, y ), std::min ( box.min_z, z ),
+                            std::max ( box.max_x, x ), std::max ( box.max_y, y ), std::max ( box.max_z, z ) };
+                }
+                if ( finite )
+                {
+                    const uint32_t slot = static_cast< uint32_t > ( boxes.size () );
+                    refs.push_back ( BuildRef{ { static_cast< float > ( 0.5 * ( box.min_x + box.max_x ) ),
+                                                 static_cast< float > ( 0.5 * ( box.min_y + box.max_y ) ),
+                                                 static_cast< float > ( 0.5 * ( box.min_z + box.max_z ) ) },
+                                               slot } );
+                    boxes.push_back ( box );
+                    candidates.push_back ( p );
+                }
+            }
+
+            if ( refs.empty () )
+            {
+                return;
+            }
+
+            // 中位数划分下子树节点数只取决于图元数，可预先分配前序槽位，左右子树并行构建互不干扰
+            const uint32_t total = static_cast< uint32_t > ( refs.size () );
+            nodes.resize ( nodeCount ( total ).first );
+            buildRecursive ( boxes, refs, 0, total, 0 );
+
+            prims.resize ( refs.size () );
+            for ( size_t i = 0; i < refs.size (); ++i )
+            {
+                prims[ i ] = candidates[ refs[ i ].slot ];
+            }
+        }
+
+        [[nodiscard]] inline bool empty () const noexcept
+        {
+            return nodes.empty ();
+        }
+
+        /**
+         * @brief 近者优先的遍历
+         *
+         * @param enter bool(const AABB3D& local_box, double& t_enter)：节点是否可能命中及其进入深度
+         * @param visit void(uint32_t primitive)：叶子中的图元
+         */
+        template < typename Enter, typename Visit >
+        inline void traverse ( Enter&& enter, Visit&& visit ) const
+        {
+            if ( nodes.empty () )
+            {
+                return;
+            }
+
+            double t_root = 0.0;
+            if ( !enter ( nodes[ 0 ].box, t_root ) )
+            {
+                return;
+            }
+
+            uint32_t stack[ 64 ];
+            uint32_t top = 0;
+            stack[ top++ ] = 0;
+
+            while ( top > 0 )
+            {
+                const uint32_t index = stack[ --top ];
+                const Node& node = nodes[ index ];
+
+                // 入栈后调用方可能已收紧深度上限，出栈时重新裁剪 (根节点已在上方测试过)
+                double t_enter = 0.0;
+                if ( index != 0 && !enter ( node.box, t_enter ) )
+                {
+                    continue;
+                }
+
+                if ( node.count > 0 )
+                {
+                    for ( uint32_t i = node.first; i < node.first + node.count; ++i )
+                    {
+                        visit ( prims[ i ] );
+                    }
+                    continue;
+                }
+
+                uint32_t near_child = index + 1;
+                uint32_t far_child = node.first;
+                double t_near = 0.0;
+                double t_far = 0.0;
+                bool hit_near = enter ( nodes[ near_child ].box, t_near );
+                bool hit_far = enter ( nodes[ far_child ].box, t_far );
+                if ( hit_near && hit_far && t_far < t_near )
+                {
+                    std::swap ( near_child, far_child );
+                }
+                else if ( !hit_near )
+                {
+                    near_child = far_child;
+                    hit_near = hit_far;
+                    hit_far = false;
+                }
+
+                // 远孩子先入栈，近孩子先出栈
+                if ( hit_far )
+                {
+                    stack[ top++ ] = far_child;
+                }
+                if ( hit_near )
+                {
+                    stack[ top++ ] = near_child;
+                }
+            }
+        }
+
+        /// 图元 p 的顶点下标，返回顶点数 (1 / 2 / 3)
+        [[nodiscard]] static inline uint32_t primitiveVertices ( const GeometryAssetView& view, uint32_t p,
+                                                                 uint32_t ( &v )[ 3 ] ) noexcept
+        {
+            switch ( view.kind )
+            {
+                case GeometryAssetView::Kind::Points:
+                    v[ 0 ] = p;
+                    return 1;
+                case GeometryAssetView::Kind::LineStrip:
+                    v[ 0 ] = p;
+                    v[ 1 ] = p + 1;
+                    return 2;
+                case GeometryAssetView::Kind::Triangles:
+                    v[ 0 ] = view.indices[ 3 * p ];
+                    v[ 1 ] = view.indices[ 3 * p + 1 ];
+                    v[ 2 ] = view.indices[ 3 * p + 2 ];
+                    return 3;
+                default:
+                    return 0;
+            }
+        }
+
+    private:
+
+        static constexpr double inf = std::numeric_limits< double >::infinity ();
+
+        struct Node
+        {
+            AABB3D box;
+            uint32_t first;   ///< 叶子：prims 起始下标；内部节点：右孩子下标
+            uint32_t count;   ///< 叶子图元数，0 表示内部节点
+        };
+
+        /// 划分用的紧凑引用：质心只决定划分顺序，可用 float；节点包围盒由精确的图元包围盒自底向上合并
+        struct BuildRef
+        {
+            float c[ 3 ];
+            uint32_t slot;   ///< boxes / 候选图元数组中的下标
+        };
+
+        std::vector< Node > nodes;
+        std::vector< uint32_t > prims;   ///< 叶子顺序排列的图元序号
+
+        /// 图元序号为 32 位；64 位资产超出 UINT32_MAX 的尾部图元不参与图元级拾取（实例级 AABB 仍完整）
+        [[nodiscard]] static uint32_t primitiveCount ( const GeometryAssetView& view ) noexcept
+        {
+            uint64_t count = 0;
+            switch ( view.kind )
+            {
+                case GeometryAssetView::Kind::Points:
+                    count = view.vertex_count;
+                    break;
+                case GeometryAssetView::Kind::LineStrip:
+                    count = view.vertex_count > 1 ? view.vertex_count - 1 : 0;
+                    break;
+                case GeometryAssetView::Kind::Triangles:
+                    count = view.index_count / 3;
+                    break;
+                default:
+                    break;
+            }
+            return static_cast< uint32_t > ( std::min< uint64_t > ( count, std::numeric_limits< uint32_t >::max () ) );
+        }
+
+        static constexpr uint32_t parallel_build_threshold = 1u << 16;
+
+        /// {n 个图元的子树节点数, n + 1 个图元的子树节点数}：两者的左右半长只可能是 n / 2 或 n / 2 + 1，递归深度 O(log n)
+        [[nodiscard]] static std::pair< uint32_t, uint32_t > nodeCount ( uint32_t n ) noexcept
+        {
+            const uint32_t m = n / 2;
+            const std::pair< uint32_t, uint32_t > half =
+                n + 1 > leaf_capacity ? nodeCount ( m ) : std::pair< uint32_t, uint32_t >{ 1u, 1u };
+            auto count = [ & ] ( uint32_t k ) -> uint32_t
+            {
+                if ( k <= leaf_capacity )
+                {
+                    return 1u;
+                }
+                const uint32_t a = k / 2;
+                const uint32_t b = k - a;
+                return 1u + ( a == m ? half.first : half.second ) + ( b == m ? half.first : half.second );
+            };
+            return { count ( n ), count ( n + 1 ) };
+        }
+
+        void buildRecursive ( const std::vector< AABB3D >& boxes, std::vector< BuildRef >& refs, uint32_t begin,
+                              uint32_t end, uint32_t index )
+        {
+            if ( end - begin <= leaf_capacity )
+            {
+                AABB3D box{ inf, inf, inf, -inf, -inf, -inf };
+                for ( uint32_t i = begin; i < end; ++i )
+                {
+                    merge ( box, boxes[ refs[ i ].slot ] );
+                }
+                nodes[ index ] = Node{ box, begin, end - begin };
+                return;
+            }
+
+            float c_lo[ 3 ] = { std::numeric_limits< float >::max (), std::numeric_limits< float >::max (),
+                                std::numeric_limits< float >::max () };
+            float c_hi[ 3 ] = { std::numeric_limits< float >::lowest (), std::numeric_limits< float >::lowest (),
+                                std::numeric_limits< float >::lowest () };
+            for ( uint32_t i = begin; i < end; ++i )
+            {
+                for ( int a = 0; a < 3; ++a )
+                {
+                    c_lo[ a ] = std::min ( c_lo[ a ], refs[ i ].c[ a ] );
+                    c_hi[ a ] = std::max ( c_hi[ a ], refs[ i ].c[ a ] );
+                }
+            }
+
+            const float ex = c_hi[ 0 ] - c_lo[ 0 ];
+            const float ey = c_hi[ 1 ] - c_lo[ 1 ];
+            const float ez = c_hi[ 2 ] - c_lo[ 2 ];
+            const int axis = ( ex >= ey && ex >= ez ) ? 0 : ( ey >= ez ? 1 : 2 );
+
+            const uint32_t mid = begin + ( end - begin ) / 2;
+            std::nth_element ( refs.begin () + begin, refs.begin () + mid, refs.begin () + end,
+                               [ axis ] ( const BuildRef& a, const BuildRef& b ) { return a.c[ axis ] < b.c[ axis ]; } );
+
+            const uint32_t left = index + 1;
+            const uint32_t right = left + nodeCount ( mid - begin ).first;
+            if ( end - begin >= parallel_build_threshold )
+            {
+                oneapi::tbb::parallel_invoke ( [ & ] { buildRecursive ( boxes, refs, begin, mid, left ); },
+                                               [ & ] { buildRecursive ( boxes, refs, mid, end, right ); } );
+            }
+            else
+            {
+                buildRecursive ( boxes, refs, begin, mid, left );
+                buildRecursive ( boxes, refs, mid, end, right );
+            }
+
+            AABB3D box = nodes[ left ].box;
+            merge ( box, nodes[ right ].box );
+            nodes[ index ] = Node{ box, right, 0 };
+        }
+
+        static void merge ( AABB3D& dst, const AABB3D& src ) noexcept
+        {
+            dst.min_x = std::min ( dst.min_x, src.min_x );
+            dst.min_y = std::min ( dst.min_y, src.min_y );
+            dst.min_z = std::min ( dst.min_z, src.min_z );
+            dst.max_x = std::max ( dst.max_x, src.max_x );
+            dst.max_y = std::max ( dst.max_y, src.max_y );
+            dst.max_z = std::max ( dst.max_z, src.max_z );
+        }
+    };
+
+    /**
+     * @brief 两级拾取：实例层复用 InstanceBVH，图元层为每个离散几何资产惰性构建 PrimitiveBVH
+     *
+     * 1. 图元层在局部空间构建，遍历时把节点包围盒经实例仿射变换投影到世界空间再与射线求交，
+     *    同一资产被多个实例共享时只建一棵树，实例变换变化也无需重建。
+     * 2. 资产地址、顶点数或对象的几何修订号变化时，首次被拾取触及才重建对应的树。
+     * 3. 命中排序：深度更浅者优先，深度相同 (2D 画布) 时离射线更近者优先；已命中的深度同时用于裁剪。
+     * 4. 解析几何 (点、线段、直线、射线、圆、球、圆柱) 直接按 NodeData 求距离；平面不参与拾取。
+     */
+    class InstancePicker
+    {
+    public:
+
+        [[nodiscard]] inline PickHit pick ( const InstanceBVH& bvh, const PickRay& query )
+        {
+            PickHit best;
+
+            const double len = std::sqrt ( query.dir[ 0 ] * query.dir[ 0 ] + query.dir[ 1 ] * query.dir[ 1 ] +
+                                           query.dir[ 2 ] * query.dir[ 2 ] );
+            if ( !( len > 0.0 ) || !( query.t_min <= query.t_max ) )
+            {
+                return best;
+            }
+
+            // 深度按归一化方向重新度量
+            detail::pick::Ray ray{};
+            for ( int a = 0; a < 3; ++a )
+            {
+                ray.o[ a ] = query.origin[ a ];
+                ray.d[ a ] = query.dir[ a ] / len;
+            }
+            ray.t0 = query.t_min * len;
+            ray.t1 = query.t_max * len;
+            ray.radius = query.radius;
+            ray.slope = query.radius_per_distance;
+
+            auto box_test = [ & ] ( const AABB3D& box )
+            {
+                double t_enter = 0.0;
+                return detail::pick::slab ( ray, box, depthLimit ( ray, best ), t_enter );
+            };
+
+            auto visit = [ & ] ( DAGObjectInstance* instance, const AABB3D& )
+            {
+                if ( instance && instance->source )
+                {
+                    pickInstance ( ray, *instance, best );
+                }
+            };
+
+            bvh.traverse ( box_test, visit );
+            return best;
+        }
+
+        /// 丢弃全部图元层缓存 (对象 -> 槽位映射保留，槽位在下次触及时重建)
+        inline void clear ()
+        {
+            for ( AssetCache& cache : caches )
+            {
+                cache = AssetCache{};
+            }
+        }
+
+    private:
+
+        struct AssetCache
+        {
+            const void* asset = nullptr;
+            uint64_t vertex_count = 0;
+            uint64_t index_count = 0;
+            uint32_t revision = 0;
+            PrimitiveBVH bvh;
+        };
+
+        utils::FlatMap< const DAGObject*, uint32_t > slot_of_object;   ///< 对象 -> caches 下标
+        std::vector< AssetCache > caches;
+
+        /// 当前最优命中允许的最大深度 (同深度仍需比较距离，因此放宽一个相对容差)
+        [[nodiscard]] static double depthLimit ( const detail::pick::Ray& ray, const PickHit& best ) noexcept
+        {
+            if ( !best.instance )
+            {
+                return ray.t1;
+            }
+            return std::min ( ray.t1, best.t + 1e-9 * ( 1.0 + std::abs ( best.t ) ) );
+        }
+
+        static void offer ( PickHit& best, DAGObjectInstance* instance, PickPrimitive kind, uint32_t primitive,
+                            double t, double dist ) noexcept
+        {
+            bool better = !best.instance;
+            if ( !better )
+            {
+                const double eps = 1e-9 * ( 1.0 + std::abs ( best.t ) );
+                better = t < best.t - eps || ( t <= best.t + eps && dist < best.distance );
+            }
+            if ( better )
+            {
+                best = PickHit{ instance, kind, primitive, t, dist };
+            }
+        }
+
+        const PrimitiveBVH& assetBVH ( const DAGObject& object, const GeometryAssetView& view )
+        {
+            uint32_t slot = 0;
+            auto it = slot_of_object.find ( &object );
+            if ( it != slot_of_object.end () )
+            {
+                slot = ( *it ).second;
+            }
+            else
+            {
+                slot = static_cast< uint32_t > ( caches.size () );
+                caches.emplace_back ();
+                slot_of_object.insert ( &object, slot );
+            }
+
+            AssetCache& cache = caches[ slot ];
+            if ( cache.asset != view.asset || cache.vertex_count != view.vertex_count ||
+                 cache.index_count != view.index_count || cache.revision != object.geometry_revision ) [[unlikely]]
+            {
+                cache.bvh.build ( view );
+                cache.asset = view.asset;
+                cache.vertex_count = view.vertex_count;
+                cache.index_count = view.index_count;
+                cache.revision = object.geometry_revision;
+            }
+            return cache.bvh;
+        }
+
+        inline void pickInstance ( const detail::pick::Ray& ray, DAGObjectInstance& instance, PickHit& best )
+        {
+            const DAGObject& object = *instance.source;
+            const detail::pick::Affine affine = detail::pick::instanceAffine ( instance );
+
+            const GeometryAssetView view = findGeometryAsset ( object );
+            if ( view.kind != GeometryAssetView::Kind::None )
+            {
+                pickAsset ( ray, instance, affine, assetBVH ( object, view ), view, best );
+                return;
+            }
+            pickAnalytic ( ray, instance, affine, best );
+        }
+
+        static void pickAsset ( const detail::pick::Ray& ray, DAGObjectInstance& instance,
+                                const detail::pick::Affine& affine, const PrimitiveBVH& bvh,
+                                const GeometryAssetView& view, PickHit& best )
+        {
+            auto vertex = [ & ] ( uint32_t v, double ( &w )[ 3 ] )
+            {
+                const double p[ 3 ] = { view.x[ v ], view.y[ v ], view.z ? view.z[ v ] : 0.0 };
+                detail::pick::apply ( affine, p, w );
+            };
+
+            auto enter = [ & ] ( const AABB3D& local_box, double& t_enter )
+            {
+                return detail::pick::slab ( ray, detail::pick::transformBox ( affine, local_box ),
+                                            depthLimit ( ray, best ), t_enter );
+            };
+
+            auto visit = [ & ] ( uint32_t p )
+            {
+                uint32_t v[ 3 ];
+                ( void ) PrimitiveBVH::primitiveVertices ( view, p, v );
+                const double t_hi = depthLimit ( ray, best );
+                double t = 0.0;
+                double dist = 0.0;
+
+                switch ( view.kind )
+                {
+                    case GeometryAssetView::Kind::Points:
+                    {
+                        double w[ 3 ];
+                        vertex ( v[ 0 ], w );
+                        if ( detail::pick::testPoint ( ray, w, 0.0, t_hi, t, dist ) )
+                        {
+                            offer ( best, &instance, PickPrimitive::Point, p, t, dist );
+                        }
+                        break;
+                    }
+                    case GeometryAssetView::Kind::LineStrip:
+                    {
+                        double a[ 3 ];
+                        double b[ 3 ];
+                        vertex ( v[ 0 ], a );
+                        vertex ( v[ 1 ], b );
+                        if ( detail::pick::testSegment ( ray, a, b, 0.0, 1.0, 0.0, t_hi, t, dist ) )
+                        {
+                            offer ( best, &instance, PickPrimitive::Segment, p, t, dist );
+                        }
+                        break;
+                    }
+                    case GeometryAssetView::Kind::Triangles:
+                    {
+                        double a[ 3 ];
+                        double b[ 3 ];
+                        double c[ 3 ];
+                        vertex ( v[ 0 ], a );
+                        vertex ( v[ 1 ], b );
+                        vertex ( v[ 2 ], c );
+                        if ( detail::pick::testTriangle ( ray, a, b, c, t_hi, t ) )
+                        {
+                            offer ( best, &instance, PickPrimitive::Triangle, p, t, 0.0 );
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            };
+
+            bvh.traverse ( enter, visit );
+        }
+
+        static void pickAnalytic ( const detail::pick::Ray& ray, DAGObjectInstance& instance,
+                                   const detail::pick::Affine& affine, PickHit& best )
+        {
+            constexpr double inf = std::numeric_limits< double >::infinity ();
+            const DAGObject& object = *instance.source;
+            const NodeData& data = object.data;
+            const double t_hi = depthLimit ( ray, best );
+            double t = 0.0;
+            double dist = 0.0;
+
+            // 非等比缩放下圆 / 球 / 圆柱半径取最大轴缩放 (保守近似)
+            const double max_scale = std::max ( { std::abs ( instance.world_scales[ 0 ] ),
+                                                  std::abs ( instance.world_scales[ 1 ] ),
+                                                  std::abs ( instance.world_scales[ 2 ] ) } );
+
+            auto point = [ & ] ( double x, double y, double z, double extra )
+            {
+                double w[ 3 ];
+                detail::pick::apply ( affine, { x, y, z }, w );
+                if ( detail::pick::testPoint ( ray, w, extra, t_hi, t, dist ) )
+                {
+                    offer ( best, &instance, PickPrimitive::Object, 0, t, dist );
+                }
+            };
+
+            auto segment = [ & ] ( const double ( &p0 )[ 3 ], const double ( &p1 )[ 3 ], double s_lo, double s_hi,
+                                   double extra )
+            {
+                double a[ 3 ];
+                double b[ 3 ];
+                detail::pick::apply ( affine, p0, a );
+                detail::pick::apply ( affine, p1, b );
+                if ( detail::pick::testSegment ( ray, a, b, s_lo, s_hi, extra, t_hi, t, dist ) )
+                {
+                    offer ( best, &instance, PickPrimitive::Object, 0, t, dist );
+                }
+            };
+
+            switch ( object.type )
+            {
+                case NodeType::POINT_2D_FREE:
+                case NodeType::POINT_2D_MID:
+                case NodeType::POINT_2D_SECTION:
+                case NodeType::POINT_2D_INTERSECT:
+                    point ( data.point_2d.x, data.point_2d.y, 0.0, 0.0 );
+                    break;
+                case NodeType::POINT_2D_SNAP:
+                    point ( data.snap_2d.x, data.snap_2d.y, 0.0, 0.0 );
+                    break;
+                case NodeType::POINT_3D_FREE:
+                case NodeType::POINT_3D_MID:
+                case NodeType::POINT_3D_SECTION:
+                case NodeType::POINT_3D_INTERSECT:
+                    point ( data.point_3d.x, data.point_3d.y, data.point_3d.z, 0.0 );
+                    break;
+                case NodeType::POINT_3D_SNAP:
+                    point ( data.snap_3d.x, data.snap_3d.y, data.snap_3d.z, 0.0 );
+                    break;
+                case NodeType::SPHERE_3D:
+                case NodeType::SPHERE_3D_FOUR_POINTS:
+                    point ( data.sphere_3d.cx, data.sphere_3d.cy, data.sphere_3d.cz, data.sphere_3d.r * max_scale );
+                    break;
+                case NodeType::LINE_2D_SEGMENT:
+                case NodeType::LINE_2D_STRAIGHT:
+                case NodeType::LINE_2D_RAY:
+                case NodeType::LINE_2D_PERPENDICULAR:
+                case NodeType::LINE_2D_PARALLEL:
+                {
+                    const bool segment_only = object.type == NodeType::LINE_2D_SEGMENT;
+                    const bool ray_only = object.type == NodeType::LINE_2D_RAY;
+                    segment ( { data.line_2d.x0, data.line_2d.y0, 0.0 }, { data.line_2d.x1, data.line_2d.y1, 0.0 },
+                              segment_only || ray_only ? 0.0 : -inf, segment_only ? 1.0 : inf, 0.0 );
+                    break;
+                }
+                case NodeType::LINE_3D_SEGMENT:
+                case NodeType::LINE_3D_STRAIGHT:
+                case NodeType::LINE_3D_RAY:
+                case NodeType::LINE_3D_PERPENDICULAR:
+                case NodeType::LINE_3D_PARALLEL:
+                {
+                    const bool segment_only = object.type == NodeType::LINE_3D_SEGMENT;
+                    const bool ray_only = object.type == NodeType::LINE_3D_RAY;
+                    segment ( { data.line_3d.x0, data.line_3d.y0, data.line_3d.z0 },
+                              { data.line_3d.x1, data.line_3d.y1, data.line_3d.z1 },
+                              segment_only || ray_only ? 0.0 : -inf, segment_only ? 1.0 : inf, 0.0 );
+                    break;
+                }
+                case NodeType::CYLINDER_3D:
+                {
+                    // 按胶囊体近似：轴线段外扩半径
+                    const auto& c = data.cylinder_3d;
+                    segment ( { c.x0, c.y0, c.z0 }, { c.x1, c.y1, c.z1 }, 0.0, 1.0, c.r * max_scale );
+                    break;
+                }
+                case NodeType::CIRCLE_2D:
+                case NodeType::CIRCLE_2D_THREE_POINTS:
+                case NodeType::ARC_2D:
+                {
+                    // 圆周按 64 段折线逼近 (弦高误差约 0.12% 半径)，非等比缩放下自然变为椭圆
+                    constexpr int segments = 64;
+                    const auto& c = data.circle_2d;
+                    double prev[ 3 ] = { c.cx + c.r, c.cy, 0.0 };
+                    for ( int i = 1; i <= segments; ++i )
+                    {
+                        const double angle = 2.0 * 3.14159265358979323846 * i / segments;
+                        const double next[ 3 ] = { c.cx + c.r * std::cos ( angle ), c.cy + c.r * std::sin ( angle ), 0.0 };
+                        segment ( prev, next, 0.0, 1.0, 0.0 );
+                        std::copy ( std::begin ( next ), std::end ( next ), prev );
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    };
+}   // namespace StuCanvas
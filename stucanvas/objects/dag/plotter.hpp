@@ -11,6 +11,7 @@
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/blocked_range2d.h>
 #include <oneapi/tbb/blocked_range3d.h>
+#include <oneapi/tbb/enumerable_thread_specific.h>
 #include <oneapi/tbb/info.h>
 #include <oneapi/tbb/parallel_invoke.h>
 #include <oneapi/tbb/task_arena.h>
@@ -23,13 +24,124 @@
 #include <vector>
 
 #include "assets.hpp"   // 确保能访问到先前定义的 DAGAssets::PointCloud2D_SoA
+#include "block_deque.hpp"
 #include "function.hpp"
 #include "l_shade.hpp"   // 确保能访问到先前定义的 utils::optimization::l_shade
 #include "marching_cubes_tables.hpp"
+#include "profiling.hpp"
 namespace StuCanvas
 {
+    // =========================================================================
+    // 🚀 绘图器统计：每次调用返回一份，用于调整离散步长 / 深度上限 / 牛顿容差
+    // =========================================================================
+    // 💡 计数先在任务或线程局部累加，调用结束时合并一次，热循环内没有原子操作；
+    //    各绘图器只填写与自身算法相关的字段，其余保持 0。
+    //    IA 两阶段绘图器把第二阶段内部调用的统计一并累加进来。
+    struct PlotStats
+    {
+        uint64_t boxes_tested = 0;           // 参与有根判定的块 / 网格单元
+        uint64_t boxes_pruned = 0;           // 判定无根而剪掉的块
+        uint64_t leaves_reached = 0;         // 到达最小分辨率（或最大细分深度）的块
+        uint64_t newton_successes = 0;       // 牛顿投影即通过区间验证的叶块
+        uint64_t lshade_runs = 0;            // L-SHADE 启动次数（stuplot_implicit* 中即牛顿失败后的兜底次数）
+        uint64_t lshade_successes = 0;       // 兜底后通过区间验证的叶块
+        uint64_t lshade_evaluations = 0;     // L-SHADE 内部的代价函数评估次数
+        uint64_t scalar_evaluations = 0;     // 绘图器自身发起的标量函数求值
+        uint64_t interval_evaluations = 0;   // 区间函数求值
+        uint64_t primitives = 0;             // 输出的点 / 线段 / 三角形数
+
+        PlotStats& operator+= ( const PlotStats& o ) noexcept
+        {
+            boxes_tested += o.boxes_tested;
+            boxes_pruned += o.boxes_pruned;
+            leaves_reached += o.leaves_reached;
+            newton_successes += o.newton_successes;
+            lshade_runs += o.lshade_runs;
+            lshade_successes += o.lshade_successes;
+            lshade_evaluations += o.lshade_evaluations;
+            scalar_evaluations += o.scalar_evaluations;
+            interval_evaluations += o.interval_evaluations;
+            primitives += o.primitives;
+            return *this;
+        }
+    };
+
     namespace detail
     {
+        using PlotStatsSlots = oneapi::tbb::enumerable_thread_specific< PlotStats >;
+
+        inline PlotStats combine_stats ( const PlotStatsSlots& slots )
+        {
+            PlotStats total;
+            for ( const PlotStats& s : slots )
+            {
+                total += s;
+            }
+            return total;
+        }
+
+        // L-SHADE 调用 + 记录启动次数与实际评估次数
+        template < size_t Dimension, typename Cost >
+        inline std::array< double, Dimension > run_l_shade (
+            const Cost& cost, const utils::optimization::l_shade_parameters< double, Dimension >& params,
+            PlotStats& stats )
+        {
+            size_t evaluations = 0;
+            std::array< double, Dimension > best = utils::optimization::l_shade< double, Dimension > (
+                cost, params, std::numeric_limits< double >::quiet_NaN (), nullptr, nullptr, nullptr, &evaluations );
+            ++stats.lshade_runs;
+            stats.lshade_evaluations += evaluations;
+            return best;
+        }
+
+        // =========================================================================
+        // 🚀 并行绘图结果收集：各任务无锁追加到分段块队列，结束后一次性按块导出到 SoA 列
+        // （取代"局部缓冲 + out_mutex 合并"：合并不再串行，也不再多拷贝一遍）
+        // =========================================================================
+        using PointDeque2D = utils::ConcurrentBlockDeque< std::pair< double, double > >;
+        using SegmentDeque2D = utils::ConcurrentBlockDeque< std::array< std::pair< double, double >, 2 >, 512 >;
+
+        // 各列一次 resize 到位，再按块直接写入：无逐元素 push_back、无再分配
+        inline void export_to_soa ( const PointDeque2D& points, DAGAssets::PointCloud2D_SoA& out_cloud )
+        {
+            const size_t n = points.size ();
+            out_cloud.x.resize ( n );
+            out_cloud.y.resize ( n );
+            double* xs = out_cloud.x.data ();
+            double* ys = out_cloud.y.data ();
+            points.for_each_run (
+                [ & ] ( const std::pair< double, double >* run, size_t count, size_t first )
+                {
+                    for ( size_t i = 0; i < count; ++i )
+                    {
+                        xs[ first + i ] = run[ i ].first;
+                        ys[ first + i ] = run[ i ].second;
+                    }
+                } );
+        }
+
+        // 每条线段两个端点相邻存放，与原先 LineStrip2D_SoA 的成对布局一致
+        inline void export_to_soa ( const SegmentDeque2D& segments, DAGAssets::LineStrip2D_SoA& out_strip )
+        {
+            const size_t n = segments.size () * 2;
+            out_strip.x.resize ( n );
+            out_strip.y.resize ( n );
+            double* xs = out_strip.x.data ();
+            double* ys = out_strip.y.data ();
+            segments.for_each_run (
+                [ & ] ( const std::array< std::pair< double, double >, 2 >* run, size_t count, size_t first )
+                {
+                    for ( size_t i = 0; i < count; ++i )
+                    {
+                        const size_t o = ( first + i ) * 2;
+                        xs[ o ] = run[ i ][ 0 ].first;
+                        ys[ o ] = run[ i ][ 0 ].second;
+                        xs[ o + 1 ] = run[ i ][ 1 ].first;
+                        ys[ o + 1 ] = run[ i ][ 1 ].second;
+                    }
+                } );
+        }
+
         // =========================================================================
         // 🚀 零日志、全 TinyVector 驱动的自适应四叉树局部细分引擎
         // =========================================================================
@@ -37,9 +149,12 @@ namespace StuCanvas
                                          double y1, double y2, double min_w, double min_h,
                                          const utils::optimization::l_shade_parameters< double, 2 >& de_params,
                                          unsigned int max_threads, size_t depth, double g_xmin, double g_xmax,
-                                         double g_ymin, double g_ymax, DAGAssets::PointCloud2D_SoA& out_cloud,
-                                         std::mutex& out_mutex )
+                                         double g_ymin, double g_ymax, PointDeque2D& out_points,
+                                         PlotStatsSlots& stat_slots )
         {
+            PlotStats& stats = stat_slots.local ();
+            ++stats.boxes_tested;
+
             // 🚀 任务消峰限制：只在浅层（depth < 2）开启多线程并行分发，防止协程/线程爆炸
             constexpr size_t tbb_depth_threshold = 2;
             bool enable_tbb = ( depth < tbb_depth_threshold );
@@ -61,25 +176,25 @@ namespace StuCanvas
             auto cost_func = [ & ] ( double x, double y ) -> double { return std::abs ( f ( x, y ) ); };
 
             // 1. 运行高并发演化算法 L-SHADE 搜寻该区间内的残差极小值点
-            std::array< double, 2 > best_solution = utils::optimization::l_shade ( cost_func, params );
+            std::array< double, 2 > best_solution = run_l_shade ( cost_func, params, stats );
             double final_cost = std::abs ( f ( best_solution[ 0 ], best_solution[ 1 ] ) );
+            ++stats.scalar_evaluations;
 
             // 2. 判定当前区间是否存在根：唯一标准为数值小于 10^-5
             bool has_root = ( final_cost < 1e-5 );
 
             if ( !has_root )
             {
+                ++stats.boxes_pruned;
                 return;   // 无根，物理剪枝，直接退出
             }
 
             // 3. 达到最小分辨率限制，写入 SoA 容器配置结果并退出
             if ( ( x2 - x1 ) <= min_w && ( y2 - y1 ) <= min_h )
             {
-                std::scoped_lock lock ( out_mutex );
-
-                // 直接推入 SoA 扁平数组
-                out_cloud.x.push_back ( ( x1 + x2 ) / 2.0 );
-                out_cloud.y.push_back ( ( y1 + y2 ) / 2.0 );
+                // 叶子结果零散且稀少：共享尾块上原子领取槽位，无锁推入
+                out_points.emplace_back ( ( x1 + x2 ) / 2.0, ( y1 + y2 ) / 2.0 );
+                ++stats.leaves_reached;
                 return;
             }
 
@@ -104,41 +219,41 @@ namespace StuCanvas
                     {
                         subdivide_quadtree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( y1 - dy ),
                                              clamp_y ( cy + dy ), min_w, min_h, de_params, max_threads, depth + 1,
-                                             g_xmin, g_xmax, g_ymin, g_ymax, out_cloud, out_mutex );
+                                             g_xmin, g_xmax, g_ymin, g_ymax, out_points, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_quadtree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( y1 - dy ),
                                              clamp_y ( cy + dy ), min_w, min_h, de_params, max_threads, depth + 1,
-                                             g_xmin, g_xmax, g_ymin, g_ymax, out_cloud, out_mutex );
+                                             g_xmin, g_xmax, g_ymin, g_ymax, out_points, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_quadtree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( cy - dy ),
                                              clamp_y ( y2 + dy ), min_w, min_h, de_params, max_threads, depth + 1,
-                                             g_xmin, g_xmax, g_ymin, g_ymax, out_cloud, out_mutex );
+                                             g_xmin, g_xmax, g_ymin, g_ymax, out_points, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_quadtree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( cy - dy ),
                                              clamp_y ( y2 + dy ), min_w, min_h, de_params, max_threads, depth + 1,
-                                             g_xmin, g_xmax, g_ymin, g_ymax, out_cloud, out_mutex );
+                                             g_xmin, g_xmax, g_ymin, g_ymax, out_points, stat_slots );
                     } );
             }
             else
             {
                 subdivide_quadtree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( y1 - dy ),
                                      clamp_y ( cy + dy ), min_w, min_h, de_params, max_threads, depth + 1, g_xmin,
-                                     g_xmax, g_ymin, g_ymax, out_cloud, out_mutex );
+                                     g_xmax, g_ymin, g_ymax, out_points, stat_slots );
                 subdivide_quadtree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( y1 - dy ),
                                      clamp_y ( cy + dy ), min_w, min_h, de_params, max_threads, depth + 1, g_xmin,
-                                     g_xmax, g_ymin, g_ymax, out_cloud, out_mutex );
+                                     g_xmax, g_ymin, g_ymax, out_points, stat_slots );
                 subdivide_quadtree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( cy - dy ),
                                      clamp_y ( y2 + dy ), min_w, min_h, de_params, max_threads, depth + 1, g_xmin,
-                                     g_xmax, g_ymin, g_ymax, out_cloud, out_mutex );
+                                     g_xmax, g_ymin, g_ymax, out_points, stat_slots );
                 subdivide_quadtree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( cy - dy ),
                                      clamp_y ( y2 + dy ), min_w, min_h, de_params, max_threads, depth + 1, g_xmin,
-                                     g_xmax, g_ymin, g_ymax, out_cloud, out_mutex );
+                                     g_xmax, g_ymin, g_ymax, out_points, stat_slots );
             }
         }
 
@@ -147,14 +262,14 @@ namespace StuCanvas
     // =========================================================================
     // 🚀 外部调用主接口 (完全零冗余、对齐项目最优解)
     // =========================================================================
-    inline void plotImplicit2D ( const utils::StuFunction< double ( double, double ) >& f, double min_block_width,
-                                 double min_block_height,
-                                 const utils::optimization::l_shade_parameters< double, 2 >& de_params,
-                                 DAGAssets::PointCloud2D_SoA& out_cloud )
+    inline PlotStats plotImplicit2D ( const utils::StuFunction< double ( double, double ) >& f,
+                                      double min_block_width, double min_block_height,
+                                      const utils::optimization::l_shade_parameters< double, 2 >& de_params,
+                                      DAGAssets::PointCloud2D_SoA& out_cloud )
     {
-        out_cloud.x.clear ();
-        out_cloud.y.clear ();
-        std::mutex out_mutex;
+        STU_PROFILE_ZONE ( "plotImplicit2D" );
+        detail::PointDeque2D points;
+        detail::PlotStatsSlots stat_slots;
 
         // 🚀 0 冗余提取：直接从描述参数 de_params 中自适应读取初始世界边界和物理线程配置
         double x_min = de_params.lower_bounds[ 0 ];
@@ -176,8 +291,14 @@ namespace StuCanvas
                 detail::subdivide_quadtree ( f, x_min, x_max, y_min, y_max, min_block_width, min_block_height,
                                              de_params, max_threads,
                                              0,   // 初始深度为 0
-                                             x_min, x_max, y_min, y_max, out_cloud, out_mutex );
+                                             x_min, x_max, y_min, y_max, points, stat_slots );
             } );
+
+        detail::export_to_soa ( points, out_cloud );
+
+        PlotStats stats = detail::combine_stats ( stat_slots );
+        stats.primitives = points.size ();
+        return stats;
     }
     namespace detail
     {
@@ -190,8 +311,12 @@ namespace StuCanvas
                                        const utils::optimization::l_shade_parameters< double, 3 >& de_params,
                                        unsigned int max_threads, size_t depth, double g_xmin, double g_xmax,
                                        double g_ymin, double g_ymax, double g_zmin, double g_zmax,
-                                       DAGAssets::PointCloud3D_SoA& out_cloud, std::mutex& out_mutex )
+                                       DAGAssets::PointCloud3D_SoA& out_cloud, std::mutex& out_mutex,
+                                       PlotStatsSlots& stat_slots )
         {
+            PlotStats& stats = stat_slots.local ();
+            ++stats.boxes_tested;
+
             // 🚀 八叉树专用任务消峰：由于 8 分裂因子极大，仅在 depth < 1 处并行即可完美榨干 CPU
             constexpr size_t tbb_depth_threshold = 1;
             bool enable_tbb = ( depth < tbb_depth_threshold );
@@ -211,14 +336,16 @@ namespace StuCanvas
             auto cost_func = [ & ] ( double x, double y, double z ) -> double { return std::abs ( f ( x, y, z ) ); };
 
             // 1. 运行三维高并发演化算法 L-SHADE 搜寻该立方体内是否存在曲面根
-            std::array< double, 3 > best_solution = utils::optimization::l_shade ( cost_func, params );
+            std::array< double, 3 > best_solution = run_l_shade ( cost_func, params, stats );
             double final_cost = std::abs ( f ( best_solution[ 0 ], best_solution[ 1 ], best_solution[ 2 ] ) );
+            ++stats.scalar_evaluations;
 
             // 2. 判定当前立方体区间是否存在根：唯一标准为数值小于 10^-5
             bool has_root = ( final_cost < 1e-5 );
 
             if ( !has_root )
             {
+                ++stats.boxes_pruned;
                 return;   // 无根，物理剪枝，直接退出
             }
 
@@ -231,6 +358,7 @@ namespace StuCanvas
                 out_cloud.x.push_back ( ( x1 + x2 ) / 2.0 );
                 out_cloud.y.push_back ( ( y1 + y2 ) / 2.0 );
                 out_cloud.z.push_back ( ( z1 + z2 ) / 2.0 );
+                ++stats.leaves_reached;
                 return;
             }
 
@@ -260,56 +388,56 @@ namespace StuCanvas
                         subdivide_octree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( y1 - dy ),
                                            clamp_y ( cy + dy ), clamp_z ( z1 - dz ), clamp_z ( cz + dz ), min_w, min_h,
                                            min_d, de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax,
-                                           g_zmin, g_zmax, out_cloud, out_mutex );
+                                           g_zmin, g_zmax, out_cloud, out_mutex, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_octree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( y1 - dy ),
                                            clamp_y ( cy + dy ), clamp_z ( z1 - dz ), clamp_z ( cz + dz ), min_w, min_h,
                                            min_d, de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax,
-                                           g_zmin, g_zmax, out_cloud, out_mutex );
+                                           g_zmin, g_zmax, out_cloud, out_mutex, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_octree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( cy - dy ),
                                            clamp_y ( y2 + dy ), clamp_z ( z1 - dz ), clamp_z ( cz + dz ), min_w, min_h,
                                            min_d, de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax,
-                                           g_zmin, g_zmax, out_cloud, out_mutex );
+                                           g_zmin, g_zmax, out_cloud, out_mutex, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_octree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( cy - dy ),
                                            clamp_y ( y2 + dy ), clamp_z ( z1 - dz ), clamp_z ( cz + dz ), min_w, min_h,
                                            min_d, de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax,
-                                           g_zmin, g_zmax, out_cloud, out_mutex );
+                                           g_zmin, g_zmax, out_cloud, out_mutex, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_octree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( y1 - dy ),
                                            clamp_y ( cy + dy ), clamp_z ( cz - dz ), clamp_z ( z2 + dz ), min_w, min_h,
                                            min_d, de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax,
-                                           g_zmin, g_zmax, out_cloud, out_mutex );
+                                           g_zmin, g_zmax, out_cloud, out_mutex, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_octree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( y1 - dy ),
                                            clamp_y ( cy + dy ), clamp_z ( cz - dz ), clamp_z ( z2 + dz ), min_w, min_h,
                                            min_d, de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax,
-                                           g_zmin, g_zmax, out_cloud, out_mutex );
+                                           g_zmin, g_zmax, out_cloud, out_mutex, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_octree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( cy - dy ),
                                            clamp_y ( y2 + dy ), clamp_z ( cz - dz ), clamp_z ( z2 + dz ), min_w, min_h,
                                            min_d, de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax,
-                                           g_zmin, g_zmax, out_cloud, out_mutex );
+                                           g_zmin, g_zmax, out_cloud, out_mutex, stat_slots );
                     },
                     [ & ] ()
                     {
                         subdivide_octree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( cy - dy ),
                                            clamp_y ( y2 + dy ), clamp_z ( cz - dz ), clamp_z ( z2 + dz ), min_w, min_h,
                                            min_d, de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax,
-                                           g_zmin, g_zmax, out_cloud, out_mutex );
+                                           g_zmin, g_zmax, out_cloud, out_mutex, stat_slots );
                     } );
             }
             else
@@ -317,35 +445,35 @@ namespace StuCanvas
                 subdivide_octree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( y1 - dy ),
                                    clamp_y ( cy + dy ), clamp_z ( z1 - dz ), clamp_z ( cz + dz ), min_w, min_h, min_d,
                                    de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax, g_zmin, g_zmax,
-                                   out_cloud, out_mutex );
+                                   out_cloud, out_mutex, stat_slots );
                 subdivide_octree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( y1 - dy ),
                                    clamp_y ( cy + dy ), clamp_z ( z1 - dz ), clamp_z ( cz + dz ), min_w, min_h, min_d,
                                    de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax, g_zmin, g_zmax,
-                                   out_cloud, out_mutex );
+                                   out_cloud, out_mutex, stat_slots );
                 subdivide_octree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( cy - dy ),
                                    clamp_y ( y2 + dy ), clamp_z ( z1 - dz ), clamp_z ( cz + dz ), min_w, min_h, min_d,
                                    de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax, g_zmin, g_zmax,
-                                   out_cloud, out_mutex );
+                                   out_cloud, out_mutex, stat_slots );
                 subdivide_octree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( cy - dy ),
                                    clamp_y ( y2 + dy ), clamp_z ( z1 - dz ), clamp_z ( cz + dz ), min_w, min_h, min_d,
                                    de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax, g_zmin, g_zmax,
-                                   out_cloud, out_mutex );
+                                   out_cloud, out_mutex, stat_slots );
                 subdivide_octree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( y1 - dy ),
                                    clamp_y ( cy + dy ), clamp_z ( cz - dz ), clamp_z ( z2 + dz ), min_w, min_h, min_d,
                                    de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax, g_zmin, g_zmax,
-                                   out_cloud, out_mutex );
+                                   out_cloud, out_mutex, stat_slots );
                 subdivide_octree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( y1 - dy ),
                                    clamp_y ( cy + dy ), clamp_z ( cz - dz ), clamp_z ( z2 + dz ), min_w, min_h, min_d,
                                    de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax, g_zmin, g_zmax,
-                                   out_cloud, out_mutex );
+                                   out_cloud, out_mutex, stat_slots );
                 subdivide_octree ( f, clamp_x ( x1 - dx ), clamp_x ( cx + dx ), clamp_y ( cy - dy ),
                                    clamp_y ( y2 + dy ), clamp_z ( cz - dz ), clamp_z ( z2 + dz ), min_w, min_h, min_d,
                                    de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax, g_zmin, g_zmax,
-                                   out_cloud, out_mutex );
+                                   out_cloud, out_mutex, stat_slots );
                 subdivide_octree ( f, clamp_x ( cx - dx ), clamp_x ( x2 + dx ), clamp_y ( cy - dy ),
                                    clamp_y ( y2 + dy ), clamp_z ( cz - dz ), clamp_z ( z2 + dz ), min_w, min_h, min_d,
                                    de_params, max_threads, depth + 1, g_xmin, g_xmax, g_ymin, g_ymax, g_zmin, g_zmax,
-                                   out_cloud, out_mutex );
+                                   out_cloud, out_mutex, stat_slots );
             }
         }
 
@@ -354,11 +482,13 @@ namespace StuCanvas
     // =========================================================================
     // 🚀 外部调用主接口 (完全零冗余、对齐 3D 几何处理最优解)
     // =========================================================================
-    inline void plotImplicit3D ( const utils::StuFunction< double ( double, double, double ) >& f,
-                                 double min_block_width, double min_block_height, double min_block_depth,
-                                 const utils::optimization::l_shade_parameters< double, 3 >& de_params,
-                                 DAGAssets::PointCloud3D_SoA& out_cloud )
+    inline PlotStats plotImplicit3D ( const utils::StuFunction< double ( double, double, double ) >& f,
+                                      double min_block_width, double min_block_height, double min_block_depth,
+                                      const utils::optimization::l_shade_parameters< double, 3 >& de_params,
+                                      DAGAssets::PointCloud3D_SoA& out_cloud )
     {
+        STU_PROFILE_ZONE ( "plotImplicit3D" );
+        detail::PlotStatsSlots stat_slots;
         out_cloud.x.clear ();
         out_cloud.y.clear ();
         out_cloud.z.clear ();
@@ -386,8 +516,13 @@ namespace StuCanvas
                 detail::subdivide_octree ( f, x_min, x_max, y_min, y_max, z_min, z_max, min_block_width,
                                            min_block_height, min_block_depth, de_params, max_threads,
                                            0,   // 初始深度为 0
-                                           x_min, x_max, y_min, y_max, z_min, z_max, out_cloud, out_mutex );
+                                           x_min, x_max, y_min, y_max, z_min, z_max, out_cloud, out_mutex,
+                                           stat_slots );
             } );
+
+        PlotStats stats = detail::combine_stats ( stat_slots );
+        stats.primitives = out_cloud.x.size ();
+        return stats;
     }
     namespace detail
     {
@@ -405,7 +540,7 @@ namespace StuCanvas
 
         // 🚀 叶子节点：标准的 16 种状态 Marching Squares 拓扑生成器
         inline void generate_segments ( double x1, double x2, double y1, double y2, double v00, double v10, double v11,
-                                        double v01, DAGAssets::LineStrip2D_SoA& out_strip, std::mutex& out_mutex )
+                                        double v01, SegmentDeque2D::Writer& out_segments )
         {
             // 通过四角正负状态计算出 0~15 的拓扑状态索引
             int index = ( v00 < 0.0 ? 1 : 0 ) | ( v10 < 0.0 ? 2 : 0 ) | ( v11 < 0.0 ? 4 : 0 ) | ( v01 < 0.0 ? 8 : 0 );
@@ -501,19 +636,11 @@ namespace StuCanvas
                     break;
             }
 
+            // 写入本线程独占的块，无锁
+            out_segments.emplace_back ( std::array< std::pair< double, double >, 2 > { s1, s2 } );
+            if ( double_line )
             {
-                std::scoped_lock lock ( out_mutex );
-                out_strip.x.push_back ( s1.first );
-                out_strip.y.push_back ( s1.second );
-                out_strip.x.push_back ( s2.first );
-                out_strip.y.push_back ( s2.second );
-                if ( double_line )
-                {
-                    out_strip.x.push_back ( s3.first );
-                    out_strip.y.push_back ( s3.second );
-                    out_strip.x.push_back ( s4.first );
-                    out_strip.y.push_back ( s4.second );
-                }
+                out_segments.emplace_back ( std::array< std::pair< double, double >, 2 > { s3, s4 } );
             }
         }
 
@@ -521,12 +648,13 @@ namespace StuCanvas
         inline void marching_squares_subdivide ( const utils::StuFunction< double ( double, double ) >& f, double x1,
                                                  double x2, double y1, double y2, double v00, double v10, double v11,
                                                  double v01, size_t depth, size_t max_depth,
-                                                 DAGAssets::LineStrip2D_SoA& out_strip, std::mutex& out_mutex )
+                                                 SegmentDeque2D::Writer& out_segments, PlotStats& stats )
         {
             // 达到极限细分深度，停止细分，直接插值出高精度的线段几何
             if ( depth == max_depth )
             {
-                generate_segments ( x1, x2, y1, y2, v00, v10, v11, v01, out_strip, out_mutex );
+                ++stats.leaves_reached;
+                generate_segments ( x1, x2, y1, y2, v00, v10, v11, v01, out_segments );
                 return;
             }
 
@@ -539,6 +667,7 @@ namespace StuCanvas
             double vt = f ( cx, y2 );
             double vl = f ( x1, cy );
             double vr = f ( x2, cy );
+            stats.scalar_evaluations += 5;
 
             // 检查 4 个子网格中哪些跨越零点（有根），选择性开启下一级细分（Narrow-band 降维打击）
             auto check_root = [] ( double a, double b, double c, double d ) -> bool
@@ -546,30 +675,36 @@ namespace StuCanvas
                 return !( ( a >= 0.0 && b >= 0.0 && c >= 0.0 && d >= 0.0 ) ||
                           ( a < 0.0 && b < 0.0 && c < 0.0 && d < 0.0 ) );
             };
+            const bool root_lb = check_root ( v00, vb, vc, vl );
+            const bool root_rb = check_root ( vb, v10, vr, vc );
+            const bool root_lt = check_root ( vl, vc, vt, v01 );
+            const bool root_rt = check_root ( vc, vr, v11, vt );
+            stats.boxes_tested += 4;
+            stats.boxes_pruned += 4u - ( root_lb + root_rb + root_lt + root_rt );
 
             // 1. 左下子格 [x1, cx] x [y1, cy]
-            if ( check_root ( v00, vb, vc, vl ) )
+            if ( root_lb )
             {
-                marching_squares_subdivide ( f, x1, cx, y1, cy, v00, vb, vc, vl, depth + 1, max_depth, out_strip,
-                                             out_mutex );
+                marching_squares_subdivide ( f, x1, cx, y1, cy, v00, vb, vc, vl, depth + 1, max_depth, out_segments,
+                                             stats );
             }
             // 2. 右下子格 [cx, x2] x [y1, cy]
-            if ( check_root ( vb, v10, vr, vc ) )
+            if ( root_rb )
             {
-                marching_squares_subdivide ( f, cx, x2, y1, cy, vb, v10, vr, vc, depth + 1, max_depth, out_strip,
-                                             out_mutex );
+                marching_squares_subdivide ( f, cx, x2, y1, cy, vb, v10, vr, vc, depth + 1, max_depth, out_segments,
+                                             stats );
             }
             // 3. 左上子格 [x1, cx] x [cy, y2]
-            if ( check_root ( vl, vc, vt, v01 ) )
+            if ( root_lt )
             {
-                marching_squares_subdivide ( f, x1, cx, cy, y2, vl, vc, vt, v01, depth + 1, max_depth, out_strip,
-                                             out_mutex );
+                marching_squares_subdivide ( f, x1, cx, cy, y2, vl, vc, vt, v01, depth + 1, max_depth, out_segments,
+                                             stats );
             }
             // 4. 右上子格 [cx, x2] x [cy, y2]
-            if ( check_root ( vc, vr, v11, vt ) )
+            if ( root_rt )
             {
-                marching_squares_subdivide ( f, cx, x2, cy, y2, vc, vr, v11, vt, depth + 1, max_depth, out_strip,
-                                             out_mutex );
+                marching_squares_subdivide ( f, cx, x2, cy, y2, vc, vr, v11, vt, depth + 1, max_depth, out_segments,
+                                             stats );
             }
         }
 
@@ -578,15 +713,18 @@ namespace StuCanvas
     // =========================================================================
     // 🚀 外部调用主接口 (分层并行、共享角0重复计算、完全解耦)
     // =========================================================================
-    inline void marchingSquares2D ( const utils::StuFunction< double ( double, double ) >& f, double x_min,
-                                    double x_max, double y_min, double y_max,
-                                    double step,                      // 粗网格离散步长
-                                    uint32_t max_subdivision_depth,   // 最大自适应 2x2 细分深度
-                                    unsigned int threads, DAGAssets::LineStrip2D_SoA& out_strip )
+    inline PlotStats marchingSquares2D ( const utils::StuFunction< double ( double, double ) >& f, double x_min,
+                                         double x_max, double y_min, double y_max,
+                                         double step,                      // 粗网格离散步长
+                                         uint32_t max_subdivision_depth,   // 最大自适应 2x2 细分深度
+                                         unsigned int threads, DAGAssets::LineStrip2D_SoA& out_strip )
     {
-        out_strip.x.clear ();
-        out_strip.y.clear ();
-        std::mutex out_mutex;
+        STU_PROFILE_ZONE ( "marchingSquares2D" );
+        detail::SegmentDeque2D segments;
+        detail::PlotStatsSlots stat_slots;
+        // 每个工作线程一个写入器：跨任务复用同一块，整个绘制期间每线程至多一个未写满的块
+        oneapi::tbb::enumerable_thread_specific< detail::SegmentDeque2D::Writer > writers (
+            [ & ] () { return segments.writer (); } );
 
         // 计算粗网格行列数
         size_t M = std::max ( size_t ( 1 ), static_cast< size_t > ( std::round ( ( x_max - x_min ) / step ) ) );
@@ -606,8 +744,9 @@ namespace StuCanvas
             [ & ] ()
             {
                 // 🚀 核心优化：分配一个一维扁平缓存，用于暂存 (M+1) * (N+1) 个粗网格顶点的值
-                utils::TinyVector< double > grid_values;
-                grid_values.resize ( static_cast< uint32_t > ( ( M + 1 ) * ( N + 1 ) ) );
+                // 稠密采样网格 (M+1)(N+1) 可能超过 2^32，使用 64 位计数的 TinyVector
+                utils::TinyVector64< double > grid_values;
+                grid_values.resize ( static_cast< size_t > ( M + 1 ) * ( N + 1 ) );
 
                 // 🚀 核心优化：并行的、无任何重复地计算所有共享角顶点的值，物理上每个格点仅求值 1 次！
                 oneapi::tbb::parallel_for ( oneapi::tbb::blocked_range< size_t > ( 0, M + 1 ),
@@ -630,6 +769,9 @@ namespace StuCanvas
                     oneapi::tbb::blocked_range2d< size_t > ( 0, M, 0, N ),
                     [ & ] ( const oneapi::tbb::blocked_range2d< size_t >& r )
                     {
+                        auto& out_segments = writers.local ();
+                        PlotStats& stats = stat_slots.local ();
+                        uint64_t crossing_cells = 0;
                         for ( size_t i = r.rows ().begin (); i != r.rows ().end (); ++i )
                         {
                             double x1 = x_min + i * dx;
@@ -654,14 +796,30 @@ namespace StuCanvas
 
                                 if ( has_root )
                                 {
+                                    ++crossing_cells;
                                     detail::marching_squares_subdivide ( f, x1, x2, y1, y2, v00, v10, v11, v01,
                                                                          0,   // 初始深度为 0
-                                                                         max_subdivision_depth, out_strip, out_mutex );
+                                                                         max_subdivision_depth, out_segments, stats );
                                 }
                             }
                         }
+                        const uint64_t cells = r.rows ().size () * r.cols ().size ();
+                        stats.boxes_tested += cells;
+                        stats.boxes_pruned += cells - crossing_cells;
                     } );
             } );
+
+        // 所有任务已结束：公布各写入器最后一块的进度，按块一次性导出
+        for ( auto& writer : writers )
+        {
+            writer.flush ();
+        }
+        detail::export_to_soa ( segments, out_strip );
+
+        PlotStats stats = detail::combine_stats ( stat_slots );
+        stats.scalar_evaluations += static_cast< uint64_t > ( M + 1 ) * ( N + 1 );
+        stats.primitives = segments.size ();
+        return stats;
     }
     struct Point3D
     {
@@ -672,6 +830,38 @@ namespace StuCanvas
 
     namespace detail
     {
+        // 每个元素是一个独立三角形的三个顶点
+        using TriangleDeque3D = utils::ConcurrentBlockDeque< std::array< Point3D, 3 > >;
+
+        // 三角形顶点互不共享：第 k 个顶点的索引就是 k，导出时顺序写出即可
+        inline void export_to_soa ( const TriangleDeque3D& triangles, DAGAssets::TriangleMesh3D_SoA& out_mesh )
+        {
+            const size_t n = triangles.size () * 3;
+            out_mesh.x.resize ( n );
+            out_mesh.y.resize ( n );
+            out_mesh.z.resize ( n );
+            out_mesh.indices.resize ( n );
+            double* xs = out_mesh.x.data ();
+            double* ys = out_mesh.y.data ();
+            double* zs = out_mesh.z.data ();
+            uint32_t* idx = out_mesh.indices.data ();
+            triangles.for_each_run (
+                [ & ] ( const std::array< Point3D, 3 >* run, size_t count, size_t first )
+                {
+                    for ( size_t t = 0; t < count; ++t )
+                    {
+                        for ( size_t v = 0; v < 3; ++v )
+                        {
+                            const size_t o = ( first + t ) * 3 + v;
+                            xs[ o ] = run[ t ][ v ].x;
+                            ys[ o ] = run[ t ][ v ].y;
+                            zs[ o ] = run[ t ][ v ].z;
+                            idx[ o ] = static_cast< uint32_t > ( o );
+                        }
+                    }
+                } );
+        }
+
         // 🚀 线性插值器：计算等值面在网格边界上的精确过零点
         inline Point3D interpolate ( double xa, double ya, double za, double va, double xb, double yb, double zb,
                                      double vb ) noexcept
@@ -688,7 +878,7 @@ namespace StuCanvas
         //    (完全对齐您的 char 类型 triTable，0 窄化警告)
         inline void generate_cube_triangles ( double x1, double x2, double y1, double y2, double z1, double z2,
                                               double v0, double v1, double v2, double v3, double v4, double v5,
-                                              double v6, double v7, DAGAssets::TriangleMesh3D_SoA& local_mesh )
+                                              double v6, double v7, TriangleDeque3D::Writer& out_triangles )
         {
             // 通过 8 顶点正负状态计算出 0~255 的拓扑状态码
             int cubeindex = 0;
@@ -782,47 +972,33 @@ namespace StuCanvas
                 vertlist[ 11 ] = interpolate ( x1, y2, z1, v3, x1, y2, z2, v7 );
             }
 
-            // 零开销面片拓扑连接并暂存入局部缓存
+            // 零开销面片拓扑连接，直接写入本线程独占的块
             for ( int i = 0; triTable[ cubeindex ][ i ] != -1; i += 3 )
             {
-                Point3D pA = vertlist[ static_cast< size_t > ( triTable[ cubeindex ][ i ] ) ];
-                Point3D pB = vertlist[ static_cast< size_t > ( triTable[ cubeindex ][ i + 1 ] ) ];
-                Point3D pC = vertlist[ static_cast< size_t > ( triTable[ cubeindex ][ i + 2 ] ) ];
-
-                uint32_t base_idx = static_cast< uint32_t > ( local_mesh.x.size () );
-                local_mesh.x.push_back ( pA.x );
-                local_mesh.y.push_back ( pA.y );
-                local_mesh.z.push_back ( pA.z );
-
-                local_mesh.x.push_back ( pB.x );
-                local_mesh.y.push_back ( pB.y );
-                local_mesh.z.push_back ( pB.z );
-
-                local_mesh.x.push_back ( pC.x );
-                local_mesh.y.push_back ( pC.y );
-                local_mesh.z.push_back ( pC.z );
-
-                local_mesh.indices.push_back ( base_idx );
-                local_mesh.indices.push_back ( base_idx + 1 );
-                local_mesh.indices.push_back ( base_idx + 2 );
+                out_triangles.emplace_back ( std::array< Point3D, 3 > {
+                    vertlist[ static_cast< size_t > ( triTable[ cubeindex ][ i ] ) ],
+                    vertlist[ static_cast< size_t > ( triTable[ cubeindex ][ i + 1 ] ) ],
+                    vertlist[ static_cast< size_t > ( triTable[ cubeindex ][ i + 2 ] ) ] } );
             }
         }
 
     }   // namespace detail
 
     // =========================================================================
-    // 🚀 外部调用主接口 (分层并行、共享角0重复计算、2x2x2 极速细分、HPC 局部锁合并)
+    // 🚀 外部调用主接口 (分层并行、共享角0重复计算、2x2x2 极速细分、按线程分块无锁收集)
     // =========================================================================
-    inline void marchingCubes3D ( const utils::StuFunction< double ( double, double, double ) >& f, double x_min,
-                                  double x_max, double y_min, double y_max, double z_min, double z_max,
-                                  double step,   // 粗网格离散步长
-                                  unsigned int threads, DAGAssets::TriangleMesh3D_SoA& out_mesh )
+    inline PlotStats marchingCubes3D ( const utils::StuFunction< double ( double, double, double ) >& f,
+                                       double x_min, double x_max, double y_min, double y_max, double z_min,
+                                       double z_max,
+                                       double step,   // 粗网格离散步长
+                                       unsigned int threads, DAGAssets::TriangleMesh3D_SoA& out_mesh )
     {
-        out_mesh.x.clear ();
-        out_mesh.y.clear ();
-        out_mesh.z.clear ();
-        out_mesh.indices.clear ();
-        std::mutex out_mutex;
+        STU_PROFILE_ZONE ( "marchingCubes3D" );
+        detail::TriangleDeque3D triangles;
+        detail::PlotStatsSlots stat_slots;
+        // 每个工作线程一个写入器，跨任务复用；合并阶段不再需要互斥锁
+        oneapi::tbb::enumerable_thread_specific< detail::TriangleDeque3D::Writer > writers (
+            [ & ] () { return triangles.writer (); } );
 
         // 计算粗网格行列数
         size_t M = std::max ( size_t ( 1 ), static_cast< size_t > ( std::round ( ( x_max - x_min ) / step ) ) );
@@ -844,8 +1020,9 @@ namespace StuCanvas
             [ & ] ()
             {
                 // 1. 连续扁平排布缓冲区：存储所有 (M+1) * (N+1) * (K+1) 个粗网格交点的值
-                utils::TinyVector< double > grid_values;
-                grid_values.resize ( static_cast< uint32_t > ( ( M + 1 ) * ( N + 1 ) * ( K + 1 ) ) );
+                // (M+1)(N+1)(K+1) 在高分辨率下极易越过 2^32，使用 64 位计数的 TinyVector
+                utils::TinyVector64< double > grid_values;
+                grid_values.resize ( static_cast< size_t > ( M + 1 ) * ( N + 1 ) * ( K + 1 ) );
 
                 // 1.1 并行、零重复计算所有共享角顶点的值
                 oneapi::tbb::parallel_for ( oneapi::tbb::blocked_range2d< size_t > ( 0, M + 1, 0, N + 1 ),
@@ -873,8 +1050,9 @@ namespace StuCanvas
                     oneapi::tbb::blocked_range3d< size_t > ( 0, M, 0, N, 0, K ),
                     [ & ] ( const oneapi::tbb::blocked_range3d< size_t >& r )
                     {
-                        // 🚀 核心：为每个并发任务建立局部 thread-safe 缓冲网格，彻底消灭内存锁冲突！
-                        DAGAssets::TriangleMesh3D_SoA local_mesh;
+                        // 🚀 核心：当前工作线程独占的写入器，三角形直接落入最终存储，无局部缓冲、无锁合并
+                        auto& out_triangles = writers.local ();
+                        uint64_t crossing_cells = 0;
 
                         for ( size_t i = r.pages ().begin (); i != r.pages ().end (); ++i )
                         {
@@ -915,6 +1093,7 @@ namespace StuCanvas
 
                                     if ( has_root )
                                     {
+                                        ++crossing_cells;
                                         // 🚀 3. 触发 2x2x2 局部极速细分（共 8 个子立方体单元）
                                         // 细分网格交点数仅为 3 * 3 * 3 = 27 个，在栈上分配，内存极其紧凑
                                         std::array< double, 27 > sub_grid;
@@ -972,7 +1151,7 @@ namespace StuCanvas
 
                                                     detail::generate_cube_triangles ( sx1, sx2, sy1, sy2, sz1, sz2, sv0,
                                                                                       sv1, sv2, sv3, sv4, sv5, sv6, sv7,
-                                                                                      local_mesh );
+                                                                                      out_triangles );
                                                 }
                                             }
                                         }
@@ -981,36 +1160,42 @@ namespace StuCanvas
                             }
                         }
 
-                        // 🚀 合流：将当前子任务的所有局部数据一次性原子写入全局 out_mesh，吞吐量达到瓶颈极限
-                        if ( !local_mesh.x.empty () )
-                        {
-                            std::scoped_lock lock ( out_mutex );
-                            uint32_t global_base = static_cast< uint32_t > ( out_mesh.x.size () );
-
-                            // 利用 TinyVector 的 append 接口批量拷贝，0 多余内存分配
-                            out_mesh.x.append ( local_mesh.x );
-                            out_mesh.y.append ( local_mesh.y );
-                            out_mesh.z.append ( local_mesh.z );
-
-                            for ( uint32_t idx : local_mesh.indices )
-                            {
-                                out_mesh.indices.push_back ( global_base + idx );
-                            }
-                        }
+                        // 每个跨零单元：27 次细分采样，8 个子立方体直接出面片
+                        PlotStats& stats = stat_slots.local ();
+                        const uint64_t cells = r.pages ().size () * r.rows ().size () * r.cols ().size ();
+                        stats.boxes_tested += cells;
+                        stats.boxes_pruned += cells - crossing_cells;
+                        stats.leaves_reached += 8 * crossing_cells;
+                        stats.scalar_evaluations += 27 * crossing_cells;
                     } );
             } );
+
+        for ( auto& writer : writers )
+        {
+            writer.flush ();
+        }
+        detail::export_to_soa ( triangles, out_mesh );
+
+        PlotStats stats = detail::combine_stats ( stat_slots );
+        stats.scalar_evaluations += static_cast< uint64_t > ( M + 1 ) * ( N + 1 ) * ( K + 1 );
+        stats.primitives = triangles.size ();
+        return stats;
     }
-    inline void stuplot_implicit2D (
+    inline PlotStats stuplot_implicit2D (
         const utils::StuFunction< double ( double, double ) >& scalar_fn,
         const utils::StuFunction< utils::IntervalSet< double > ( const utils::IntervalSet< double >&,
                                                                  const utils::IntervalSet< double >& ) >& interval_fn,
         const DAGAssets::LShade& de_params, double x_min, double x_max, double y_min, double y_max,
         double min_block_width, double min_block_height, double epsilon, DAGAssets::PointCloud2D_SoA& out_cloud )
     {
+        STU_PROFILE_ZONE ( "stuplot_implicit2D" );
+
         // 清理输出缓冲区
         out_cloud.x.clear ();
         out_cloud.y.clear ();
         std::mutex out_mutex;
+        PlotStats stats;
+        detail::PlotStatsSlots stat_slots;
 
         // 内部物理内存块
         struct Box
@@ -1034,10 +1219,13 @@ namespace StuCanvas
             auto ix = utils::IntervalSet< double > ( utils::Interval< double > ( t.x0, t.x1 ) );
             auto iy = utils::IntervalSet< double > ( utils::Interval< double > ( t.y0, t.y1 ) );
             auto res_ia = interval_fn ( ix, iy );
+            ++stats.boxes_tested;
+            ++stats.interval_evaluations;
 
             // 若本块绝对不可能有根，物理剪枝
             if ( !utils::detals::possible_root ( res_ia ) )
             {
+                ++stats.boxes_pruned;
                 continue;
             }
 
@@ -1056,12 +1244,13 @@ namespace StuCanvas
             {
                 // 抵达分辨率阈值，推入物理计算列队
                 leaf_tasks.push_back ( t );
+                ++stats.leaves_reached;
             }
         }
 
         if ( leaf_tasks.empty () )
         {
-            return;
+            return stats;
         }
 
         // --- 阶段 2：基于 TBB 调度的 Newton-LSHADE 融合求解 ---
@@ -1070,9 +1259,12 @@ namespace StuCanvas
             oneapi::tbb::blocked_range< size_t > ( 0, leaf_tasks.size () ),
             [ & ] ( const oneapi::tbb::blocked_range< size_t >& r )
             {
+                STU_PROFILE_ZONE ( "stuplot_implicit2D/solve_chunk" );
+
                 // 线程局部微存，彻底剥离全局锁并发竞争
                 utils::TinyVector< double > local_x;
                 utils::TinyVector< double > local_y;
+                PlotStats local_stats;
 
                 for ( size_t i = r.begin (); i != r.end (); ++i )
                 {
@@ -1090,12 +1282,14 @@ namespace StuCanvas
                         auto verify_iy =
                             utils::IntervalSet< double > ( utils::Interval< double > ( cy - epsilon, cy + epsilon ) );
                         auto verify_res = interval_fn ( verify_ix, verify_iy );
+                        ++local_stats.interval_evaluations;
 
                         // IA 证明已入根区，立停
                         if ( utils::detals::possible_root ( verify_res ) &&
                              !utils::detals::is_unbounded ( verify_res ) )
                         {
                             found = true;
+                            ++local_stats.newton_successes;
                             break;
                         }
 
@@ -1105,6 +1299,7 @@ namespace StuCanvas
                         double f_x_minus = scalar_fn ( cx - epsilon, cy );
                         double f_y_plus = scalar_fn ( cx, cy + epsilon );
                         double f_y_minus = scalar_fn ( cx, cy - epsilon );
+                        local_stats.scalar_evaluations += 5;
 
                         double df_dx = ( f_x_plus - f_x_minus ) / ( 2.0 * epsilon );
                         double df_dy = ( f_y_plus - f_y_minus ) / ( 2.0 * epsilon );
@@ -1144,7 +1339,7 @@ namespace StuCanvas
                         { return std::abs ( scalar_fn ( x, y ) ); };
 
                         std::array< double, 2 > best_solution =
-                            utils::optimization::l_shade ( cost_func, de_params_local );
+                            detail::run_l_shade ( cost_func, de_params_local, local_stats );
                         cx = best_solution[ 0 ];
                         cy = best_solution[ 1 ];
 
@@ -1154,11 +1349,13 @@ namespace StuCanvas
                         auto verify_iy =
                             utils::IntervalSet< double > ( utils::Interval< double > ( cy - epsilon, cy + epsilon ) );
                         auto verify_res = interval_fn ( verify_ix, verify_iy );
+                        ++local_stats.interval_evaluations;
 
                         if ( utils::detals::possible_root ( verify_res ) &&
                              !utils::detals::is_unbounded ( verify_res ) )
                         {
                             found = true;
+                            ++local_stats.lshade_successes;
                         }
                     }
 
@@ -1170,6 +1367,8 @@ namespace StuCanvas
                     }
                 }
 
+                stat_slots.local () += local_stats;
+
                 // 4. 批处理内存合流 (Span + memcpy 极速穿透)
                 if ( !local_x.empty () )
                 {
@@ -1178,9 +1377,12 @@ namespace StuCanvas
                     out_cloud.y.append ( std::span< const double > ( local_y.begin (), local_y.size () ) );
                 }
             } );
+        stats += detail::combine_stats ( stat_slots );
+        stats.primitives = out_cloud.x.size ();
+        return stats;
     }
 
-    inline void stuplot_implicit3D ( const utils::StuFunction< double ( double, double, double ) >& scalar_fn,
+    inline PlotStats stuplot_implicit3D ( const utils::StuFunction< double ( double, double, double ) >& scalar_fn,
                                      const utils::StuFunction< utils::IntervalSet< double > (
                                          const utils::IntervalSet< double >&, const utils::IntervalSet< double >&,
                                          const utils::IntervalSet< double >& ) >& interval_fn,
@@ -1189,11 +1391,15 @@ namespace StuCanvas
                                      double min_block_height, double min_block_depth, double epsilon,
                                      DAGAssets::PointCloud3D_SoA& out_cloud )
     {
+        STU_PROFILE_ZONE ( "stuplot_implicit3D" );
+
         // 清理 3D 输出缓冲区
         out_cloud.x.clear ();
         out_cloud.y.clear ();
         out_cloud.z.clear ();
         std::mutex out_mutex;
+        PlotStats stats;
+        detail::PlotStatsSlots stat_slots;
 
         // 内部三维物理内存块
         struct Box3D
@@ -1218,10 +1424,13 @@ namespace StuCanvas
             auto iy = utils::IntervalSet< double > ( utils::Interval< double > ( t.y0, t.y1 ) );
             auto iz = utils::IntervalSet< double > ( utils::Interval< double > ( t.z0, t.z1 ) );
             auto res_ia = interval_fn ( ix, iy, iz );
+            ++stats.boxes_tested;
+            ++stats.interval_evaluations;
 
             // 若本块绝对不可能存在零等值面，直接丢弃（核心加速区）
             if ( !utils::detals::possible_root ( res_ia ) )
             {
+                ++stats.boxes_pruned;
                 continue;
             }
 
@@ -1249,12 +1458,13 @@ namespace StuCanvas
             {
                 // 抵达分辨率阈值，推入物理计算列队
                 leaf_tasks.push_back ( t );
+                ++stats.leaves_reached;
             }
         }
 
         if ( leaf_tasks.empty () )
         {
-            return;
+            return stats;
         }
 
         // --- 阶段 2：基于 TBB 调度的 3D Newton-LSHADE 融合求解 ---
@@ -1262,10 +1472,13 @@ namespace StuCanvas
             oneapi::tbb::blocked_range< size_t > ( 0, leaf_tasks.size () ),
             [ & ] ( const oneapi::tbb::blocked_range< size_t >& r )
             {
+                STU_PROFILE_ZONE ( "stuplot_implicit3D/solve_chunk" );
+
                 // 线程局部缓存，彻底剥离全局锁并发竞争
                 utils::TinyVector< double > local_x;
                 utils::TinyVector< double > local_y;
                 utils::TinyVector< double > local_z;
+                PlotStats local_stats;
 
                 for ( size_t i = r.begin (); i != r.end (); ++i )
                 {
@@ -1286,12 +1499,14 @@ namespace StuCanvas
                         auto verify_iz =
                             utils::IntervalSet< double > ( utils::Interval< double > ( cz - epsilon, cz + epsilon ) );
                         auto verify_res = interval_fn ( verify_ix, verify_iy, verify_iz );
+                        ++local_stats.interval_evaluations;
 
                         // IA 证明已入根的三维体素区间，立停
                         if ( utils::detals::possible_root ( verify_res ) &&
                              !utils::detals::is_unbounded ( verify_res ) )
                         {
                             found = true;
+                            ++local_stats.newton_successes;
                             break;
                         }
 
@@ -1303,6 +1518,7 @@ namespace StuCanvas
                         double f_y_minus = scalar_fn ( cx, cy - epsilon, cz );
                         double f_z_plus = scalar_fn ( cx, cy, cz + epsilon );
                         double f_z_minus = scalar_fn ( cx, cy, cz - epsilon );
+                        local_stats.scalar_evaluations += 7;
 
                         double df_dx = ( f_x_plus - f_x_minus ) / ( 2.0 * epsilon );
                         double df_dy = ( f_y_plus - f_y_minus ) / ( 2.0 * epsilon );
@@ -1346,7 +1562,7 @@ namespace StuCanvas
                         { return std::abs ( scalar_fn ( x, y, z ) ); };
 
                         std::array< double, 3 > best_solution =
-                            utils::optimization::l_shade ( cost_func, de_params_local );
+                            detail::run_l_shade ( cost_func, de_params_local, local_stats );
                         cx = best_solution[ 0 ];
                         cy = best_solution[ 1 ];
                         cz = best_solution[ 2 ];
@@ -1359,11 +1575,13 @@ namespace StuCanvas
                         auto verify_iz =
                             utils::IntervalSet< double > ( utils::Interval< double > ( cz - epsilon, cz + epsilon ) );
                         auto verify_res = interval_fn ( verify_ix, verify_iy, verify_iz );
+                        ++local_stats.interval_evaluations;
 
                         if ( utils::detals::possible_root ( verify_res ) &&
                              !utils::detals::is_unbounded ( verify_res ) )
                         {
                             found = true;
+                            ++local_stats.lshade_successes;
                         }
                     }
 
@@ -1376,6 +1594,8 @@ namespace StuCanvas
                     }
                 }
 
+                stat_slots.local () += local_stats;
+
                 // 4. 批处理内存合流 (Span + memcpy 极速穿透)
                 if ( !local_x.empty () )
                 {
@@ -1385,11 +1605,14 @@ namespace StuCanvas
                     out_cloud.z.append ( std::span< const double > ( local_z.begin (), local_z.size () ) );
                 }
             } );
+        stats += detail::combine_stats ( stat_slots );
+        stats.primitives = out_cloud.x.size ();
+        return stats;
     }
     // =========================================================================
     // 🚀 外部调用主接口：区间算术 (IA) 增强版 Marching Squares 2D
     // =========================================================================
-    inline void marchingSquares2DIA (
+    inline PlotStats marchingSquares2DIA (
         const utils::StuFunction< double ( double, double ) >& scalar_fn,
         const utils::StuFunction< utils::IntervalSet< double > ( const utils::IntervalSet< double >&,
                                                                  const utils::IntervalSet< double >& ) >& interval_fn,
@@ -1399,9 +1622,13 @@ namespace StuCanvas
         unsigned int threads,             // 完全透传的用户线程配置
         DAGAssets::LineStrip2D_SoA& out_strip )
     {
+        STU_PROFILE_ZONE ( "marchingSquares2DIA" );
+
         out_strip.x.clear ();
         out_strip.y.clear ();
         std::mutex out_mutex;
+        PlotStats stats;
+        detail::PlotStatsSlots stat_slots;
 
         // 内部物理内存块
         struct Box
@@ -1429,10 +1656,13 @@ namespace StuCanvas
             auto ix = utils::IntervalSet< double > ( utils::Interval< double > ( t.x0, t.x1 ) );
             auto iy = utils::IntervalSet< double > ( utils::Interval< double > ( t.y0, t.y1 ) );
             auto res_ia = interval_fn ( ix, iy );
+            ++stats.boxes_tested;
+            ++stats.interval_evaluations;
 
             // 若本块绝对不可能有根，物理剪枝丢弃
             if ( !utils::detals::possible_root ( res_ia ) )
             {
+                ++stats.boxes_pruned;
                 continue;
             }
 
@@ -1451,12 +1681,13 @@ namespace StuCanvas
             {
                 // 抵达 10x10 分辨率阈值，推入物理计算列队
                 leaf_tasks.push_back ( t );
+                ++stats.leaves_reached;
             }
         }
 
         if ( leaf_tasks.empty () )
         {
-            return;
+            return stats;
         }
 
         // --- 阶段 2：并行展开叶子任务，稍微扩充 5% 并调用纯 Marching Squares ---
@@ -1475,6 +1706,7 @@ namespace StuCanvas
                                             {
                                                 // 🚀 核心优化 2：Task 级的局部缓存，聚积该 Chunk 下所有小块的结果
                                                 DAGAssets::LineStrip2D_SoA local_strip;
+                                                PlotStats local_stats;
 
                                                 for ( size_t i = r.begin (); i != r.end (); ++i )
                                                 {
@@ -1497,10 +1729,10 @@ namespace StuCanvas
                                                     // 🚀 核心纠正：绝对信任 TBB 的高级调度算法！
                                                     // 完完整整透传外部的 threads 参数，底层将优雅地处理 Task Arena
                                                     // 嵌套复用
-                                                    marchingSquares2D ( scalar_fn, ex0, ex1, ey0, ey1, step,
-                                                                        max_subdivision_depth,
-                                                                        threads,   // <--- 无条件透传用户指定的并发度
-                                                                        temp_strip );
+                                                    local_stats += marchingSquares2D (
+                                                        scalar_fn, ex0, ex1, ey0, ey1, step, max_subdivision_depth,
+                                                        threads,   // <--- 无条件透传用户指定的并发度
+                                                        temp_strip );
 
                                                     // 将当前小块生成的几何吸入当前 Chunk 的局部缓冲中
                                                     if ( !temp_strip.x.empty () )
@@ -1512,6 +1744,8 @@ namespace StuCanvas
                                                     }
                                                 }
 
+                                                stat_slots.local () += local_stats;
+
                                                 // 🚀 核心优化 3：每个 Chunk 仅触发 1 次锁竞争，利用 Span + memcpy
                                                 // 瞬间吸入全局缓冲
                                                 if ( !local_strip.x.empty () )
@@ -1524,11 +1758,15 @@ namespace StuCanvas
                                                 }
                                             } );
             } );
+
+        stats += detail::combine_stats ( stat_slots );
+        stats.primitives = out_strip.x.size () / 2;
+        return stats;
     }
     // =========================================================================
     // 🚀 外部调用主接口：区间算术 (IA) 增强版 Marching Cubes 3D
     // =========================================================================
-    inline void marchingCubes3DIA ( const utils::StuFunction< double ( double, double, double ) >& scalar_fn,
+    inline PlotStats marchingCubes3DIA ( const utils::StuFunction< double ( double, double, double ) >& scalar_fn,
                                     const utils::StuFunction< utils::IntervalSet< double > (
                                         const utils::IntervalSet< double >&, const utils::IntervalSet< double >&,
                                         const utils::IntervalSet< double >& ) >& interval_fn,
@@ -1537,11 +1775,15 @@ namespace StuCanvas
                                     unsigned int threads,   // 完全透传的用户线程配置
                                     DAGAssets::TriangleMesh3D_SoA& out_mesh )
     {
+        STU_PROFILE_ZONE ( "marchingCubes3DIA" );
+
         out_mesh.x.clear ();
         out_mesh.y.clear ();
         out_mesh.z.clear ();
         out_mesh.indices.clear ();
         std::mutex out_mutex;
+        PlotStats stats;
+        detail::PlotStatsSlots stat_slots;
 
         // 内部三维物理内存块
         struct Box3D
@@ -1571,10 +1813,13 @@ namespace StuCanvas
             auto iy = utils::IntervalSet< double > ( utils::Interval< double > ( t.y0, t.y1 ) );
             auto iz = utils::IntervalSet< double > ( utils::Interval< double > ( t.z0, t.z1 ) );
             auto res_ia = interval_fn ( ix, iy, iz );
+            ++stats.boxes_tested;
+            ++stats.interval_evaluations;
 
             // 若本块绝对不可能有根，物理剪枝丢弃（3D 空间下此步剔除收益巨大）
             if ( !utils::detals::possible_root ( res_ia ) )
             {
+                ++stats.boxes_pruned;
                 continue;
             }
 
@@ -1601,12 +1846,13 @@ namespace StuCanvas
             {
                 // 抵达分辨率阈值，推入物理计算列队
                 leaf_tasks.push_back ( t );
+                ++stats.leaves_reached;
             }
         }
 
         if ( leaf_tasks.empty () )
         {
-            return;
+            return stats;
         }
 
         // --- 阶段 2：并行展开叶子任务，稍微扩充 5% 并调用纯 Marching Cubes ---
@@ -1628,6 +1874,7 @@ namespace StuCanvas
                         // 避免每次进入循环都申请和释放三角网格内存。
                         DAGAssets::TriangleMesh3D_SoA local_mesh;
                         DAGAssets::TriangleMesh3D_SoA temp_mesh;
+                        PlotStats local_stats;
 
                         for ( size_t i = r.begin (); i != r.end (); ++i )
                         {
@@ -1656,9 +1903,9 @@ namespace StuCanvas
                             temp_mesh.indices.clear ();
 
                             // 🚀 无条件透传 threads 给底层的 Marching Cubes
-                            marchingCubes3D ( scalar_fn, ex0, ex1, ey0, ey1, ez0, ez1, step,
-                                              threads,   // <--- 信任 TBB 调度
-                                              temp_mesh );
+                            local_stats += marchingCubes3D ( scalar_fn, ex0, ex1, ey0, ey1, ez0, ez1, step,
+                                                             threads,   // <--- 信任 TBB 调度
+                                                             temp_mesh );
 
                             // 🚀 核心逻辑 3：安全平移三角形顶点索引 (Index Base Offset)
                             if ( !temp_mesh.x.empty () )
@@ -1680,6 +1927,8 @@ namespace StuCanvas
                             }
                         }
 
+                        stat_slots.local () += local_stats;
+
                         // 🚀 核心优化 4：仅在 Chunk 结束时参与全局自旋锁竞争
                         if ( !local_mesh.x.empty () )
                         {
@@ -1702,16 +1951,23 @@ namespace StuCanvas
                         }
                     } );
             } );
+
+        stats += detail::combine_stats ( stat_slots );
+        stats.primitives = out_mesh.indices.size () / 3;
+        return stats;
     }
-    inline void stuplot_implicit2D_IA_pure (
+    inline PlotStats stuplot_implicit2D_IA_pure (
         const utils::StuFunction< utils::IntervalSet< double > ( const utils::IntervalSet< double >&,
                                                                  const utils::IntervalSet< double >& ) >& interval_fn,
         double x_min, double x_max, double y_min, double y_max, double min_block_width, double min_block_height,
         DAGAssets::PointCloud2D_SoA& out_cloud )
     {
+        STU_PROFILE_ZONE ( "stuplot_implicit2D_IA_pure" );
+
         // 无锁清理输出缓冲
         out_cloud.x.clear ();
         out_cloud.y.clear ();
+        PlotStats stats;
 
         struct Box
         {
@@ -1731,10 +1987,13 @@ namespace StuCanvas
             auto ix = utils::IntervalSet< double > ( utils::Interval< double > ( t.x0, t.x1 ) );
             auto iy = utils::IntervalSet< double > ( utils::Interval< double > ( t.y0, t.y1 ) );
             auto res_ia = interval_fn ( ix, iy );
+            ++stats.boxes_tested;
+            ++stats.interval_evaluations;
 
             // 物理剪枝：数学上证明该矩形内绝对不存在 f(x,y)=0
             if ( !utils::detals::possible_root ( res_ia ) )
             {
+                ++stats.boxes_pruned;
                 continue;
             }
 
@@ -1755,8 +2014,12 @@ namespace StuCanvas
                 // 抵达极限分辨率且包含根区，将区块中心点直接推入 SoA 扁平数组
                 out_cloud.x.push_back ( ( t.x0 + t.x1 ) * 0.5 );
                 out_cloud.y.push_back ( ( t.y0 + t.y1 ) * 0.5 );
+                ++stats.leaves_reached;
             }
         }
+
+        stats.primitives = out_cloud.x.size ();
+        return stats;
     }
 
 
@@ -1770,17 +2033,20 @@ namespace StuCanvas
      * 1. 极致的三维八叉树空间剪枝，只追逐可能存在等值面的拓扑边缘。
      * 2. 没有任何求导、没有任何近似算子，绝对可靠的纯数学空间细分。
      */
-    inline void stuplot_implicit3D_IA_pure (
+    inline PlotStats stuplot_implicit3D_IA_pure (
         const utils::StuFunction< utils::IntervalSet< double > ( const utils::IntervalSet< double >&,
                                                                  const utils::IntervalSet< double >&,
                                                                  const utils::IntervalSet< double >& ) >& interval_fn,
         double x_min, double x_max, double y_min, double y_max, double z_min, double z_max, double min_block_width,
         double min_block_height, double min_block_depth, DAGAssets::PointCloud3D_SoA& out_cloud )
     {
+        STU_PROFILE_ZONE ( "stuplot_implicit3D_IA_pure" );
+
         // 无锁清理输出缓冲
         out_cloud.x.clear ();
         out_cloud.y.clear ();
         out_cloud.z.clear ();
+        PlotStats stats;
 
         struct Box3D
         {
@@ -1801,10 +2067,13 @@ namespace StuCanvas
             auto iy = utils::IntervalSet< double > ( utils::Interval< double > ( t.y0, t.y1 ) );
             auto iz = utils::IntervalSet< double > ( utils::Interval< double > ( t.z0, t.z1 ) );
             auto res_ia = interval_fn ( ix, iy, iz );
+            ++stats.boxes_tested;
+            ++stats.interval_evaluations;
 
             // 物理剪枝：数学上证明该体素立方体内绝对不存在 f(x,y,z)=0
             if ( !utils::detals::possible_root ( res_ia ) )
             {
+                ++stats.boxes_pruned;
                 continue;
             }
 
@@ -1834,8 +2103,12 @@ namespace StuCanvas
                 out_cloud.x.push_back ( ( t.x0 + t.x1 ) * 0.5 );
                 out_cloud.y.push_back ( ( t.y0 + t.y1 ) * 0.5 );
                 out_cloud.z.push_back ( ( t.z0 + t.z1 ) * 0.5 );
+                ++stats.leaves_reached;
             }
         }
+
+        stats.primitives = out_cloud.x.size ();
+        return stats;
     }
     // =========================================================================
     // 🚀 辅助函数：极速一维包围盒交叠检测 (O(N) 扫描 IntervalSet，N 通常为 1~2)
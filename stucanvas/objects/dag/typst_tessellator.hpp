@@ -0,0 +1,675 @@
+/****************************************************************************
+ * Copyright (c) 2025-2026 Tian Yuxuan (Friendships666)                     *
+ *                                                                          *
+ * StuCanvas is licensed under Mulan PSL v2.                                *
+ * You can use this software according to the terms and conditions of the   *
+ * Mulan PSL v2.                                                            *
+ * You may obtain a copy of Mulan PSL v2 at:                                *
+ *          http://license.coscl.org.cn/MulanPSL2                           *
+ *                                                                          *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF     *
+ * ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO        *
+ * NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.       *
+ * See the Mulan PSL v2 for more details.                                   *
+ ***************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <oneapi/tbb/parallel_for.h>
+
+#include "assets.hpp"
+#include "typst_c.hpp"
+#include "../../utils2/flat_map.hpp"
+
+namespace StuCanvas
+{
+    /**
+     * @brief 一份几何体 (字形或普通路径) 在某一缩放档位下的展平 + 三角化结果，坐标为几何本地坐标
+     */
+    struct TessellatedGeometry
+    {
+        DAGAssets::LineStrip2D_SoA outline;           ///< 各轮廓顺次拼接；闭合轮廓以重复首点结尾，可直接用于描边
+        utils::TinyVector< uint32_t > contour_ends;   ///< 每个轮廓在 outline 中的结束下标 (不含)
+        DAGAssets::TriangleMesh3D_SoA fill;           ///< 按填充规则三角化后的填充网格 (z = 0)
+    };
+
+    /**
+     * @brief 一条可直接绘制的记录：展平几何 + 本地到页面 (pt) 的仿射变换 + 来源指令
+     */
+    struct TessellatedDraw
+    {
+        uint32_t geometry;       ///< TypstTessellator::geometry() 的下标
+        uint32_t instance;       ///< 来源 DrawInstance 在 Outline::instances 中的下标 (材质、描边、裁剪标志)
+        Transform2D transform;   ///< 几何本地坐标 -> 页面坐标 (pt)
+    };
+
+    namespace detail::typst_tess
+    {
+        /// 几何体的只读路径视图 (Rect / Line 会被合成为等价路径)
+        struct PathView
+        {
+            std::span< const Point2D > points;
+            std::span< const PathVerb > verbs;
+        };
+
+        /// 2x2 线性部分的最大奇异值：各向异性缩放时取最坏方向，保证容差上界
+        inline double maxStretch ( const Transform2D& t ) noexcept
+        {
+            const double sum = t.sx * t.sx + t.ky * t.ky + t.kx * t.kx + t.sy * t.sy;
+            const double det = t.sx * t.sy - t.kx * t.ky;
+            const double disc = std::sqrt ( std::max ( 0.0, sum * sum - 4.0 * det * det ) );
+            return std::sqrt ( 0.5 * ( sum + disc ) );
+        }
+
+        inline Transform2D concat ( const Transform2D& a, const Transform2D& b ) noexcept
+        {
+            return Transform2D{ a.sx * b.sx + a.kx * b.ky, a.ky * b.sx + a.sy * b.ky,
+                                a.sx * b.kx + a.kx * b.sy, a.ky * b.kx + a.sy * b.sy,
+                                a.sx * b.tx + a.kx * b.ty + a.tx, a.ky * b.tx + a.sy * b.ty + a.ty };
+        }
+
+        /// 路径内容哈希：跨 Outline / 跨编译识别同一字形或同一形状
+        inline uint64_t hashPath ( const PathView& path ) noexcept
+        {
+            uint64_t h = 0x9E3779B97F4A7C15ull ^ ( static_cast< uint64_t > ( path.points.size () ) << 32 ) ^ path.verbs.size ();
+            auto mix = [ &h ] ( uint64_t v ) noexcept
+            {
+                h ^= v + 0x9E3779B97F4A7C15ull + ( h << 6 ) + ( h >> 2 );
+                h *= 0xFF51AFD7ED558CCDull;
+                h ^= h >> 33;
+            };
+            for ( const Point2D& p : path.points )
+            {
+                uint64_t x, y;
+                std::memcpy ( &x, &p.x, 8 );
+                std::memcpy ( &y, &p.y, 8 );
+                mix ( x );
+                mix ( y );
+            }
+            for ( size_t i = 0; i < path.verbs.size (); i += 8 )
+            {
+                uint64_t chunk = 0;
+                std::memcpy ( &chunk, path.verbs.data () + i, std::min< size_t > ( 8, path.verbs.size () - i ) );
+                mix ( chunk );
+            }
+            return h;
+        }
+
+        // ---------------------------------------------------------------------
+        // 1. 误差受控的自适应展平
+        // ---------------------------------------------------------------------
+
+        /**
+         * @brief 三次贝塞尔递归细分：弦与曲线的最大偏差不超过 0.75 * max(|P0-2P1+P2|, |P1-2P2+P3|)，
+         *        满足容差即输出弦，否则在 t = 0.5 处 de Casteljau 二分 (每次二分该上界缩小为 1/4)
+         */
+        inline void flattenCubic ( double x0, double y0, double x1, double y1, double x2, double y2, double x3, double y3,
+                                   double tol, int depth, std::vector< double >& xs, std::vector< double >& ys )
+        {
+            const double ax = x0 - 2.0 * x1 + x2, ay = y0 - 2.0 * y1 + y2;
+            const double bx = x1 - 2.0 * x2 + x3, by = y1 - 2.0 * y2 + y3;
+            const double m2 = std::max ( ax * ax + ay * ay, bx * bx + by * by );
+
+            if ( depth >= 16 || 0.5625 * m2 <= tol * tol )
+            {
+                xs.push_back ( x3 );
+                ys.push_back ( y3 );
+                return;
+            }
+
+            const double x01 = 0.5 * ( x0 + x1 ), y01 = 0.5 * ( y0 + y1 );
+            const double x12 = 0.5 * ( x1 + x2 ), y12 = 0.5 * ( y1 + y2 );
+            const double x23 = 0.5 * ( x2 + x3 ), y23 = 0.5 * ( y2 + y3 );
+            const double xa = 0.5 * ( x01 + x12 ), ya = 0.5 * ( y01 + y12 );
+            const double xb = 0.5 * ( x12 + x23 ), yb = 0.5 * ( y12 + y23 );
+            const double xm = 0.5 * ( xa + xb ), ym = 0.5 * ( ya + yb );
+
+            flattenCubic ( x0, y0, x01, y01, xa, ya, xm, ym, tol, depth + 1, xs, ys );
+            flattenCubic ( xm, ym, xb, yb, x23, y23, x3, y3, tol, depth + 1, xs, ys );
+        }
+
+        /// 展平整条路径；返回每个轮廓的结束下标 (闭合轮廓末尾重复首点)
+        inline void flattenPath ( const PathView& path, double tol, std::vector< double >& xs, std::vector< double >& ys,
+                                  std::vector< uint32_t >& ends )
+        {
+            size_t pi = 0;
+            size_t start = 0;
+            bool open = false;
+
+            auto finish = [ & ] ( bool close )
+            {
+                if ( !open ) return;
+                if ( close && xs.size () > start && ( xs.back () != xs[ start ] || ys.back () != ys[ start ] ) )
+                {
+                    xs.push_back ( xs[ start ] );
+                    ys.push_back ( ys[ start ] );
+                }
+                ends.push_back ( static_cast< uint32_t > ( xs.size () ) );
+                open = false;
+            };
+
+            for ( const PathVerb verb : path.verbs )
+            {
+                switch ( verb )
+                {
+                    case PathVerb::MoveTo:
+                        if ( pi >= path.points.size () ) return;
+                        finish ( false );
+                        start = xs.size ();
+                        open = true;
+                        xs.push_back ( path.points[ pi ].x );
+                        ys.push_back ( path.points[ pi ].y );
+                        pi += 1;
+                        break;
+                    case PathVerb::LineTo:
+                        if ( pi >= path.points.size () || !open ) return;
+                        xs.push_back ( path.points[ pi ].x );
+                        ys.push_back ( path.points[ pi ].y );
+                        pi += 1;
+                        break;
+                    case PathVerb::CubicTo:
+                        if ( pi + 2 >= path.points.size () || !open ) return;
+                        flattenCubic ( xs.back (), ys.back (), path.points[ pi ].x, path.points[ pi ].y,
+                                       path.points[ pi + 1 ].x, path.points[ pi + 1 ].y,
+                                       path.points[ pi + 2 ].x, path.points[ pi + 2 ].y, tol, 0, xs, ys );
+                        pi += 3;
+                        break;
+                    case PathVerb::Close:
+                        finish ( true );
+                        break;
+                }
+            }
+            finish ( false );
+        }
+
+        // ---------------------------------------------------------------------
+        // 2. 填充规则感知的扫描带梯形剖分
+        // ---------------------------------------------------------------------
+
+        struct Edge
+        {
+            double x0, y0, x1, y1;   ///< y0 < y1
+            int winding;             ///< 原方向向下 (y 增大) 为 +1，否则为 -1
+
+            [[nodiscard]] double xAt ( double y ) const noexcept
+            {
+                return x0 + ( x1 - x0 ) * ( ( y - y0 ) / ( y1 - y0 ) );
+            }
+        };
+
+        struct BandEdge
+        {
+            double top, bottom;
+            int winding;
+        };
+
+        /**
+         * @brief 将闭合多边形集合按填充规则剖分为三角形
+         * @details 以所有顶点的 y 值切分水平扫描带；带内若有边相交，则在最早的交点处再次切分，
+         *          保证带内各边左右次序不变。随后自左向右累加环绕数，按 NonZero / EvenOdd 规则输出
+         *          内部区间对应的梯形 (退化为三角形时只输出一个三角形)。自交、重叠轮廓与孔洞均可正确处理。
+         */
+        inline void triangulate ( std::span< const double > xs, std::span< const double > ys, std::span< const uint32_t > ends,
+                                  FillRule rule, DAGAssets::TriangleMesh3D_SoA& mesh )
+        {
+            if ( rule == FillRule::None ) return;
+
+            std::vector< Edge > edges;
+            std::vector< double > cuts;
+            uint32_t begin = 0;
+            for ( const uint32_t end : ends )
+            {
+                // 每个轮廓都按隐式闭合处理 (开放路径的填充语义)
+                for ( uint32_t i = begin; i < end; ++i )
+                {
+                    const uint32_t j = ( i + 1 < end ) ? i + 1 : begin;
+                    if ( ys[ i ] == ys[ j ] ) continue;
+                    if ( ys[ i ] < ys[ j ] )
+                        edges.push_back ( Edge{ xs[ i ], ys[ i ], xs[ j ], ys[ j ], 1 } );
+                    else
+                        edges.push_back ( Edge{ xs[ j ], ys[ j ], xs[ i ], ys[ i ], -1 } );
+                    cuts.push_back ( ys[ i ] );
+                }
+                begin = end;
+            }
+            if ( edges.empty () ) return;
+
+            std::sort ( cuts.begin (), cuts.end () );
+            cuts.erase ( std::unique ( cuts.begin (), cuts.end () ), cuts.end () );
+            std::sort ( edges.begin (), edges.end (), [] ( const Edge& a, const Edge& b ) { return a.y0 < b.y0; } );
+
+            constexpr double kProbe = 1e-6;   ///< 探针位置 (相对带高)，也是可忽略交点的下限
+            std::vector< uint32_t > active;
+            std::vector< BandEdge > band;
+            size_t next_edge = 0;
+
+            auto emitBand = [ & ] ( double y_top, double y_bottom )
+            {
+                band.clear ();
+                for ( const uint32_t e : active )
+                {
+                    band.push_back ( BandEdge{ edges[ e ].xAt ( y_top ), edges[ e ].xAt ( y_bottom ), edges[ e ].winding } );
+                }
+
+                int winding = 0;
+                for ( size_t k = 0; k + 1 < band.size (); ++k )
+                {
+                    winding += band[ k ].winding;
+                    const bool inside = ( rule == FillRule::EvenOdd ) ? ( winding & 1 ) != 0 : winding != 0;
+                    if ( !inside ) continue;
+
+                    const BandEdge& l = band[ k ];
+                    const BandEdge& r = band[ k + 1 ];
+                    const bool top_open = r.top - l.top > 0.0;
+                    const bool bottom_open = r.bottom - l.bottom > 0.0;
+                    if ( !top_open && !bottom_open ) continue;
+
+                    const uint32_t base = mesh.x.size ();
+                    mesh.x.push_back ( l.top );    mesh.y.push_back ( y_top );    mesh.z.push_back ( 0.0 );
+                    mesh.x.push_back ( r.top );    mesh.y.push_back ( y_top );    mesh.z.push_back ( 0.0 );
+                    mesh.x.push_back ( r.bottom ); mesh.y.push_back ( y_bottom ); mesh.z.push_back ( 0.0 );
+                    mesh.x.push_back ( l.bottom ); mesh.y.push_back ( y_bottom ); mesh.z.push_back ( 0.0 );
+
+                    if ( top_open )
+                    {
+                        mesh.indices.push_back ( base );
+                        mesh.indices.push_back ( base + 1 );
+                        mesh.indices.push_back ( base + 2 );
+                    }
+                    if ( bottom_open )
+                    {
+                        mesh.indices.push_back ( base );
+                        mesh.indices.push_back ( base + 2 );
+                        mesh.indices.push_back ( base + 3 );
+                    }
+                }
+            };
+
+            for ( size_t c = 0; c + 1 < cuts.size (); ++c )
+            {
+                const double ya = cuts[ c ];
+                const double yb = cuts[ c + 1 ];
+
+                // 维护跨越当前带的活动边
+                std::erase_if ( active, [ & ] ( uint32_t e ) { return edges[ e ].y1 <= ya; } );
+                while ( next_edge < edges.size () && edges[ next_edge ].y0 <= ya )
+                {
+                    if ( edges[ next_edge ].y1 > ya ) active.push_back ( static_cast< uint32_t > ( next_edge ) );
+                    ++next_edge;
+                }
+                if ( active.size () < 2 ) continue;
+
+                // 带内交点切分：在带顶略下方的探针处排序 (避开共享顶点处的并列)，
+                // 最早的交点必然出现在相邻边之间；切出的子带内次序不变，可直接沿用该次序输出
+                double y_lo = ya;
+                for ( size_t guard = 0; guard <= active.size () * active.size (); ++guard )
+                {
+                    const double probe = y_lo + kProbe * ( yb - y_lo );
+                    std::sort ( active.begin (), active.end (), [ & ] ( uint32_t a, uint32_t b )
+                                { return edges[ a ].xAt ( probe ) < edges[ b ].xAt ( probe ); } );
+
+                    double t_min = 1.0;
+                    for ( size_t k = 0; k + 1 < active.size (); ++k )
+                    {
+                        const Edge& e0 = edges[ active[ k ] ];
+                        const Edge& e1 = edges[ active[ k + 1 ] ];
+                        const double d_top = e1.xAt ( y_lo ) - e0.xAt ( y_lo );
+                        const double d_bottom = e1.xAt ( yb ) - e0.xAt ( yb );
+                        if ( d_bottom < 0.0 && d_top > 0.0 )
+                        {
+                            const double t = d_top / ( d_top - d_bottom );
+                            if ( t > kProbe ) t_min = std::min ( t_min, t );
+                        }
+                    }
+
+                    const double y_hi = ( t_min >= 1.0 ) ? yb : y_lo + t_min * ( yb - y_lo );
+                    emitBand ( y_lo, y_hi );
+                    if ( y_hi >= yb || y_hi <= y_lo ) break;
+                    y_lo = y_hi;
+                }
+            }
+        }
+
+        /// 单份几何的完整处理：展平 + 按需三角化
+        inline void tessellate ( const PathView& path, double tol, FillRule rule, TessellatedGeometry& out )
+        {
+            std::vector< double > xs, ys;
+            std::vector< uint32_t > ends;
+            flattenPath ( path, tol, xs, ys, ends );
+
+            out.outline.x.append ( std::span< const double > ( xs ) );
+            out.outline.y.append ( std::span< const double > ( ys ) );
+            out.contour_ends.append ( std::span< const uint32_t > ( ends ) );
+            triangulate ( xs, ys, ends, rule, out.fill );
+        }
+    }   // namespace detail::typst_tess
+
+    /**
+     * @brief Typst Outline 的自适应展平 / 三角化器，按 (几何内容, 填充规则, 缩放档位) 缓存结果
+     * @details 缩放档位以 √2 为步长 (半个倍频程)：同一字形在相近字号 / 缩放下命中同一条目，
+     *          每档按档位上界求本地容差，保证屏幕误差不超过 tolerance_px，顶点数随屏幕尺寸成比例增长。
+     *          缓存未命中的几何在 TBB 中并行处理。
+     *          缓存总量受 max_bytes 约束：超出时按最近使用帧淘汰 (LRU)，当前帧用到的条目不会被淘汰；
+     *          调用方应在每帧开始时调用 nextFrame()。
+     */
+    class TypstTessellator
+    {
+    public:
+        explicit TypstTessellator ( double tolerance_px = 0.25, size_t max_bytes = size_t ( 256 ) << 20 )
+            : tolerance_px ( tolerance_px ), max_bytes ( max_bytes )
+        {
+            if ( !( tolerance_px > 0.0 ) )
+            {
+                throw std::runtime_error ( "TypstTessellator::TypstTessellator: tolerance_px must be positive." );
+            }
+        }
+
+        /**
+         * @brief 处理一份 Outline，把可绘制记录追加到 out (顺序与绘制指令一致，字形运行按字形展开)
+         * @param pixels_per_pt 页面 pt 到屏幕像素的缩放 (含相机缩放)
+         * @note 返回记录中的 geometry 下标在下一次 nextFrame() / clear() 之前保持有效
+         */
+        void tessellate ( const Outline& outline, double pixels_per_pt, std::vector< TessellatedDraw >& out )
+        {
+            const std::span< const SharedGeometry > geometries ( outline.geometries.ptr, outline.geometries.len );
+            const std::span< const DrawInstance > instances ( outline.instances.ptr, outline.instances.len );
+            const std::span< const GlyphPlacement > glyphs ( outline.glyphs.ptr, outline.glyphs.len );
+
+            // Outline 内的几何内容哈希只算一次
+            geometry_hash.assign ( geometries.size (), 0 );
+            geometry_hashed.assign ( geometries.size (), 0 );
+            pending.clear ();
+
+            auto request = [ & ] ( uint32_t geometry_id, uint32_t instance_index, const Transform2D& ts, FillRule rule )
+            {
+                if ( geometry_id >= geometries.size () ) return;
+
+                PathStorage rect_storage;
+                const detail::typst_tess::PathView path = viewOf ( geometries[ geometry_id ].geometry, rect_storage );
+                if ( !geometry_hashed[ geometry_id ] )
+                {
+                    geometry_hash[ geometry_id ] = detail::typst_tess::hashPath ( path );
+                    geometry_hashed[ geometry_id ] = 1;
+                }
+
+                const int bucket = zoomBucket ( pixels_per_pt * detail::typst_tess::maxStretch ( ts ) );
+                const uint64_t key = cacheKey ( geometry_hash[ geometry_id ], rule, bucket );
+
+                uint32_t entry;
+                if ( auto it = cache.find ( key ); it != cache.end () && slots[ it->second ].matches ( path, rule, bucket ) )
+                {
+                    entry = it->second;
+                }
+                else
+                {
+                    // 未命中；或 64 位键撞上了内容不同的几何，此时单独处理且不登记入缓存
+                    const bool collided = it != cache.end ();
+                    entry = allocate ( path, rule, bucket, key, !collided );
+                    if ( !collided ) cache.insert ( key, entry );
+                    pending.push_back ( Job{ geometry_id, entry, rule, bucket } );
+                }
+                slots[ entry ].last_use = frame;
+                out.push_back ( TessellatedDraw{ entry, instance_index, ts } );
+            };
+
+            for ( uint32_t i = 0; i < instances.size (); ++i )
+            {
+                const DrawInstance& inst = instances[ i ];
+                const FillRule rule = ( inst.fill_paint.ty != PaintType::None || inst.clip ) ? inst.fill_rule : FillRule::None;
+
+                if ( inst.geometry_id == GLYPH_RUN_GEOMETRY )
+                {
+                    if ( static_cast< uint64_t > ( inst.glyph_first ) + inst.glyph_count > glyphs.size () ) continue;
+                    for ( uint32_t g = inst.glyph_first; g < inst.glyph_first + inst.glyph_count; ++g )
+                    {
+                        request ( glyphs[ g ].geometry_id, i, glyphs[ g ].transform, rule );
+                    }
+                }
+                else
+                {
+                    request ( inst.geometry_id, i, inst.transform, rule );
+                }
+            }
+
+            if ( pending.empty () ) return;
+
+            // 🚀 未命中的几何并行展平 / 三角化 (各任务写入互不相同的条目)，随后串行统计内存并按预算淘汰
+            try
+            {
+                oneapi::tbb::parallel_for ( size_t ( 0 ), pending.size (), [ & ] ( size_t j )
+                                            {
+                                                const Job& job = pending[ j ];
+                                                PathStorage rect_storage;
+                                                const detail::typst_tess::PathView path =
+                                                    viewOf ( geometries[ job.geometry_id ].geometry, rect_storage );
+                                                const double tol = tolerance_px / bucketScale ( job.bucket );
+                                                detail::typst_tess::tessellate ( path, tol, job.rule, entries[ job.entry ] );
+                                            } );
+            }
+            catch ( ... )
+            {
+                // 半成品条目不能留在缓存里被后续调用命中
+                for ( const Job& job : pending ) release ( job.entry );
+                pending.clear ();
+                throw;
+            }
+
+            for ( const Job& job : pending )
+            {
+                slots[ job.entry ].bytes = footprint ( entries[ job.entry ] ) + slots[ job.entry ].points.size () * sizeof ( Point2D ) +
+                                           slots[ job.entry ].verbs.size () * sizeof ( PathVerb );
+                live_bytes += slots[ job.entry ].bytes;
+            }
+            evict ();
+        }
+
+        /// 开始新的一帧：此前各帧用到的条目成为可淘汰对象，之前返回的 geometry 下标随之失效
+        void nextFrame () noexcept { ++frame; }
+
+        /// 把 Outline 的一条几何局部变换与外部 (如相机 / 版面) 变换级联
+        static Transform2D compose ( const Transform2D& outer, const Transform2D& local ) noexcept
+        {
+            return detail::typst_tess::concat ( outer, local );
+        }
+
+        [[nodiscard]] const TessellatedGeometry& geometry ( uint32_t index ) const
+        {
+            if ( index >= entries.size () || !slots[ index ].live )
+            {
+                throw std::runtime_error ( "TypstTessellator::geometry: index out of range." );
+            }
+            return entries[ index ];
+        }
+
+        [[nodiscard]] size_t cacheSize () const noexcept { return live_count; }
+        [[nodiscard]] size_t cacheBytes () const noexcept { return live_bytes; }
+        [[nodiscard]] double tolerance () const noexcept { return tolerance_px; }
+
+        /// 释放全部缓存 (之前返回的 geometry 下标随之失效)
+        void clear ()
+        {
+            entries.clear ();
+            slots.clear ();
+            free_slots.clear ();
+            cache = utils::FlatMap< uint64_t, uint32_t >{};
+            live_bytes = 0;
+            live_count = 0;
+        }
+
+    private:
+        struct Job
+        {
+            uint32_t geometry_id;
+            uint32_t entry;
+            FillRule rule;
+            int bucket;
+        };
+
+        /// 条目的元数据：LRU 时间戳、内存占用，以及命中时用于排除哈希碰撞的完整路径副本
+        struct Slot
+        {
+            uint64_t key = 0;
+            uint64_t last_use = 0;
+            size_t bytes = 0;
+            std::vector< PathVerb > verbs;   ///< 路径动词序列，命中时逐项比对
+            std::vector< Point2D > points;   ///< 路径控制点，命中时按位比对 (同拓扑的矩形 / 字形轮廓动词完全相同)
+            int bucket = 0;
+            FillRule rule = FillRule::None;
+            bool live = false;
+            bool cached = false;             ///< 是否登记在 cache 中 (键碰撞时生成的条目不登记)
+
+            [[nodiscard]] bool matches ( const detail::typst_tess::PathView& path, FillRule r, int b ) const noexcept
+            {
+                return live && cached && rule == r && bucket == b && points.size () == path.points.size () &&
+                       std::equal ( verbs.begin (), verbs.end (), path.verbs.begin (), path.verbs.end () ) &&
+                       ( points.empty () || std::memcmp ( points.data (), path.points.data (), points.size () * sizeof ( Point2D ) ) == 0 );
+            }
+        };
+
+        /// Rect / Line 合成路径所需的临时存储
+        struct PathStorage
+        {
+            Point2D points[ 4 ];
+            PathVerb verbs[ 5 ];
+        };
+
+        static detail::typst_tess::PathView viewOf ( const Geometry& g, PathStorage& storage ) noexcept
+        {
+            switch ( g.ty )
+            {
+                case GeometryType::Path:
+                    return { std::span< const Point2D > ( g.data.path.points.ptr, g.data.path.points.len ),
+                             std::span< const PathVerb > ( g.data.path.verbs.ptr, g.data.path.verbs.len ) };
+                case GeometryType::Line:
+                    storage.points[ 0 ] = g.data.line.start;
+                    storage.points[ 1 ] = g.data.line.end;
+                    storage.verbs[ 0 ] = PathVerb::MoveTo;
+                    storage.verbs[ 1 ] = PathVerb::LineTo;
+                    return { std::span< const Point2D > ( storage.points, 2 ), std::span< const PathVerb > ( storage.verbs, 2 ) };
+                case GeometryType::Rect:
+                {
+                    const Point2D o = g.data.rect.origin;
+                    const double w = g.data.rect.width, h = g.data.rect.height;
+                    storage.points[ 0 ] = o;
+                    storage.points[ 1 ] = Point2D{ o.x + w, o.y };
+                    storage.points[ 2 ] = Point2D{ o.x + w, o.y + h };
+                    storage.points[ 3 ] = Point2D{ o.x, o.y + h };
+                    storage.verbs[ 0 ] = PathVerb::MoveTo;
+                    storage.verbs[ 1 ] = PathVerb::LineTo;
+                    storage.verbs[ 2 ] = PathVerb::LineTo;
+                    storage.verbs[ 3 ] = PathVerb::LineTo;
+                    storage.verbs[ 4 ] = PathVerb::Close;
+                    return { std::span< const Point2D > ( storage.points, 4 ), std::span< const PathVerb > ( storage.verbs, 5 ) };
+                }
+            }
+            return {};
+        }
+
+        /// 缩放档位：ceil(2·log2(s))，即以 √2 为步长向上取整
+        static int zoomBucket ( double scale ) noexcept
+        {
+            if ( !( scale > 0.0 ) || !std::isfinite ( scale ) ) return 0;
+            return std::clamp ( static_cast< int > ( std::ceil ( 2.0 * std::log2 ( scale ) ) ), -96, 96 );
+        }
+
+        static double bucketScale ( int bucket ) noexcept { return std::exp2 ( 0.5 * bucket ); }
+
+        static uint64_t cacheKey ( uint64_t content, FillRule rule, int bucket ) noexcept
+        {
+            uint64_t tag = ( static_cast< uint64_t > ( static_cast< uint8_t > ( rule ) ) << 8 ) | static_cast< uint8_t > ( bucket + 128 );
+            tag *= 0x9E3779B97F4A7C15ull;
+            return content ^ ( tag + ( content << 6 ) + ( content >> 2 ) );
+        }
+
+        static size_t footprint ( const TessellatedGeometry& g ) noexcept
+        {
+            return ( g.outline.x.size () + g.outline.y.size () + g.fill.x.size () + g.fill.y.size () + g.fill.z.size () ) * sizeof ( double ) +
+                   ( g.contour_ends.size () + g.fill.indices.size () ) * sizeof ( uint32_t );
+        }
+
+        /// 取一个空闲条目 (优先复用被淘汰的下标) 并记录路径指纹
+        uint32_t allocate ( const detail::typst_tess::PathView& path, FillRule rule, int bucket, uint64_t key, bool cached )
+        {
+            uint32_t index;
+            if ( !free_slots.empty () )
+            {
+                index = free_slots.back ();
+                free_slots.pop_back ();
+            }
+            else
+            {
+                index = static_cast< uint32_t > ( entries.size () );
+                entries.emplace_back ();
+                slots.emplace_back ();
+            }
+
+            Slot& slot = slots[ index ];
+            slot.key = key;
+            slot.verbs.assign ( path.verbs.begin (), path.verbs.end () );
+            slot.points.assign ( path.points.begin (), path.points.end () );
+            slot.bucket = bucket;
+            slot.rule = rule;
+            slot.live = true;
+            slot.cached = cached;
+            ++live_count;
+            return index;
+        }
+
+        void release ( uint32_t index )
+        {
+            Slot& slot = slots[ index ];
+            if ( slot.cached ) cache.erase ( slot.key );
+            live_bytes -= slot.bytes;
+            --live_count;
+            entries[ index ] = TessellatedGeometry{};
+            slot = Slot{};
+            free_slots.push_back ( index );
+        }
+
+        /// 💡 超出预算时按最近使用帧淘汰，且一次淘汰到预算的 3/4，避免在预算边缘每次调用都重新排序
+        void evict ()
+        {
+            if ( live_bytes <= max_bytes ) return;
+
+            victims.clear ();
+            for ( uint32_t i = 0; i < slots.size (); ++i )
+            {
+                if ( slots[ i ].live && slots[ i ].last_use < frame ) victims.push_back ( i );
+            }
+            std::sort ( victims.begin (), victims.end (),
+                        [ this ] ( uint32_t a, uint32_t b ) { return slots[ a ].last_use < slots[ b ].last_use; } );
+
+            const size_t target = max_bytes - max_bytes / 4;
+            for ( const uint32_t i : victims )
+            {
+                if ( live_bytes <= target ) break;
+                release ( i );
+            }
+        }
+
+        double tolerance_px;                                    ///< 屏幕空间最大弦偏差 (像素)
+        size_t max_bytes;                                       ///< 缓存几何的内存预算 (字节)
+        std::vector< TessellatedGeometry > entries;             ///< 缓存条目，下标即 TessellatedDraw::geometry
+        std::vector< Slot > slots;                              ///< 与 entries 一一对应的元数据
+        std::vector< uint32_t > free_slots;                     ///< 被淘汰、可复用的条目下标
+        utils::FlatMap< uint64_t, uint32_t > cache;             ///< (内容, 填充规则, 档位) -> 条目下标
+        uint64_t frame = 0;
+        size_t live_bytes = 0;
+        size_t live_count = 0;
+
+        // 单次 tessellate 调用的暂存区 (复用容量)
+        std::vector< uint64_t > geometry_hash;
+        std::vector< uint8_t > geometry_hashed;
+        std::vector< Job > pending;
+        std::vector< uint32_t > victims;
+    };
+}   // namespace StuCanvas
@@ -0,0 +1,265 @@
+/***************************************************************************
+* Copyright (c) 2026 Tian Yuxuan (Friendships666)                          *
+*                                                                          *
+* Distributed under the terms of the MIT License.                          *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+***************************************************************************/
+
+//! 常驻 Typst 引擎：字体只扫描 / 建索引一次，Library、FontBook 与 comemo 记忆化缓存跨编译复用。
+
+use std::collections::HashMap;
+use std::fs;
+use std::path::{Path, PathBuf};
+use std::sync::{Mutex, OnceLock};
+use std::time::{SystemTime, UNIX_EPOCH};
+
+use memmap2::Mmap;
+use typst::diag::{FileError, FileResult};
+use typst::foundations::{Bytes, Datetime};
+use typst::layout::PagedDocument;
+use typst::syntax::{FileId, Source, VirtualPath};
+use typst::text::{Font, FontBook, FontInfo};
+use typst::utils::LazyHash;
+use typst::{Library, LibraryExt, World};
+use typst_kit::download::{Downloader, ProgressSink};
+use typst_kit::package::PackageStorage;
+
+use crate::outline_builder::GlyphCache;
+
+/// 每次编译结束后，连续这么多次编译都未被命中的 comemo 缓存条目会被回收
+/// (与 typst-cli watch 模式一致；设为 0 即等价于旧的一次性引擎行为)
+const COMEMO_EVICT_MAX_AGE: usize = 10;
+
+// =====================================================================
+// 1. 字体缓存：创建时仅解析 FontInfo 建立 FontBook，字形数据首次使用时才 mmap 载入
+// =====================================================================
+
+struct FontSlot {
+    path: PathBuf,
+    index: u32,
+    font: OnceLock<Option<Font>>,
+}
+
+impl FontSlot {
+    fn get(&self) -> Option<Font> {
+        self.font
+            .get_or_init(|| {
+                let file = fs::File::open(&self.path).ok()?;
+                // 💡 只读映射：零拷贝交给 Bytes，多个字形表按需缺页载入，CJK 大字库不会整体读入内存
+                let map = unsafe { Mmap::map(&file) }.ok()?;
+                Font::new(Bytes::new(map), self.index)
+            })
+            .clone()
+    }
+}
+
+pub struct FontCache {
+    book: LazyHash<FontBook>,
+    slots: Vec<FontSlot>,
+}
+
+impl FontCache {
+    /// 扫描字体目录 (ttf / otf / ttc)，为每个字面登记一个惰性槽位
+    pub fn scan(dir: &Path) -> Self {
+        let mut book = FontBook::new();
+        let mut slots = Vec::new();
+
+        if let Ok(entries) = fs::read_dir(dir) {
+            let mut paths: Vec<PathBuf> = entries.flatten().map(|e| e.path()).collect();
+            paths.sort(); // 目录顺序与平台相关，排序后字体回退顺序稳定
+
+            for path in paths {
+                let is_font = path
+                    .extension()
+                    .map(|ext| matches!(ext.to_string_lossy().to_lowercase().as_str(), "ttf" | "otf" | "ttc"))
+                    .unwrap_or(false);
+                if !is_font {
+                    continue;
+                }
+
+                let Ok(file) = fs::File::open(&path) else { continue };
+                let Ok(map) = (unsafe { Mmap::map(&file) }) else { continue };
+
+                for (index, info) in FontInfo::iter(&map).enumerate() {
+                    book.push(info);
+                    slots.push(FontSlot { path: path.clone(), index: index as u32, font: OnceLock::new() });
+                }
+            }
+        }
+
+        Self { book: LazyHash::new(book), slots }
+    }
+
+    pub fn font(&self, index: usize) -> Option<Font> {
+        self.slots.get(index)?.get()
+    }
+}
+
+// =====================================================================
+// 2. 包文件缓存：@namespace/name:version 依次查找本地数据目录、缓存目录，缺失时下载到缓存目录
+//    (与一次性引擎的 with_package_file_resolver 行为一致)
+// =====================================================================
+
+struct FileCache {
+    packages: PackageStorage,
+    /// 同一时刻只准备一个包：并行编译同时引用一个新包时不会重复下载
+    preparing: Mutex<()>,
+    /// 💡 只缓存成功的结果：包缺失或下载失败时下次编译会重新尝试，包稍后落地即可使用
+    bytes: Mutex<HashMap<FileId, Bytes>>,
+    sources: Mutex<HashMap<FileId, Source>>,
+}
+
+impl Default for FileCache {
+    fn default() -> Self {
+        Self {
+            // None / None：沿用 typst-cli 的默认目录 ({data,cache}_dir/typst/packages)
+            packages: PackageStorage::new(None, None, Downloader::new(concat!("stucanvas-typst-c/", env!("CARGO_PKG_VERSION")))),
+            preparing: Mutex::new(()),
+            bytes: Mutex::new(HashMap::new()),
+            sources: Mutex::new(HashMap::new()),
+        }
+    }
+}
+
+impl FileCache {
+    fn resolve_path(&self, id: FileId) -> FileResult<PathBuf> {
+        let Some(spec) = id.package() else {
+            // 与一次性引擎一致：主文件之外不开放本地文件系统访问
+            return Err(FileError::NotFound(id.vpath().as_rootless_path().into()));
+        };
+
+        let dir = {
+            let _guard = self.preparing.lock().unwrap();
+            self.packages.prepare_package(spec, &mut ProgressSink).map_err(FileError::Package)?
+        };
+        id.vpath().resolve(&dir).ok_or(FileError::AccessDenied)
+    }
+
+    fn file(&self, id: FileId) -> FileResult<Bytes> {
+        if let Some(hit) = self.bytes.lock().unwrap().get(&id) {
+            return Ok(hit.clone());
+        }
+        let bytes = self
+            .resolve_path(id)
+            .and_then(|path| fs::read(&path).map_err(|e| FileError::from_io(e, &path)))
+            .map(Bytes::new)?;
+        self.bytes.lock().unwrap().insert(id, bytes.clone());
+        Ok(bytes)
+    }
+
+    fn source(&self, id: FileId) -> FileResult<Source> {
+        if let Some(hit) = self.sources.lock().unwrap().get(&id) {
+            return Ok(hit.clone());
+        }
+        let bytes = self.file(id)?;
+        let text = std::str::from_utf8(&bytes).map_err(|_| FileError::InvalidUtf8)?;
+        let source = Source::new(id, text.to_owned());
+        self.sources.lock().unwrap().insert(id, source.clone());
+        Ok(source)
+    }
+}
+
+// =====================================================================
+// 3. 引擎本体与单次编译视图
+// =====================================================================
+
+pub struct Engine {
+    library: LazyHash<Library>,
+    fonts: FontCache,
+    files: FileCache,
+    glyphs: GlyphCache,
+    main_id: FileId,
+}
+
+/// 单次编译的 World：共享引擎的全部缓存，仅持有本次的主源文件
+struct CompileWorld<'a> {
+    engine: &'a Engine,
+    main: Source,
+}
+
+impl World for CompileWorld<'_> {
+    fn library(&self) -> &LazyHash<Library> {
+        &self.engine.library
+    }
+
+    fn book(&self) -> &LazyHash<FontBook> {
+        &self.engine.fonts.book
+    }
+
+    fn main(&self) -> FileId {
+        self.main.id()
+    }
+
+    fn source(&self, id: FileId) -> FileResult<Source> {
+        if id == self.main.id() {
+            Ok(self.main.clone())
+        } else {
+            self.engine.files.source(id)
+        }
+    }
+
+    fn file(&self, id: FileId) -> FileResult<Bytes> {
+        self.engine.files.file(id)
+    }
+
+    fn font(&self, index: usize) -> Option<Font> {
+        self.engine.fonts.font(index)
+    }
+
+    fn today(&self, offset: Option<i64>) -> Option<Datetime> {
+        let secs = SystemTime::now().duration_since(UNIX_EPOCH).ok()?.as_secs() as i64;
+        let days = (secs + offset.unwrap_or(0) * 3600).div_euclid(86_400);
+
+        // 公历日期换算 (Howard Hinnant, days_from_civil 的逆运算)
+        let z = days + 719_468;
+        let era = z.div_euclid(146_097);
+        let doe = z - era * 146_097;
+        let yoe = (doe - doe / 1460 + doe / 36_524 - doe / 146_096) / 365;
+        let doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        let mp = (5 * doy + 2) / 153;
+        let day = (doy - (153 * mp + 2) / 5 + 1) as u8;
+        let month = if mp < 10 { mp + 3 } else { mp - 9 } as u8;
+        let year = (yoe + era * 400 + i64::from(month <= 2)) as i32;
+
+        Datetime::from_ymd(year, month, day)
+    }
+}
+
+impl Engine {
+    /// 扫描字体目录并构建标准库；之后的所有编译共享这些资源
+    pub fn new(fonts_dir: &Path) -> Self {
+        Self {
+            library: LazyHash::new(Library::default()),
+            fonts: FontCache::scan(fonts_dir),
+            files: FileCache::default(),
+            glyphs: GlyphCache::default(),
+            main_id: FileId::new(None, VirtualPath::new("main.typ")),
+        }
+    }
+
+    /// 编译一段标记文本，失败时返回格式化后的诊断信息。可从多个线程并发调用 (所有缓存均为只读或带锁)
+    pub fn compile(&self, markup: &str) -> Result<PagedDocument, String> {
+        let result = self.compile_document(markup);
+        self.evict_caches();
+        result
+    }
+
+    /// 编译但不推进 comemo 缓存代数：批量编译时由调用方在整批结束后统一调用 evict_caches，
+    /// 避免并行任务互相把对方刚建立的记忆化条目提前老化
+    pub fn compile_document(&self, markup: &str) -> Result<PagedDocument, String> {
+        let world = CompileWorld { engine: self, main: Source::new(self.main_id, markup.to_owned()) };
+        typst::compile::<PagedDocument>(&world).output.map_err(|diagnostics| format!("{:#?}", diagnostics))
+    }
+
+    /// 推进 comemo 与字形缓存的代数并回收老化条目 (两者同步老化，字形缓存另有条目上限)
+    pub fn evict_caches(&self) {
+        comemo::evict(COMEMO_EVICT_MAX_AGE);
+        self.glyphs.evict(COMEMO_EVICT_MAX_AGE);
+    }
+
+    /// 跨编译共享的字形轮廓缓存 (同一字体的同一字形只解析一次)
+    pub fn glyphs(&self) -> &GlyphCache {
+        &self.glyphs
+    }
+}
@@ -10,20 +10,26 @@ pub mod types;
 pub mod outline_builder;
 pub mod parser;
 pub mod printer;
+pub mod engine;
+pub mod packed;
 
 pub use printer::print_detailed_outline;
 
 use std::ffi::{CStr, CString};
-use std::os::raw::c_char;
+use std::os::raw::{c_char, c_void};
+use std::sync::Arc;
 use std::fs;
 use std::path::Path;
-use std::collections::HashMap;
 use std::mem::ManuallyDrop; // 💡 【关键修复 1】：显式导入 ManuallyDrop，消除 E0433 报错
 use typst_as_lib::TypstEngine;
 use typst::layout::{PagedDocument, Point, Transform};
+use rayon::prelude::*;
 
 use crate::types::*;
 use crate::parser::{GeometryPool, extract_frame_to_ffi};
+use crate::outline_builder::GlyphCache;
+use crate::engine::Engine;
+use crate::packed::{PackedOutlineHeader, PackedPrecision, pack_document, free_packed};
 
 #[repr(C)]
 pub struct CompileResult {
@@ -31,6 +37,9 @@ pub struct CompileResult {
     pub error_msg: *mut c_char,
 }
 
+// 💡 CompileResult 独占其指向的堆内存 (所有权随值转移给 C++)，在工作线程间移动是安全的
+unsafe impl Send for CompileResult {}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn stucanvas_compile_typst(
     markup_str: *const c_char,
@@ -69,35 +78,294 @@ pub unsafe extern "C" fn stucanvas_compile_typst(
         .build();
 
     match engine.compile::<PagedDocument>().output {
-        Ok(compiled_doc) => {
-            let mut pool = GeometryPool { lookup: HashMap::new() };
-            let mut geometries = Vec::new();
-            let mut instances = Vec::new();
+        Ok(compiled_doc) => document_to_result(&compiled_doc, &GlyphCache::default()),
+        Err(error) => error_to_result(compile_error_message(format!("{:#?}", error))),
+    }
+}
 
-            if let Some(page) = compiled_doc.pages.first() {
-                extract_frame_to_ffi(&page.frame, Point::zero(), Transform::identity(), &mut pool, &mut geometries, &mut instances);
-            }
+/// 将编译完成的文档首页转换为 FFI 矢量大纲 (一次性引擎与常驻引擎共用)
+fn document_to_result(compiled_doc: &PagedDocument, glyphs: &GlyphCache) -> CompileResult {
+    let mut pool = GeometryPool::new(glyphs);
+    let mut geometries = Vec::new();
+    let mut instances = Vec::new();
+    let mut placements = Vec::new();
 
-            let final_outline = Box::new(Outline {
-                geometries: CVec::from_vec(geometries),
-                instances: CVec::from_vec(instances),
-            });
+    if let Some(page) = compiled_doc.pages.first() {
+        extract_frame_to_ffi(&page.frame, Point::zero(), Transform::identity(), &mut pool, &mut geometries, &mut instances, &mut placements);
+    }
 
-            CompileResult {
-                outline: Box::into_raw(final_outline),
-                error_msg: std::ptr::null_mut::<c_char>(),
-            }
-        }
-        Err(error) => {
-            let err_str = format!("❌ [Typst 语法/编译错误]\n{:#?}", error);
+    let final_outline = Box::new(Outline {
+        geometries: CVec::from_vec(geometries),
+        instances: CVec::from_vec(instances),
+        glyphs: CVec::from_vec(placements),
+    });
 
-            let c_err = CString::new(err_str).unwrap_or_else(|_| CString::new("Unknown compile error").unwrap());
-            CompileResult {
-                outline: std::ptr::null_mut::<Outline>(),
-                error_msg: c_err.into_raw(),
-            }
+    CompileResult {
+        outline: Box::into_raw(final_outline),
+        error_msg: std::ptr::null_mut::<c_char>(),
+    }
+}
+
+fn compile_error_message(diagnostics: String) -> String {
+    format!("❌ [Typst 语法/编译错误]\n{}", diagnostics)
+}
+
+fn error_cstring(message: String) -> *mut c_char {
+    CString::new(message).unwrap_or_else(|_| CString::new("Unknown compile error").unwrap()).into_raw()
+}
+
+fn error_to_result(message: String) -> CompileResult {
+    CompileResult {
+        outline: std::ptr::null_mut::<Outline>(),
+        error_msg: error_cstring(message),
+    }
+}
+
+fn outline_result(engine: &Engine, compiled: Result<PagedDocument, String>) -> CompileResult {
+    match compiled {
+        Ok(compiled_doc) => document_to_result(&compiled_doc, engine.glyphs()),
+        Err(message) => error_to_result(message),
+    }
+}
+
+// =====================================================================
+// 常驻引擎 FFI：字体与 Library 仅初始化一次，comemo 缓存跨编译复用
+// =====================================================================
+
+/// 不透明句柄，C++ 侧只持有指针。引擎以 Arc 持有，异步批量任务在飞行期间销毁句柄也不会悬垂
+pub struct TypstEngineHandle {
+    engine: Arc<Engine>,
+}
+
+/// # Safety
+/// `fonts_dir` 必须是合法的以 NUL 结尾的 C 字符串；返回的句柄须经 `stucanvas_typst_engine_destroy` 释放
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn stucanvas_typst_engine_create(fonts_dir: *const c_char) -> *mut TypstEngineHandle {
+    if fonts_dir.is_null() {
+        return std::ptr::null_mut();
+    }
+    let c_fonts_path = unsafe { CStr::from_ptr(fonts_dir) }.to_string_lossy().into_owned();
+    Box::into_raw(Box::new(TypstEngineHandle { engine: Arc::new(Engine::new(Path::new(&c_fonts_path))) }))
+}
+
+/// 以常驻引擎编译单段文本；空指针时返回 None
+unsafe fn compile_single<'a>(handle: *const TypstEngineHandle, markup_str: *const c_char) -> Option<(&'a Engine, Result<PagedDocument, String>)> {
+    if handle.is_null() || markup_str.is_null() {
+        return None;
+    }
+    let c_markup = unsafe { CStr::from_ptr(markup_str) }.to_string_lossy();
+    let engine: &'a Engine = unsafe { &(*handle).engine };
+    Some((engine, engine.compile(&c_markup).map_err(compile_error_message)))
+}
+
+const NULL_HANDLE_MESSAGE: &str = "❌ [FFI Error] 传入的引擎句柄或 C 字符串指针为空！";
+
+/// # Safety
+/// `handle` 须来自 `stucanvas_typst_engine_create`；允许多个线程以同一句柄并发调用
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn stucanvas_typst_engine_compile(
+    handle: *const TypstEngineHandle,
+    markup_str: *const c_char,
+) -> CompileResult {
+    match unsafe { compile_single(handle, markup_str) } {
+        Some((engine, compiled)) => outline_result(engine, compiled),
+        None => error_to_result(NULL_HANDLE_MESSAGE.to_owned()),
+    }
+}
+
+/// 批量编译完成回调：results 数组已按输入顺序全部写入
+pub type TypstBatchCallback = unsafe extern "C" fn(user_data: *mut c_void);
+
+/// 在调用线程上把 C 字符串数组拷贝为 Rust 字符串 (空指针项保留为 None，编译时报告为该项错误)
+unsafe fn collect_markups(markups: *const *const c_char, count: usize) -> Vec<Option<String>> {
+    if markups.is_null() {
+        return vec![None; count];
+    }
+    unsafe { std::slice::from_raw_parts(markups, count) }
+        .iter()
+        .map(|&ptr| (!ptr.is_null()).then(|| unsafe { CStr::from_ptr(ptr) }.to_string_lossy().into_owned()))
+        .collect()
+}
+
+/// 在 rayon 工作池上并行编译整批标记文本，并行完成结果转换，按输入顺序写入 results
+fn compile_batch_into<R: Send>(
+    engine: &Engine,
+    markups: &[Option<String>],
+    results: &mut [R],
+    convert: &(dyn Fn(&Engine, Result<PagedDocument, String>) -> R + Sync),
+) {
+    results.par_iter_mut().zip(markups.par_iter()).enumerate().for_each(|(index, (slot, markup))| {
+        let compiled = match markup {
+            Some(markup) => engine.compile_document(markup).map_err(compile_error_message),
+            None => Err(format!("❌ [FFI Error] 批量编译第 {} 项的 C 字符串指针为空！", index)),
+        };
+        *slot = convert(engine, compiled);
+    });
+    engine.evict_caches();
+}
+
+/// 异步批量编译的公共实现：拷贝输入后立即返回，整批在 rayon 工作池上完成后调用 callback
+unsafe fn spawn_batch<R: Send + 'static>(
+    handle: *const TypstEngineHandle,
+    markups: *const *const c_char,
+    count: usize,
+    results: *mut R,
+    callback: TypstBatchCallback,
+    user_data: *mut c_void,
+    convert: impl Fn(&Engine, Result<PagedDocument, String>) -> R + Send + Sync + 'static,
+) {
+    struct SendPtr<T>(*mut T);
+    unsafe impl<T> Send for SendPtr<T> {}
+    impl<T> SendPtr<T> {
+        // 💡 经由方法取指针：闭包会整体捕获 SendPtr，而不是按字段只捕获 !Send 的裸指针
+        fn get(&self) -> *mut T {
+            self.0
         }
     }
+
+    if handle.is_null() || results.is_null() || count == 0 {
+        unsafe { callback(user_data) };
+        return;
+    }
+
+    let engine = unsafe { (*handle).engine.clone() };
+    let markups = unsafe { collect_markups(markups, count) };
+    let results = SendPtr(results);
+    let user_data = SendPtr(user_data);
+
+    rayon::spawn(move || {
+        let results = unsafe { std::slice::from_raw_parts_mut(results.get(), count) };
+        compile_batch_into(&engine, &markups, results, &convert);
+        unsafe { callback(user_data.get()) };
+    });
+}
+
+/// # Safety
+/// `handle` 须来自 `stucanvas_typst_engine_create`；`markups` 与 `results` 均须指向至少 `count` 个元素。
+/// 阻塞调用线程直到整批完成；每一项的 CompileResult 须由调用方各自释放
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn stucanvas_typst_engine_compile_batch(
+    handle: *const TypstEngineHandle,
+    markups: *const *const c_char,
+    count: usize,
+    results: *mut CompileResult,
+) {
+    if handle.is_null() || results.is_null() || count == 0 {
+        return;
+    }
+    let markups = unsafe { collect_markups(markups, count) };
+    let results = unsafe { std::slice::from_raw_parts_mut(results, count) };
+    compile_batch_into(unsafe { &(*handle).engine }, &markups, results, &outline_result);
+}
+
+/// # Safety
+/// 约束同 `stucanvas_typst_engine_compile_batch`，另外 `results` 与 `user_data` 须存活到 `callback` 被调用为止。
+/// 立即返回：标记文本在返回前已被拷贝，整批在 rayon 工作池上完成后于工作线程调用 `callback(user_data)`
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn stucanvas_typst_engine_compile_batch_async(
+    handle: *const TypstEngineHandle,
+    markups: *const *const c_char,
+    count: usize,
+    results: *mut CompileResult,
+    callback: TypstBatchCallback,
+    user_data: *mut c_void,
+) {
+    unsafe { spawn_batch(handle, markups, count, results, callback, user_data, outline_result) };
+}
+
+// =====================================================================
+// 单块 arena 输出：整份结果位于一次分配中，C++ 原地读取并以一次调用释放
+// =====================================================================
+
+#[repr(C)]
+pub struct PackedCompileResult {
+    pub arena: *mut PackedOutlineHeader, // 成功时指向 arena 首地址，失败时为空
+    pub error_msg: *mut c_char,
+}
+
+// 💡 与 CompileResult 相同：结构体独占其指向的内存，可在工作线程间转移
+unsafe impl Send for PackedCompileResult {}
+
+fn precision_from_u8(precision: u8) -> PackedPrecision {
+    if precision == PackedPrecision::F32Soa as u8 { PackedPrecision::F32Soa } else { PackedPrecision::F64Aos }
+}
+
+fn packed_result(engine: &Engine, compiled: Result<PagedDocument, String>, precision: PackedPrecision) -> PackedCompileResult {
+    match compiled {
+        Ok(compiled_doc) => PackedCompileResult {
+            arena: pack_document(&compiled_doc, engine.glyphs(), precision),
+            error_msg: std::ptr::null_mut(),
+        },
+        Err(message) => PackedCompileResult { arena: std::ptr::null_mut(), error_msg: error_cstring(message) },
+    }
+}
+
+/// # Safety
+/// 约束同 `stucanvas_typst_engine_compile`；`precision` 为 0 (f64 AoS) 或 1 (f32 SoA)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn stucanvas_typst_engine_compile_packed(
+    handle: *const TypstEngineHandle,
+    markup_str: *const c_char,
+    precision: u8,
+) -> PackedCompileResult {
+    match unsafe { compile_single(handle, markup_str) } {
+        Some((engine, compiled)) => packed_result(engine, compiled, precision_from_u8(precision)),
+        None => PackedCompileResult { arena: std::ptr::null_mut(), error_msg: error_cstring(NULL_HANDLE_MESSAGE.to_owned()) },
+    }
+}
+
+/// # Safety
+/// 约束同 `stucanvas_typst_engine_compile_batch`
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn stucanvas_typst_engine_compile_batch_packed(
+    handle: *const TypstEngineHandle,
+    markups: *const *const c_char,
+    count: usize,
+    precision: u8,
+    results: *mut PackedCompileResult,
+) {
+    if handle.is_null() || results.is_null() || count == 0 {
+        return;
+    }
+    let precision = precision_from_u8(precision);
+    let markups = unsafe { collect_markups(markups, count) };
+    let results = unsafe { std::slice::from_raw_parts_mut(results, count) };
+    compile_batch_into(unsafe { &(*handle).engine }, &markups, results, &move |engine, compiled| packed_result(engine, compiled, precision));
+}
+
+/// # Safety
+/// 约束同 `stucanvas_typst_engine_compile_batch_async`
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn stucanvas_typst_engine_compile_batch_packed_async(
+    handle: *const TypstEngineHandle,
+    markups: *const *const c_char,
+    count: usize,
+    precision: u8,
+    results: *mut PackedCompileResult,
+    callback: TypstBatchCallback,
+    user_data: *mut c_void,
+) {
+    let precision = precision_from_u8(precision);
+    unsafe {
+        spawn_batch(handle, markups, count, results, callback, user_data, move |engine, compiled| packed_result(engine, compiled, precision))
+    };
+}
+
+/// # Safety
+/// `arena` 须来自 packed 系列编译接口，且仅释放一次
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn stucanvas_free_packed_outline(arena: *mut PackedOutlineHeader) {
+    unsafe { free_packed(arena) };
+}
+
+/// # Safety
+/// `handle` 须来自 `stucanvas_typst_engine_create`，且销毁后不得再使用
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn stucanvas_typst_engine_destroy(handle: *mut TypstEngineHandle) {
+    if handle.is_null() {
+        return;
+    }
+    let _ = unsafe { Box::from_raw(handle) };
 }
 
 #[unsafe(no_mangle)]
@@ -184,6 +452,13 @@ pub unsafe extern "C" fn stucanvas_free_outline_members(outline: *mut Outline) {
         }
     }
 
+    let _ = unsafe {
+        cvec_to_vec(std::mem::replace(
+            &mut out.glyphs,
+            CVec { ptr: std::ptr::null_mut(), len: 0, cap: 0 }
+        ))
+    };
+
     let geometries = unsafe {
         cvec_to_vec(std::mem::replace(
             &mut out.geometries,
@@ -205,6 +480,6 @@ pub unsafe extern "C" fn stucanvas_free_outline(outline: *mut Outline) {
     }
     // 1. 先安全清理 Outline 内部的所有子成员堆资源
     unsafe { stucanvas_free_outline_members(outline) };
-    // 2. 重新打包为 Box，收回并彻底销毁 Outline 自身的 48 字节堆空间
+    // 2. 重新打包为 Box，收回并彻底销毁 Outline 自身 (三个 CVec 头部) 的堆空间
     let _ = unsafe { Box::from_raw(outline) };
 }
\ No newline at end of file
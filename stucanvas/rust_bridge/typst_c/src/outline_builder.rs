@@ -6,6 +6,11 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ***************************************************************************/
 
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, RwLock};
+use typst::text::Font;
+
 use crate::types::{Point2D, PathVerb};
 
 #[derive(Clone)]
@@ -91,4 +96,92 @@ impl ttf_parser::OutlineBuilder for RawOutlineBuilder {
             self.contours.push(c);
         }
     }
-}
\ No newline at end of file
+}
+
+// =====================================================================
+// 字形轮廓缓存：同一 (字体, 字形) 的轮廓只解析 / 升阶一次
+// =====================================================================
+
+/// 单个字形在字体单位 (font units) 下的合并轮廓，2 阶曲线已升为 3 阶，末尾线圈已封存
+pub struct GlyphOutline {
+    pub points: Vec<Point2D>,
+    pub verbs: Vec<PathVerb>,
+}
+
+impl GlyphOutline {
+    pub fn extract(face: &ttf_parser::Face, glyph_id: u16) -> Self {
+        let mut builder = RawOutlineBuilder { contours: Vec::new(), current_contour: None };
+        face.outline_glyph(ttf_parser::GlyphId(glyph_id), &mut builder);
+
+        // 封存最后一个线圈
+        if let Some(c) = builder.current_contour.take() {
+            builder.contours.push(c);
+        }
+
+        let mut points = Vec::new();
+        let mut verbs = Vec::new();
+        for raw_contour in builder.contours {
+            points.extend(raw_contour.points);
+            verbs.extend(raw_contour.verbs);
+        }
+        Self { points, verbs }
+    }
+}
+
+/// 字形缓存的条目上限：超出后按最近使用代数淘汰最旧的条目
+const GLYPH_CACHE_MAX_ENTRIES: usize = 65_536;
+
+struct GlyphEntry {
+    outline: Arc<GlyphOutline>,
+    /// 最近一次命中时的缓存代数 (读锁下原子更新)
+    last_used: AtomicUsize,
+}
+
+/// 跨页面 / 跨编译共享的字形轮廓缓存 (读多写少，允许多个编译线程并发查询)
+///
+/// 💡 以 typst 的 Font 作键 (内部按字体数据哈希 + 字面索引比较)，同一字族的粗体 / 斜体不会互相串用轮廓。
+/// 与 comemo 同步老化：每次 evict 推进一代，连续 max_age 代未被命中的条目被回收，并保证条目数不超过上限
+#[derive(Default)]
+pub struct GlyphCache {
+    outlines: RwLock<HashMap<(Font, u16), GlyphEntry>>,
+    generation: AtomicUsize,
+}
+
+impl GlyphCache {
+    pub fn get(&self, font: &Font, glyph_id: u16) -> Arc<GlyphOutline> {
+        let key = (font.clone(), glyph_id);
+        let generation = self.generation.load(Ordering::Relaxed);
+        if let Some(hit) = self.outlines.read().unwrap().get(&key) {
+            hit.last_used.store(generation, Ordering::Relaxed);
+            return hit.outline.clone();
+        }
+        // 解析放在锁外进行；并发未命中时以先写入者为准
+        let outline = Arc::new(GlyphOutline::extract(font.ttf(), glyph_id));
+        let mut outlines = self.outlines.write().unwrap();
+        let entry = outlines.entry(key).or_insert_with(|| GlyphEntry { outline, last_used: AtomicUsize::new(generation) });
+        entry.last_used.store(generation, Ordering::Relaxed);
+        entry.outline.clone()
+    }
+
+    /// 推进一代并回收 max_age 代内未被命中的字形；仍超过条目上限时继续按最近使用代数从旧到新淘汰。
+    /// 已交出的 Arc<GlyphOutline> 不受影响
+    pub fn evict(&self, max_age: usize) {
+        let generation = self.generation.fetch_add(1, Ordering::Relaxed) + 1;
+        let mut outlines = self.outlines.write().unwrap();
+        outlines.retain(|_, entry| generation.saturating_sub(entry.last_used.load(Ordering::Relaxed)) <= max_age);
+
+        if outlines.len() > GLYPH_CACHE_MAX_ENTRIES {
+            let mut by_age: Vec<(usize, (Font, u16))> =
+                outlines.iter().map(|(key, entry)| (entry.last_used.load(Ordering::Relaxed), key.clone())).collect();
+            let excess = outlines.len() - GLYPH_CACHE_MAX_ENTRIES;
+            by_age.select_nth_unstable_by_key(excess - 1, |(last_used, _)| *last_used);
+            for (_, key) in &by_age[..excess] {
+                outlines.remove(key);
+            }
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.outlines.read().unwrap().len()
+    }
+}
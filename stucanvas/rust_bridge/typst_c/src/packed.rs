@@ -0,0 +1,473 @@
+/***************************************************************************
+* Copyright (c) 2026 Tian Yuxuan (Friendships666)                          *
+*                                                                          *
+* Distributed under the terms of the MIT License.                          *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+***************************************************************************/
+
+//! 单次分配的紧凑 Outline：全部几何、指令、字形、渐变色标与虚线写入同一块可重定位内存 (arena)。
+//! arena 内部只使用相对偏移 / 下标区间，C++ 侧原地只读访问，并以一次调用整体释放。
+
+use std::collections::HashMap;
+use typst::layout::{Frame, FrameItem, Transform, Point, Abs, Ratio};
+use typst::visualize::{Geometry as TGeom, Paint as TPaint, Gradient as TGrad};
+use typst::text::Font;
+
+use crate::types::*;
+use crate::outline_builder::GlyphCache;
+use crate::parser::{convert_transform, convert_color, convert_cap, convert_join, push_curve, glyph_transform, run_transform};
+
+pub const PACKED_OUTLINE_MAGIC: u32 = 0x4F50_5453; // "STPO" (小端)
+pub const PACKED_OUTLINE_VERSION: u32 = 1;
+
+/// 路径点的存储格式
+#[repr(u8)]
+#[derive(Debug, Copy, Clone, PartialEq)]
+pub enum PackedPrecision {
+    F64Aos = 0, // Point2D (f64, x/y 交错)，与 Outline 精度一致
+    F32Soa = 1, // 两条 f32 数组 points_x / points_y，可直接上传 GPU 存储缓冲
+}
+
+// =====================================================================
+// 1. arena 内部数据结构 (全部 #[repr(C)] 且可按位拷贝)
+// =====================================================================
+
+/// 相对 arena 首地址的字节偏移 + 元素个数
+#[repr(C)]
+#[derive(Debug, Copy, Clone, Default)]
+pub struct PackedSpan {
+    pub offset: u64,
+    pub len: u64,
+}
+
+/// 指向 header 某个元素池的下标区间 [first, first + count)
+#[repr(C)]
+#[derive(Debug, Copy, Clone, Default)]
+pub struct PackedRange {
+    pub first: u32,
+    pub count: u32,
+}
+
+/// 一个 (子) 大纲：根页面或 Tiling 图案，各自拥有一段连续的绘制指令
+#[repr(C)]
+#[derive(Debug, Copy, Clone, Default)]
+pub struct PackedSubOutline {
+    pub instances: PackedRange,
+}
+
+/// 几何体：Path 引用点 / 动词池；Line 使用 p0 = 起点、p1 = 终点；Rect 使用 p0 = 原点、p1 = (宽, 高)
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct PackedGeometry {
+    pub ty: GeometryType,
+    pub points: PackedRange,
+    pub verbs: PackedRange,
+    pub p0: Point2D,
+    pub p1: Point2D,
+}
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct PackedPaint {
+    pub ty: PaintType,
+    pub gradient_ty: GradientType,
+    pub spread: SpreadMethod,
+    pub relative: RelativeTo,
+    pub pattern: u32, // Tiling：子大纲下标 (其余为 u32::MAX)
+    pub solid_color: RGBA,
+    pub stops: PackedRange,
+    pub start: Point2D,
+    pub end: Point2D,
+    pub radius: f64,
+    pub angle: f64,
+    pub tile_size: Point2D,
+    pub tile_spacing: Point2D,
+}
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct PackedDrawInstance {
+    pub geometry_id: u32, // 字形运行时为 GLYPH_RUN_GEOMETRY
+    pub glyph_first: u32,
+    pub glyph_count: u32,
+    pub clip: bool,
+    pub fill_rule: FillRule,
+    pub stroke_cap: LineCap,
+    pub stroke_join: LineJoin,
+    pub transform: Transform2D,
+    pub opacity: f64,
+    pub stroke_width: f64,
+    pub miter_limit: f64,
+    pub dash_offset: f64,
+    pub dashes: PackedRange,
+    pub fill_paint: PackedPaint,
+    pub stroke_paint: PackedPaint,
+}
+
+/// arena 头部，位于 arena 偏移 0 处
+#[repr(C)]
+#[derive(Debug, Copy, Clone, Default)]
+pub struct PackedOutlineHeader {
+    pub magic: u32,
+    pub version: u32,
+    pub total_size: u64, // arena 总字节数 (8 字节对齐)
+    pub precision: u32,
+    pub root: u32,       // 根大纲在 outlines 中的下标
+    pub outlines: PackedSpan,   // PackedSubOutline
+    pub geometries: PackedSpan, // PackedGeometry，下标即 geometry_id
+    pub instances: PackedSpan,  // PackedDrawInstance
+    pub glyphs: PackedSpan,     // GlyphPlacement
+    pub points: PackedSpan,     // Point2D (F64Aos)
+    pub points_x: PackedSpan,   // f32 (F32Soa)
+    pub points_y: PackedSpan,   // f32 (F32Soa)
+    pub verbs: PackedSpan,      // PathVerb
+    pub stops: PackedSpan,      // GradientStop
+    pub dashes: PackedSpan,     // f64
+}
+
+// =====================================================================
+// 2. 构建器：少量按需增长的元素池，代替每个几何 / 材质各自的小分配
+// =====================================================================
+
+pub struct PackedBuilder<'a> {
+    glyph_cache: &'a GlyphCache,
+    glyph_lookup: HashMap<(Font, u16), u32>,
+    outlines: Vec<PackedSubOutline>,
+    geometries: Vec<PackedGeometry>,
+    instances: Vec<PackedDrawInstance>,
+    glyphs: Vec<GlyphPlacement>,
+    points: Vec<Point2D>,
+    verbs: Vec<PathVerb>,
+    stops: Vec<GradientStop>,
+    dashes: Vec<f64>,
+}
+
+#[inline]
+fn range(first: usize, end: usize) -> PackedRange {
+    PackedRange { first: first as u32, count: (end - first) as u32 }
+}
+
+fn no_paint() -> PackedPaint {
+    PackedPaint {
+        ty: PaintType::None,
+        gradient_ty: GradientType::Linear,
+        spread: SpreadMethod::Pad,
+        relative: RelativeTo::Self_,
+        pattern: u32::MAX,
+        solid_color: RGBA { r: 0., g: 0., b: 0., a: 0. },
+        stops: PackedRange::default(),
+        start: Point2D { x: 0., y: 0. },
+        end: Point2D { x: 0., y: 0. },
+        radius: 0.,
+        angle: 0.,
+        tile_size: Point2D { x: 0., y: 0. },
+        tile_spacing: Point2D { x: 0., y: 0. },
+    }
+}
+
+impl<'a> PackedBuilder<'a> {
+    pub fn new(glyph_cache: &'a GlyphCache) -> Self {
+        Self {
+            glyph_cache,
+            glyph_lookup: HashMap::new(),
+            outlines: Vec::new(),
+            geometries: Vec::new(),
+            instances: Vec::new(),
+            glyphs: Vec::new(),
+            points: Vec::new(),
+            verbs: Vec::new(),
+            stops: Vec::new(),
+            dashes: Vec::new(),
+        }
+    }
+
+    /// 打包一帧，返回其子大纲下标。
+    /// 嵌套的 Tiling 图案会在材质转换时先行完成打包，故本帧指令先收集在局部数组中，结束时再整段追加，保证连续
+    pub fn pack_frame(&mut self, frame: &Frame, origin: Point, transform: Transform) -> u32 {
+        let mut local = Vec::new();
+        self.walk(frame, origin, transform, &mut local);
+
+        let first = self.instances.len();
+        self.instances.extend_from_slice(&local);
+        self.outlines.push(PackedSubOutline { instances: range(first, self.instances.len()) });
+        (self.outlines.len() - 1) as u32
+    }
+
+    fn push_path(&mut self, curve_pts: impl FnOnce(&mut Vec<Point2D>, &mut Vec<PathVerb>)) -> u32 {
+        let (p, v) = (self.points.len(), self.verbs.len());
+        curve_pts(&mut self.points, &mut self.verbs);
+        self.geometries.push(PackedGeometry {
+            ty: GeometryType::Path,
+            points: range(p, self.points.len()),
+            verbs: range(v, self.verbs.len()),
+            p0: Point2D { x: 0., y: 0. },
+            p1: Point2D { x: 0., y: 0. },
+        });
+        (self.geometries.len() - 1) as u32
+    }
+
+    fn push_primitive(&mut self, ty: GeometryType, x: Abs, y: Abs) -> u32 {
+        self.geometries.push(PackedGeometry {
+            ty,
+            points: PackedRange::default(),
+            verbs: PackedRange::default(),
+            p0: Point2D { x: 0., y: 0. },
+            p1: Point2D { x: x.to_pt(), y: y.to_pt() },
+        });
+        (self.geometries.len() - 1) as u32
+    }
+
+    fn glyph_geometry(&mut self, font: &Font, glyph_id: u16) -> u32 {
+        let key = (font.clone(), glyph_id);
+        if let Some(&id) = self.glyph_lookup.get(&key) {
+            return id;
+        }
+        let outline = self.glyph_cache.get(font, glyph_id);
+        let id = self.push_path(|pts, vbs| {
+            pts.extend_from_slice(&outline.points);
+            vbs.extend_from_slice(&outline.verbs);
+        });
+        self.glyph_lookup.insert(key, id);
+        id
+    }
+
+    fn paint(&mut self, paint: &TPaint, origin: Point, transform: Transform) -> PackedPaint {
+        let mut out = no_paint();
+        match paint {
+            TPaint::Solid(color) => {
+                out.ty = PaintType::Solid;
+                out.solid_color = convert_color(color);
+            }
+            TPaint::Gradient(grad) => {
+                let first = self.stops.len();
+                for (color, ratio) in grad.stops_ref() {
+                    self.stops.push(GradientStop { offset: ratio.get(), color: convert_color(color) });
+                }
+
+                // 与 parser::convert_paint 一致：线性渐变由 angle 驱动，起止点由渲染端结合包围盒求解
+                let center = grad.center().unwrap_or_default();
+                let focal_center = grad.focal_center().unwrap_or_default();
+                out.ty = PaintType::Gradient;
+                out.gradient_ty = match grad {
+                    TGrad::Linear(_) => GradientType::Linear,
+                    TGrad::Radial(_) => GradientType::Radial,
+                    TGrad::Conic(_) => GradientType::Conic,
+                };
+                out.relative = match grad.relative() {
+                    typst::foundations::Smart::Custom(typst::visualize::RelativeTo::Parent) => RelativeTo::Parent,
+                    _ => RelativeTo::Self_,
+                };
+                out.stops = range(first, self.stops.len());
+                out.start = Point2D { x: center.x.get(), y: center.y.get() };
+                out.end = Point2D { x: focal_center.x.get(), y: focal_center.y.get() };
+                out.radius = grad.radius().map(|r| r.get()).unwrap_or(1.0);
+                out.angle = grad.angle().map(|a| a.to_rad()).unwrap_or(0.0);
+            }
+            TPaint::Tiling(tiling) => {
+                out.ty = PaintType::Tiling;
+                out.pattern = self.pack_frame(tiling.frame(), origin, transform);
+                out.tile_size = Point2D { x: tiling.size().x.to_pt(), y: tiling.size().y.to_pt() };
+                out.tile_spacing = Point2D { x: tiling.spacing().x.to_pt(), y: tiling.spacing().y.to_pt() };
+            }
+        }
+        out
+    }
+
+    fn stroke_fields(&mut self, stroke: Option<&typst::visualize::FixedStroke>, origin: Point, transform: Transform, inst: &mut PackedDrawInstance) {
+        let Some(stroke) = stroke else { return };
+        inst.stroke_paint = self.paint(&stroke.paint, origin, transform);
+        inst.stroke_width = stroke.thickness.to_pt();
+        inst.stroke_cap = convert_cap(&stroke.cap);
+        inst.stroke_join = convert_join(&stroke.join);
+        inst.miter_limit = stroke.miter_limit.get();
+        if let Some(dash) = &stroke.dash {
+            let first = self.dashes.len();
+            self.dashes.extend(dash.array.iter().map(|l| l.to_pt()));
+            inst.dashes = range(first, self.dashes.len());
+            inst.dash_offset = dash.phase.to_pt();
+        }
+    }
+
+    fn walk(&mut self, frame: &Frame, origin: Point, transform: Transform, out: &mut Vec<PackedDrawInstance>) {
+        for (pos, item) in frame.items() {
+            match item {
+                FrameItem::Shape(shape, _) => {
+                    let abs_pos = origin + *pos;
+                    let shape_transform = transform.pre_concat(Transform {
+                        sx: Ratio::new(1.0), ky: Ratio::new(0.0), kx: Ratio::new(0.0), sy: Ratio::new(1.0),
+                        tx: Abs::pt(abs_pos.x.to_pt()),
+                        ty: Abs::pt(abs_pos.y.to_pt()),
+                    });
+
+                    let geometry_id = match &shape.geometry {
+                        TGeom::Line(target) => self.push_primitive(GeometryType::Line, target.x, target.y),
+                        TGeom::Rect(size) => self.push_primitive(GeometryType::Rect, size.x, size.y),
+                        TGeom::Curve(curve) => self.push_path(|pts, vbs| push_curve(curve, pts, vbs)),
+                    };
+
+                    let mut inst = self.instance(geometry_id, &shape_transform);
+                    inst.fill_rule = match shape.fill_rule {
+                        typst::visualize::FillRule::NonZero => FillRule::NonZero,
+                        typst::visualize::FillRule::EvenOdd => FillRule::EvenOdd,
+                    };
+                    if let Some(fill) = &shape.fill {
+                        inst.fill_paint = self.paint(fill, origin, transform);
+                    }
+                    self.stroke_fields(shape.stroke.as_ref(), origin, transform, &mut inst);
+                    out.push(inst);
+                }
+
+                FrameItem::Text(text) => {
+                    let scale = text.size.to_pt() as f32 / (text.font.ttf().units_per_em() as f32);
+                    let glyph_first = self.glyphs.len();
+
+                    let mut cursor_x = 0.0;
+                    for glyph in &text.glyphs {
+                        let offset_x = glyph.x_offset.at(text.size).to_pt() as f32;
+                        let offset_y = glyph.y_offset.at(text.size).to_pt() as f32;
+                        let geometry_id = self.glyph_geometry(&text.font, glyph.id);
+                        let ts = glyph_transform(transform, origin, *pos, scale, cursor_x + offset_x, offset_y);
+                        self.glyphs.push(GlyphPlacement { geometry_id, transform: convert_transform(&ts) });
+                        cursor_x += glyph.x_advance.at(text.size).to_pt() as f32;
+                    }
+
+                    // 字形区间必须在材质转换 (可能递归打包 Tiling 并追加字形) 之前确定
+                    let mut inst = self.instance(GLYPH_RUN_GEOMETRY, &run_transform(transform, origin, *pos));
+                    inst.glyph_first = glyph_first as u32;
+                    inst.glyph_count = (self.glyphs.len() - glyph_first) as u32;
+                    inst.fill_paint = self.paint(&text.fill, origin, transform);
+                    self.stroke_fields(text.stroke.as_ref(), origin, transform, &mut inst);
+                    out.push(inst);
+                }
+
+                FrameItem::Group(group) => {
+                    let new_origin = origin + *pos;
+                    let new_transform = transform.pre_concat(group.transform);
+
+                    if let Some(clip_curve) = &group.clip {
+                        let geometry_id = self.push_path(|pts, vbs| push_curve(clip_curve, pts, vbs));
+                        let mut inst = self.instance(geometry_id, &new_transform);
+                        inst.clip = true;
+                        out.push(inst);
+                    }
+
+                    self.walk(&group.frame, new_origin, new_transform, out);
+                }
+                _ => {}
+            }
+        }
+    }
+
+    fn instance(&self, geometry_id: u32, transform: &Transform) -> PackedDrawInstance {
+        PackedDrawInstance {
+            geometry_id,
+            glyph_first: 0,
+            glyph_count: 0,
+            clip: false,
+            fill_rule: FillRule::NonZero,
+            stroke_cap: LineCap::Butt,
+            stroke_join: LineJoin::Miter,
+            transform: convert_transform(transform),
+            opacity: 1.0,
+            stroke_width: 0.0,
+            miter_limit: 4.0,
+            dash_offset: 0.0,
+            dashes: PackedRange::default(),
+            fill_paint: no_paint(),
+            stroke_paint: no_paint(),
+        }
+    }
+
+    // =================================================================
+    // 3. 定稿：计算各池偏移并一次性拷入按 8 字节对齐的单块内存
+    // =================================================================
+
+    pub fn finish(self, root: u32, precision: PackedPrecision) -> *mut PackedOutlineHeader {
+        let mut cursor = std::mem::size_of::<PackedOutlineHeader>();
+        let mut place = |bytes: usize, len: usize| {
+            let span = PackedSpan { offset: cursor as u64, len: len as u64 };
+            cursor = (cursor + bytes + 7) & !7;
+            span
+        };
+
+        let mut header = PackedOutlineHeader {
+            magic: PACKED_OUTLINE_MAGIC,
+            version: PACKED_OUTLINE_VERSION,
+            precision: precision as u32,
+            root,
+            ..Default::default()
+        };
+        header.outlines = place(std::mem::size_of_val(self.outlines.as_slice()), self.outlines.len());
+        header.geometries = place(std::mem::size_of_val(self.geometries.as_slice()), self.geometries.len());
+        header.instances = place(std::mem::size_of_val(self.instances.as_slice()), self.instances.len());
+        header.glyphs = place(std::mem::size_of_val(self.glyphs.as_slice()), self.glyphs.len());
+        match precision {
+            PackedPrecision::F64Aos => {
+                header.points = place(std::mem::size_of_val(self.points.as_slice()), self.points.len());
+            }
+            PackedPrecision::F32Soa => {
+                header.points_x = place(self.points.len() * 4, self.points.len());
+                header.points_y = place(self.points.len() * 4, self.points.len());
+            }
+        }
+        header.verbs = place(self.verbs.len(), self.verbs.len());
+        header.stops = place(std::mem::size_of_val(self.stops.as_slice()), self.stops.len());
+        header.dashes = place(std::mem::size_of_val(self.dashes.as_slice()), self.dashes.len());
+        header.total_size = cursor as u64;
+
+        // 以 u64 为单位分配以保证 8 字节对齐；零填充使对齐空隙的内容确定
+        let words = vec![0u64; cursor / 8].into_boxed_slice();
+        let base = Box::into_raw(words) as *mut u8;
+
+        unsafe fn copy<T: Copy>(base: *mut u8, span: PackedSpan, src: &[T]) {
+            if !src.is_empty() {
+                unsafe { std::ptr::copy_nonoverlapping(src.as_ptr(), base.add(span.offset as usize) as *mut T, src.len()) };
+            }
+        }
+
+        unsafe {
+            std::ptr::write(base as *mut PackedOutlineHeader, header);
+            copy(base, header.outlines, &self.outlines);
+            copy(base, header.geometries, &self.geometries);
+            copy(base, header.instances, &self.instances);
+            copy(base, header.glyphs, &self.glyphs);
+            match precision {
+                PackedPrecision::F64Aos => copy(base, header.points, &self.points),
+                PackedPrecision::F32Soa => {
+                    let xs = base.add(header.points_x.offset as usize) as *mut f32;
+                    let ys = base.add(header.points_y.offset as usize) as *mut f32;
+                    for (i, p) in self.points.iter().enumerate() {
+                        *xs.add(i) = p.x as f32;
+                        *ys.add(i) = p.y as f32;
+                    }
+                }
+            }
+            copy(base, header.verbs, &self.verbs);
+            copy(base, header.stops, &self.stops);
+            copy(base, header.dashes, &self.dashes);
+        }
+
+        base as *mut PackedOutlineHeader
+    }
+}
+
+/// 打包文档首页；无页面时得到一个指令为空的根大纲
+pub fn pack_document(doc: &typst::layout::PagedDocument, glyphs: &GlyphCache, precision: PackedPrecision) -> *mut PackedOutlineHeader {
+    let mut builder = PackedBuilder::new(glyphs);
+    let root = match doc.pages.first() {
+        Some(page) => builder.pack_frame(&page.frame, Point::zero(), Transform::identity()),
+        None => builder.pack_frame(&Frame::soft(typst::layout::Size::zero()), Point::zero(), Transform::identity()),
+    };
+    builder.finish(root, precision)
+}
+
+/// # Safety
+/// `arena` 须来自 `pack_document`，且仅释放一次
+pub unsafe fn free_packed(arena: *mut PackedOutlineHeader) {
+    if arena.is_null() {
+        return;
+    }
+    let words = unsafe { (*arena).total_size } as usize / 8;
+    let _ = unsafe { Box::from_raw(std::ptr::slice_from_raw_parts_mut(arena as *mut u64, words)) };
+}
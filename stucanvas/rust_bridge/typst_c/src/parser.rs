@@ -9,16 +9,49 @@
 use std::collections::HashMap;
 use std::mem::ManuallyDrop;
 use typst::layout::{Frame, FrameItem, Transform, Point, Abs, Ratio};
-use typst::visualize::{Geometry as TGeom, CurveItem, Paint as TPaint, Color, Gradient as TGrad};
+use typst::visualize::{Geometry as TGeom, Curve, CurveItem, Paint as TPaint, Color, Gradient as TGrad};
+use typst::text::Font;
 
 use crate::types::*;
-use crate::outline_builder::{RawOutlineBuilder};
+use crate::outline_builder::GlyphCache;
 
 // =====================================================================
 // 1. 编译期去重几何池
 // =====================================================================
-pub struct GeometryPool {
-    pub lookup: HashMap<(String, u16), u32>,
+pub struct GeometryPool<'a> {
+    pub lookup: HashMap<(Font, u16), u32>,
+    pub glyphs: &'a GlyphCache,
+}
+
+impl<'a> GeometryPool<'a> {
+    pub fn new(glyphs: &'a GlyphCache) -> Self {
+        Self { lookup: HashMap::new(), glyphs }
+    }
+
+    /// 获取字形在本 Outline 共享几何池中的 ID：每个 (字体, 字形) 仅登记一次，轮廓取自跨编译缓存
+    fn glyph_geometry(&mut self, font: &Font, glyph_id: u16, geometries: &mut Vec<SharedGeometry>) -> u32 {
+        let key = (font.clone(), glyph_id);
+        if let Some(&id) = self.lookup.get(&key) {
+            return id;
+        }
+
+        let outline = self.glyphs.get(font, glyph_id);
+        let id = geometries.len() as u32;
+        geometries.push(SharedGeometry {
+            geometry_id: id,
+            geometry: Geometry {
+                ty: GeometryType::Path,
+                data: GeometryUnion {
+                    path: ManuallyDrop::new(PathGeometry {
+                        points: CVec::from_vec(outline.points.clone()),
+                        verbs: CVec::from_vec(outline.verbs.clone()),
+                    })
+                }
+            },
+        });
+        self.lookup.insert(key, id);
+        id
+    }
 }
 
 // =====================================================================
@@ -43,10 +76,70 @@ pub fn convert_color(color: &Color) -> RGBA {
     RGBA { r: rgb.red, g: rgb.green, b: rgb.blue, a: rgb.alpha }
 }
 
+#[inline]
+pub fn convert_cap(cap: &typst::visualize::LineCap) -> LineCap {
+    match cap {
+        typst::visualize::LineCap::Butt => LineCap::Butt,
+        typst::visualize::LineCap::Round => LineCap::Round,
+        typst::visualize::LineCap::Square => LineCap::Square,
+    }
+}
+
+#[inline]
+pub fn convert_join(join: &typst::visualize::LineJoin) -> LineJoin {
+    match join {
+        typst::visualize::LineJoin::Miter => LineJoin::Miter,
+        typst::visualize::LineJoin::Round => LineJoin::Round,
+        typst::visualize::LineJoin::Bevel => LineJoin::Bevel,
+    }
+}
+
+/// 将 Typst 曲线追加为点 / 动词流。闭合被编码为零点消耗的 Close 动词 [1]
+pub fn push_curve(curve: &Curve, pts: &mut Vec<Point2D>, vbs: &mut Vec<PathVerb>) {
+    for item in curve.0.iter() {
+        match item {
+            CurveItem::Move(p) => { pts.push(Point2D { x: p.x.to_pt(), y: p.y.to_pt() }); vbs.push(PathVerb::MoveTo); }
+            CurveItem::Line(p) => { pts.push(Point2D { x: p.x.to_pt(), y: p.y.to_pt() }); vbs.push(PathVerb::LineTo); }
+            CurveItem::Cubic(p1, p2, p3) => {
+                pts.push(Point2D { x: p1.x.to_pt(), y: p1.y.to_pt() });
+                pts.push(Point2D { x: p2.x.to_pt(), y: p2.y.to_pt() });
+                pts.push(Point2D { x: p3.x.to_pt(), y: p3.y.to_pt() });
+                vbs.push(PathVerb::CubicTo);
+            }
+            CurveItem::Close => vbs.push(PathVerb::Close),
+        }
+    }
+}
+
+/// 字形在文本项内的最终变换：字体单位 -> pt 的缩放 (y 轴翻转) 与字形偏移，再叠加父级变换与绝对位置
+pub fn glyph_transform(transform: Transform, origin: Point, pos: Point, scale: f32, x: f32, y: f32) -> Transform {
+    let glyph_local = Transform {
+        sx: Ratio::new(scale as f64), ky: Ratio::new(0.0), kx: Ratio::new(0.0), sy: Ratio::new(-(scale as f64)),
+        tx: Abs::pt(x as f64),
+        ty: Abs::pt(y as f64),
+    };
+
+    let combined = transform.pre_concat(glyph_local);
+    Transform {
+        sx: combined.sx, ky: combined.ky, kx: combined.kx, sy: combined.sy,
+        tx: Abs::pt(combined.tx.to_pt() + origin.x.to_pt() + pos.x.to_pt()),
+        ty: Abs::pt(combined.ty.to_pt() + origin.y.to_pt() + pos.y.to_pt()),
+    }
+}
+
+/// 文本项整体的变换 (字形运行实例使用)：父级线性部分 + 绝对位置平移
+pub fn run_transform(transform: Transform, origin: Point, pos: Point) -> Transform {
+    Transform {
+        sx: transform.sx, ky: transform.ky, kx: transform.kx, sy: transform.sy,
+        tx: Abs::pt(transform.tx.to_pt() + origin.x.to_pt() + pos.x.to_pt()),
+        ty: Abs::pt(transform.ty.to_pt() + origin.y.to_pt() + pos.y.to_pt()),
+    }
+}
+
 // =====================================================================
 // 3. 材质（Paint）转换与多态解析
 // =====================================================================
-pub fn convert_paint(paint: &TPaint, origin: Point, transform: Transform) -> Paint {
+pub fn convert_paint(paint: &TPaint, origin: Point, transform: Transform, glyphs: &GlyphCache) -> Paint {
     match paint {
         TPaint::Solid(color) => Paint {
             ty: PaintType::Solid,
@@ -105,7 +198,7 @@ pub fn convert_paint(paint: &TPaint, origin: Point, transform: Transform) -> Pai
         }
         TPaint::Tiling(tiling) => {
             // 递归编译平铺子帧并打包为 Box [3.2.1]
-            let sub_outline = Box::new(compile_sub_frame(tiling.frame(), origin, transform));
+            let sub_outline = Box::new(compile_sub_frame(tiling.frame(), origin, transform, glyphs));
             Paint {
                 ty: PaintType::Tiling,
                 solid_color: RGBA { r: 0., g: 0., b: 0., a: 0. },
@@ -122,14 +215,16 @@ pub fn convert_paint(paint: &TPaint, origin: Point, transform: Transform) -> Pai
     }
 }
 
-fn compile_sub_frame(frame: &Frame, origin: Point, transform: Transform) -> Outline {
-    let mut pool = GeometryPool { lookup: HashMap::new() };
+fn compile_sub_frame(frame: &Frame, origin: Point, transform: Transform, glyphs: &GlyphCache) -> Outline {
+    let mut pool = GeometryPool::new(glyphs);
     let mut geometries = Vec::new();
     let mut instances = Vec::new();
-    extract_frame_to_ffi(frame, origin, transform, &mut pool, &mut geometries, &mut instances);
+    let mut placements = Vec::new();
+    extract_frame_to_ffi(frame, origin, transform, &mut pool, &mut geometries, &mut instances, &mut placements);
     Outline {
         geometries: CVec::from_vec(geometries),
         instances: CVec::from_vec(instances),
+        glyphs: CVec::from_vec(placements),
     }
 }
 
@@ -143,6 +238,7 @@ pub fn extract_frame_to_ffi(
     pool: &mut GeometryPool,
     geometries: &mut Vec<SharedGeometry>,
     instances: &mut Vec<DrawInstance>,
+    placements: &mut Vec<GlyphPlacement>,
 ) {
     for (pos, item) in frame.items() {
         match item {
@@ -183,23 +279,7 @@ pub fn extract_frame_to_ffi(
                         geom.ty = GeometryType::Path;
                         let mut pts = Vec::new();
                         let mut vbs = Vec::new();
-                        for item in curve.0.iter() {
-                            match item {
-                                CurveItem::Move(p) => { pts.push(Point2D { x: p.x.to_pt(), y: p.y.to_pt() }); vbs.push(PathVerb::MoveTo); }
-                                CurveItem::Line(p) => { pts.push(Point2D { x: p.x.to_pt(), y: p.y.to_pt() }); vbs.push(PathVerb::LineTo); }
-                                CurveItem::Cubic(p1, p2, p3) => {
-                                    pts.push(Point2D { x: p1.x.to_pt(), y: p1.y.to_pt() });
-                                    pts.push(Point2D { x: p2.x.to_pt(), y: p2.y.to_pt() });
-                                    pts.push(Point2D { x: p3.x.to_pt(), y: p3.y.to_pt() });
-                                    vbs.push(PathVerb::CubicTo);
-                                }
-                                CurveItem::Close => {
-                                    // 💡 【闭合动作化控制】：
-                                    // 将“闭合”设计为一种特殊的 PathVerb 指令，处于动作流中，零点消耗 [1]
-                                    vbs.push(PathVerb::Close);
-                                }
-                            }
-                        }
+                        push_curve(curve, &mut pts, &mut vbs);
                         geom.data.path = ManuallyDrop::new(PathGeometry {
                             points: CVec::from_vec(pts),
                             verbs: CVec::from_vec(vbs),
@@ -217,11 +297,13 @@ pub fn extract_frame_to_ffi(
                 // 分发实例化绘制指令
                 let instance = DrawInstance {
                     geometry_id: geom_id,
+                    glyph_first: 0,
+                    glyph_count: 0,
                     transform: convert_transform(&shape_transform),
                     opacity: 1.0,
                     clip: false,
                     fill_paint: if let Some(fill) = &shape.fill {
-                        convert_paint(fill, origin, transform)
+                        convert_paint(fill, origin, transform, pool.glyphs)
                     } else {
                         Paint { ty: PaintType::None, solid_color: unsafe { std::mem::zeroed() }, gradient: unsafe { std::mem::zeroed() }, tiling: unsafe { std::mem::zeroed() } }
                     },
@@ -230,21 +312,13 @@ pub fn extract_frame_to_ffi(
                         typst::visualize::FillRule::EvenOdd => FillRule::EvenOdd,
                     },
                     stroke_paint: if let Some(stroke) = &shape.stroke {
-                        convert_paint(&stroke.paint, origin, transform)
+                        convert_paint(&stroke.paint, origin, transform, pool.glyphs)
                     } else {
                         Paint { ty: PaintType::None, solid_color: unsafe { std::mem::zeroed() }, gradient: unsafe { std::mem::zeroed() }, tiling: unsafe { std::mem::zeroed() } }
                     },
                     stroke_width: shape.stroke.as_ref().map(|s| s.thickness.to_pt()).unwrap_or(0.0),
-                    stroke_cap: shape.stroke.as_ref().map(|s| match s.cap {
-                        typst::visualize::LineCap::Butt => LineCap::Butt,
-                        typst::visualize::LineCap::Round => LineCap::Round,
-                        typst::visualize::LineCap::Square => LineCap::Square,
-                    }).unwrap_or(LineCap::Butt),
-                    stroke_join: shape.stroke.as_ref().map(|s| match s.join {
-                        typst::visualize::LineJoin::Miter => LineJoin::Miter,
-                        typst::visualize::LineJoin::Round => LineJoin::Round,
-                        typst::visualize::LineJoin::Bevel => LineJoin::Bevel,
-                    }).unwrap_or(LineJoin::Miter),
+                    stroke_cap: shape.stroke.as_ref().map(|s| convert_cap(&s.cap)).unwrap_or(LineCap::Butt),
+                    stroke_join: shape.stroke.as_ref().map(|s| convert_join(&s.join)).unwrap_or(LineJoin::Miter),
                     miter_limit: shape.stroke.as_ref().map(|s| s.miter_limit.get()).unwrap_or(4.0),
                     dash_array: CVec::from_vec(shape.stroke.as_ref().and_then(|s| s.dash.as_ref().map(|d| d.array.iter().map(|l| l.to_pt()).collect())).unwrap_or_else(Vec::new)),
                     dash_offset: shape.stroke.as_ref().and_then(|s| s.dash.as_ref().map(|d| d.phase.to_pt())).unwrap_or(0.0),
@@ -255,102 +329,52 @@ pub fn extract_frame_to_ffi(
 
             FrameItem::Text(text) => {
                 let size_in_pt = text.size.to_pt() as f32;
-                let face = text.font.ttf();
-                let scale = size_in_pt / (face.units_per_em() as f32);
-                let font_family = text.font.info().family.clone();
+                let scale = size_in_pt / (text.font.ttf().units_per_em() as f32);
+                let glyph_first = placements.len() as u32;
 
                 let mut cursor_x = 0.0;
                 for glyph in &text.glyphs {
                     let offset_x = glyph.x_offset.at(text.size).to_pt() as f32;
                     let offset_y = glyph.y_offset.at(text.size).to_pt() as f32;
 
-                    // 1. 获取共享几何 ID（如果已存在则直接复用）
-                    let key = (font_family.clone(), glyph.id);
-                    let geom_id = if let Some(&id) = pool.lookup.get(&key) {
-                        id
-                    } else {
-                        let mut builder = RawOutlineBuilder { contours: Vec::new(), current_contour: None };
-                        face.outline_glyph(ttf_parser::GlyphId(glyph.id), &mut builder);
-
-                        // 封存最后一个线圈
-                        if let Some(c) = builder.current_contour.take() {
-                            builder.contours.push(c);
-                        }
-
-                        let mut merged_points = Vec::new();
-                        let mut merged_verbs = Vec::new();
-
-                        // 已清理：彻底删除了未使用的 `let mut closed` 局部变量，消除了静态警告 [1]
-                        for raw_contour in builder.contours {
-                            merged_points.extend(raw_contour.points);
-                            merged_verbs.extend(raw_contour.verbs);
-                        }
-
-                        let geom = Geometry {
-                            ty: GeometryType::Path,
-                            data: GeometryUnion {
-                                path: ManuallyDrop::new(PathGeometry {
-                                    points: CVec::from_vec(merged_points),
-                                    verbs: CVec::from_vec(merged_verbs),
-                                })
-                            }
-                        };
-
-                        let id = geometries.len() as u32;
-                        geometries.push(SharedGeometry {
-                            geometry_id: id,
-                            geometry: geom,
-                        });
-                        pool.lookup.insert(key, id);
-                        id
-                    };
+                    // 1. 获取共享几何 ID（同一页内每个字形只登记一次，轮廓来自跨编译缓存）
+                    let geom_id = pool.glyph_geometry(&text.font, glyph.id, geometries);
 
                     // 2. 级联矩阵计算
-                    let glyph_local = Transform {
-                        sx: Ratio::new(scale as f64), ky: Ratio::new(0.0), kx: Ratio::new(0.0), sy: Ratio::new(-(scale as f64)),
-                        tx: Abs::pt((cursor_x + offset_x) as f64),
-                        ty: Abs::pt(offset_y as f64),
-                    };
+                    let final_transform = glyph_transform(transform, origin, *pos, scale, cursor_x + offset_x, offset_y);
 
-                    let combined = transform.pre_concat(glyph_local);
-                    let final_transform = Transform {
-                        sx: combined.sx, ky: combined.ky, kx: combined.kx, sy: combined.sy,
-                        tx: Abs::pt(combined.tx.to_pt() + origin.x.to_pt() + pos.x.to_pt()),
-                        ty: Abs::pt(combined.ty.to_pt() + origin.y.to_pt() + pos.y.to_pt()),
-                    };
-
-                    // 3. 仅分发轻量级绘制指令（只含 ID 和 2D 仿射变换矩阵）
-                    let instance = DrawInstance {
+                    // 3. 每个字形只产生一条紧凑的放置记录（几何 ID + 2D 仿射变换矩阵）
+                    placements.push(GlyphPlacement {
                         geometry_id: geom_id,
                         transform: convert_transform(&final_transform),
-                        opacity: 1.0,
-                        clip: false,
-                        fill_paint: convert_paint(&text.fill, origin, transform),
-                        fill_rule: FillRule::NonZero,
-                        stroke_paint: if let Some(stroke) = &text.stroke {
-                            convert_paint(&stroke.paint, origin, transform)
-                        } else {
-                            Paint { ty: PaintType::None, solid_color: unsafe { std::mem::zeroed() }, gradient: unsafe { std::mem::zeroed() }, tiling: unsafe { std::mem::zeroed() } }
-                        },
-                        stroke_width: text.stroke.as_ref().map(|s| s.thickness.to_pt()).unwrap_or(0.0),
-                        stroke_cap: text.stroke.as_ref().map(|s| match s.cap {
-                            typst::visualize::LineCap::Butt => LineCap::Butt,
-                            typst::visualize::LineCap::Round => LineCap::Round,
-                            typst::visualize::LineCap::Square => LineCap::Square,
-                        }).unwrap_or(LineCap::Butt),
-                        stroke_join: text.stroke.as_ref().map(|s| match s.join {
-                            typst::visualize::LineJoin::Miter => LineJoin::Miter,
-                            typst::visualize::LineJoin::Round => LineJoin::Round,
-                            typst::visualize::LineJoin::Bevel => LineJoin::Bevel,
-                        }).unwrap_or(LineJoin::Miter),
-                        miter_limit: text.stroke.as_ref().map(|s| s.miter_limit.get()).unwrap_or(4.0),
-                        dash_array: CVec::from_vec(text.stroke.as_ref().and_then(|s| s.dash.as_ref().map(|d| d.array.iter().map(|l| l.to_pt()).collect())).unwrap_or_else(Vec::new)),
-                        dash_offset: text.stroke.as_ref().and_then(|s| s.dash.as_ref().map(|d| d.phase.to_pt())).unwrap_or(0.0),
-                    };
-                    instances.push(instance);
+                    });
 
                     cursor_x += glyph.x_advance.at(text.size).to_pt() as f32;
                 }
+
+                // 4. 整段文本共享一条绘制指令：材质只转换一次，字形由 [glyph_first, glyph_first + glyph_count) 给出
+                let instance = DrawInstance {
+                    geometry_id: GLYPH_RUN_GEOMETRY,
+                    glyph_first,
+                    glyph_count: placements.len() as u32 - glyph_first,
+                    transform: convert_transform(&run_transform(transform, origin, *pos)),
+                    opacity: 1.0,
+                    clip: false,
+                    fill_paint: convert_paint(&text.fill, origin, transform, pool.glyphs),
+                    fill_rule: FillRule::NonZero,
+                    stroke_paint: if let Some(stroke) = &text.stroke {
+                        convert_paint(&stroke.paint, origin, transform, pool.glyphs)
+                    } else {
+                        Paint { ty: PaintType::None, solid_color: unsafe { std::mem::zeroed() }, gradient: unsafe { std::mem::zeroed() }, tiling: unsafe { std::mem::zeroed() } }
+                    },
+                    stroke_width: text.stroke.as_ref().map(|s| s.thickness.to_pt()).unwrap_or(0.0),
+                    stroke_cap: text.stroke.as_ref().map(|s| convert_cap(&s.cap)).unwrap_or(LineCap::Butt),
+                    stroke_join: text.stroke.as_ref().map(|s| convert_join(&s.join)).unwrap_or(LineJoin::Miter),
+                    miter_limit: text.stroke.as_ref().map(|s| s.miter_limit.get()).unwrap_or(4.0),
+                    dash_array: CVec::from_vec(text.stroke.as_ref().and_then(|s| s.dash.as_ref().map(|d| d.array.iter().map(|l| l.to_pt()).collect())).unwrap_or_else(Vec::new)),
+                    dash_offset: text.stroke.as_ref().and_then(|s| s.dash.as_ref().map(|d| d.phase.to_pt())).unwrap_or(0.0),
+                };
+                instances.push(instance);
             }
 
             FrameItem::Group(group) => {
@@ -358,25 +382,10 @@ pub fn extract_frame_to_ffi(
                 let new_transform = transform.pre_concat(group.transform);
 
                 if let Some(clip_curve) = &group.clip {
+                    // 💡 剪裁路径同样携带 Close 动词，避免圆角容器等剪裁蒙版在 GPU 端 Stencil-Mask 渲染异常
                     let mut pts = Vec::new();
                     let mut vbs = Vec::new();
-                    for item in clip_curve.0.iter() {
-                        match item {
-                            CurveItem::Move(p) => { pts.push(Point2D { x: p.x.to_pt(), y: p.y.to_pt() }); vbs.push(PathVerb::MoveTo); }
-                            CurveItem::Line(p) => { pts.push(Point2D { x: p.x.to_pt(), y: p.y.to_pt() }); vbs.push(PathVerb::LineTo); }
-                            CurveItem::Cubic(p1, p2, p3) => {
-                                pts.push(Point2D { x: p1.x.to_pt(), y: p1.y.to_pt() });
-                                pts.push(Point2D { x: p2.x.to_pt(), y: p2.y.to_pt() });
-                                pts.push(Point2D { x: p3.x.to_pt(), y: p3.y.to_pt() });
-                                vbs.push(PathVerb::CubicTo);
-                            }
-                            CurveItem::Close => {
-                                // 💡 【关键修复】：在此处的 Group Clip 路径解析中，也同样将 Close 动作正确填入！
-                                // 避免含有剪裁蒙版的图容器（如圆角容器）因剪裁路径未闭合引起 Vulkan GPU 端 Stencil-Mask 渲染异常。
-                                vbs.push(PathVerb::Close);
-                            }
-                        }
-                    }
+                    push_curve(clip_curve, &mut pts, &mut vbs);
                     let clip_geom = Geometry {
                         ty: GeometryType::Path,
                         data: GeometryUnion {
@@ -395,6 +404,8 @@ pub fn extract_frame_to_ffi(
 
                     let clip_instance = DrawInstance {
                         geometry_id: geom_id,
+                        glyph_first: 0,
+                        glyph_count: 0,
                         transform: convert_transform(&new_transform),
                         opacity: 1.0,
                         clip: true,
@@ -411,7 +422,7 @@ pub fn extract_frame_to_ffi(
                     instances.push(clip_instance);
                 }
 
-                extract_frame_to_ffi(&group.frame, new_origin, new_transform, pool, geometries, instances);
+                extract_frame_to_ffi(&group.frame, new_origin, new_transform, pool, geometries, instances, placements);
             }
             _ => {}
         }
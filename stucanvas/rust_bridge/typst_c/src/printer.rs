@@ -22,10 +22,11 @@ unsafe fn print_detailed_outline_impl(outline_ptr: *const Outline, indent: &str)
     let outline: &Outline = &*outline_ptr;
     let geometries = outline.geometries.as_slice();
     let instances = outline.instances.as_slice();
+    let glyphs = outline.glyphs.as_slice();
 
     println!("{}--------------------------------------------------------------------", indent);
-    println!("{}▲ [Instanced Outline] 地址: {:?}, 共享几何体数: {}, 实例化指令数: {}",
-             indent, outline_ptr, geometries.len(), instances.len());
+    println!("{}▲ [Instanced Outline] 地址: {:?}, 共享几何体数: {}, 实例化指令数: {}, 字形放置数: {}",
+             indent, outline_ptr, geometries.len(), instances.len(), glyphs.len());
     println!("{}--------------------------------------------------------------------", indent);
 
     // 1. 打印去重几何池
@@ -39,8 +40,19 @@ unsafe fn print_detailed_outline_impl(outline_ptr: *const Outline, indent: &str)
     // 2. 打印绘制指令流
     println!("\n{}  === 2. 实例化绘制指令 (Draw Instances) ===", indent);
     for (idx, instance) in instances.iter().enumerate() {
-        println!("{}    * [Instance {}] 引用 Geometry ID: {} | 内存偏移: +{} bytes",
-                 indent, idx, instance.geometry_id, idx * std::mem::size_of::<DrawInstance>());
+        if instance.geometry_id == GLYPH_RUN_GEOMETRY {
+            println!("{}    * [Instance {}] 字形运行 (Glyph Run): glyphs[{}..{}] | 内存偏移: +{} bytes",
+                     indent, idx, instance.glyph_first, instance.glyph_first + instance.glyph_count, idx * std::mem::size_of::<DrawInstance>());
+            let first = instance.glyph_first as usize;
+            for placement in glyphs.get(first..first + instance.glyph_count as usize).unwrap_or(&[]) {
+                let ts = &placement.transform;
+                println!("{}      - 字形 -> Geometry ID: {} @ (tx: {:.4}, ty: {:.4}) pt, 缩放 ({:.6}, {:.6})",
+                         indent, placement.geometry_id, ts.tx, ts.ty, ts.sx, ts.sy);
+            }
+        } else {
+            println!("{}    * [Instance {}] 引用 Geometry ID: {} | 内存偏移: +{} bytes",
+                     indent, idx, instance.geometry_id, idx * std::mem::size_of::<DrawInstance>());
+        }
         println!("{}      - 全局不透明度 (Opacity): {:.4}", indent, instance.opacity);
         println!("{}      - 启用裁剪 (Clip Mask): {}", indent, instance.clip);
 
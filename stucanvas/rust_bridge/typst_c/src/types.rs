@@ -253,9 +253,22 @@ pub struct SharedGeometry {
     pub geometry: Geometry,
 }
 
+/// 字形运行 (glyph run) 实例使用的哨兵几何 ID：真正的几何体由 Outline::glyphs 中的放置记录给出
+pub const GLYPH_RUN_GEOMETRY: u32 = u32::MAX;
+
+/// 单个字形的放置记录：引用共享几何池中的字形轮廓，附带其最终仿射变换
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct GlyphPlacement {
+    pub geometry_id: u32,
+    pub transform: Transform2D,
+}
+
 #[repr(C)]
 pub struct DrawInstance {
     pub geometry_id: u32,
+    pub glyph_first: u32, // 字形运行：在 Outline::glyphs 中的起始下标 (普通几何实例为 0)
+    pub glyph_count: u32, // 字形运行：放置记录数量 (普通几何实例为 0)
     pub transform: Transform2D,
     pub opacity: f64,
     pub clip: bool,
@@ -276,4 +289,5 @@ pub struct DrawInstance {
 pub struct Outline {
     pub geometries: CVec<SharedGeometry>,
     pub instances: CVec<DrawInstance>,
+    pub glyphs: CVec<GlyphPlacement>,
 }
\ No newline at end of file
@@ -11,11 +11,20 @@
 #include <cstdint>
 #include <cstddef>
 #include <memory>
+#include <span>
+#include <stdexcept>
 #include <string_view>
+#include <vector>
+
+#include <oneapi/tbb/task.h>
+#include <oneapi/tbb/task_arena.h>
 
 // 前向声明不透明的 Outline 和 CompileResult 结构体
 struct Outline;
 struct CompileResult;
+struct TypstEngineHandle; ///< Rust 侧常驻引擎的不透明句柄
+struct PackedOutlineHeader;
+struct PackedCompileResult;
 
 // =====================================================================
 // 1. 导出 C 风格函数声明 (C 链接性，前置以支持 Outline 析构器调用) [1.2.2]
@@ -30,6 +39,23 @@ void stucanvas_free_outline_members(Outline* outline); // 💡 【核心新增
 void stucanvas_free_string(char* err_str);
 void stucanvas_print_detailed_outline(const Outline* outline);
 
+TypstEngineHandle* stucanvas_typst_engine_create(const char* fonts_dir);
+CompileResult stucanvas_typst_engine_compile(const TypstEngineHandle* handle, const char* markup_str);
+void stucanvas_typst_engine_destroy(TypstEngineHandle* handle);
+
+typedef void (*TypstBatchCallback)(void* user_data);
+void stucanvas_typst_engine_compile_batch(const TypstEngineHandle* handle, const char* const* markups, size_t count, CompileResult* results);
+void stucanvas_typst_engine_compile_batch_async(const TypstEngineHandle* handle, const char* const* markups, size_t count,
+                                                CompileResult* results, TypstBatchCallback callback, void* user_data);
+
+PackedCompileResult stucanvas_typst_engine_compile_packed(const TypstEngineHandle* handle, const char* markup_str, uint8_t precision);
+void stucanvas_typst_engine_compile_batch_packed(const TypstEngineHandle* handle, const char* const* markups, size_t count,
+                                                 uint8_t precision, PackedCompileResult* results);
+void stucanvas_typst_engine_compile_batch_packed_async(const TypstEngineHandle* handle, const char* const* markups, size_t count,
+                                                       uint8_t precision, PackedCompileResult* results,
+                                                       TypstBatchCallback callback, void* user_data);
+void stucanvas_free_packed_outline(PackedOutlineHeader* arena);
+
 #ifdef __cplusplus
 }
 #endif
@@ -204,9 +230,20 @@ struct SharedGeometry {
     Geometry geometry;
 };
 
+/// 字形运行 (glyph run) 实例使用的哨兵几何 ID：真正的几何体由 Outline::glyphs 中的放置记录给出
+inline constexpr uint32_t GLYPH_RUN_GEOMETRY = 0xFFFFFFFFu;
+
+/// 单个字形的放置记录：引用共享几何池中的字形轮廓 (字体单位)，附带其最终仿射变换
+struct GlyphPlacement {
+    uint32_t geometry_id;
+    Transform2D transform;
+};
+
 /// 实例化绘制指令 [3.2.1]
 struct DrawInstance {
-    uint32_t geometry_id;       ///< 引用上面的 SharedGeometry ID [3.2.1]
+    uint32_t geometry_id;       ///< 引用上面的 SharedGeometry ID；字形运行时为 GLYPH_RUN_GEOMETRY [3.2.1]
+    uint32_t glyph_first;       ///< 字形运行：在 Outline::glyphs 中的起始下标 (普通几何实例为 0)
+    uint32_t glyph_count;       ///< 字形运行：共享本条指令材质的字形数量 (普通几何实例为 0)
     Transform2D transform;      ///< 独立的列主序仿射变换矩阵 [1.1.1, 3.2.1]
     double opacity;
     bool clip;
@@ -229,11 +266,13 @@ struct DrawInstance {
 struct Outline {
     CVector<SharedGeometry> geometries; ///< 共享几何池 [3.2.1]
     CVector<DrawInstance> instances;   ///< 实例化绘制指令队列 [3.2.1]
+    CVector<GlyphPlacement> glyphs;    ///< 字形放置表，由字形运行实例按 [glyph_first, glyph_first + glyph_count) 引用
 
     // ① 默认构造：零初始化
     Outline() noexcept {
         geometries = { nullptr, 0, 0 };
         instances = { nullptr, 0, 0 };
+        glyphs = { nullptr, 0, 0 };
     }
 
     // ② 析构函数：生命周期结束（如从 FlatMap 中清空/移除）时，自动调用 FFI 仅回收成员，绝不释放 Outline 自身 [1.1.2]
@@ -249,8 +288,10 @@ struct Outline {
     Outline(Outline&& other) noexcept {
         geometries = other.geometries;
         instances = other.instances;
+        glyphs = other.glyphs;
         other.geometries = { nullptr, 0, 0 };
         other.instances = { nullptr, 0, 0 };
+        other.glyphs = { nullptr, 0, 0 };
     }
 
     // ⑤ 移动赋值
@@ -259,8 +300,10 @@ struct Outline {
             ::stucanvas_free_outline_members(this); // 先行深度释放自己旧的内部数据 [1.1.2]
             geometries = other.geometries;
             instances = other.instances;
+            glyphs = other.glyphs;
             other.geometries = { nullptr, 0, 0 };
             other.instances = { nullptr, 0, 0 };
+            other.glyphs = { nullptr, 0, 0 };
         }
         return *this;
     }
@@ -272,6 +315,100 @@ struct CompileResult {
     char* error_msg;    ///< 失败时指向编译报错字符串，成功时为 nullptr [1.2.2]
 };
 
+// =====================================================================
+// 💡 单块 arena 版 Outline：一次分配、原地只读、一次释放
+// =====================================================================
+// 全部数据位于同一块 8 字节对齐的内存中，内部只使用偏移 (PackedSpan，相对 arena 首地址)
+// 与下标区间 (PackedRange，相对 header 中对应的元素池)，因此可整体 memcpy / 映射后直接读取。
+
+/// 路径点存储格式
+enum class PackedPrecision : uint8_t {
+    F64Aos = 0, ///< Point2D (double, x/y 交错)，与 Outline 精度一致
+    F32Soa = 1  ///< points_x / points_y 两条 float 数组，可直接上传 GPU
+};
+
+struct PackedSpan {
+    uint64_t offset; ///< 相对 arena 首地址的字节偏移
+    uint64_t len;    ///< 元素个数
+};
+
+struct PackedRange {
+    uint32_t first;
+    uint32_t count;
+};
+
+/// 根页面或 Tiling 图案各自拥有一段连续的绘制指令
+struct PackedSubOutline {
+    PackedRange instances;
+};
+
+/// Path 引用点 / 动词池；Line 使用 p0 = 起点、p1 = 终点；Rect 使用 p0 = 原点、p1 = (宽, 高)
+struct PackedGeometry {
+    GeometryType ty;
+    PackedRange points;
+    PackedRange verbs;
+    Point2D p0;
+    Point2D p1;
+};
+
+struct PackedPaint {
+    PaintType ty;
+    GradientType gradient_ty;
+    SpreadMethod spread;
+    RelativeTo relative;
+    uint32_t pattern;          ///< Tiling：子大纲下标 (其余为 0xFFFFFFFF)
+    RGBA solid_color;
+    PackedRange stops;
+    Point2D start;
+    Point2D end;
+    double radius;
+    double angle;
+    Point2D tile_size;
+    Point2D tile_spacing;
+};
+
+struct PackedDrawInstance {
+    uint32_t geometry_id;      ///< 字形运行时为 GLYPH_RUN_GEOMETRY
+    uint32_t glyph_first;
+    uint32_t glyph_count;
+    bool clip;
+    FillRule fill_rule;
+    LineCap stroke_cap;
+    LineJoin stroke_join;
+    Transform2D transform;
+    double opacity;
+    double stroke_width;
+    double miter_limit;
+    double dash_offset;
+    PackedRange dashes;
+    PackedPaint fill_paint;
+    PackedPaint stroke_paint;
+};
+
+/// arena 头部 (位于偏移 0)
+struct PackedOutlineHeader {
+    uint32_t magic;            ///< 'STPO'
+    uint32_t version;
+    uint64_t total_size;       ///< arena 总字节数
+    uint32_t precision;        ///< PackedPrecision
+    uint32_t root;             ///< 根大纲在 outlines 中的下标
+    PackedSpan outlines;       ///< PackedSubOutline
+    PackedSpan geometries;     ///< PackedGeometry，下标即 geometry_id
+    PackedSpan instances;      ///< PackedDrawInstance
+    PackedSpan glyphs;         ///< GlyphPlacement
+    PackedSpan points;         ///< Point2D (F64Aos)
+    PackedSpan points_x;       ///< float (F32Soa)
+    PackedSpan points_y;       ///< float (F32Soa)
+    PackedSpan verbs;          ///< PathVerb
+    PackedSpan stops;          ///< GradientStop
+    PackedSpan dashes;         ///< double
+};
+
+struct PackedCompileResult {
+    PackedOutlineHeader* arena; ///< 成功时指向 arena，失败时为 nullptr
+    char* error_msg;            ///< 失败时指向编译报错字符串，成功时为 nullptr
+};
+
 // =====================================================================
 // 3. 现代 C++ 自动化内存管理包装 (RAII 核心层) [1.1.2]
 // =====================================================================
@@ -297,8 +434,18 @@ struct StringDeleter {
     }
 };
 
+/// 单块 arena 的析构器：一次调用整体释放
+struct PackedOutlineDeleter {
+    void operator()(PackedOutlineHeader* ptr) const noexcept {
+        if (ptr) {
+            ::stucanvas_free_packed_outline(ptr);
+        }
+    }
+};
+
 /// 现代 C++ 托管型智能指针定义
 using OutlineUniquePtr = std::unique_ptr<Outline, OutlineDeleter>;
+using PackedOutlineUniquePtr = std::unique_ptr<PackedOutlineHeader, PackedOutlineDeleter>;
 using FfiStringUniquePtr = std::unique_ptr<char, StringDeleter>;
 
 /// 编译结果高层 RAII 托管类 (具备自动、安全的双向生命周期析构能力)
@@ -334,8 +481,9 @@ public:
     const Outline& operator*() const noexcept { return *m_outline; }
 
 private:
-    // 仅允许 compile 函数进行内部构造
+    // 仅允许 compile 函数与常驻引擎进行内部构造
     friend Result compile(const char* markup_str, const char* fonts_dir);
+    friend class TypstEngine;
 
     Result(Outline* out, char* err) noexcept
         : m_outline(out), m_error_msg(err) {}
@@ -353,6 +501,179 @@ inline Result compile(const char* markup_str, const char* fonts_dir) {
     return Result(raw.outline, raw.error_msg);
 }
 
+/// 单块 arena 编译结果 (只读视图 + 独占所有权)
+class PackedResult {
+public:
+    PackedResult(PackedResult&&) noexcept = default;
+    PackedResult& operator=(PackedResult&&) noexcept = default;
+    PackedResult(const PackedResult&) = delete;
+    PackedResult& operator=(const PackedResult&) = delete;
+
+    bool is_success() const noexcept { return m_arena != nullptr; }
+    bool is_error() const noexcept { return m_error_msg != nullptr; }
+    explicit operator bool() const noexcept { return is_success(); }
+
+    std::string_view get_error() const noexcept {
+        return m_error_msg ? std::string_view(m_error_msg.get()) : std::string_view();
+    }
+
+    const PackedOutlineHeader* header() const noexcept { return m_arena.get(); }
+    PackedPrecision precision() const noexcept { return static_cast<PackedPrecision>(m_arena->precision); }
+
+    /// 按 header 中的 PackedSpan 原地取得元素池视图
+    template <typename T>
+    std::span<const T> pool(const PackedSpan& span) const noexcept {
+        const auto* base = reinterpret_cast<const std::byte*>(m_arena.get());
+        return { reinterpret_cast<const T*>(base + span.offset), static_cast<size_t>(span.len) };
+    }
+
+    /// 按 PackedRange 从元素池中切片
+    template <typename T>
+    static std::span<const T> slice(std::span<const T> pool, PackedRange range) noexcept {
+        return pool.subspan(range.first, range.count);
+    }
+
+    std::span<const PackedSubOutline> outlines() const noexcept { return pool<PackedSubOutline>(m_arena->outlines); }
+    std::span<const PackedGeometry> geometries() const noexcept { return pool<PackedGeometry>(m_arena->geometries); }
+    std::span<const PackedDrawInstance> instances() const noexcept { return pool<PackedDrawInstance>(m_arena->instances); }
+    std::span<const GlyphPlacement> glyphs() const noexcept { return pool<GlyphPlacement>(m_arena->glyphs); }
+    std::span<const ::Point2D> points() const noexcept { return pool<::Point2D>(m_arena->points); }
+    std::span<const float> points_x() const noexcept { return pool<float>(m_arena->points_x); }
+    std::span<const float> points_y() const noexcept { return pool<float>(m_arena->points_y); }
+    std::span<const PathVerb> verbs() const noexcept { return pool<PathVerb>(m_arena->verbs); }
+    std::span<const GradientStop> stops() const noexcept { return pool<GradientStop>(m_arena->stops); }
+    std::span<const double> dashes() const noexcept { return pool<double>(m_arena->dashes); }
+
+    /// 根页面 (或任一 Tiling 子大纲) 的绘制指令
+    std::span<const PackedDrawInstance> outline_instances(uint32_t outline) const noexcept {
+        return slice(instances(), outlines()[outline].instances);
+    }
+    std::span<const PackedDrawInstance> root_instances() const noexcept { return outline_instances(m_arena->root); }
+
+private:
+    friend class TypstEngine;
+
+    PackedResult(PackedOutlineHeader* arena, char* err) noexcept
+        : m_arena(arena), m_error_msg(err) {}
+
+    PackedOutlineUniquePtr m_arena;
+    FfiStringUniquePtr m_error_msg;
+};
+
+/**
+ * @brief 常驻 Typst 引擎 (RAII)
+ * @details 字体目录只扫描一次 (字形数据按需 mmap 载入)，标准库与 comemo 记忆化缓存在多次编译间复用，
+ *          适合交互式编辑时反复编译相近的标记文本。compile 可被多个线程并发调用。
+ *          包导入与一次性的 compile() 一致：先查本地 typst 包目录，缺失时下载到缓存目录；
+ *          查找失败不会被缓存，包稍后落地后再次编译即可导入。
+ */
+class TypstEngine {
+public:
+    explicit TypstEngine(const char* fonts_dir)
+        : m_handle(::stucanvas_typst_engine_create(fonts_dir))
+    {
+        if (!m_handle) {
+            throw std::runtime_error("TypstEngine::TypstEngine: Failed to create Typst engine (null fonts_dir?).");
+        }
+    }
+
+    ~TypstEngine() { ::stucanvas_typst_engine_destroy(m_handle); }
+
+    TypstEngine(TypstEngine&& other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; }
+    TypstEngine& operator=(TypstEngine&& other) noexcept {
+        if (this != &other) {
+            ::stucanvas_typst_engine_destroy(m_handle);
+            m_handle = other.m_handle;
+            other.m_handle = nullptr;
+        }
+        return *this;
+    }
+    TypstEngine(const TypstEngine&) = delete;
+    TypstEngine& operator=(const TypstEngine&) = delete;
+
+    /// 以常驻缓存编译一段标记文本
+    Result compile(const char* markup_str) const {
+        CompileResult raw = ::stucanvas_typst_engine_compile(m_handle, markup_str);
+        return Result(raw.outline, raw.error_msg);
+    }
+
+    /**
+     * @brief 批量并行编译 (Rust 侧 rayon 工作池，共享同一份字体与记忆化缓存)
+     * @return 与输入一一对应的结果，单项失败不影响其余项
+     * @note 在 TBB 任务中调用时，当前任务会被挂起 (tbb::task::suspend) 而不是阻塞工作线程，
+     *       该线程可继续执行其他任务，批次完成后由 Rust 工作线程恢复本任务。
+     */
+    std::vector<Result> compileBatch(std::span<const char* const> markups) const {
+        std::vector<CompileResult> raw(markups.size(), CompileResult{ nullptr, nullptr });
+        if (!markups.empty()) {
+            dispatchBatch(
+                [&] { ::stucanvas_typst_engine_compile_batch(m_handle, markups.data(), markups.size(), raw.data()); },
+                [&](TypstBatchCallback callback, void* user_data) {
+                    ::stucanvas_typst_engine_compile_batch_async(m_handle, markups.data(), markups.size(), raw.data(), callback, user_data);
+                });
+        }
+
+        std::vector<Result> results;
+        results.reserve(raw.size());
+        for (const CompileResult& r : raw) {
+            results.push_back(Result(r.outline, r.error_msg));
+        }
+        return results;
+    }
+
+    /// 编译为单块 arena：Rust 侧只做一次最终分配，C++ 侧原地读取、一次释放
+    PackedResult compilePacked(const char* markup_str, PackedPrecision precision = PackedPrecision::F64Aos) const {
+        PackedCompileResult raw = ::stucanvas_typst_engine_compile_packed(m_handle, markup_str, static_cast<uint8_t>(precision));
+        return PackedResult(raw.arena, raw.error_msg);
+    }
+
+    /// compileBatch 的 arena 版本 (并行编译时避免成千上万次小块分配 / 释放造成的分配器争用)
+    std::vector<PackedResult> compileBatchPacked(std::span<const char* const> markups,
+                                                 PackedPrecision precision = PackedPrecision::F64Aos) const {
+        std::vector<PackedCompileResult> raw(markups.size(), PackedCompileResult{ nullptr, nullptr });
+        const auto p = static_cast<uint8_t>(precision);
+        if (!markups.empty()) {
+            dispatchBatch(
+                [&] { ::stucanvas_typst_engine_compile_batch_packed(m_handle, markups.data(), markups.size(), p, raw.data()); },
+                [&](TypstBatchCallback callback, void* user_data) {
+                    ::stucanvas_typst_engine_compile_batch_packed_async(m_handle, markups.data(), markups.size(), p, raw.data(), callback, user_data);
+                });
+        }
+
+        std::vector<PackedResult> results;
+        results.reserve(raw.size());
+        for (const PackedCompileResult& r : raw) {
+            results.push_back(PackedResult(r.arena, r.error_msg));
+        }
+        return results;
+    }
+
+private:
+    /// 在 TBB 任务中挂起当前任务并走异步接口 (完成回调恢复任务)，否则直接阻塞调用
+    template <typename SyncFn, typename AsyncFn>
+    static void dispatchBatch(SyncFn&& sync_fn, AsyncFn&& async_fn) {
+#if __TBB_RESUMABLE_TASKS
+        if (oneapi::tbb::this_task_arena::current_thread_index() != oneapi::tbb::task_arena::not_initialized) {
+            oneapi::tbb::task::suspend_point resume_tag{};
+            oneapi::tbb::task::suspend([&](oneapi::tbb::task::suspend_point tag) {
+                resume_tag = tag;
+                async_fn(&resumeBatchTask, &resume_tag);
+            });
+            return;
+        }
+#endif
+        sync_fn();
+    }
+
+#if __TBB_RESUMABLE_TASKS
+    static void resumeBatchTask(void* user_data) {
+        oneapi::tbb::task::resume(*static_cast<oneapi::tbb::task::suspend_point*>(user_data));
+    }
+#endif
+
+    TypstEngineHandle* m_handle;
+};
+
 } // namespace StuCanvas
 
 // =====================================================================
@@ -365,5 +686,10 @@ static_assert(sizeof(Transform2D) == 48, "Mismatched size of Transform2D");
 static_assert(sizeof(CVector<double>) == 24, "Mismatched size of CVec");
 // 💡 升级：精简无效几何并融入五法则后，SharedGeometry 在 64 位平台对齐大小已精确固定为 64 字节
 static_assert(sizeof(SharedGeometry) == 64, "SharedGeometry alignment failure");
+static_assert(sizeof(GlyphPlacement) == 56, "Mismatched size of GlyphPlacement");
+static_assert(sizeof(PackedGeometry) == 56, "Mismatched size of PackedGeometry");
+static_assert(sizeof(PackedPaint) == 112, "Mismatched size of PackedPaint");
+static_assert(sizeof(PackedDrawInstance) == 328, "Mismatched size of PackedDrawInstance");
+static_assert(sizeof(PackedOutlineHeader) == 184, "Mismatched size of PackedOutlineHeader");
 static_assert(sizeof(CompileResult) == 16, "Mismatched size of CompileResult");
 #endif
\ No newline at end of file
@@ -4,7 +4,10 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <tbb/parallel_for.h>
 #include "graph.hpp"
+#include "family.hpp"
 
 namespace StuCanvas
 {
@@ -28,12 +31,13 @@ namespace StuCanvas
         }
 
         // ====================================================================
-        // 💡 机制复用 2：统一的 2D 离散化与裁剪引擎
+        // 💡 机制复用 2：采样规划 —— 裁剪后先算出点数与起点 / 步长，输出位置由调用方决定
+        //    （规划结构体定义在 family.hpp，家族竞技场跨刷新持有规划表）
         // ====================================================================
         template <typename T>
-        inline void DiscretizeLine2D_Internal(
-            SObjectGraph<T>& graph,
-            SObject<T>& node,
+        inline LinePointPlan2D<T> PlanLine2D_Points(
+            const SObjectGraph<T>& graph,
+            const SObject<T>& node,
             T t_enter,
             T t_exit,
             bool should_clip
@@ -43,41 +47,32 @@ namespace StuCanvas
             T dx = x1 - x0, dy = y1 - y0;
             T len = static_cast<T>(std::sqrt(dx * dx + dy * dy));
 
+            LinePointPlan2D<T> plan{};
+
             // 如果是直线/射线，启用边界裁剪
             if (should_clip) {
                 ClipAxis(x0, dx, graph.world_xmin, graph.world_xmax, t_enter, t_exit);
                 ClipAxis(y0, dy, graph.world_ymin, graph.world_ymax, t_enter, t_exit);
-                if (t_enter > t_exit) return; // 裁剪后完全不可见，直接退出
+                if (t_enter > t_exit) return plan; // 裁剪后完全不可见
             }
 
             T step = node.discretization_step_points;
             T clipped_len = len * (t_exit - t_enter);
-            int n = static_cast<int>(clipped_len / step) + 1;
-
-            std::vector<Point2D_CPU<T>> pts;
-            pts.reserve(static_cast<size_t>(n));
 
-            // 从世界坐标系下的 t_enter 开始顺序离散化
-            T step_ratio = step / len;
-            T step_x = dx * step_ratio;
-            T step_y = dy * step_ratio;
-            T base_x = x0 + dx * t_enter;
-            T base_y = y0 + dy * t_enter;
-
-            for (int i = 0; i < n; ++i) {
-                T t = static_cast<T>(i);
-                pts.push_back({base_x + step_x * t, base_y + step_y * t});
-            }
-            graph.points_2d.insert(&node, std::move(pts));
+            // 从世界坐标系下的 t_enter 开始顺序离散化；退化线段只输出起点
+            T step_ratio = len > T(0) ? step / len : T(0);
+            plan.step_x = dx * step_ratio;
+            plan.step_y = dy * step_ratio;
+            plan.base_x = x0 + dx * t_enter;
+            plan.base_y = y0 + dy * t_enter;
+            plan.count = static_cast<uint32_t>(clipped_len / step) + 1;
+            return plan;
         }
 
-        // ====================================================================
-        // 💡 机制复用 3：统一的 3D 离散化与裁剪引擎
-        // ====================================================================
         template <typename T>
-        inline void DiscretizeLine3D_Internal(
-            SObjectGraph<T>& graph,
-            SObject<T>& node,
+        inline LinePointPlan3D<T> PlanLine3D_Points(
+            const SObjectGraph<T>& graph,
+            const SObject<T>& node,
             T t_enter,
             T t_exit,
             bool should_clip
@@ -86,35 +81,103 @@ namespace StuCanvas
             T x1 = node.data.line_3d.x1, y1 = node.data.line_3d.y1, z1 = node.data.line_3d.z1;
             T dx = x1 - x0, dy = y1 - y0, dz = z1 - z0;
 
+            LinePointPlan3D<T> plan{};
+
             if (should_clip) {
                 ClipAxis(x0, dx, graph.world_xmin, graph.world_xmax, t_enter, t_exit);
                 ClipAxis(y0, dy, graph.world_ymin, graph.world_ymax, t_enter, t_exit);
                 ClipAxis(z0, dz, graph.world_zmin, graph.world_zmax, t_enter, t_exit);
-                if (t_enter > t_exit) return;
+                if (t_enter > t_exit) return plan;
             }
 
             T len = static_cast<T>(std::sqrt(dx * dx + dy * dy + dz * dz));
             T step = node.discretization_step_points;
             T clipped_len = len * (t_exit - t_enter);
-            int n = static_cast<int>(clipped_len / step) + 1;
 
-            std::vector<Point3D_CPU<T>> pts;
-            pts.reserve(static_cast<size_t>(n));
+            T step_ratio = len > T(0) ? step / len : T(0);
+            plan.step_x = dx * step_ratio;
+            plan.step_y = dy * step_ratio;
+            plan.step_z = dz * step_ratio;
+            plan.base_x = x0 + dx * t_enter;
+            plan.base_y = y0 + dy * t_enter;
+            plan.base_z = z0 + dz * t_enter;
+            plan.count = static_cast<uint32_t>(clipped_len / step) + 1;
+            return plan;
+        }
 
-            T step_ratio = step / len;
-            T step_x = dx * step_ratio;
-            T step_y = dy * step_ratio;
-            T step_z = dz * step_ratio;
-            T base_x = x0 + dx * t_enter;
-            T base_y = y0 + dy * t_enter;
-            T base_z = z0 + dz * t_enter;
+        // 按规划直接写入目标位置（调用方保证 out 至少有 plan.count 个槽位）
+        template <typename T>
+        inline void WriteLine2D_Points(const LinePointPlan2D<T>& plan, Point2D_CPU<T>* out) noexcept
+        {
+            for (uint32_t i = 0; i < plan.count; ++i) {
+                T t = static_cast<T>(i);
+                out[i] = {plan.base_x + plan.step_x * t, plan.base_y + plan.step_y * t};
+            }
+        }
 
-            for (int i = 0; i < n; ++i) {
+        template <typename T>
+        inline void WriteLine3D_Points(const LinePointPlan3D<T>& plan, Point3D_CPU<T>* out) noexcept
+        {
+            for (uint32_t i = 0; i < plan.count; ++i) {
                 T t = static_cast<T>(i);
-                pts.push_back({base_x + step_x * t, base_y + step_y * t, base_z + step_z * t});
+                out[i] = {plan.base_x + plan.step_x * t, plan.base_y + plan.step_y * t, plan.base_z + plan.step_z * t};
             }
+        }
+
+        // ====================================================================
+        // 💡 机制复用 3：单节点离散化入口（输出到图谱的逐节点点集表）
+        // ====================================================================
+        template <typename T>
+        inline void DiscretizeLine2D_Internal(
+            SObjectGraph<T>& graph,
+            SObject<T>& node,
+            T t_enter,
+            T t_exit,
+            bool should_clip
+        ) noexcept {
+            const LinePointPlan2D<T> plan = PlanLine2D_Points(graph, node, t_enter, t_exit, should_clip);
+            if (plan.count == 0) return;
+
+            std::vector<Point2D_CPU<T>> pts(plan.count);
+            WriteLine2D_Points(plan, pts.data());
+            graph.points_2d.insert(&node, std::move(pts));
+        }
+
+        template <typename T>
+        inline void DiscretizeLine3D_Internal(
+            SObjectGraph<T>& graph,
+            SObject<T>& node,
+            T t_enter,
+            T t_exit,
+            bool should_clip
+        ) noexcept {
+            const LinePointPlan3D<T> plan = PlanLine3D_Points(graph, node, t_enter, t_exit, should_clip);
+            if (plan.count == 0) return;
+
+            std::vector<Point3D_CPU<T>> pts(plan.count);
+            WriteLine3D_Points(plan, pts.data());
             graph.points_3d.insert(&node, std::move(pts));
         }
+
+        // ====================================================================
+        // 💡 机制复用 4：成员级规划分派（家族批量离散化用）
+        // ====================================================================
+        template <typename T>
+        inline MemberPointPlan<T> PlanMember_Points(const SObjectGraph<T>& graph, const SObject<T>& node) noexcept
+        {
+            constexpr T inf = static_cast<T>(1e30);
+            MemberPointPlan<T> plan{};
+            switch (node.type) {
+            case NodeType::LINE_2D_SEGMENT:  plan.dim = 2; plan.line_2d = PlanLine2D_Points(graph, node, T(0), T(1), false); break;
+            case NodeType::LINE_2D_STRAIGHT: plan.dim = 2; plan.line_2d = PlanLine2D_Points(graph, node, -inf, inf, true); break;
+            case NodeType::LINE_2D_RAY:      plan.dim = 2; plan.line_2d = PlanLine2D_Points(graph, node, T(0), inf, true); break;
+            case NodeType::LINE_3D_SEGMENT:  plan.dim = 3; plan.line_3d = PlanLine3D_Points(graph, node, T(0), T(1), false); break;
+            case NodeType::LINE_3D_STRAIGHT: plan.dim = 3; plan.line_3d = PlanLine3D_Points(graph, node, -inf, inf, true); break;
+            case NodeType::LINE_3D_RAY:      plan.dim = 3; plan.line_3d = PlanLine3D_Points(graph, node, T(0), inf, true); break;
+            default: break;
+            }
+            return plan;
+        }
     } // namespace detail
 
     // ========================================================================
@@ -163,4 +226,55 @@ namespace StuCanvas
     {
         detail::DiscretizeLine3D_Internal(graph, node, static_cast<T>(0), static_cast<T>(1e30), true);
     }
-} // namespace StuCanvas
\ No newline at end of file
+
+    // ========================================================================
+    // 家族批量离散化：输出到家族常驻竞技场
+    // ========================================================================
+    // 两遍式：先逐成员规划出点数并做前缀和，每个成员拿到自己在连续缓冲中的最终偏移；
+    // 再按成员独立写入（互不重叠，可直接并行）。缓冲容量跨刷新保留，稳态下零分配。
+    template <typename T>
+    inline void DiscretizeFamily_Points(SObjectGraph<T>& graph, SObjectFamily<T>& family, bool use_parallel = true)
+    {
+        using Range = typename FamilyPointArena<T>::Range;
+
+        const auto& members = family.GetMembers();
+        FamilyPointArena<T>& arena = family.GetPointArena();
+        const size_t member_count = members.size();
+
+        // 1. 规划 + 前缀和（纯标量运算，成员数量级的开销）
+        // 规划表随家族竞技场常驻：并行写入期间本线程即使窃取到其他家族的刷新任务，用的也是那个家族自己的表
+        std::vector<detail::MemberPointPlan<T>>& plans = arena.plans;
+        plans.resize(member_count);
+        arena.ranges.resize(member_count);
+
+        uint32_t total_2d = 0, total_3d = 0;
+        for (size_t i = 0; i < member_count; ++i) {
+            const SObject<T>* node = members[i];
+            plans[i] = node ? detail::PlanMember_Points(graph, *node) : detail::MemberPointPlan<T>{};
+
+            const uint32_t count = plans[i].count();
+            uint32_t& total = plans[i].dim == 3 ? total_3d : total_2d;
+            arena.ranges[i] = Range{ plans[i].dim ? total : 0u, count, plans[i].dim };
+            total += count;
+        }
+
+        // 2. 只改长度不释放容量
+        arena.points_2d.resize(total_2d);
+        arena.points_3d.resize(total_3d);
+
+        // 3. 各成员写入自己的最终偏移
+        auto write_member = [&](size_t i)
+        {
+            const detail::MemberPointPlan<T>& plan = plans[i];
+            const Range& r = arena.ranges[i];
+            if (plan.dim == 2) detail::WriteLine2D_Points(plan.line_2d, arena.points_2d.data() + r.offset);
+            else if (plan.dim == 3) detail::WriteLine3D_Points(plan.line_3d, arena.points_3d.data() + r.offset);
+        };
+
+        if (use_parallel && member_count > 1) {
+            tbb::parallel_for(size_t(0), member_count, write_member);
+        } else {
+            for (size_t i = 0; i < member_count; ++i) write_member(i);
+        }
+    }
+} // namespace StuCanvas
@@ -1,6 +1,10 @@
 #pragma once
 #include <eigen3/Eigen/Dense>
 #include <stdexcept>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../types/cpu/point.hpp"
 namespace StuCanvas
 {
 
@@ -20,6 +24,71 @@ namespace StuCanvas
 
 
 
+    namespace detail
+    {
+        // 单条线的采样规划：裁剪后的点数与起点 / 步长（由 discretizer_points.hpp 填写）
+        template <typename T>
+        struct LinePointPlan2D
+        {
+            T base_x, base_y;
+            T step_x, step_y;
+            uint32_t count = 0; // 0 表示裁剪后完全不可见
+        };
+
+        template <typename T>
+        struct LinePointPlan3D
+        {
+            T base_x, base_y, base_z;
+            T step_x, step_y, step_z;
+            uint32_t count = 0;
+        };
+
+        template <typename T>
+        struct MemberPointPlan
+        {
+            uint8_t dim = 0; // 0：该成员不产出离散点
+            LinePointPlan2D<T> line_2d{};
+            LinePointPlan3D<T> line_3d{};
+
+            uint32_t count() const noexcept { return dim == 2 ? line_2d.count : (dim == 3 ? line_3d.count : 0u); }
+        };
+    } // namespace detail
+
+    // ========================================================================
+    // 家族级离散点竞技场：全体成员的离散点按成员顺序连续存放在同一块缓冲中
+    // ========================================================================
+    // 💡 缓冲随家族常驻，刷新时只 resize 不释放；拖拽时点数在稳定区间内波动，
+    //    容量一旦够用，整轮离散化不再触发任何堆分配。
+    template <typename T>
+    struct FamilyPointArena
+    {
+        struct Range
+        {
+            uint32_t offset = 0; // 在对应维度缓冲中的起始下标
+            uint32_t count = 0;  // 点数（0 表示不可见或该成员不产出离散点）
+            uint8_t dim = 0;     // 2 / 3，0 表示该成员没有点离散化
+        };
+
+        std::vector<Point2D_CPU<T>> points_2d{};
+        std::vector<Point3D_CPU<T>> points_3d{};
+        std::vector<Range> ranges{}; // 与 SObjectFamily::GetMembers() 一一对应
+        std::vector<detail::MemberPointPlan<T>> plans{}; // 离散化期间的规划表，与 ranges 同序，容量同样跨刷新复用
+
+        std::span<const Point2D_CPU<T>> Points2D(size_t member) const noexcept
+        {
+            const Range& r = ranges[member];
+            if (r.dim != 2) return {};
+            return { points_2d.data() + r.offset, r.count };
+        }
+
+        std::span<const Point3D_CPU<T>> Points3D(size_t member) const noexcept
+        {
+            const Range& r = ranges[member];
+            if (r.dim != 3) return {};
+            return { points_3d.data() + r.offset, r.count };
+        }
+    };
+
     template <typename T>
     struct SObject;
 
@@ -83,9 +152,13 @@ namespace StuCanvas
         const std::vector<SObject<T>*>& GetMembers() const noexcept { return m_members; }
         const SObject<T>* GetStartNode() const noexcept { return m_start_node; }
 
+        FamilyPointArena<T>& GetPointArena() noexcept { return m_point_arena; }
+        const FamilyPointArena<T>& GetPointArena() const noexcept { return m_point_arena; }
+
     private:
         SObjectGraph<T>* m_graph = nullptr;
         const SObject<T>* m_start_node = nullptr; // 特征探测点指针
         std::vector<SObject<T>*> m_members{};       // 本家族包含的全部 SObject 成员指针
+        FamilyPointArena<T> m_point_arena{};        // 成员离散点的常驻输出缓冲（跨刷新复用容量）
     };
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "tiny_vector.hpp"
 #include "function.hpp"
 #include "interval.hpp"
+#include "point_index.hpp"
 namespace StuCanvas
 {
     // ========================================================================
@@ -99,8 +100,6 @@ namespace StuCanvas
 
 
         // utils::FlatMap<const SObject<T>*, Outline> fonts_2d;
-        // utils::FlatMap<const SObject<T>*, std::vector<Point2D_CPU<T>>> points_2d;
-        // utils::FlatMap<const SObject<T>*, std::vector<Point3D_CPU<T>>> points_3d;
         // utils::FlatMap<const SObject<T>*, SegmentStrips2D_CPU<T>> segment_stips_2d;
         // utils::FlatMap<const SObject<T>*, SegmentStrips3D_CPU<T>> segment_stips_3d;
         // utils::FlatMap<const SObject<T>*, Triangles2D_CPU<T>> triangles_2d;
@@ -133,6 +132,16 @@ namespace StuCanvas
         
 
 
+        // 单对象离散点输出（discretizer_points.hpp 写入；读写都在 point_index_mutex 内进行）
+        utils::FlatMap<const SObject<T>*, std::vector<Point2D_CPU<T>>> points_2d;
+        utils::FlatMap<const SObject<T>*, std::vector<Point3D_CPU<T>>> points_3d;
+
+        // 离散点集的最近邻索引（吸附 / 切线解算按目标惰性构建；目标被重算或拓扑刷新时失效）
+        utils::FlatMap<const SObject<T>*, std::unique_ptr<PointIndexEntry<T, 2>>, utils::FlatMapMode::Swiss> point_index_2d;
+        utils::FlatMap<const SObject<T>*, std::unique_ptr<PointIndexEntry<T, 3>>, utils::FlatMapMode::Swiss> point_index_3d;
+        std::mutex point_index_mutex;
+        uint64_t compute_epoch = 0; // 每次 Compute 递增，用于判定索引是否已在本轮重建
+
         // 内存连续、极其紧凑的对象分配大池（确保 Object* 物理寻址的绝对地址稳定性）
         utils::BlockDeque<SObject<T>, 256> node_pool;
 
@@ -268,6 +277,7 @@ namespace StuCanvas
         void Compute(bool use_parallel = true)
         {
             if (dirty_list.empty()) return;
+            ++compute_epoch;
 
             // 1. 稀疏自适应向下脏化
             PropagateDirtyFlags();
@@ -286,6 +296,8 @@ namespace StuCanvas
                 {
                     family_pool[i].refresh(); // 自动重新爬取拓扑网络，补齐成员
                 }
+                for (auto& entry : point_index_2d) entry.second.reset();
+                for (auto& entry : point_index_3d) entry.second.reset();
                 topology_changed = false;
             }
 
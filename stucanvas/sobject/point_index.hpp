@@ -0,0 +1,321 @@
+// stucanvas/sobject/point_index.hpp
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+#include "sobject.hpp"
+
+namespace StuCanvas
+{
+    // ========================================================================
+    // 离散点集的 k-d 树空间索引 —— 吸附 / 切线解算在拖拽时每帧查询最近点
+    // ========================================================================
+    // 💡 叶子桶内坐标按 SoA 连续存放，叶子扫描是无分支的平方距离计算（编译器自动向量化），
+    //    之后才做一次标量的 argmin；每个节点保存紧致包围盒，曲线采样这类一维流形上远离曲线的查询
+    //    也只会展开贴近最近点的少数叶子。子树按最长轴中位数平衡划分。
+    template <typename T, int Dim>
+    class PointKdTree
+    {
+        static_assert(Dim == 2 || Dim == 3, "PointKdTree: only 2D and 3D point sets are supported.");
+
+    public:
+        using Query = std::array<T, Dim>;
+
+        static constexpr uint32_t kLeafSize = 32;
+        static constexpr size_t npos = (std::numeric_limits<size_t>::max)();
+
+        struct Neighbor
+        {
+            size_t index; // 原始点数组中的下标
+            T dist2;      // 平方距离
+        };
+
+        PointKdTree() = default;
+
+        // 从离散化输出（Point2D_CPU / Point3D_CPU 等带 x/y(/z) 成员的类型）一次性构建
+        template <typename PointType>
+        explicit PointKdTree(const std::vector<PointType>& pts)
+        {
+            build(pts);
+        }
+
+        template <typename PointType>
+        void build(const std::vector<PointType>& pts)
+        {
+            const uint32_t n = static_cast<uint32_t>(pts.size());
+            m_nodes.clear();
+            m_ids.resize(n);
+            for (uint32_t i = 0; i < n; ++i) m_ids[i] = i;
+
+            for (int a = 0; a < Dim; ++a) m_coords[a].resize(n);
+            for (uint32_t i = 0; i < n; ++i) {
+                m_coords[0][i] = pts[i].x;
+                m_coords[1][i] = pts[i].y;
+                if constexpr (Dim == 3) m_coords[2][i] = pts[i].z;
+            }
+
+            if (n == 0) return;
+            m_nodes.reserve(2 * (n / kLeafSize + 1));
+            BuildNode(0, n);
+
+            // 按叶子顺序重排坐标，使每个叶子桶在各轴上都是一段连续内存
+            for (int a = 0; a < Dim; ++a) {
+                std::vector<T> permuted(n);
+                for (uint32_t i = 0; i < n; ++i) permuted[i] = m_coords[a][m_ids[i]];
+                m_coords[a] = std::move(permuted);
+            }
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return m_ids.size(); }
+        [[nodiscard]] bool empty() const noexcept { return m_ids.empty(); }
+
+        // 最近点：返回原始下标（空集返回 npos），可选输出平方距离
+        size_t nearest(const Query& q, T* out_dist2 = nullptr) const noexcept
+        {
+            if (m_nodes.empty()) return npos;
+
+            Neighbor best{ npos, (std::numeric_limits<T>::max)() };
+            NearestRecursive(0, q, best);
+            if (out_dist2) *out_dist2 = best.dist2;
+            return best.index;
+        }
+
+        // k 近邻：结果按距离升序写入 out（不足 k 个时返回全部）
+        void k_nearest(const Query& q, size_t k, std::vector<Neighbor>& out) const
+        {
+            out.clear();
+            if (m_nodes.empty() || k == 0) return;
+
+            out.reserve(k);
+            KNearestRecursive(0, q, k, out);
+            std::sort_heap(out.begin(), out.end(), HeapLess{});
+        }
+
+    private:
+        struct Node
+        {
+            Query lo, hi;        // 子树内点的紧致包围盒
+            uint32_t begin, end; // 子树在重排数组中的点区间
+            uint32_t right;      // 内部节点：右孩子下标（左孩子紧随其后）
+            int8_t axis;         // -1 表示叶子
+        };
+
+        struct HeapLess
+        {
+            bool operator()(const Neighbor& a, const Neighbor& b) const noexcept { return a.dist2 < b.dist2; }
+        };
+
+        uint32_t BuildNode(uint32_t begin, uint32_t end)
+        {
+            const uint32_t idx = static_cast<uint32_t>(m_nodes.size());
+            Node node{ {}, {}, begin, end, 0, -1 };
+
+            // 包围盒，同时选出最长轴作为划分轴
+            int axis = 0;
+            T widest = T(-1);
+            for (int a = 0; a < Dim; ++a) {
+                T lo = (std::numeric_limits<T>::max)(), hi = (std::numeric_limits<T>::lowest)();
+                for (uint32_t i = begin; i < end; ++i) {
+                    const T v = m_coords[a][m_ids[i]];
+                    lo = (std::min)(lo, v);
+                    hi = (std::max)(hi, v);
+                }
+                node.lo[a] = lo;
+                node.hi[a] = hi;
+                if (hi - lo > widest) { widest = hi - lo; axis = a; }
+            }
+            m_nodes.push_back(node);
+            if (end - begin <= kLeafSize) return idx;
+
+            const uint32_t mid = begin + (end - begin) / 2;
+            const std::vector<T>& c = m_coords[axis];
+            std::nth_element(m_ids.begin() + begin, m_ids.begin() + mid, m_ids.begin() + end,
+                             [&c](uint32_t a, uint32_t b) { return c[a] < c[b]; });
+
+            m_nodes[idx].axis = static_cast<int8_t>(axis);
+            BuildNode(begin, mid);
+            const uint32_t right = BuildNode(mid, end);
+            m_nodes[idx].right = right;
+            return idx;
+        }
+
+        // 查询点到节点包围盒的平方距离（点在盒内为 0）
+        T BoxDistance(const Node& node, const Query& q) const noexcept
+        {
+            T d2 = T(0);
+            for (int a = 0; a < Dim; ++a) {
+                const T d = (std::max)({ node.lo[a] - q[a], q[a] - node.hi[a], T(0) });
+                d2 += d * d;
+            }
+            return d2;
+        }
+
+        // 叶子桶距离计算：SoA + 定长缓冲，循环体无分支
+        uint32_t LeafDistances(const Node& node, const Query& q, T* dist2) const noexcept
+        {
+            const uint32_t count = node.end - node.begin;
+            const T* xs = m_coords[0].data() + node.begin;
+            const T* ys = m_coords[1].data() + node.begin;
+            if constexpr (Dim == 2) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    const T dx = xs[i] - q[0];
+                    const T dy = ys[i] - q[1];
+                    dist2[i] = dx * dx + dy * dy;
+                }
+            } else {
+                const T* zs = m_coords[2].data() + node.begin;
+                for (uint32_t i = 0; i < count; ++i) {
+                    const T dx = xs[i] - q[0];
+                    const T dy = ys[i] - q[1];
+                    const T dz = zs[i] - q[2];
+                    dist2[i] = dx * dx + dy * dy + dz * dz;
+                }
+            }
+            return count;
+        }
+
+        void NearestRecursive(uint32_t idx, const Query& q, Neighbor& best) const noexcept
+        {
+            const Node& node = m_nodes[idx];
+            if (node.axis < 0) {
+                T dist2[kLeafSize];
+                const uint32_t count = LeafDistances(node, q, dist2);
+                for (uint32_t i = 0; i < count; ++i) {
+                    // 距离相同取原始下标较小者，与线性扫描的结果一致
+                    const uint32_t id = m_ids[node.begin + i];
+                    if (dist2[i] < best.dist2 || (dist2[i] == best.dist2 && id < best.index)) {
+                        best = Neighbor{ id, dist2[i] };
+                    }
+                }
+                return;
+            }
+
+            // 先进入更近的孩子；盒距离相等时也要进入，以保证平局取较小下标
+            uint32_t near_child = idx + 1, far_child = node.right;
+            T near_d2 = BoxDistance(m_nodes[near_child], q), far_d2 = BoxDistance(m_nodes[far_child], q);
+            if (far_d2 < near_d2) { std::swap(near_child, far_child); std::swap(near_d2, far_d2); }
+            if (near_d2 <= best.dist2) NearestRecursive(near_child, q, best);
+            if (far_d2 <= best.dist2) NearestRecursive(far_child, q, best);
+        }
+
+        void KNearestRecursive(uint32_t idx, const Query& q, size_t k, std::vector<Neighbor>& heap) const
+        {
+            const Node& node = m_nodes[idx];
+            if (node.axis < 0) {
+                T dist2[kLeafSize];
+                const uint32_t count = LeafDistances(node, q, dist2);
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (heap.size() < k) {
+                        heap.push_back(Neighbor{ m_ids[node.begin + i], dist2[i] });
+                        std::push_heap(heap.begin(), heap.end(), HeapLess{});
+                    } else if (dist2[i] < heap.front().dist2) {
+                        std::pop_heap(heap.begin(), heap.end(), HeapLess{});
+                        heap.back() = Neighbor{ m_ids[node.begin + i], dist2[i] };
+                        std::push_heap(heap.begin(), heap.end(), HeapLess{});
+                    }
+                }
+                return;
+            }
+
+            uint32_t near_child = idx + 1, far_child = node.right;
+            T near_d2 = BoxDistance(m_nodes[near_child], q), far_d2 = BoxDistance(m_nodes[far_child], q);
+            if (far_d2 < near_d2) { std::swap(near_child, far_child); std::swap(near_d2, far_d2); }
+            KNearestRecursive(near_child, q, k, heap);
+            if (heap.size() < k || far_d2 < heap.front().dist2) KNearestRecursive(far_child, q, k, heap);
+        }
+
+        std::array<std::vector<T>, Dim> m_coords{}; // 按叶子顺序重排的 SoA 坐标
+        std::vector<uint32_t> m_ids{};              // 重排位置 -> 原始下标
+        std::vector<Node> m_nodes{};
+    };
+
+    template <typename T>
+    using PointIndex2D = PointKdTree<T, 2>;
+
+    template <typename T>
+    using PointIndex3D = PointKdTree<T, 3>;
+
+    // 图谱侧缓存条目：记录构建时所在的解算轮次，同一轮内目标只离散化 / 建树一次
+    template <typename T, int Dim>
+    struct PointIndexEntry
+    {
+        PointKdTree<T, Dim> tree;
+        uint64_t epoch = 0;
+    };
+
+    // 索引查询结果：树与其对应的离散点在同一次加锁内取出，调用方解锁后不再访问图谱上的点集映射
+    // （映射扩容只搬移 std::vector 句柄，points 指向的堆缓冲不变；同一目标本轮不会被再次离散化）
+    template <typename T, int Dim, typename PointType>
+    struct PointIndexView
+    {
+        const PointKdTree<T, Dim>* tree = nullptr;
+        std::span<const PointType> points{};
+
+        [[nodiscard]] bool empty() const noexcept { return !tree || tree->empty() || points.empty(); }
+    };
+
+    template <typename T>
+    using PointIndexView2D = PointIndexView<T, 2, Point2D_CPU<T>>;
+
+    template <typename T>
+    using PointIndexView3D = PointIndexView<T, 3, Point3D_CPU<T>>;
+
+    template <typename T>
+    struct SObjectGraph;
+
+    namespace detail
+    {
+        // ====================================================================
+        // 💡 统一的索引获取：目标本轮未被重算时直接复用缓存；否则重新离散化并重建索引
+        // ====================================================================
+        template <int Dim, typename T, typename IndexMap, typename PointMap>
+        inline auto AcquirePointIndex(SObjectGraph<T>& graph, const SObject<T>* target, IndexMap& indices, PointMap& points)
+        {
+            using PointType = typename std::remove_cvref_t<decltype(points.find(target)->second)>::value_type;
+            PointIndexView<T, Dim, PointType> view;
+
+            std::lock_guard<std::mutex> lock(graph.point_index_mutex);
+
+            auto& entry = indices[target];
+            const bool stale = !entry || (target->has_mask(NodeMask::DIRTY) && entry->epoch != graph.compute_epoch);
+            if (stale) {
+                if (target->vptr && target->vptr->discretize_to_points) {
+                    target->vptr->discretize_to_points(graph, *const_cast<SObject<T>*>(target));
+                }
+                if (!entry) entry = std::make_unique<PointIndexEntry<T, Dim>>();
+                entry->epoch = graph.compute_epoch;
+            }
+
+            auto it = points.find(target);
+            if (stale) {
+                if (it != points.end()) {
+                    entry->tree.build(it->second);
+                } else {
+                    entry->tree = PointKdTree<T, Dim>{};
+                }
+            }
+
+            view.tree = &entry->tree;
+            if (it != points.end()) view.points = { it->second.data(), it->second.size() };
+            return view;
+        }
+    } // namespace detail
+
+    template <typename T>
+    inline PointIndexView2D<T> AcquirePointIndex2D(SObjectGraph<T>& graph, const SObject<T>* target)
+    {
+        return detail::AcquirePointIndex<2>(graph, target, graph.point_index_2d, graph.points_2d);
+    }
+
+    template <typename T>
+    inline PointIndexView3D<T> AcquirePointIndex3D(SObjectGraph<T>& graph, const SObject<T>* target)
+    {
+        return detail::AcquirePointIndex<3>(graph, target, graph.point_index_3d, graph.points_3d);
+    }
+} // namespace StuCanvas
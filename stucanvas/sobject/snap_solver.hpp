@@ -6,6 +6,7 @@
 #include <vector>
 #include <algorithm>
 #include "graph.hpp"
+#include "point_index.hpp"
 
 namespace StuCanvas
 {
@@ -109,12 +110,12 @@ namespace StuCanvas
             target->type != NodeType::CIRCLE_2D &&
             target->type != NodeType::CIRCLE_2D_THREE_POINTS)
         {
-            if (target->vptr && target->vptr->discretize_to_points) {
-                target->vptr->discretize_to_points(graph, *const_cast<SObject<T>*>(target));
-            }
-            auto it = graph.points_2d.find(target);
-            if (it != graph.points_2d.end() && !it->second.empty()) {
-                detail::FindNearestPoint2D(it->second, gx, gy, node.data.snap_2d.x, node.data.snap_2d.y);
+            // 离散点集走 k-d 树索引（同一轮解算内只离散化 / 建树一次），拖拽时每帧查询为对数复杂度
+            const PointIndexView2D<T> index = AcquirePointIndex2D(graph, target);
+            if (!index.empty()) {
+                const auto& p = index.points[index.tree->nearest({ gx, gy })];
+                node.data.snap_2d.x = p.x;
+                node.data.snap_2d.y = p.y;
             }
             return;
         }
@@ -172,12 +173,12 @@ namespace StuCanvas
             target->type != NodeType::SPHERE_3D_FOUR_POINTS &&
             target->type != NodeType::CYLINDER_3D)
         {
-            if (target->vptr && target->vptr->discretize_to_points) {
-                target->vptr->discretize_to_points(graph, *const_cast<SObject<T>*>(target));
-            }
-            auto it = graph.points_3d.find(target);
-            if (it != graph.points_3d.end() && !it->second.empty()) {
-                detail::FindNearestPoint3D(it->second, gx, gy, gz, node.data.snap_3d.x, node.data.snap_3d.y, node.data.snap_3d.z);
+            const PointIndexView3D<T> index = AcquirePointIndex3D(graph, target);
+            if (!index.empty()) {
+                const auto& p = index.points[index.tree->nearest({ gx, gy, gz })];
+                node.data.snap_3d.x = p.x;
+                node.data.snap_3d.y = p.y;
+                node.data.snap_3d.z = p.z;
             }
             return;
         }
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <limits>
 #include "graph.hpp"
+#include "point_index.hpp"
 
 namespace StuCanvas
 {
@@ -19,12 +20,9 @@ namespace StuCanvas
 
         T px = pt->data.point_2d.x, py = pt->data.point_2d.y;
 
-        // 💡 调用目标对象的离散化点云
-        if (curve->vptr && curve->vptr->discretize_to_points)
-            curve->vptr->discretize_to_points(graph, *const_cast<SObject<T>*>(curve));
-
-        auto it = graph.points_2d.find(curve);
-        if (it == graph.points_2d.end() || it->second.size() < 2)
+        // 💡 获取目标离散化点云的 k-d 树索引（本轮首次访问时离散化并建树）
+        const PointIndexView2D<T> index = AcquirePointIndex2D(graph, curve);
+        if (index.empty() || index.points.size() < 2)
         {
             // 无法计算切线，退化为零长度
             node.data.line_2d.x0 = px;
@@ -34,16 +32,10 @@ namespace StuCanvas
             return;
         }
 
-        const auto& pts = it->second;
+        const std::span<const Point2D_CPU<T>> pts = index.points;
 
-        // 💡 找到离切点最近的两个采样点
-        size_t nearest = 0;
-        T best = std::numeric_limits<T>::max();
-        for (size_t i = 0; i < pts.size(); ++i)
-        {
-            T d = (pts[i].x - px)*(pts[i].x - px) + (pts[i].y - py)*(pts[i].y - py);
-            if (d < best) { best = d; nearest = i; }
-        }
+        // 💡 找到离切点最近的采样点，前后邻点由采样顺序给出
+        const size_t nearest = index.tree->nearest({ px, py });
 
         size_t prev = (nearest == 0) ? 1 : nearest - 1;
         size_t next = (nearest == pts.size() - 1) ? nearest - 1 : nearest + 1;
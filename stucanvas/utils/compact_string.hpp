@@ -11,8 +11,10 @@
 #include <cstdint>
 #include <cstring>
 #include <new>
+#include <stdexcept>
 #include <utility>
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <string_view>
 
@@ -27,10 +29,23 @@
 
 namespace StuCanvas::utils
 {
+    // ========================================================================
+    // 8 字节句柄字符串：堆上 [capacity | size] 头部前缀 + 内联短串
+    // ========================================================================
+    // 💡 句柄按小端字节序解释为 64 位字 m_word：
+    //    - m_word == 0                    ：空串
+    //    - 高 16 位 (字节 6、7) 全为 0    ：堆指针（用户态规范地址高 16 位恒为 0，且 8 字节对齐）
+    //    - 否则为内联串，字符从字节 0 开始：
+    //        · 长度 1~6：字节 7 = 0x80 | len，字节 len 起全部为 0（兼作 '\0'）
+    //        · 长度 7  ：字节 6 为第 7 个字符（必须非 0），字节 7 = 0 恰好充当结束符
+    //    "A"、"P1" 这类名称不再产生任何堆分配，c_str () 直接指向句柄自身。
     class CompactString
     {
     private:
 
+        static_assert ( sizeof ( uintptr_t ) == 8 && std::endian::native == std::endian::little,
+                        "CompactString: inline representation requires a little-endian 64-bit target" );
+
         // 1. 偏置于字符指针前方的标头
         struct alignas ( 8 ) StringHeader
         {
@@ -42,30 +57,71 @@ namespace StuCanvas::utils
         static constexpr size_t Alignment = 8;
         static constexpr size_t HeaderOffset = ( sizeof ( StringHeader ) + Alignment - 1 ) & ~( Alignment - 1 );
 
-        // 核心句柄：仅占 8 字节（一个 naked char 指针）
-        char* m_ptr = nullptr;
+        static constexpr uint32_t InlineCapacity = 7;
+        static constexpr uint64_t InlineLengthTag = 0x80;
+
+        // 核心句柄：仅占 8 字节（堆指针或内联字符）
+        uint64_t m_word = 0;
+
+        [[nodiscard]] inline bool is_inline () const noexcept
+        {
+            return ( m_word >> 48 ) != 0;
+        }
+
+        [[nodiscard]] inline char* heap_ptr () const noexcept
+        {
+            return reinterpret_cast< char* > ( static_cast< uintptr_t > ( m_word ) );
+        }
 
         [[nodiscard]] inline StringHeader* get_header () const noexcept
         {
-            if ( !m_ptr )
+            if ( m_word == 0 || is_inline () )
             {
                 return nullptr;
             }
-            return reinterpret_cast< StringHeader* > ( m_ptr - HeaderOffset );
+            return reinterpret_cast< StringHeader* > ( heap_ptr () - HeaderOffset );
         }
 
-        static char* allocate ( uint32_t capacity )
+        [[nodiscard]] inline uint32_t inline_size () const noexcept
+        {
+            const uint32_t tag = static_cast< uint32_t > ( m_word >> 56 );
+            return tag ? ( tag & 0x7f ) : InlineCapacity;
+        }
+
+        // 能否以内联形式保存：长度 7 时第 7 个字节必须非 0（否则会与堆指针混淆）
+        [[nodiscard]] static inline bool fits_inline ( const char* str, uint32_t len ) noexcept
+        {
+            return len > 0 && ( len < InlineCapacity || ( len == InlineCapacity && str[ InlineCapacity - 1 ] != '\0' ) );
+        }
+
+        [[nodiscard]] static inline uint64_t pack_inline ( const char* str, uint32_t len ) noexcept
         {
-            if ( capacity == 0 )
+            uint64_t word = 0;
+            std::memcpy ( &word, str, len );
+            if ( len < InlineCapacity )
             {
-                return nullptr;
+                word |= ( InlineLengthTag | len ) << 56;
             }
+            return word;
+        }
+
+        // 把容量撑满小对象池的尺寸等级（短字符串至少可容纳 23 个字符）
+        [[nodiscard]] static uint32_t fit_capacity ( uint32_t capacity ) noexcept
+        {
+            const size_t usable = ::StuCanvas::utils::detail::pool_usable_size ( HeaderOffset + static_cast< size_t > ( capacity ) + 1, Alignment );
+            const size_t fit = usable - HeaderOffset - 1;
+            return fit < UINT32_MAX ? static_cast< uint32_t > ( fit ) : UINT32_MAX;
+        }
+
+        static char* allocate ( uint32_t capacity )
+        {
+            capacity = fit_capacity ( capacity );
 
             // 标头偏移量 + 容量 + 1 字节结束符（\0）
             size_t total_size = HeaderOffset + static_cast< size_t > ( capacity ) + 1;
-            
-            // 🚀 复用项目底层的自适应分配器，消除跨平台差异与 Leak 警报
-            void* raw = ::StuCanvas::utils::detail::aligned_alloc_helper ( total_size, Alignment );
+
+            // 🚀 经共享小对象池分配（短字符串命中线程弹匣，跨线程释放归还给分配线程）
+            void* raw = ::StuCanvas::utils::detail::pool_alloc ( total_size, Alignment );
 
             StringHeader* h = reinterpret_cast< StringHeader* > ( raw );
             h->capacity = capacity;
@@ -73,17 +129,56 @@ namespace StuCanvas::utils
 
             char* data = reinterpret_cast< char* > ( raw ) + HeaderOffset;
             data[ 0 ] = '\0';
+            assert ( ( reinterpret_cast< uintptr_t > ( data ) >> 48 ) == 0 && "CompactString: heap pointer collides with inline tag" );
             return data;
         }
 
         static void deallocate ( char* ptr ) noexcept
         {
-            if ( !ptr )
+            void* raw = ptr - HeaderOffset;
+            const size_t total_size = HeaderOffset + static_cast< size_t > ( reinterpret_cast< StringHeader* > ( raw )->capacity ) + 1;
+            ::StuCanvas::utils::detail::pool_free ( raw, total_size, Alignment );
+        }
+
+        void release () noexcept
+        {
+            if ( get_header () )
+            {
+                deallocate ( heap_ptr () );
+            }
+            m_word = 0;
+        }
+
+        // 统一赋值入口：短串内联，长串优先复用现有堆容量
+        void assign ( const char* str, uint32_t len )
+        {
+            if ( len == 0 )
             {
+                release ();
                 return;
             }
-            void* raw = ptr - HeaderOffset;
-            ::StuCanvas::utils::detail::aligned_free_helper ( raw, Alignment );
+            if ( fits_inline ( str, len ) )
+            {
+                const uint64_t word = pack_inline ( str, len ); // 先打包：str 可能指向自身
+                release ();
+                m_word = word;
+                return;
+            }
+            StringHeader* h = get_header ();
+            if ( !h || len > h->capacity )
+            {
+                char* p = allocate ( len );
+                std::memcpy ( p, str, len );
+                release ();
+                m_word = reinterpret_cast< uintptr_t > ( p );
+                h = get_header ();
+            }
+            else
+            {
+                std::memmove ( heap_ptr (), str, len );
+            }
+            h->size = len;
+            heap_ptr ()[ len ] = '\0';
         }
 
     public:
@@ -94,15 +189,7 @@ namespace StuCanvas::utils
         {
             if ( str )
             {
-                uint32_t len = static_cast< uint32_t > ( std::strlen ( str ) );
-                if ( len > 0 )
-                {
-                    m_ptr = allocate ( len );
-                    StringHeader* h = get_header ();
-                    h->size = len;
-                    std::memcpy ( m_ptr, str, len );
-                    m_ptr[ len ] = '\0';
-                }
+                assign ( str, static_cast< uint32_t > ( std::strlen ( str ) ) );
             }
         }
 
@@ -110,53 +197,42 @@ namespace StuCanvas::utils
         {
             if ( str && len > 0 )
             {
-                m_ptr = allocate ( len );
-                StringHeader* h = get_header ();
-                h->size = len;
-                std::memcpy ( m_ptr, str, len );
-                m_ptr[ len ] = '\0';
+                assign ( str, len );
             }
         }
 
         ~CompactString () noexcept
         {
-            if ( m_ptr )
-            {
-                deallocate ( m_ptr );
-            }
+            release ();
         }
 
-        // 🚀 O(1) 移动语义：只需交换 8 字节指针，无任何内存分配开销
-        CompactString ( CompactString&& other ) noexcept : m_ptr ( other.m_ptr )
+        // 🚀 O(1) 移动语义：只需交换 8 字节句柄，无任何内存分配开销
+        CompactString ( CompactString&& other ) noexcept : m_word ( other.m_word )
         {
-            other.m_ptr = nullptr;
+            other.m_word = 0;
         }
 
         CompactString& operator= ( CompactString&& other ) noexcept
         {
             if ( this != &other )
             {
-                if ( m_ptr )
-                {
-                    deallocate ( m_ptr );
-                }
-                m_ptr = other.m_ptr;
-                other.m_ptr = nullptr;
+                release ();
+                m_word = other.m_word;
+                other.m_word = 0;
             }
             return *this;
         }
 
-        // 🚀 拷贝构造
+        // 🚀 拷贝构造：内联串直接复制 8 字节句柄
         CompactString ( const CompactString& other )
         {
-            if ( other.m_ptr )
+            if ( other.m_word == 0 || other.is_inline () )
+            {
+                m_word = other.m_word;
+            }
+            else
             {
-                uint32_t len = other.size ();
-                m_ptr = allocate ( len );
-                StringHeader* h = get_header ();
-                h->size = len;
-                std::memcpy ( m_ptr, other.m_ptr, len );
-                m_ptr[ len ] = '\0';
+                assign ( other.data (), other.size () );
             }
         }
 
@@ -165,30 +241,7 @@ namespace StuCanvas::utils
         {
             if ( this != &other )
             {
-                if ( other.m_ptr )
-                {
-                    uint32_t len = other.size ();
-                    if ( len > capacity () )
-                    {
-                        if ( m_ptr )
-                        {
-                            deallocate ( m_ptr );
-                        }
-                        m_ptr = allocate ( len );
-                    }
-                    StringHeader* h = get_header ();
-                    h->size = len;
-                    std::memcpy ( m_ptr, other.m_ptr, len );
-                    m_ptr[ len ] = '\0';
-                }
-                else
-                {
-                    if ( m_ptr )
-                    {
-                        deallocate ( m_ptr );
-                        m_ptr = nullptr;
-                    }
-                }
+                assign ( other.data (), other.size () );
             }
             return *this;
         }
@@ -203,21 +256,33 @@ namespace StuCanvas::utils
             }
 
             uint32_t sz = size ();
-            void* old_raw = m_ptr ? ( reinterpret_cast< char* > ( m_ptr ) - HeaderOffset ) : nullptr;
-            
+            if ( m_word == 0 || is_inline () )
+            {
+                // 内联 / 空串转入堆
+                char* p = allocate ( new_cap );
+                std::memcpy ( p, c_str (), sz );
+                p[ sz ] = '\0';
+                reinterpret_cast< StringHeader* > ( p - HeaderOffset )->size = sz;
+                m_word = reinterpret_cast< uintptr_t > ( p );
+                return;
+            }
+
+            new_cap = fit_capacity ( new_cap );
+            void* old_raw = heap_ptr () - HeaderOffset;
+
             // 额外留出 1 字节结束符的空间
             size_t old_total_size = HeaderOffset + cur_cap + 1;
             size_t new_total_size = HeaderOffset + new_cap + 1;
 
-            // 调用您项目底层的 realloc
-            void* new_raw = ::StuCanvas::utils::detail::aligned_realloc_helper ( old_raw, old_total_size, new_total_size, Alignment );
+            // 同尺寸等级内原地返回，跨等级由小对象池完成拷贝
+            void* new_raw = ::StuCanvas::utils::detail::pool_realloc ( old_raw, old_total_size, new_total_size, Alignment );
 
             StringHeader* h = reinterpret_cast< StringHeader* > ( new_raw );
             h->capacity = new_cap;
             h->size = sz;
 
-            m_ptr = reinterpret_cast< char* > ( new_raw ) + HeaderOffset;
-            m_ptr[ sz ] = '\0';
+            m_word = reinterpret_cast< uintptr_t > ( reinterpret_cast< char* > ( new_raw ) + HeaderOffset );
+            heap_ptr ()[ sz ] = '\0';
         }
 
         // 🚀 批量追加
@@ -228,21 +293,60 @@ namespace StuCanvas::utils
                 return;
             }
 
-            uint32_t cur_size = size ();
-            uint32_t new_size = cur_size + len;
+            const uint32_t cur_size = size ();
+            if ( len > UINT32_MAX - cur_size )
+            {
+                throw std::length_error ( "CompactString::append: size exceeds uint32 range" );
+            }
+            const uint32_t new_size = cur_size + len;
 
-            if ( new_size > capacity () )
+            // 以差值判断而非 cur_size + len，避免回绕后误入内联分支写穿 buf
+            if ( ( m_word == 0 || is_inline () ) && len <= InlineCapacity - cur_size )
             {
-                uint32_t new_cap = capacity () == 0 ? 8 : capacity () * 2;
-                while ( new_cap < new_size )
+                char buf[ InlineCapacity + 1 ] = {};
+                std::memcpy ( buf, c_str (), cur_size );
+                std::memcpy ( buf + cur_size, str, len );
+                if ( fits_inline ( buf, new_size ) )
                 {
-                    new_cap *= 2;
+                    m_word = pack_inline ( buf, new_size );
+                    return;
                 }
+            }
+
+            if ( new_size > capacity () || m_word == 0 || is_inline () )
+            {
+                // 按 size_t 倍增，超出 uint32 后钳到上限（new_size 已保证不超过 UINT32_MAX）
+                size_t grown = capacity () <= InlineCapacity ? 16 : static_cast< size_t > ( capacity () ) * 2;
+                while ( grown < new_size )
+                {
+                    grown *= 2;
+                }
+                const uint32_t new_cap = static_cast< uint32_t > ( std::min< size_t > ( grown, UINT32_MAX ) );
+                if ( m_word != 0 && is_inline () )
+                {
+                    // str 可能指向内联字符，转堆前先保存
+                    char buf[ InlineCapacity + 1 ] = {};
+                    std::memcpy ( buf, str, len < InlineCapacity ? len : InlineCapacity );
+                    const char* src = ( str >= c_str () && str < c_str () + InlineCapacity + 1 ) ? buf : str;
+                    reserve ( new_cap );
+                    std::memcpy ( heap_ptr () + cur_size, src, len );
+                    heap_ptr ()[ new_size ] = '\0';
+                    get_header ()->size = new_size;
+                    return;
+                }
+                // str 可能指向自身堆缓冲（如 append ( *this )），扩容后按偏移重新定位
+                const char* base = heap_ptr ();
+                const bool aliased = base && str >= base && str < base + cur_size;
+                const size_t offset = aliased ? static_cast< size_t > ( str - base ) : 0;
                 reserve ( new_cap );
+                if ( aliased )
+                {
+                    str = heap_ptr () + offset;
+                }
             }
 
-            std::memcpy ( m_ptr + cur_size, str, len );
-            m_ptr[ new_size ] = '\0';
+            std::memcpy ( heap_ptr () + cur_size, str, len );
+            heap_ptr ()[ new_size ] = '\0';
             get_header ()->size = new_size;
         }
 
@@ -259,72 +363,65 @@ namespace StuCanvas::utils
             append ( other.data (), other.size () );
         }
 
-        // 极致性能：保持原容量，仅逻辑清零
+        // 极致性能：保持原容量，仅逻辑清零（内联串直接归零）
         void clear () noexcept
         {
             StringHeader* h = get_header ();
             if ( h )
             {
                 h->size = 0;
-                m_ptr[ 0 ] = '\0';
+                heap_ptr ()[ 0 ] = '\0';
+            }
+            else
+            {
+                m_word = 0;
             }
         }
 
-        // 释放物理内存
+        // 释放物理内存：能内联的短串搬回句柄
         void shrink_to_fit () noexcept
         {
-            uint32_t sz = size ();
+            StringHeader* h = get_header ();
+            if ( !h )
+            {
+                return;
+            }
+            uint32_t sz = h->size;
             if ( sz == 0 )
             {
-                if ( m_ptr )
-                {
-                    deallocate ( m_ptr );
-                    m_ptr = nullptr;
-                }
+                release ();
+            }
+            else if ( fits_inline ( heap_ptr (), sz ) )
+            {
+                const uint64_t word = pack_inline ( heap_ptr (), sz );
+                release ();
+                m_word = word;
             }
-            else if ( sz < capacity () )
+            else if ( sz < h->capacity )
             {
-                void* old_raw = reinterpret_cast< char* > ( m_ptr ) - HeaderOffset;
-                size_t old_total_size = HeaderOffset + capacity () + 1;
+                void* old_raw = heap_ptr () - HeaderOffset;
+                size_t old_total_size = HeaderOffset + h->capacity + 1;
                 size_t new_total_size = HeaderOffset + sz + 1;
 
-                void* new_raw = ::StuCanvas::utils::detail::aligned_realloc_helper ( old_raw, old_total_size, new_total_size, Alignment );
-                
-                StringHeader* h = reinterpret_cast< StringHeader* > ( new_raw );
-                h->capacity = sz;
+                void* new_raw = ::StuCanvas::utils::detail::pool_realloc ( old_raw, old_total_size, new_total_size, Alignment );
 
-                m_ptr = reinterpret_cast< char* > ( new_raw ) + HeaderOffset;
+                StringHeader* nh = reinterpret_cast< StringHeader* > ( new_raw );
+                nh->capacity = sz;
+
+                m_word = reinterpret_cast< uintptr_t > ( reinterpret_cast< char* > ( new_raw ) + HeaderOffset );
             }
         }
 
-
         // 🚀 新增：支持从裸 C 风格字符串直接赋值（零拷贝复用内存）
         CompactString& operator= ( const char* str )
         {
             if ( str )
             {
-                uint32_t len = static_cast< uint32_t > ( std::strlen ( str ) );
-                if ( len > capacity () )
-                {
-                    if ( m_ptr )
-                    {
-                        deallocate ( m_ptr );
-                    }
-                    m_ptr = allocate ( len );
-                }
-                
-                StringHeader* h = get_header ();
-                h->size = len;
-                std::memcpy ( m_ptr, str, len );
-                m_ptr[ len ] = '\0';
+                assign ( str, static_cast< uint32_t > ( std::strlen ( str ) ) );
             }
             else
             {
-                if ( m_ptr )
-                {
-                    deallocate ( m_ptr );
-                    m_ptr = nullptr;
-                }
+                release ();
             }
             return *this;
         }
@@ -332,44 +429,26 @@ namespace StuCanvas::utils
         // 🚀 新增：支持从现代 std::string_view 直接赋值（极致性能，零多余分配）
         CompactString& operator= ( std::string_view sv )
         {
-            uint32_t len = static_cast< uint32_t > ( sv.size () );
-            if ( len > 0 )
-            {
-                if ( len > capacity () )
-                {
-                    if ( m_ptr )
-                    {
-                        deallocate ( m_ptr );
-                    }
-                    m_ptr = allocate ( len );
-                }
-                
-                StringHeader* h = get_header ();
-                h->size = len;
-                std::memcpy ( m_ptr, sv.data (), len );
-                m_ptr[ len ] = '\0';
-            }
-            else
-            {
-                if ( m_ptr )
-                {
-                    deallocate ( m_ptr );
-                    m_ptr = nullptr;
-                }
-            }
+            assign ( sv.data (), static_cast< uint32_t > ( sv.size () ) );
             return *this;
         }
 
         [[nodiscard]] inline uint32_t size () const noexcept
         {
-            auto* h = get_header ();
-            return h ? h->size : 0;
+            if ( m_word == 0 )
+            {
+                return 0;
+            }
+            return is_inline () ? inline_size () : get_header ()->size;
         }
 
         [[nodiscard]] inline uint32_t capacity () const noexcept
         {
-            auto* h = get_header ();
-            return h ? h->capacity : 0;
+            if ( m_word == 0 )
+            {
+                return 0;
+            }
+            return is_inline () ? InlineCapacity : get_header ()->capacity;
         }
 
         [[nodiscard]] inline bool empty () const noexcept
@@ -377,19 +456,37 @@ namespace StuCanvas::utils
             return size () == 0;
         }
 
+        // 内联串返回句柄自身的地址：对象移动 / 销毁后指针即失效
         [[nodiscard]] inline const char* c_str () const noexcept
         {
-            return m_ptr ? m_ptr : "";
+            if ( m_word == 0 )
+            {
+                return "";
+            }
+            return is_inline () ? reinterpret_cast< const char* > ( &m_word ) : heap_ptr ();
+        }
+
+        [[nodiscard]] inline bool is_inline_storage () const noexcept
+        {
+            return m_word != 0 && is_inline ();
         }
 
         [[nodiscard]] inline char* data () noexcept
         {
-            return m_ptr;
+            if ( m_word == 0 )
+            {
+                return nullptr;
+            }
+            return is_inline () ? reinterpret_cast< char* > ( &m_word ) : heap_ptr ();
         }
 
         [[nodiscard]] inline const char* data () const noexcept
         {
-            return m_ptr;
+            if ( m_word == 0 )
+            {
+                return nullptr;
+            }
+            return is_inline () ? reinterpret_cast< const char* > ( &m_word ) : heap_ptr ();
         }
 
         // 🚀 零拷贝无缝转换标准只读视图，完美兼容标准库接口
@@ -398,20 +495,26 @@ namespace StuCanvas::utils
             return std::string_view ( c_str (), size () );
         }
 
+        // 注意：经非 const 下标把 7 字节内联串的最后一个字符写成 '\0' 会破坏内联编码
         [[nodiscard]] inline char& operator[] ( size_t idx ) noexcept
         {
             assert ( idx < size () );
-            return m_ptr[ idx ];
+            return data ()[ idx ];
         }
 
         [[nodiscard]] inline const char& operator[] ( size_t idx ) const noexcept
         {
             assert ( idx < size () );
-            return m_ptr[ idx ];
+            return data ()[ idx ];
         }
 
         [[nodiscard]] inline bool operator== ( const CompactString& other ) const noexcept
         {
+            // 内联编码是规范的（结束符之后全为 0）：两个内联串相等当且仅当句柄相等
+            if ( is_inline_storage () && other.is_inline_storage () )
+            {
+                return m_word == other.m_word;
+            }
             uint32_t sz = size ();
             if ( sz != other.size () )
             {
@@ -422,7 +525,7 @@ namespace StuCanvas::utils
                 return true;
             }
             // 🚀 利用系统级极致优化 memcmp 替代普通的 strcmp 遍历，耗时大幅压低
-            return std::memcmp ( m_ptr, other.m_ptr, sz ) == 0;
+            return std::memcmp ( data (), other.data (), sz ) == 0;
         }
 
         [[nodiscard]] inline bool operator!= ( const CompactString& other ) const noexcept
@@ -1,6 +1,7 @@
 // stucanvas/utils/ffi_function.hpp
 #pragma once
 
+#include <cstring>
 #include <functional>
 #include <new>
 #include <type_traits>
@@ -12,8 +13,13 @@ namespace StuCanvas::utils
     class StuFunction;
 
     // =========================================================================
-    // 🚀 C++23 极致优化版 8 字节 FFI 闭包包装器 (Move-Only / Single-Allocation)
+    // 🚀 C++23 极致优化版 FFI 闭包包装器 (Move-Only / 小对象内联 + 单次堆分配回退)
     // =========================================================================
+    // 💡 存储策略：
+    //  - 不超过 InlineSize 字节、可平凡拷贝的可调用对象（空 Lambda、按值捕获至多四个 double 或
+    //    按引用捕获的 Lambda、普通函数指针）直接放在对象内部：构造 0 次堆分配，移动即 memcpy
+    //  - 其余对象回退为原先的 CombinedBlock 单次堆分配
+    //  - 调用统一走 invoke_(storage_, args...)：一次间接调用直达闭包，不再经 Block 二次取址
     template < typename Ret, typename... Args >
     class [[nodiscard]] StuFunction< Ret ( Args... ) >
     {
@@ -30,11 +36,17 @@ namespace StuCanvas::utils
             DeleterFn deleter;   // 静态析构函数指针
         };
 
+        static constexpr size_t InlineSize = 32;   // 容纳 4 个 double / 指针的捕获
+        static constexpr size_t InlineAlign = alignof ( void* );
+
+        // 可内联存放的类型：尺寸 / 对齐受限，且平凡可拷贝（移动 = memcpy，析构无操作）
+        template < typename F >
+        static constexpr bool stored_inline = sizeof ( F ) <= InlineSize && alignof ( F ) <= InlineAlign &&
+                                              std::is_trivially_copyable_v< F >;
+
         // 默认构造与空构造
-        constexpr StuFunction () noexcept : block_ ( nullptr )
-        {
-        }
-        constexpr StuFunction ( std::nullptr_t ) noexcept : block_ ( nullptr )
+        constexpr StuFunction () noexcept = default;
+        constexpr StuFunction ( std::nullptr_t ) noexcept
         {
         }
 
@@ -55,21 +67,41 @@ namespace StuCanvas::utils
         {
             using DecayedF = std::decay_t< F >;
 
-            // 仅仅进行一次 new 分配
-            auto* cb = new CombinedBlock< DecayedF >{
-                .block = { .context = nullptr,   // 稍后绑定为 cb 自身
-                           .invoker = [] ( void* ctx, Args&&... args ) -> Ret
-                           {
-                               // 寄存器直接通过偏移量直达 Lambda 闭包，0 查表开销
-                               auto* self = static_cast< CombinedBlock< DecayedF >* > ( ctx );
-                               return self->functor ( std::forward< Args > ( args )... );
-                           },
-                           .deleter = [] ( void* ctx ) { delete static_cast< CombinedBlock< DecayedF >* > ( ctx ); } },
-                .functor = std::forward< F > ( f ) };
-
-            // 绑定上下文为分配块的基地址
-            cb->block.context = static_cast< void* > ( cb );
-            block_ = &( cb->block );
+            if constexpr ( std::is_pointer_v< DecayedF > && std::is_function_v< std::remove_pointer_t< DecayedF > > )
+            {
+                // 🚀 普通函数指针快速通道：与 std::function 一致，空指针构造出空对象
+                if ( f == nullptr )
+                {
+                    return;
+                }
+                new ( storage_ ) DecayedF ( f );
+                invoke_ = &invoke_inline< DecayedF >;
+            }
+            else if constexpr ( stored_inline< DecayedF > )
+            {
+                new ( storage_ ) DecayedF ( std::forward< F > ( f ) );
+                invoke_ = &invoke_inline< DecayedF >;
+            }
+            else
+            {
+                // 仅仅进行一次 new 分配
+                auto* cb = new CombinedBlock< DecayedF >{
+                    .block = { .context = nullptr,   // 稍后绑定为 cb 自身
+                               .invoker = [] ( void* ctx, Args&&... args ) -> Ret
+                               {
+                                   // 寄存器直接通过偏移量直达 Lambda 闭包，0 查表开销
+                                   auto* self = static_cast< CombinedBlock< DecayedF >* > ( ctx );
+                                   return self->functor ( std::forward< Args > ( args )... );
+                               },
+                               .deleter = [] ( void* ctx ) { delete static_cast< CombinedBlock< DecayedF >* > ( ctx ); } },
+                    .functor = std::forward< F > ( f ) };
+
+                // 绑定上下文为分配块的基地址
+                cb->block.context = static_cast< void* > ( cb );
+                block_ = &( cb->block );
+                new ( storage_ ) CombinedBlock< DecayedF >* ( cb );
+                invoke_ = &invoke_heap< DecayedF >;
+            }
         }
 
         // 析构函数
@@ -83,9 +115,11 @@ namespace StuCanvas::utils
         StuFunction ( const StuFunction& ) = delete;
         StuFunction& operator= ( const StuFunction& ) = delete;
 
-        // 移动构造
-        StuFunction ( StuFunction&& other ) noexcept : block_ ( other.block_ )
+        // 移动构造：内联对象平凡可拷贝、堆模式只存指针，整体按字节搬运即可
+        StuFunction ( StuFunction&& other ) noexcept : invoke_ ( other.invoke_ ), block_ ( other.block_ )
         {
+            std::memcpy ( storage_, other.storage_, InlineSize );
+            other.invoke_ = nullptr;
             other.block_ = nullptr;
         }
 
@@ -95,7 +129,10 @@ namespace StuCanvas::utils
             if ( this != &other )
             {
                 reset ();
+                std::memcpy ( storage_, other.storage_, InlineSize );
+                invoke_ = other.invoke_;
                 block_ = other.block_;
+                other.invoke_ = nullptr;
                 other.block_ = nullptr;
             }
             return *this;
@@ -104,23 +141,51 @@ namespace StuCanvas::utils
         // 调用重载
         Ret operator() ( Args... args ) const
         {
-            if ( !block_ ) [[unlikely]]
+            if ( !invoke_ ) [[unlikely]]
             {
                 throw std::bad_function_call ();
             }
-            return block_->invoker ( block_->context, std::forward< Args > ( args )... );
+            return invoke_ ( storage_, std::forward< Args > ( args )... );
         }
 
         explicit operator bool () const noexcept
         {
-            return block_ != nullptr;
+            return invoke_ != nullptr;
+        }
+
+        // 当前闭包是否内联存放（无堆分配）
+        [[nodiscard]] bool is_inline () const noexcept
+        {
+            return invoke_ != nullptr && block_ == nullptr;
         }
 
         // 💡 FFI 核心接口：剥离控制权并交付给外部语言
         // 外部语言拿到的 Block* 本质就是一个 8 字节的物理指针（句柄）
-        [[nodiscard]] Block* release () noexcept
+        // 内联存放的闭包在此刻才装箱到堆上，平时不付出任何分配代价
+        [[nodiscard]] Block* release ()
         {
+            if ( !invoke_ )
+            {
+                return nullptr;
+            }
             Block* temp = block_;
+            if ( !temp )
+            {
+                auto* box = new InlineBox{ .block = { .context = nullptr,
+                                                      .invoker = [] ( void* ctx, Args&&... args ) -> Ret
+                                                      {
+                                                          auto* self = static_cast< InlineBox* > ( ctx );
+                                                          return self->invoke ( self->storage,
+                                                                                std::forward< Args > ( args )... );
+                                                      },
+                                                      .deleter = [] ( void* ctx )
+                                                      { delete static_cast< InlineBox* > ( ctx ); } },
+                                           .invoke = invoke_ };
+                std::memcpy ( box->storage, storage_, InlineSize );
+                box->block.context = static_cast< void* > ( box );
+                temp = &( box->block );
+            }
+            invoke_ = nullptr;
             block_ = nullptr;
             return temp;
         }
@@ -129,7 +194,13 @@ namespace StuCanvas::utils
         void acquire ( Block* block ) noexcept
         {
             reset ();
+            if ( !block )
+            {
+                return;
+            }
             block_ = block;
+            new ( storage_ ) Block* ( block );
+            invoke_ = &invoke_foreign;
         }
 
         void reset () noexcept
@@ -142,10 +213,42 @@ namespace StuCanvas::utils
                 }
                 block_ = nullptr;
             }
+            invoke_ = nullptr;
         }
 
     private:
 
-        Block* block_ = nullptr;   // 💡 物理大小：永远正好是 8 字节！
+        using Thunk = Ret ( * ) ( void*, Args&&... );
+
+        // 内联闭包装箱后的堆布局（仅 release () 时产生）
+        struct InlineBox
+        {
+            Block block;
+            Thunk invoke;
+            alignas ( InlineAlign ) unsigned char storage[ InlineSize ] {};
+        };
+
+        template < typename F >
+        static Ret invoke_inline ( void* storage, Args&&... args )
+        {
+            return ( *std::launder ( static_cast< F* > ( storage ) ) ) ( std::forward< Args > ( args )... );
+        }
+
+        template < typename F >
+        static Ret invoke_heap ( void* storage, Args&&... args )
+        {
+            auto* cb = *std::launder ( static_cast< CombinedBlock< F >** > ( storage ) );
+            return cb->functor ( std::forward< Args > ( args )... );
+        }
+
+        static Ret invoke_foreign ( void* storage, Args&&... args )
+        {
+            Block* block = *std::launder ( static_cast< Block** > ( storage ) );
+            return block->invoker ( block->context, std::forward< Args > ( args )... );
+        }
+
+        alignas ( InlineAlign ) mutable unsigned char storage_[ InlineSize ];   // 不做零填充：移动 / 构造时整体覆盖
+        Thunk invoke_ = nullptr;   // 空对象为 nullptr
+        Block* block_ = nullptr;   // 仅堆模式 / 外部接管时非空，析构据此归还
     };
 }   // namespace StuCanvas::utils
@@ -0,0 +1,280 @@
+/***************************************************************************
+ * Copyright (c) 2026 Tian Yuxuan (Friendships666)                          *
+ *                                                                          *
+ * Distributed under the terms of the MIT License.                          *
+ *                                                                          *
+ * The full license is in the file LICENSE, distributed with this software. *
+ ***************************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "pinned_vector.hpp"
+
+namespace StuCanvas::utils
+{
+// =========================================================================
+// 🚀 全局并发字符串驻留表：名称 -> 32 位符号 id
+// =========================================================================
+// 💡 设计要点：
+//  - id 从 1 开始连续分配，0 保留给空串；同一字符串在进程生命周期内只存一份、id 永不变化。
+//  - 字节与条目分别存放在两个 ConcurrentPinnedVector 中：地址稳定，按 id 取字符串无需加锁。
+//  - 去重索引按哈希高位分成 64 个分片，每片是读写锁保护的开放寻址表（只存 id）；
+//    查找只取共享锁，插入取独占锁并二次确认，生成场景时多线程建名几乎不相互阻塞。
+//  - 表只增不减：适合对象名、类型名这类取值集合有限、反复出现的字符串。
+class InternTable
+{
+   public:
+
+    static constexpr uint32_t kShardBits = 6;
+    static constexpr uint32_t kShards = 1u << kShardBits;
+
+    [[nodiscard]] static InternTable& global ()
+    {
+        // 故意泄漏：静态析构期间仍可能有对象按名称查询
+        static InternTable* table = new InternTable ();
+        return *table;
+    }
+
+    // 驻留字符串并返回其 id（空串返回 0）；线程安全
+    [[nodiscard]] uint32_t intern ( std::string_view s )
+    {
+        if ( s.empty () )
+            return 0;
+        if ( s.size () > UINT32_MAX )
+            throw std::length_error ( "InternTable: string too long" );
+
+        const uint64_t h = hash_bytes ( s );
+        Shard& shard = m_shards[ h >> ( 64 - kShardBits ) ];
+        {
+            std::shared_lock< std::shared_mutex > lock ( shard.mutex );
+            if ( const uint32_t id = probe ( shard, s, h ) )
+                return id;
+        }
+
+        std::unique_lock< std::shared_mutex > lock ( shard.mutex );
+        if ( const uint32_t id = probe ( shard, s, h ) )
+            return id;
+
+        // 字节区末尾补 '\0'，c_str () 可直接返回
+        const size_t offset = m_bytes.grow_by ( s.size () + 1,
+                                                [ s ] ( char* dst, size_t n )
+                                                {
+                                                    std::memcpy ( dst, s.data (), s.size () );
+                                                    dst[ n - 1 ] = '\0';
+                                                } );
+        const Entry& entry = m_entries.emplace_back ( Entry { offset, static_cast< uint32_t > ( s.size () ),
+                                                              static_cast< uint32_t > ( h ) } );
+        const uint32_t id = static_cast< uint32_t > ( &entry - m_entries.data () ) + 1;
+        insert ( shard, id, h );
+        return id;
+    }
+
+    // 只查不插：字符串从未驻留过时返回 0（名称查找可据此直接判定无匹配）
+    [[nodiscard]] uint32_t find ( std::string_view s ) const
+    {
+        if ( s.empty () )
+            return 0;
+        const uint64_t h = hash_bytes ( s );
+        const Shard& shard = m_shards[ h >> ( 64 - kShardBits ) ];
+        std::shared_lock< std::shared_mutex > lock ( shard.mutex );
+        return probe ( shard, s, h );
+    }
+
+    // id -> 字符串；无锁（id 只能来自 intern / find，其返回先行于此处读取）
+    [[nodiscard]] std::string_view view ( uint32_t id ) const noexcept
+    {
+        if ( id == 0 )
+            return {};
+        const Entry& e = m_entries[ id - 1 ];
+        return std::string_view ( m_bytes.data () + e.offset, e.size );
+    }
+
+    [[nodiscard]] const char* c_str ( uint32_t id ) const noexcept
+    {
+        return id == 0 ? "" : m_bytes.data () + m_entries[ id - 1 ].offset;
+    }
+
+    // 驻留时计算的字符串哈希（低 32 位）
+    [[nodiscard]] uint32_t hash ( uint32_t id ) const noexcept
+    {
+        return id == 0 ? 0 : m_entries[ id - 1 ].hash;
+    }
+
+    [[nodiscard]] size_t size () const noexcept
+    {
+        return m_entries.size ();
+    }
+
+   private:
+
+    struct Entry
+    {
+        size_t offset;   ///< 在字节区中的起始下标
+        uint32_t size;
+        uint32_t hash;
+    };
+
+    struct alignas ( 64 ) Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::vector< uint32_t > slots;   ///< 开放寻址，0 为空槽；容量为 2 的幂
+        uint32_t count = 0;
+    };
+
+    InternTable () = default;
+
+    [[nodiscard]] static uint64_t hash_bytes ( std::string_view s ) noexcept
+    {
+        // 再混合一次：std::hash 的高位质量依实现而定，而分片恰好取高位
+        uint64_t h = std::hash< std::string_view > {}( s );
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    [[nodiscard]] uint32_t probe ( const Shard& shard, std::string_view s, uint64_t h ) const noexcept
+    {
+        if ( shard.slots.empty () )
+            return 0;
+        const size_t mask = shard.slots.size () - 1;
+        const uint32_t h32 = static_cast< uint32_t > ( h );
+        for ( size_t i = h & mask;; i = ( i + 1 ) & mask )
+        {
+            const uint32_t id = shard.slots[ i ];
+            if ( id == 0 )
+                return 0;
+            const Entry& e = m_entries[ id - 1 ];
+            if ( e.hash == h32 && e.size == s.size () &&
+                 std::memcmp ( m_bytes.data () + e.offset, s.data (), s.size () ) == 0 )
+                return id;
+        }
+    }
+
+    void insert ( Shard& shard, uint32_t id, uint64_t h )
+    {
+        // 负载上限 1/2：每片的探查链保持很短
+        if ( ( shard.count + 1 ) * 2 > shard.slots.size () )
+        {
+            std::vector< uint32_t > grown ( shard.slots.empty () ? 64 : shard.slots.size () * 2, 0 );
+            const size_t mask = grown.size () - 1;
+            for ( uint32_t old : shard.slots )
+            {
+                if ( old == 0 )
+                    continue;
+                const uint64_t oh = hash_bytes ( view ( old ) );
+                size_t i = oh & mask;
+                while ( grown[ i ] != 0 )
+                    i = ( i + 1 ) & mask;
+                grown[ i ] = old;
+            }
+            shard.slots = std::move ( grown );
+        }
+        const size_t mask = shard.slots.size () - 1;
+        size_t i = h & mask;
+        while ( shard.slots[ i ] != 0 )
+            i = ( i + 1 ) & mask;
+        shard.slots[ i ] = id;
+        ++shard.count;
+    }
+
+    Shard m_shards[ kShards ];
+    ConcurrentPinnedVector< Entry, 1 > m_entries;   ///< id - 1 -> 条目
+    ConcurrentPinnedVector< char, 4 > m_bytes;      ///< 所有驻留字符串的字节（各自以 '\0' 结尾）
+};
+
+// =========================================================================
+// 4 字节驻留字符串句柄：相等比较与哈希都是 O(1) 的整数运算
+// =========================================================================
+class InternedString
+{
+   public:
+
+    InternedString () noexcept = default;
+
+    explicit InternedString ( std::string_view s ) : m_id ( InternTable::global ().intern ( s ) )
+    {
+    }
+
+    InternedString& operator= ( std::string_view s )
+    {
+        m_id = InternTable::global ().intern ( s );
+        return *this;
+    }
+
+    // 只查不插：未驻留过的字符串返回空句柄，且不会污染驻留表
+    [[nodiscard]] static InternedString lookup ( std::string_view s )
+    {
+        InternedString r;
+        r.m_id = InternTable::global ().find ( s );
+        return r;
+    }
+
+    [[nodiscard]] inline uint32_t id () const noexcept
+    {
+        return m_id;
+    }
+
+    [[nodiscard]] inline bool empty () const noexcept
+    {
+        return m_id == 0;
+    }
+
+    [[nodiscard]] inline std::string_view view () const noexcept
+    {
+        return InternTable::global ().view ( m_id );
+    }
+
+    [[nodiscard]] inline const char* c_str () const noexcept
+    {
+        return InternTable::global ().c_str ( m_id );
+    }
+
+    [[nodiscard]] inline uint32_t size () const noexcept
+    {
+        return static_cast< uint32_t > ( view ().size () );
+    }
+
+    [[nodiscard]] inline operator std::string_view () const noexcept
+    {
+        return view ();
+    }
+
+    [[nodiscard]] inline size_t hash () const noexcept
+    {
+        return m_id;
+    }
+
+    [[nodiscard]] inline bool operator== ( const InternedString& other ) const noexcept
+    {
+        return m_id == other.m_id;
+    }
+
+    [[nodiscard]] inline bool operator!= ( const InternedString& other ) const noexcept
+    {
+        return m_id != other.m_id;
+    }
+
+   private:
+
+    uint32_t m_id = 0;
+};
+}   // namespace StuCanvas::utils
+
+template <>
+struct std::hash< StuCanvas::utils::InternedString >
+{
+    size_t operator() ( const StuCanvas::utils::InternedString& s ) const noexcept
+    {
+        return s.hash ();
+    }
+};
@@ -29,6 +29,7 @@
 
 // 💡 引入共享基础组件
 #include "optimization_common.hpp"
+#include "profiling.hpp"
 
 namespace StuCanvas::utils::optimization
 {
@@ -137,8 +138,10 @@ namespace StuCanvas::utils::optimization
         std::atomic< bool >* cancellation = nullptr,
         std::atomic< apply_invoke_result_t< Func, Real, Dimension > >* current_minimum_cost = nullptr,
         std::vector< std::pair< std::array< Real, Dimension >, apply_invoke_result_t< Func, Real, Dimension > > >*
-            queries = nullptr )
+            queries = nullptr,
+        size_t* evaluations = nullptr )   // 可选：写回实际消耗的代价函数评估次数（NFE）
     {
+        STU_PROFILE_ZONE ( "l_shade" );
 
         using Container = std::array< Real, Dimension >;
         using ResultType = apply_invoke_result_t< Func, Real, Dimension >;
@@ -530,6 +533,11 @@ namespace StuCanvas::utils::optimization
             }
         }
 
+        if ( evaluations )
+        {
+            *evaluations = NFE;
+        }
+
         auto it = std::min_element ( cost.begin (), cost.end () );
         return population[ std::distance ( cost.begin (), it ) ];
     }
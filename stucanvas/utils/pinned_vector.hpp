@@ -1,10 +1,19 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <new>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 // 根据不同平台引入对应的系统调用头文件
 #ifdef _WIN32
@@ -13,13 +22,34 @@
 #else
 #include <sys/mman.h>
 #include <unistd.h>
+#if defined( __linux__ )
+#include <sys/syscall.h>
+#endif
 #endif
 
 namespace StuCanvas::utils
 {
+// 物理页在 NUMA 节点间的放置策略
+enum class NumaPlacement : uint8_t
+{
+    FirstTouch,   // 系统默认：页面落在首次写入它的线程所在节点（配合 prefault 即提交线程所在节点）
+    Interleave    // 按页在全部节点间轮转，适合被多个插槽上的线程共同遍历的大池
+};
+
+// 物理内存提交策略（结构化类型，可直接作为 PinnedVector 的模板参数）
+struct PinnedPolicy
+{
+    bool huge_pages = false;   // 预留区按 2 MB 对齐并 MADV_HUGEPAGE，提交粒度取整到 2 MB，由透明大页承载
+    bool prefault = false;     // 提交时立即预缺页（MADV_POPULATE_WRITE），缺页中断留在扩容冷路径而非遍历热路径；
+                               // 代价是倍增提交的余量也会立刻占用物理内存
+    NumaPlacement numa = NumaPlacement::FirstTouch;
+};
+
 // 系统级虚拟内存操作封装
 struct SysMem
 {
+    static constexpr size_t HUGE_PAGE_SIZE = 2ULL * 1024ULL * 1024ULL;
+
     static size_t get_page_size ()
     {
 #ifdef _WIN32
@@ -31,6 +61,12 @@ struct SysMem
 #endif
     }
 
+    // 提交粒度：启用大页时取整到 2 MB，保证每次提交出的区间都能被整页大页覆盖
+    static size_t commit_granularity ( size_t page_size, const PinnedPolicy& policy ) noexcept
+    {
+        return policy.huge_pages ? std::max ( page_size, HUGE_PAGE_SIZE ) : page_size;
+    }
+
     static void* reserve ( size_t size )
     {
 #ifdef _WIN32
@@ -44,6 +80,118 @@ struct SysMem
 #endif
     }
 
+    // 按策略预留：大页模式下起始地址对齐到 2 MB；大页与 NUMA 建议一次性作用在整个预留区上，
+    // 之后 mprotect 切分出的各段都继承同一组标记，相邻已提交段仍可合并成完整的大页区间
+    static void* reserve ( size_t size, const PinnedPolicy& policy )
+    {
+#ifdef _WIN32
+        // Windows 的大页需要 SeLockMemoryPrivilege 且必须在预留时整体提交，这里保持默认行为
+        ( void ) policy;
+        return reserve ( size );
+#else
+        const size_t page_size = get_page_size ();
+        const size_t map_size = ( size + page_size - 1 ) & ~( page_size - 1 );
+        void* ptr = nullptr;
+
+        if ( policy.huge_pages )
+        {
+            const size_t padded = map_size + HUGE_PAGE_SIZE;
+            void* raw = mmap ( nullptr, padded, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+            if ( raw == MAP_FAILED )
+                return nullptr;
+
+            // 裁掉首尾多余部分，只留下对齐后的 [aligned, aligned + map_size)
+            const uintptr_t base = reinterpret_cast< uintptr_t > ( raw );
+            const uintptr_t aligned = ( base + HUGE_PAGE_SIZE - 1 ) & ~( uintptr_t ) ( HUGE_PAGE_SIZE - 1 );
+            if ( aligned > base )
+                munmap ( raw, aligned - base );
+            const size_t tail = ( base + padded ) - ( aligned + map_size );
+            if ( tail > 0 )
+                munmap ( reinterpret_cast< void* > ( aligned + map_size ), tail );
+            ptr = reinterpret_cast< void* > ( aligned );
+        }
+        else
+        {
+            ptr = reserve ( map_size );
+            if ( !ptr )
+                return nullptr;
+        }
+
+#if defined( __linux__ )
+        if ( policy.huge_pages )
+        {
+            madvise ( ptr, map_size, MADV_HUGEPAGE );   // 透明大页关闭时返回失败，退回普通页即可
+        }
+        if ( policy.numa == NumaPlacement::Interleave && !interleave ( ptr, map_size ) )
+        {
+            // 交错失败不影响正确性：该区间保持首次写入放置，只提示一次
+            static std::atomic< bool > warned{ false };
+            if ( !warned.exchange ( true, std::memory_order_relaxed ) )
+            {
+                std::cerr << "[PinnedVector] mbind(MPOL_INTERLEAVE) failed: " << std::strerror ( errno )
+                          << "; falling back to first-touch placement" << std::endl;
+            }
+        }
+#endif
+        return ptr;
+#endif
+    }
+
+#if defined( __linux__ )
+    // 当前在线的内存节点掩码（解析 /sys/devices/system/node/online，如 "0-1,3"）；读取失败时为空
+    static const std::vector< unsigned long >& online_nodes ()
+    {
+        static const std::vector< unsigned long > mask = []
+        {
+            std::vector< unsigned long > bits;
+            std::FILE* file = std::fopen ( "/sys/devices/system/node/online", "r" );
+            if ( !file )
+                return bits;
+            constexpr unsigned WORD_BITS = sizeof ( unsigned long ) * 8;
+            unsigned first = 0, last = 0;
+            while ( std::fscanf ( file, "%u", &first ) == 1 )
+            {
+                last = first;
+                int sep = std::fgetc ( file );
+                if ( sep == '-' )
+                {
+                    if ( std::fscanf ( file, "%u", &last ) != 1 )
+                        break;
+                    sep = std::fgetc ( file );
+                }
+                for ( unsigned node = first; node <= last; ++node )
+                {
+                    if ( bits.size () <= node / WORD_BITS )
+                        bits.resize ( node / WORD_BITS + 1, 0 );
+                    bits[ node / WORD_BITS ] |= 1UL << ( node % WORD_BITS );
+                }
+                if ( sep != ',' )
+                    break;
+            }
+            std::fclose ( file );
+            return bits;
+        }();
+        return mask;
+    }
+
+    // 把区间的页面放置策略设为在全部在线节点间交错；单节点机器无需交错，直接视为成功。
+    // 直接走系统调用，避免引入 libnuma
+    static bool interleave ( void* addr, size_t size )
+    {
+        const std::vector< unsigned long >& nodes = online_nodes ();
+        size_t online = 0;
+        for ( unsigned long word : nodes )
+            online += static_cast< size_t > ( std::popcount ( word ) );
+        if ( online <= 1 )
+            return true;
+
+        constexpr int MPOL_INTERLEAVE_MODE = 3;
+        // maxnode 按内核约定取掩码位数 + 1
+        const unsigned long max_node = nodes.size () * sizeof ( unsigned long ) * 8 + 1;
+        return syscall ( SYS_mbind, addr, size, MPOL_INTERLEAVE_MODE, nodes.data (), max_node, 0 ) == 0;
+    }
+#endif
+
     static bool commit ( void* addr, size_t size )
     {
 #ifdef _WIN32
@@ -53,6 +201,39 @@ struct SysMem
 #endif
     }
 
+    // 按策略提交：在普通提交的基础上可选地立即预缺页
+    static bool commit ( void* addr, size_t size, const PinnedPolicy& policy )
+    {
+        if ( !commit ( addr, size ) )
+            return false;
+        if ( policy.prefault )
+        {
+            prefault ( addr, size );
+        }
+        return true;
+    }
+
+    // 预缺页：优先用 MADV_POPULATE_WRITE 一次性建立页表（Linux 5.14+），不支持时退回逐页写入
+    static void prefault ( void* addr, size_t size )
+    {
+#if defined( __linux__ )
+#if defined( MADV_POPULATE_WRITE )
+        constexpr int POPULATE_WRITE = MADV_POPULATE_WRITE;
+#else
+        constexpr int POPULATE_WRITE = 23;
+#endif
+        if ( madvise ( addr, size, POPULATE_WRITE ) == 0 )
+            return;
+#endif
+        // 新提交的匿名页内容必为零，逐页写零即可触发缺页且不改变内容
+        const size_t page_size = get_page_size ();
+        volatile char* p = static_cast< volatile char* > ( addr );
+        for ( size_t offset = 0; offset < size; offset += page_size )
+        {
+            p[ offset ] = 0;
+        }
+    }
+
     static void decommit ( void* addr, size_t size )
     {
 #ifdef _WIN32
@@ -86,7 +267,8 @@ namespace details = StuCanvas::utils;
 // PinnedVector 模板参数：
 // T: 元素类型
 // GbCapacity: 预留的虚拟地址空间大小（单位：GB）
-template < typename T, size_t GbCapacity >
+// Policy: 物理内存提交策略（大页 / 预缺页 / NUMA 放置），默认与系统行为一致
+template < typename T, size_t GbCapacity, PinnedPolicy Policy = PinnedPolicy{} >
 class PinnedVector
 {
     static_assert ( GbCapacity > 0, "Capacity must be at least 1 GB" );
@@ -163,7 +345,8 @@ class PinnedVector
         if ( required_sys_bytes <= header->committed_bytes )
             return;
 
-        required_sys_bytes = align_up ( required_sys_bytes, header->page_size );
+        required_sys_bytes =
+            align_up ( required_sys_bytes, details::SysMem::commit_granularity ( header->page_size, Policy ) );
         if ( required_sys_bytes > RESERVED_BYTES )
         {
             required_sys_bytes = RESERVED_BYTES;
@@ -174,7 +357,7 @@ class PinnedVector
             return;
 
         void* commit_addr = reinterpret_cast< char* > ( header ) + header->committed_bytes;
-        if ( !details::SysMem::commit ( commit_addr, diff ) )
+        if ( !details::SysMem::commit ( commit_addr, diff, Policy ) )
         {
             throw std::bad_alloc ();
         }
@@ -215,7 +398,7 @@ class PinnedVector
             throw std::runtime_error ( "Failed to query system page size" );
         }
 
-        void* addr = details::SysMem::reserve ( RESERVED_BYTES );
+        void* addr = details::SysMem::reserve ( RESERVED_BYTES, Policy );
         if ( !addr )
         {
             throw std::bad_alloc ();
@@ -223,7 +406,7 @@ class PinnedVector
         PinnedHeader* header = reinterpret_cast< PinnedHeader* > ( addr );
 
         size_t initial_commit = align_up ( HEADER_OFFSET, page_size );
-        if ( !details::SysMem::commit ( header, initial_commit ) )
+        if ( !details::SysMem::commit ( header, initial_commit, Policy ) )
         {
             details::SysMem::release ( header, RESERVED_BYTES );
             throw std::bad_alloc ();
@@ -479,4 +662,363 @@ class PinnedVector
     }
 };
 
+
+// ConcurrentPinnedVector：PinnedVector 的并发追加版本
+// 元素地址同样永不移动，多个线程可同时追加：
+//   - 下标占位是一次 CAS（先确认容量再占位，扩容失败不会留下空洞），写入各自的槽位互不干扰
+//   - 提交物理内存的扩容冷路径由互斥锁串行化，快速路径只有一次 acquire 读
+//   - 读者通过 size() 看到“已发布”的长度，保证 [0, size()) 内的元素都已构造完毕；
+//     持续并发追加期间发布长度可能滞后，所有追加结束后必然等于追加总数
+// 注意：追加与 clear()/shrink 类操作不能并发；元素构造不得抛出异常，否则该槽位永远不会被发布
+template < typename T, size_t GbCapacity, PinnedPolicy Policy = PinnedPolicy{} >
+class ConcurrentPinnedVector
+{
+    static_assert ( GbCapacity > 0, "Capacity must be at least 1 GB" );
+    static_assert ( sizeof ( void* ) == 8, "ConcurrentPinnedVector is only supported on 64-bit architectures" );
+
+   public:
+
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+   private:
+
+    static constexpr size_t CACHE_LINE = 64;
+
+    // 控制信息结构体，放置在预留内存的头部；高频原子量各占一条缓存行，避免伪共享
+    struct ConcurrentHeader
+    {
+        alignas ( CACHE_LINE ) std::atomic< size_t > reserved{ 0 };      // 已被占位的下标数
+        alignas ( CACHE_LINE ) std::atomic< size_t > constructed{ 0 };   // 已构造完毕的元素数（不保证连续）
+        alignas ( CACHE_LINE ) std::atomic< size_t > published{ 0 };     // 对读者可见的长度：[0, published) 全部构造完毕
+        alignas ( CACHE_LINE ) std::atomic< size_t > max_committed_elements{ 0 };
+        size_t committed_bytes = 0;   // 整个虚拟内存区已提交物理内存的字节数（含头部）
+        size_t page_size = 0;
+        std::mutex grow_mutex;        // 仅冷路径（提交新页面）使用
+    };
+
+    static constexpr size_t GB = 1024ULL * 1024ULL * 1024ULL;
+    static constexpr size_t TOTAL_BYTES = GbCapacity * GB;
+
+    static constexpr size_t align_up ( size_t size, size_t alignment ) noexcept
+    {
+        return ( size + alignment - 1 ) & ~( alignment - 1 );
+    }
+
+    static constexpr size_t HEADER_ALIGN = alignof ( T ) > CACHE_LINE ? alignof ( T ) : CACHE_LINE;
+    static constexpr size_t HEADER_OFFSET = align_up ( sizeof ( ConcurrentHeader ), HEADER_ALIGN );
+    static constexpr size_t RESERVED_BYTES = TOTAL_BYTES + HEADER_OFFSET;
+    static constexpr size_t MAX_ELEMENTS = TOTAL_BYTES / sizeof ( T );
+
+    T* m_data = nullptr;
+
+    inline ConcurrentHeader* get_header () const noexcept
+    {
+        if ( m_data ) [[likely]]
+        {
+            return reinterpret_cast< ConcurrentHeader* > ( reinterpret_cast< char* > ( m_data ) - HEADER_OFFSET );
+        }
+        return nullptr;
+    }
+
+    // 冷路径：加锁后再次确认，按指数策略提交到至少 required_elements 个元素
+#if defined( __GNUC__ ) || defined( __clang__ )
+    __attribute__ ( ( noinline ) )
+#elif defined( _MSC_VER )
+    __declspec ( noinline )
+#endif
+    void grow_capacity_to ( size_t required_elements )
+    {
+        ConcurrentHeader* header = get_header ();
+        std::lock_guard< std::mutex > lock ( header->grow_mutex );
+        if ( required_elements <= header->max_committed_elements.load ( std::memory_order_relaxed ) )
+            return;
+
+        size_t current_user_committed = header->committed_bytes - HEADER_OFFSET;
+        size_t next_commit = current_user_committed == 0 ? header->page_size : current_user_committed * 2;
+        next_commit = std::max ( next_commit, required_elements * sizeof ( T ) );
+
+        size_t required_sys_bytes = align_up ( HEADER_OFFSET + next_commit,
+                                               details::SysMem::commit_granularity ( header->page_size, Policy ) );
+        if ( required_sys_bytes > RESERVED_BYTES )
+        {
+            required_sys_bytes = RESERVED_BYTES;
+        }
+
+        void* commit_addr = reinterpret_cast< char* > ( header ) + header->committed_bytes;
+        if ( !details::SysMem::commit ( commit_addr, required_sys_bytes - header->committed_bytes, Policy ) )
+        {
+            throw std::bad_alloc ();
+        }
+        header->committed_bytes = required_sys_bytes;
+        header->max_committed_elements.store ( ( required_sys_bytes - HEADER_OFFSET ) / sizeof ( T ),
+                                               std::memory_order_release );
+    }
+
+    // 占位 count 个连续下标，并保证对应页面已提交；返回起始下标
+    // 先检查容量（必要时提交页面）再以 CAS 占位：越界或提交失败抛出时尚未占位，
+    // reserved 不会超前于 constructed，发布长度不会因此永久卡住
+    size_t claim ( size_t count )
+    {
+        ConcurrentHeader* header = get_header ();
+        if ( !header ) [[unlikely]]
+        {
+            throw std::out_of_range ( "ConcurrentPinnedVector is uninitialized or moved from" );
+        }
+
+        size_t first = header->reserved.load ( std::memory_order_relaxed );
+        for ( ;; )
+        {
+            const size_t last = first + count;
+            if ( last > MAX_ELEMENTS || last < first ) [[unlikely]]
+            {
+                throw std::out_of_range ( "ConcurrentPinnedVector capacity limit reached" );
+            }
+            if ( last > header->max_committed_elements.load ( std::memory_order_acquire ) ) [[unlikely]]
+            {
+                grow_capacity_to ( last );
+            }
+            if ( header->reserved.compare_exchange_weak ( first, last, std::memory_order_relaxed,
+                                                          std::memory_order_relaxed ) ) [[likely]]
+            {
+                return first;
+            }
+        }
+    }
+
+    // 构造完成后计数；当全部已占位的槽位都构造完毕时推进发布长度
+    // 其他线程的 acq_rel 计数构成释放序列，发布者的 release 写因此也覆盖了它们的元素
+    void mark_constructed ( size_t count ) noexcept
+    {
+        ConcurrentHeader* header = get_header ();
+        const size_t done = header->constructed.fetch_add ( count, std::memory_order_acq_rel ) + count;
+        if ( done != header->reserved.load ( std::memory_order_acquire ) )
+            return;
+
+        size_t current = header->published.load ( std::memory_order_relaxed );
+        while ( current < done &&
+                !header->published.compare_exchange_weak ( current, done, std::memory_order_release,
+                                                           std::memory_order_relaxed ) )
+        {
+        }
+    }
+
+    void release_storage () noexcept
+    {
+        ConcurrentHeader* header = get_header ();
+        if ( !header )
+            return;
+        clear ();
+        header->~ConcurrentHeader ();
+        details::SysMem::release ( header, RESERVED_BYTES );
+        m_data = nullptr;
+    }
+
+   public:
+
+    ConcurrentPinnedVector ()
+    {
+        size_t page_size = details::SysMem::get_page_size ();
+        if ( page_size == 0 )
+        {
+            throw std::runtime_error ( "Failed to query system page size" );
+        }
+
+        void* addr = details::SysMem::reserve ( RESERVED_BYTES, Policy );
+        if ( !addr )
+        {
+            throw std::bad_alloc ();
+        }
+
+        size_t initial_commit = align_up ( HEADER_OFFSET, page_size );
+        if ( !details::SysMem::commit ( addr, initial_commit, Policy ) )
+        {
+            details::SysMem::release ( addr, RESERVED_BYTES );
+            throw std::bad_alloc ();
+        }
+
+        ConcurrentHeader* header = new ( addr ) ConcurrentHeader ();
+        header->committed_bytes = initial_commit;
+        header->page_size = page_size;
+        header->max_committed_elements.store ( ( initial_commit - HEADER_OFFSET ) / sizeof ( T ),
+                                               std::memory_order_relaxed );
+
+        m_data = reinterpret_cast< T* > ( reinterpret_cast< char* > ( addr ) + HEADER_OFFSET );
+    }
+
+    ~ConcurrentPinnedVector ()
+    {
+        release_storage ();
+    }
+
+    ConcurrentPinnedVector ( const ConcurrentPinnedVector& ) = delete;
+    ConcurrentPinnedVector& operator= ( const ConcurrentPinnedVector& ) = delete;
+
+    ConcurrentPinnedVector ( ConcurrentPinnedVector&& other ) noexcept : m_data ( other.m_data )
+    {
+        other.m_data = nullptr;
+    }
+
+    ConcurrentPinnedVector& operator= ( ConcurrentPinnedVector&& other ) noexcept
+    {
+        if ( this != &other )
+        {
+            release_storage ();
+            m_data = other.m_data;
+            other.m_data = nullptr;
+        }
+        return *this;
+    }
+
+    // 线程安全：追加单个元素，返回其稳定引用
+    template < typename... Args >
+    reference emplace_back ( Args&&... args )
+    {
+        const size_t index = claim ( 1 );
+        T* target = m_data + index;
+        new ( target ) T ( std::forward< Args > ( args )... );
+        mark_constructed ( 1 );
+        return *target;
+    }
+
+    void push_back ( const T& value )
+    {
+        emplace_back ( value );
+    }
+
+    void push_back ( T&& value )
+    {
+        emplace_back ( std::move ( value ) );
+    }
+
+    // 线程安全：一次占位 count 个连续槽位，由 init(T* first, size_t count) 原位构造全部元素
+    // 适合并行任务把整段结果直接写进最终位置；返回起始下标
+    template < typename Init >
+    size_t grow_by ( size_t count, Init&& init )
+    {
+        if ( count == 0 )
+            return size ();
+        const size_t first = claim ( count );
+        init ( m_data + first, count );
+        mark_constructed ( count );
+        return first;
+    }
+
+    // 线程安全：整段拷贝追加，返回起始下标
+    size_t append ( const T* src, size_t count )
+    {
+        return grow_by ( count, [ src ] ( T* dst, size_t n ) { std::uninitialized_copy_n ( src, n, dst ); } );
+    }
+
+    // 线程安全：提前提交物理内存，使后续追加全部走快速路径
+    void reserve ( size_t new_capacity )
+    {
+        ConcurrentHeader* header = get_header ();
+        if ( !header )
+        {
+            throw std::out_of_range ( "ConcurrentPinnedVector is uninitialized or moved from" );
+        }
+        if ( new_capacity > MAX_ELEMENTS )
+        {
+            throw std::out_of_range ( "Requested reserve size exceeds virtual capacity limits" );
+        }
+        if ( new_capacity > header->max_committed_elements.load ( std::memory_order_acquire ) )
+        {
+            grow_capacity_to ( new_capacity );
+        }
+    }
+
+    // 非线程安全：须在没有并发追加时调用
+    void clear () noexcept
+    {
+        ConcurrentHeader* header = get_header ();
+        if ( !header )
+            return;
+        const size_t count = header->reserved.load ( std::memory_order_acquire );
+        for ( size_t i = 0; i < count; ++i )
+        {
+            m_data[ i ].~T ();
+        }
+        header->reserved.store ( 0, std::memory_order_relaxed );
+        header->constructed.store ( 0, std::memory_order_relaxed );
+        header->published.store ( 0, std::memory_order_release );
+    }
+
+    inline reference operator[] ( size_t index ) noexcept
+    {
+        return m_data[ index ];
+    }
+    inline const_reference operator[] ( size_t index ) const noexcept
+    {
+        return m_data[ index ];
+    }
+
+    reference at ( size_t index )
+    {
+        if ( index >= size () )
+            throw std::out_of_range ( "Index out of bounds" );
+        return m_data[ index ];
+    }
+
+    const_reference at ( size_t index ) const
+    {
+        if ( index >= size () )
+            throw std::out_of_range ( "Index out of bounds" );
+        return m_data[ index ];
+    }
+
+    inline T* data () noexcept
+    {
+        return m_data;
+    }
+    inline const T* data () const noexcept
+    {
+        return m_data;
+    }
+
+    // 已发布长度：可与追加并发读取，[0, size()) 内元素均已构造完毕
+    inline size_t size () const noexcept
+    {
+        const ConcurrentHeader* header = get_header ();
+        return header ? header->published.load ( std::memory_order_acquire ) : 0;
+    }
+
+    // 已占位长度（包含仍在构造中的槽位），仅用于统计与调试
+    inline size_t reserved_size () const noexcept
+    {
+        const ConcurrentHeader* header = get_header ();
+        return header ? header->reserved.load ( std::memory_order_relaxed ) : 0;
+    }
+
+    inline size_t capacity () const noexcept
+    {
+        return MAX_ELEMENTS;
+    }
+    inline bool empty () const noexcept
+    {
+        return size () == 0;
+    }
+
+    inline T* begin () noexcept
+    {
+        return m_data;
+    }
+    inline const T* begin () const noexcept
+    {
+        return m_data;
+    }
+    inline T* end () noexcept
+    {
+        return m_data + size ();
+    }
+    inline const T* end () const noexcept
+    {
+        return m_data + size ();
+    }
+};
+
 }
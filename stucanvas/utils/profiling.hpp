@@ -0,0 +1,218 @@
+/***************************************************************************
+ * Copyright (c) 2026 Tian Yuxuan (Friendships666)                          *
+ *                                                                          *
+ * Distributed under the terms of the MIT License.                          *
+ *                                                                          *
+ * The full license is in the file LICENSE, distributed with this software. *
+ ***************************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// =========================================================================
+// 🚀 编译期可选的性能分析区段（Profiling Zones）
+// =========================================================================
+// 💡 三种模式，由编译宏决定：
+//  - 默认（STUCANVAS_PROFILING=0）：STU_PROFILE_ZONE 展开为空语句，不产生任何代码与数据。
+//  - STUCANVAS_PROFILING=1：内置记录器。每个线程一个定长环形缓冲，区段结束时写入
+//    { 名称指针, 起止时间 }，无锁、无分配；满后覆盖最旧记录。
+//    export_chrome_trace () 导出 Chrome Trace JSON，可直接拖进 chrome://tracing 或 Perfetto。
+//  - STUCANVAS_PROFILING_TRACY：转发为 Tracy 的 ZoneScopedN，需自行链接 TracyClient。
+//
+// 用法：在函数或作用域开头写 STU_PROFILE_ZONE ( "marchingCubes3D" );
+// 名称必须是字符串字面量（只保存指针）。
+#ifndef STUCANVAS_PROFILING
+#define STUCANVAS_PROFILING 0
+#endif
+
+#if defined( STUCANVAS_PROFILING_TRACY )
+#include <tracy/Tracy.hpp>
+#elif STUCANVAS_PROFILING
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#endif
+
+namespace StuCanvas::utils::profiling
+{
+#if defined( STUCANVAS_PROFILING_TRACY )
+inline constexpr bool kBuiltinRecorder = false;
+inline constexpr bool kEnabled = true;
+#elif STUCANVAS_PROFILING
+inline constexpr bool kBuiltinRecorder = true;
+inline constexpr bool kEnabled = true;
+#else
+inline constexpr bool kBuiltinRecorder = false;
+inline constexpr bool kEnabled = false;
+#endif
+
+#if STUCANVAS_PROFILING && !defined( STUCANVAS_PROFILING_TRACY )
+
+struct ZoneEvent
+{
+    const char* name;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+};
+
+class ZoneRecorder
+{
+   public:
+
+    // 每线程保留最近 32768 个区段（24 B / 条，约 768 KB），仅在该线程第一次记录时分配
+    static constexpr size_t kRingCapacity = size_t ( 1 ) << 15;
+
+    struct ThreadRing
+    {
+        ZoneEvent events[ kRingCapacity ];
+        std::atomic< uint64_t > head { 0 };   // 累计写入条数，只由所属线程递增
+        uint32_t tid = 0;
+    };
+
+    [[nodiscard]] static ZoneRecorder& global ()
+    {
+        // 故意泄漏：线程退出或静态析构期间仍可能有区段结束
+        static ZoneRecorder* recorder = new ZoneRecorder ();
+        return *recorder;
+    }
+
+    [[nodiscard]] static uint64_t now_ns () noexcept
+    {
+        return static_cast< uint64_t > ( std::chrono::duration_cast< std::chrono::nanoseconds > (
+                                             std::chrono::steady_clock::now ().time_since_epoch () )
+                                             .count () );
+    }
+
+    void record ( const char* name, uint64_t begin_ns, uint64_t end_ns )
+    {
+        ThreadRing& ring = local_ring ();
+        const uint64_t h = ring.head.load ( std::memory_order_relaxed );
+        ring.events[ h & ( kRingCapacity - 1 ) ] = ZoneEvent { name, begin_ns, end_ns };
+        ring.head.store ( h + 1, std::memory_order_release );
+    }
+
+    // 丢弃已记录的区段；应在没有活跃区段（例如两帧之间）时调用
+    void clear ()
+    {
+        std::scoped_lock lock ( m_mutex );
+        for ( auto& ring : m_rings )
+            ring->head.store ( 0, std::memory_order_relaxed );
+        m_epoch_ns = now_ns ();
+    }
+
+    // 导出 Chrome Trace（"X" 完整事件，时间单位微秒）；应在没有活跃区段时调用
+    bool export_chrome_trace ( std::ostream& out ) const
+    {
+        std::scoped_lock lock ( m_mutex );
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for ( const auto& ring : m_rings )
+        {
+            const uint64_t head = ring->head.load ( std::memory_order_acquire );
+            const uint64_t begin = head > kRingCapacity ? head - kRingCapacity : 0;
+            for ( uint64_t i = begin; i < head; ++i )
+            {
+                const ZoneEvent& e = ring->events[ i & ( kRingCapacity - 1 ) ];
+                if ( e.begin_ns < m_epoch_ns )
+                    continue;
+                out << ( first ? "\n" : ",\n" ) << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                    << ring->tid << ",\"ts\":" << static_cast< double > ( e.begin_ns - m_epoch_ns ) * 1e-3
+                    << ",\"dur\":" << static_cast< double > ( e.end_ns - e.begin_ns ) * 1e-3 << "}";
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+        return static_cast< bool > ( out );
+    }
+
+   private:
+
+    ZoneRecorder () : m_epoch_ns ( now_ns () )
+    {
+    }
+
+    ThreadRing& local_ring ()
+    {
+        thread_local ThreadRing* ring = nullptr;
+        if ( !ring ) [[unlikely]]
+        {
+            auto owned = std::make_unique< ThreadRing > ();
+            std::scoped_lock lock ( m_mutex );
+            owned->tid = static_cast< uint32_t > ( m_rings.size () );
+            ring = owned.get ();
+            m_rings.push_back ( std::move ( owned ) );
+        }
+        return *ring;
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector< std::unique_ptr< ThreadRing > > m_rings;   // 只增不减，线程退出后记录仍可导出
+    uint64_t m_epoch_ns;
+};
+
+class ScopedZone
+{
+   public:
+
+    // 先确保记录器已创建：其时间原点必须早于第一个区段的起点，否则首个外层区段会被导出过滤掉
+    explicit ScopedZone ( const char* name ) noexcept
+        : m_name ( ( static_cast< void > ( ZoneRecorder::global () ), name ) ), m_begin_ns ( ZoneRecorder::now_ns () )
+    {
+    }
+
+    ~ScopedZone ()
+    {
+        ZoneRecorder::global ().record ( m_name, m_begin_ns, ZoneRecorder::now_ns () );
+    }
+
+    ScopedZone ( const ScopedZone& ) = delete;
+    ScopedZone& operator= ( const ScopedZone& ) = delete;
+
+   private:
+
+    const char* m_name;
+    uint64_t m_begin_ns;
+};
+
+inline bool export_chrome_trace ( const char* path )
+{
+    std::ofstream out ( path );
+    return out && ZoneRecorder::global ().export_chrome_trace ( out );
+}
+
+inline void clear ()
+{
+    ZoneRecorder::global ().clear ();
+}
+
+#else
+
+// 未启用内置记录器（关闭或交给 Tracy）：保持调用点可编译，导出恒失败
+inline bool export_chrome_trace ( const char* )
+{
+    return false;
+}
+
+inline void clear ()
+{
+}
+
+#endif
+}   // namespace StuCanvas::utils::profiling
+
+#define STU_PROFILE_CONCAT_INNER( a, b ) a##b
+#define STU_PROFILE_CONCAT( a, b ) STU_PROFILE_CONCAT_INNER ( a, b )
+
+#if defined( STUCANVAS_PROFILING_TRACY )
+#define STU_PROFILE_ZONE( name ) ZoneScopedN ( name )
+#elif STUCANVAS_PROFILING
+#define STU_PROFILE_ZONE( name ) \
+    const ::StuCanvas::utils::profiling::ScopedZone STU_PROFILE_CONCAT ( stu_profile_zone_, __LINE__ ) ( name )
+#else
+#define STU_PROFILE_ZONE( name ) static_cast< void > ( 0 )
+#endif
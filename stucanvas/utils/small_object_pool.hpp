@@ -0,0 +1,648 @@
+/***************************************************************************
+ * Copyright (c) 2026 Tian Yuxuan (Friendships666)                          *
+ *                                                                          *
+ * Distributed under the terms of the MIT License.                          *
+ *                                                                          *
+ * The full license is in the file LICENSE, distributed with this software. *
+ ***************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+#if defined( _MSC_VER )
+#include <malloc.h>
+#define STUCANVAS_POOL_NOINLINE __declspec ( noinline )
+#else
+#define STUCANVAS_POOL_NOINLINE __attribute__ ( ( noinline ) )
+#endif
+
+// 置 1 时小对象池统计命中 / 未命中 / 跨线程释放次数（每线程单写者计数，热路径仅多一次普通存储）
+#ifndef STUCANVAS_SMALL_POOL_STATS
+#define STUCANVAS_SMALL_POOL_STATS 0
+#endif
+
+namespace StuCanvas::utils
+{
+// ─────────────────────────────────────────────────────────────────────────
+// 小对象池计数快照（所有线程堆之和）
+// ─────────────────────────────────────────────────────────────────────────
+struct SmallPoolStats
+{
+    uint64_t hits = 0;              ///< 本线程弹匣直接命中
+    uint64_t remote_reclaims = 0;   ///< 弹匣为空时从跨线程归还链表收回
+    uint64_t depot_refills = 0;     ///< 从全局仓库整批取回
+    uint64_t misses = 0;            ///< 从 chunk 切出新块
+    uint64_t remote_frees = 0;      ///< 释放时归还给所属线程
+    uint64_t depot_flushes = 0;     ///< 弹匣溢出时整批交给全局仓库
+    uint64_t large = 0;             ///< 超出尺寸等级、直接走系统分配器
+    uint64_t chunks_released = 0;   ///< 完全空闲、已归还系统的 chunk 数（不受 STUCANVAS_SMALL_POOL_STATS 控制）
+};
+
+namespace detail
+{
+// =========================================================================
+// 🚀 头部前缀容器共享的小对象分配器
+// =========================================================================
+// 💡 设计要点：
+//  - 2 的幂尺寸等级 32 B ~ 64 KB；超过上限或对齐要求 > 64 字节的请求直接走系统分配器。
+//  - 每个线程独占一个 ThreadHeap：按等级的单链表弹匣，分配 / 释放本线程的块不需要任何原子操作。
+//  - 块从 1 MB 对齐的 chunk 中切出，chunk 头记录所属 ThreadHeap；
+//    其它线程释放时按 chunk 头找到主人，CAS 压入主人的跨线程归还链表，
+//    主人在弹匣耗尽时一次性 exchange 收回，因此 TBB 工作线程分配、主线程释放的缓冲会回到工作线程。
+//  - 弹匣超过上限时把一半整批交给全局仓库 (depot)，其它线程弹匣为空时整批取回，实现线程间再平衡。
+//  - 线程退出时 ThreadHeap 不销毁，而是把弹匣交回仓库并挂入孤儿列表，由之后的新线程接管（连同 chunk 与归还链表）。
+//  - 仓库中的空闲字节超过高水位时整理仓库：某个已切完的 chunk 的全部块都躺在仓库里，即说明它完全空闲，
+//    把这些块从仓库摘除后整块归还系统。弹匣与归还链表中的块不参与判断，热路径不增加任何计数。
+//  - 释放时调用者必须传入与分配时相同的 (size, alignment)，头部前缀容器都能从自身头部还原出该值。
+class SmallObjectPool
+{
+   public:
+
+    static constexpr size_t kMinClassShift = 5;    // 32 B
+    static constexpr size_t kMaxClassShift = 16;   // 64 KB
+    static constexpr size_t kNumClasses = kMaxClassShift - kMinClassShift + 1;
+    static constexpr size_t kMaxSmallSize = size_t ( 1 ) << kMaxClassShift;
+    static constexpr size_t kMaxSmallAlign = 64;
+    static constexpr size_t kChunkSize = size_t ( 1 ) << 20;
+    static constexpr size_t kLarge = kNumClasses;
+    static constexpr size_t kDepotHighWater = size_t ( 64 ) << 20;   ///< 仓库空闲字节超过该值时尝试归还 chunk
+
+    struct Node
+    {
+        Node* next;
+    };
+
+    enum Stat : uint32_t
+    {
+        Hits,
+        RemoteReclaims,
+        DepotRefills,
+        Misses,
+        RemoteFrees,
+        DepotFlushes,
+        Large,
+        kNumStats
+    };
+
+    struct ThreadHeap;
+
+    struct alignas ( 64 ) ChunkHeader
+    {
+        ThreadHeap* owner;
+        std::atomic< uint32_t > carved { 0 };     ///< 已切出的块数（仅主人在切分时写入）
+        std::atomic< bool > retired { false };    ///< 主人已换用新 chunk，块数不再变化
+    };
+
+    struct alignas ( 64 ) ThreadHeap
+    {
+        // ── 仅主人线程读写 ──
+        Node* magazine[ kNumClasses ] = {};
+        uint32_t count[ kNumClasses ] = {};
+        char* cursor = nullptr;   ///< 当前 chunk 的切分游标
+        char* limit = nullptr;
+#if STUCANVAS_SMALL_POOL_STATS
+        std::atomic< uint64_t > stats[ kNumStats ] = {};
+#endif
+
+        // ── 其它线程写入 ──
+        alignas ( 64 ) std::atomic< Node* > remote[ kNumClasses ] = {};
+        std::atomic< bool > orphaned { false };
+    };
+
+    // 按等级的弹匣上限：约 256 KB，且在 [4, 256] 块之间
+    [[nodiscard]] static constexpr uint32_t magazine_limit ( size_t cls ) noexcept
+    {
+        const size_t by_bytes = ( size_t ( 256 ) << 10 ) >> ( cls + kMinClassShift );
+        return static_cast< uint32_t > ( by_bytes < 4 ? 4 : ( by_bytes > 256 ? 256 : by_bytes ) );
+    }
+
+    // (size, alignment) -> 尺寸等级；kLarge 表示走系统分配器
+    [[nodiscard]] static inline size_t size_class ( size_t size, size_t alignment ) noexcept
+    {
+        if ( alignment > kMaxSmallAlign )
+            return kLarge;
+        const size_t need = size > alignment ? size : alignment;
+        if ( need > kMaxSmallSize )
+            return kLarge;
+        if ( need <= ( size_t ( 1 ) << kMinClassShift ) )
+            return 0;
+        return static_cast< size_t > ( std::bit_width ( need - 1 ) ) - kMinClassShift;
+    }
+
+    [[nodiscard]] static constexpr size_t class_size ( size_t cls ) noexcept
+    {
+        return size_t ( 1 ) << ( cls + kMinClassShift );
+    }
+
+    [[nodiscard]] static SmallObjectPool& instance () noexcept
+    {
+        // 故意泄漏：线程局部析构与静态析构期间仍可能有块被释放
+        static SmallObjectPool* pool = new SmallObjectPool ();
+        return *pool;
+    }
+
+    // ─────────────────────────────────────────────────────────────────────
+    // 分配 / 释放
+    // ─────────────────────────────────────────────────────────────────────
+    [[nodiscard]] static inline void* allocate ( size_t size, size_t alignment )
+    {
+        const size_t cls = size_class ( size, alignment );
+        if ( cls == kLarge ) [[unlikely]]
+        {
+            return allocate_large ( size, alignment );
+        }
+        ThreadHeap* heap = t_heap;
+        if ( heap ) [[likely]]
+        {
+            Node* n = heap->magazine[ cls ];
+            if ( n ) [[likely]]
+            {
+                heap->magazine[ cls ] = n->next;
+                heap->count[ cls ]--;
+                bump ( heap, Hits );
+                return n;
+            }
+        }
+        return allocate_slow ( cls );
+    }
+
+    static inline void deallocate ( void* ptr, size_t size, size_t alignment ) noexcept
+    {
+        if ( !ptr )
+            return;
+        const size_t cls = size_class ( size, alignment );
+        if ( cls == kLarge ) [[unlikely]]
+        {
+            deallocate_large ( ptr, alignment );
+            return;
+        }
+        ThreadHeap* heap = t_heap;
+        if ( heap && chunk_of ( ptr )->owner == heap ) [[likely]]
+        {
+            Node* n = static_cast< Node* > ( ptr );
+            n->next = heap->magazine[ cls ];
+            heap->magazine[ cls ] = n;
+            if ( ++heap->count[ cls ] > magazine_limit ( cls ) ) [[unlikely]]
+            {
+                flush_half ( heap, cls );
+            }
+            return;
+        }
+        deallocate_remote ( ptr, cls );
+    }
+
+    // 同等级内原地返回；两端都是系统大块时走 realloc；否则分配 + 拷贝 + 释放
+    [[nodiscard]] static inline void* reallocate ( void* ptr, size_t old_size, size_t new_size, size_t alignment )
+    {
+        if ( !ptr )
+            return allocate ( new_size, alignment );
+        const size_t old_cls = size_class ( old_size, alignment );
+        const size_t new_cls = size_class ( new_size, alignment );
+        if ( old_cls == new_cls && old_cls != kLarge )
+            return ptr;
+        if ( old_cls == kLarge && new_cls == kLarge && alignment <= 16 )
+        {
+#if defined( _MSC_VER )
+            void* p = _aligned_realloc ( ptr, new_size, 16 );
+#else
+            void* p = std::realloc ( ptr, new_size );
+#endif
+            if ( !p )
+                throw std::bad_alloc ();
+            return p;
+        }
+        void* p = allocate ( new_size, alignment );
+        std::memcpy ( p, ptr, old_size < new_size ? old_size : new_size );
+        deallocate ( ptr, old_size, alignment );
+        return p;
+    }
+
+    // 所有线程堆的计数之和；未开启 STUCANVAS_SMALL_POOL_STATS 时全部为 0
+    [[nodiscard]] static SmallPoolStats stats () noexcept
+    {
+        SmallPoolStats s;
+#if STUCANVAS_SMALL_POOL_STATS
+        SmallObjectPool& pool = instance ();
+        std::lock_guard< std::mutex > lock ( pool.m_heaps_mutex );
+        for ( ThreadHeap* h : pool.m_all_heaps )
+        {
+            s.hits += h->stats[ Hits ].load ( std::memory_order_relaxed );
+            s.remote_reclaims += h->stats[ RemoteReclaims ].load ( std::memory_order_relaxed );
+            s.depot_refills += h->stats[ DepotRefills ].load ( std::memory_order_relaxed );
+            s.misses += h->stats[ Misses ].load ( std::memory_order_relaxed );
+            s.remote_frees += h->stats[ RemoteFrees ].load ( std::memory_order_relaxed );
+            s.depot_flushes += h->stats[ DepotFlushes ].load ( std::memory_order_relaxed );
+            s.large += h->stats[ Large ].load ( std::memory_order_relaxed );
+        }
+#endif
+        s.chunks_released = instance ().m_chunks_released.load ( std::memory_order_relaxed );
+        return s;
+    }
+
+   private:
+
+    struct Batch
+    {
+        Node* head;
+        uint32_t count;
+    };
+
+    struct alignas ( 64 ) Depot
+    {
+        std::mutex mutex;
+        std::vector< Batch > batches;
+    };
+
+    struct ThreadGuard
+    {
+        ~ThreadGuard () noexcept
+        {
+            release_thread_heap ();
+        }
+    };
+
+    // 平凡析构的线程局部指针：访问无需初始化守卫
+    static inline thread_local ThreadHeap* t_heap = nullptr;
+    static inline thread_local bool t_released = false;
+
+    Depot m_depot[ kNumClasses ];
+    std::mutex m_heaps_mutex;
+    std::vector< ThreadHeap* > m_all_heaps;
+    std::vector< ThreadHeap* > m_orphans;
+    ThreadHeap m_fallback;   ///< 线程局部析构之后的分配，受 m_fallback_mutex 保护
+    std::mutex m_fallback_mutex;
+    std::atomic< size_t > m_depot_bytes { 0 };   ///< 仓库中空闲块的总字节数
+    std::atomic< size_t > m_trim_threshold { kDepotHighWater };
+    std::atomic< uint64_t > m_chunks_released { 0 };
+    std::mutex m_trim_mutex;
+
+    SmallObjectPool () = default;
+
+    [[nodiscard]] static inline ChunkHeader* chunk_of ( void* ptr ) noexcept
+    {
+        return reinterpret_cast< ChunkHeader* > ( reinterpret_cast< uintptr_t > ( ptr ) & ~( kChunkSize - 1 ) );
+    }
+
+    static inline void bump ( [[maybe_unused]] ThreadHeap* heap, [[maybe_unused]] Stat id ) noexcept
+    {
+#if STUCANVAS_SMALL_POOL_STATS
+        // 单写者：load + store 即可，避免 lock 前缀
+        auto& counter = heap->stats[ id ];
+        counter.store ( counter.load ( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+#endif
+    }
+
+    // ─────────────────────────────────────────────────────────────────────
+    // 线程堆的获取与归还
+    // ─────────────────────────────────────────────────────────────────────
+    static ThreadHeap* acquire_thread_heap ()
+    {
+        if ( t_released )
+            return nullptr;
+        static thread_local ThreadGuard guard;   // 注册线程退出回调
+        ( void ) guard;
+
+        SmallObjectPool& pool = instance ();
+        ThreadHeap* heap = nullptr;
+        {
+            std::lock_guard< std::mutex > lock ( pool.m_heaps_mutex );
+            if ( !pool.m_orphans.empty () )
+            {
+                heap = pool.m_orphans.back ();
+                pool.m_orphans.pop_back ();
+            }
+            else
+            {
+                heap = new ThreadHeap ();
+                pool.m_all_heaps.push_back ( heap );
+            }
+        }
+        heap->orphaned.store ( false, std::memory_order_release );
+        t_heap = heap;
+        return heap;
+    }
+
+    static void release_thread_heap () noexcept
+    {
+        ThreadHeap* heap = t_heap;
+        t_heap = nullptr;
+        t_released = true;
+        if ( !heap )
+            return;
+
+        SmallObjectPool& pool = instance ();
+        for ( size_t cls = 0; cls < kNumClasses; ++cls )
+        {
+            if ( heap->magazine[ cls ] )
+            {
+                pool.depot_push ( cls, Batch { heap->magazine[ cls ], heap->count[ cls ] } );
+                heap->magazine[ cls ] = nullptr;
+                heap->count[ cls ] = 0;
+            }
+        }
+        heap->orphaned.store ( true, std::memory_order_release );
+        try
+        {
+            std::lock_guard< std::mutex > lock ( pool.m_heaps_mutex );
+            pool.m_orphans.push_back ( heap );
+        }
+        catch ( ... )
+        {
+            // 孤儿列表扩容失败：该堆的 chunk 仍可经归还链表被释放，只是不再被接管
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────
+    // 全局仓库
+    // ─────────────────────────────────────────────────────────────────────
+    void depot_push ( size_t cls, Batch batch ) noexcept
+    {
+        const size_t bytes = batch.count * class_size ( cls );
+        size_t total = 0;
+        try
+        {
+            std::lock_guard< std::mutex > lock ( m_depot[ cls ].mutex );
+            m_depot[ cls ].batches.push_back ( batch );
+            total = m_depot_bytes.fetch_add ( bytes, std::memory_order_relaxed ) + bytes;
+        }
+        catch ( ... )
+        {
+            // 仓库扩容失败时直接丢弃该批块（块所在 chunk 常驻，不会被误用）
+            return;
+        }
+        if ( total > m_trim_threshold.load ( std::memory_order_relaxed ) ) [[unlikely]]
+            trim_depot ();
+    }
+
+    bool depot_pop ( size_t cls, Batch& out ) noexcept
+    {
+        std::lock_guard< std::mutex > lock ( m_depot[ cls ].mutex );
+        auto& batches = m_depot[ cls ].batches;
+        if ( batches.empty () )
+            return false;
+        out = batches.back ();
+        batches.pop_back ();
+        m_depot_bytes.fetch_sub ( out.count * class_size ( cls ), std::memory_order_relaxed );
+        return true;
+    }
+
+    // 🚀 把全部块都在仓库中的已退役 chunk 摘出并归还系统。
+    // 仓库中某 chunk 的块数等于其切出的块数，说明没有块存活、也没有块停留在任何弹匣或归还链表中
+    STUCANVAS_POOL_NOINLINE void trim_depot () noexcept
+    {
+        std::unique_lock< std::mutex > trim_lock ( m_trim_mutex, std::try_to_lock );
+        if ( !trim_lock.owns_lock () )
+            return;   // 已有线程在整理
+        try
+        {
+            // 按等级顺序加锁；其它路径一次只持有一把仓库锁，不会死锁
+            std::unique_lock< std::mutex > locks[ kNumClasses ];
+            for ( size_t cls = 0; cls < kNumClasses; ++cls )
+                locks[ cls ] = std::unique_lock< std::mutex > ( m_depot[ cls ].mutex );
+
+            std::unordered_map< ChunkHeader*, uint32_t > in_depot;
+            for ( size_t cls = 0; cls < kNumClasses; ++cls )
+                for ( const Batch& batch : m_depot[ cls ].batches )
+                    for ( Node* it = batch.head; it; it = it->next )
+                        ++in_depot[ chunk_of ( it ) ];
+
+            std::erase_if ( in_depot, [] ( const auto& entry ) {
+                const ChunkHeader* chunk = entry.first;
+                return !chunk->retired.load ( std::memory_order_acquire ) ||
+                       entry.second != chunk->carved.load ( std::memory_order_relaxed );
+            } );
+
+            if ( !in_depot.empty () )
+            {
+                size_t released = 0;
+                for ( size_t cls = 0; cls < kNumClasses; ++cls )
+                {
+                    auto& batches = m_depot[ cls ].batches;
+                    size_t kept = 0;
+                    for ( const Batch& batch : batches )
+                    {
+                        Node* head = nullptr;
+                        Node** tail = &head;
+                        uint32_t count = 0;
+                        for ( Node* it = batch.head; it; )
+                        {
+                            Node* next = it->next;
+                            if ( in_depot.contains ( chunk_of ( it ) ) )
+                            {
+                                released += class_size ( cls );
+                            }
+                            else
+                            {
+                                *tail = it;
+                                tail = &it->next;
+                                ++count;
+                            }
+                            it = next;
+                        }
+                        *tail = nullptr;
+                        if ( count )
+                            batches[ kept++ ] = Batch { head, count };
+                    }
+                    batches.resize ( kept );
+                }
+                m_depot_bytes.fetch_sub ( released, std::memory_order_relaxed );
+                for ( const auto& entry : in_depot )
+                    ::operator delete ( entry.first, std::align_val_t ( kChunkSize ) );
+                m_chunks_released.fetch_add ( in_depot.size (), std::memory_order_relaxed );
+            }
+        }
+        catch ( ... )
+        {
+            // 统计表分配失败：本次不整理
+        }
+        // 下次触发阈值取剩余量的两倍，避免仓库里全是不可归还的块时每次入库都重新扫描
+        const size_t remaining = m_depot_bytes.load ( std::memory_order_relaxed );
+        m_trim_threshold.store ( remaining * 2 > kDepotHighWater ? remaining * 2 : kDepotHighWater,
+                                 std::memory_order_relaxed );
+    }
+
+    static void flush_half ( ThreadHeap* heap, size_t cls ) noexcept
+    {
+        const uint32_t keep = magazine_limit ( cls ) / 2;
+        Node* tail = heap->magazine[ cls ];
+        for ( uint32_t i = 1; i < keep; ++i )
+            tail = tail->next;
+        Batch batch { tail->next, heap->count[ cls ] - keep };
+        tail->next = nullptr;
+        heap->count[ cls ] = keep;
+        instance ().depot_push ( cls, batch );
+        bump ( heap, DepotFlushes );
+    }
+
+    // ─────────────────────────────────────────────────────────────────────
+    // 慢路径
+    // ─────────────────────────────────────────────────────────────────────
+    static void* carve ( ThreadHeap* heap, size_t cls )
+    {
+        const size_t size = class_size ( cls );
+        const size_t align = size < kMaxSmallAlign ? size : kMaxSmallAlign;
+        char* p = reinterpret_cast< char* > ( ( reinterpret_cast< uintptr_t > ( heap->cursor ) + align - 1 ) &
+                                              ~static_cast< uintptr_t > ( align - 1 ) );
+        if ( !heap->cursor || p + size > heap->limit )
+        {
+            char* chunk = static_cast< char* > ( ::operator new ( kChunkSize, std::align_val_t ( kChunkSize ) ) );
+            ::new ( chunk ) ChunkHeader { heap };
+            if ( heap->limit )
+                chunk_of ( heap->limit - 1 )->retired.store ( true, std::memory_order_release );
+            heap->cursor = chunk + sizeof ( ChunkHeader );
+            heap->limit = chunk + kChunkSize;
+            p = heap->cursor;
+        }
+        ChunkHeader* header = chunk_of ( p );
+        header->carved.store ( header->carved.load ( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        heap->cursor = p + size;
+        bump ( heap, Misses );
+        return p;
+    }
+
+    static void* refill ( ThreadHeap* heap, size_t cls )
+    {
+        // 1. 收回其它线程归还的块
+        if ( Node* list = heap->remote[ cls ].exchange ( nullptr, std::memory_order_acquire ) )
+        {
+            uint32_t n = 0;
+            for ( Node* it = list->next; it; it = it->next )
+                ++n;
+            heap->magazine[ cls ] = list->next;
+            heap->count[ cls ] = n;
+            bump ( heap, RemoteReclaims );
+            return list;
+        }
+        // 2. 从全局仓库整批取回
+        Batch batch;
+        if ( instance ().depot_pop ( cls, batch ) )
+        {
+            heap->magazine[ cls ] = batch.head->next;
+            heap->count[ cls ] = batch.count - 1;
+            bump ( heap, DepotRefills );
+            return batch.head;
+        }
+        // 3. 从 chunk 切出新块
+        return carve ( heap, cls );
+    }
+
+    static STUCANVAS_POOL_NOINLINE void* allocate_slow ( size_t cls )
+    {
+        ThreadHeap* heap = t_heap ? t_heap : acquire_thread_heap ();
+        if ( heap )
+            return refill ( heap, cls );
+
+        // 线程局部析构之后仍在分配：退回受锁保护的共享堆
+        SmallObjectPool& pool = instance ();
+        std::lock_guard< std::mutex > lock ( pool.m_fallback_mutex );
+        ThreadHeap* fb = &pool.m_fallback;
+        if ( Node* n = fb->magazine[ cls ] )
+        {
+            fb->magazine[ cls ] = n->next;
+            fb->count[ cls ]--;
+            return n;
+        }
+        return refill ( fb, cls );
+    }
+
+    static STUCANVAS_POOL_NOINLINE void deallocate_remote ( void* ptr, size_t cls ) noexcept
+    {
+        ThreadHeap* owner = chunk_of ( ptr )->owner;
+        Node* n = static_cast< Node* > ( ptr );
+        if ( owner->orphaned.load ( std::memory_order_acquire ) )
+        {
+            // 主人已退出且尚未被接管：收进本线程弹匣（溢出时整批进仓库），避免块滞留在无人收取的链表里
+            if ( ThreadHeap* self = t_heap )
+            {
+                n->next = self->magazine[ cls ];
+                self->magazine[ cls ] = n;
+                if ( ++self->count[ cls ] > magazine_limit ( cls ) )
+                    flush_half ( self, cls );
+                return;
+            }
+            n->next = nullptr;
+            instance ().depot_push ( cls, Batch { n, 1 } );
+            return;
+        }
+        Node* head = owner->remote[ cls ].load ( std::memory_order_relaxed );
+        do
+        {
+            n->next = head;
+        } while ( !owner->remote[ cls ].compare_exchange_weak ( head, n, std::memory_order_release,
+                                                                 std::memory_order_relaxed ) );
+        if ( ThreadHeap* self = t_heap )
+            bump ( self, RemoteFrees );
+    }
+
+    static void* allocate_large ( size_t size, size_t alignment )
+    {
+        if ( ThreadHeap* self = t_heap )
+            bump ( self, Large );
+        if ( alignment <= 16 )
+        {
+#if defined( _MSC_VER )
+            void* p = _aligned_malloc ( size, 16 );
+#else
+            void* p = std::malloc ( size );
+#endif
+            if ( !p )
+                throw std::bad_alloc ();
+            return p;
+        }
+        return ::operator new ( size, std::align_val_t ( alignment ) );
+    }
+
+    static void deallocate_large ( void* ptr, size_t alignment ) noexcept
+    {
+        if ( alignment <= 16 )
+        {
+#if defined( _MSC_VER )
+            _aligned_free ( ptr );
+#else
+            std::free ( ptr );
+#endif
+            return;
+        }
+        ::operator delete ( ptr, std::align_val_t ( alignment ) );
+    }
+};
+
+// 请求实际可用的字节数（所在尺寸等级的块大小）；容器据此把容量撑满整个块，
+// 否则 2 的幂容量 + 头部前缀总会落在下一等级、浪费近一半内存
+[[nodiscard]] inline size_t pool_usable_size ( size_t size, size_t alignment ) noexcept
+{
+    const size_t cls = SmallObjectPool::size_class ( size, alignment );
+    return cls == SmallObjectPool::kLarge ? size : SmallObjectPool::class_size ( cls );
+}
+
+// 头部前缀容器使用的薄封装：(size, alignment) 必须在分配与释放两端一致
+[[nodiscard]] inline void* pool_alloc ( size_t size, size_t alignment )
+{
+    return SmallObjectPool::allocate ( size, alignment );
+}
+
+inline void pool_free ( void* ptr, size_t size, size_t alignment ) noexcept
+{
+    SmallObjectPool::deallocate ( ptr, size, alignment );
+}
+
+[[nodiscard]] inline void* pool_realloc ( void* ptr, size_t old_size, size_t new_size, size_t alignment )
+{
+    return SmallObjectPool::reallocate ( ptr, old_size, new_size, alignment );
+}
+}   // namespace detail
+
+// 小对象池计数快照；需以 STUCANVAS_SMALL_POOL_STATS=1 编译才有非零值
+[[nodiscard]] inline SmallPoolStats small_pool_stats () noexcept
+{
+    return detail::SmallObjectPool::stats ();
+}
+}   // namespace StuCanvas::utils
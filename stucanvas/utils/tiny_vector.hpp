@@ -13,10 +13,13 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>   // 引入 std::memcpy
+#include <limits>
 #include <new>
+#include <stdexcept>
 #include <span>
 #include <type_traits>
 #include <utility>
+#include "small_object_pool.hpp"
 #if defined( _MSC_VER )
 #include <malloc.h>
 #define STUCANVAS_NOINLINE __declspec ( noinline )
@@ -131,15 +134,33 @@ inline void* aligned_realloc_helper ( void* ptr, size_t old_size, size_t new_siz
 // ─────────────────────────────────────────────────────────────────────────
 // 1. 通用版 TinyVector 声明（非指针类型）
 // ─────────────────────────────────────────────────────────────────────────
-template < typename T >
+// SizeT 决定堆头中 size / capacity 的宽度：默认 uint32_t（堆头 8 字节）；
+// 超过 40 亿元素的稠密网格、点云与网格资产可选 uint64_t（堆头 16 字节，对齐后首元素偏移不变）。
+// 两种模式的句柄都只有一个 8 字节指针，线程缓存快速路径完全相同。
+template < typename T, typename SizeT = uint32_t >
 class TinyVector
 {
+    static_assert ( std::is_same_v< SizeT, uint32_t > || std::is_same_v< SizeT, uint64_t >,
+                    "TinyVector: SizeT must be uint32_t or uint64_t" );
+
+   public:
+
+    using size_type = SizeT;
+
+    // 元素个数上限：既受 size_type 限制，也不能让分配字节数在 size_t 上溢出
+    [[nodiscard]] static constexpr size_type max_size () noexcept
+    {
+        constexpr size_t by_bytes = ( std::numeric_limits< size_t >::max () - 64 ) / sizeof ( T );
+        constexpr size_t by_type = std::numeric_limits< size_type >::max ();
+        return static_cast< size_type > ( by_bytes < by_type ? by_bytes : by_type );
+    }
+
    private:
 
     struct TinyHeader
     {
-        uint32_t capacity;
-        uint32_t size;
+        size_type capacity;
+        size_type size;
     };
 
     // 🚀 16 字节黄金对齐平衡点：堆上仅产生 8 字节 Padding，彻底消除跨缓存行惩罚
@@ -148,30 +169,6 @@ class TinyVector
 
     T* m_data = nullptr;
 
-    struct ThreadCache
-    {
-        struct Node
-        {
-            Node* next;
-        };
-        Node* head = nullptr;
-        size_t count = 0;
-
-        ~ThreadCache () noexcept
-        {
-            while ( head )
-            {
-                Node* next = head->next;
-                // 🚀 绝对路径定位
-                ::StuCanvas::utils::detail::aligned_free_helper ( head, Alignment );
-                head = next;
-            }
-        }
-    };
-
-    static thread_local inline ThreadCache s_cache2;
-    static thread_local inline ThreadCache s_cache4;
-
     [[nodiscard]] inline TinyHeader* get_header () const noexcept
     {
         if ( !m_data )
@@ -179,30 +176,27 @@ class TinyVector
         return reinterpret_cast< TinyHeader* > ( reinterpret_cast< char* > ( m_data ) - TinyHeaderOffset );
     }
 
-    static T* allocate ( uint32_t capacity )
+    [[nodiscard]] static constexpr size_t alloc_bytes ( size_type capacity ) noexcept
+    {
+        return TinyHeaderOffset + static_cast< size_t > ( capacity ) * sizeof ( T );
+    }
+
+    // 把容量撑满小对象池的尺寸等级，避免 2 的幂容量 + 头部前缀浪费半个块
+    [[nodiscard]] static size_type fit_capacity ( size_type capacity ) noexcept
+    {
+        const size_t usable = ::StuCanvas::utils::detail::pool_usable_size ( alloc_bytes ( capacity ), Alignment );
+        const size_t fit = ( usable - TinyHeaderOffset ) / sizeof ( T );
+        return fit < max_size () ? static_cast< size_type > ( fit ) : max_size ();
+    }
+
+    // 🚀 经共享小对象池分配：按尺寸等级的线程弹匣 + 跨线程归还，取代仅缓存容量 2 / 4 的私有链表
+    static T* allocate ( size_type capacity )
     {
         if ( capacity == 0 )
             return nullptr;
-        size_t total_size = TinyHeaderOffset + static_cast< size_t > ( capacity ) * sizeof ( T );
-
-        void* raw = nullptr;
-        if ( capacity == 2 && s_cache2.head )
-        {
-            raw = s_cache2.head;
-            s_cache2.head = s_cache2.head->next;
-            s_cache2.count--;
-        }
-        else if ( capacity == 4 && s_cache4.head )
-        {
-            raw = s_cache4.head;
-            s_cache4.head = s_cache4.head->next;
-            s_cache4.count--;
-        }
-        else
-        {
-            raw = ::StuCanvas::utils::detail::aligned_alloc_helper (
-                total_size, Alignment );   // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
-        }
+        capacity = fit_capacity ( capacity );
+        void* raw = ::StuCanvas::utils::detail::pool_alloc ( alloc_bytes ( capacity ),
+                                                             Alignment );   // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
 
         TinyHeader* h = reinterpret_cast< TinyHeader* > ( raw );
         h->capacity = capacity;
@@ -217,32 +211,37 @@ class TinyVector
             return;
         void* raw = reinterpret_cast< char* > ( data ) - TinyHeaderOffset;
         TinyHeader* h = reinterpret_cast< TinyHeader* > ( raw );
-        uint32_t capacity = h->capacity;
+        ::StuCanvas::utils::detail::pool_free ( raw, alloc_bytes ( h->capacity ), Alignment );
+    }
 
-        if ( capacity == 2 && s_cache2.count < 128 )
-        {
-            auto* node = reinterpret_cast< ThreadCache::Node* > ( raw );   // 🚀 修复：移除了多余的 typename 关键字
-            node->next = s_cache2.head;
-            s_cache2.head = node;
-            s_cache2.count++;
-        }
-        else if ( capacity == 4 && s_cache4.count < 64 )
+    // 超出上限时抛出，而不是静默截断
+    static size_type checked_count ( size_t count )
+    {
+        if ( count > max_size () ) [[unlikely]]
         {
-            auto* node = reinterpret_cast< ThreadCache::Node* > ( raw );   // 🚀 修复：移除了多余的 typename 关键字
-            node->next = s_cache4.head;
-            s_cache4.head = node;
-            s_cache4.count++;
+            throw std::length_error ( "TinyVector: requested size exceeds max_size()" );
         }
-        else
+        return static_cast< size_type > ( count );
+    }
+
+    // 倍增扩容：接近上限时收敛到 max_size()，已满时抛出
+    static size_type next_capacity ( size_type sz )
+    {
+        if ( sz == 0 )
+            return 2;
+        if ( sz > max_size () / 2 ) [[unlikely]]
         {
-            ::StuCanvas::utils::detail::aligned_free_helper ( raw, Alignment );
+            if ( sz >= max_size () )
+                throw std::length_error ( "TinyVector: capacity exhausted" );
+            return max_size ();
         }
+        return static_cast< size_type > ( sz * 2 );
     }
 
     STUCANVAS_NOINLINE void grow_and_push ( const T& val )
     {
-        uint32_t sz = size ();
-        reserve ( sz == 0 ? 2 : static_cast< uint32_t > ( sz * 2 ) );
+        size_type sz = size ();
+        reserve ( next_capacity ( sz ) );
         TinyHeader* h = get_header ();
         assert ( m_data != nullptr );   // 🚀 修复：增加零成本断言，彻底消除分析器指针可能为空的警报
         new ( &m_data[ sz ] ) T ( val );
@@ -251,8 +250,8 @@ class TinyVector
 
     STUCANVAS_NOINLINE void grow_and_push ( T&& val )
     {
-        uint32_t sz = size ();
-        reserve ( sz == 0 ? 2 : static_cast< uint32_t > ( sz * 2 ) );
+        size_type sz = size ();
+        reserve ( next_capacity ( sz ) );
         TinyHeader* h = get_header ();
         assert ( m_data != nullptr );   // 🚀 修复：增加零成本断言
         new ( &m_data[ sz ] ) T ( std::move ( val ) );
@@ -292,11 +291,11 @@ class TinyVector
     {
         if ( other.m_data )
         {
-            uint32_t cap = other.capacity ();
-            uint32_t sz = other.size ();
+            size_type cap = other.capacity ();
+            size_type sz = other.size ();
             m_data = allocate ( cap );
             get_header ()->size = sz;
-            for ( uint32_t i = 0; i < sz; ++i )
+            for ( size_type i = 0; i < sz; ++i )
             {
                 new ( &m_data[ i ] ) T ( other.m_data[ i ] );
             }
@@ -312,11 +311,11 @@ class TinyVector
                 deallocate ( m_data );
             if ( other.m_data )
             {
-                uint32_t cap = other.capacity ();
-                uint32_t sz = other.size ();
+                size_type cap = other.capacity ();
+                size_type sz = other.size ();
                 m_data = allocate ( cap );
                 get_header ()->size = sz;
-                for ( uint32_t i = 0; i < sz; ++i )
+                for ( size_type i = 0; i < sz; ++i )
                 {
                     new ( &m_data[ i ] ) T ( other.m_data[ i ] );
                 }
@@ -339,13 +338,14 @@ class TinyVector
     /**
      * @brief 动态调整容器大小（就地默认构造/析构释放）
      */
-    void resize ( uint32_t new_size )
+    void resize ( size_t count )
     {
-        uint32_t cur_size = size ();
+        const size_type new_size = checked_count ( count );
+        size_type cur_size = size ();
         if ( new_size < cur_size )
         {
             // 1. 缩减大小：安全析构多余元素，不缩减物理容量
-            for ( uint32_t i = new_size; i < cur_size; ++i )
+            for ( size_type i = new_size; i < cur_size; ++i )
             {
                 m_data[ i ].~T ();
             }
@@ -357,7 +357,7 @@ class TinyVector
             reserve ( new_size );
             TinyHeader* h = get_header ();
             assert ( m_data != nullptr );   // 🚀 消除分析器空指针警告
-            for ( uint32_t i = cur_size; i < new_size; ++i )
+            for ( size_type i = cur_size; i < new_size; ++i )
             {
                 new ( &m_data[ i ] ) T ();
             }
@@ -368,12 +368,13 @@ class TinyVector
     /**
      * @brief 动态调整容器大小，并用 val 填充新槽位
      */
-    void resize ( uint32_t new_size, const T& val )
+    void resize ( size_t count, const T& val )
     {
-        uint32_t cur_size = size ();
+        const size_type new_size = checked_count ( count );
+        size_type cur_size = size ();
         if ( new_size < cur_size )
         {
-            for ( uint32_t i = new_size; i < cur_size; ++i )
+            for ( size_type i = new_size; i < cur_size; ++i )
             {
                 m_data[ i ].~T ();
             }
@@ -384,7 +385,7 @@ class TinyVector
             reserve ( new_size );
             TinyHeader* h = get_header ();
             assert ( m_data != nullptr );
-            for ( uint32_t i = cur_size; i < new_size; ++i )
+            for ( size_type i = cur_size; i < new_size; ++i )
             {
                 new ( &m_data[ i ] ) T ( val );
             }
@@ -395,15 +396,16 @@ class TinyVector
     /**
      * @brief 将当前内容替换为 count 个拷贝的 val
      */
-    void assign ( uint32_t count, const T& val )
+    void assign ( size_t n, const T& val )
     {
+        const size_type count = checked_count ( n );
         clear ();
         if ( count > 0 )
         {
             reserve ( count );
             TinyHeader* h = get_header ();
             assert ( m_data != nullptr );
-            for ( uint32_t i = 0; i < count; ++i )
+            for ( size_type i = 0; i < count; ++i )
             {
                 new ( &m_data[ i ] ) T ( val );
             }
@@ -419,7 +421,7 @@ class TinyVector
         clear ();
         if ( first != last )
         {
-            uint32_t count = static_cast< uint32_t > ( last - first );
+            size_type count = checked_count ( static_cast< size_t > ( last - first ) );
             reserve ( count );
             TinyHeader* h = get_header ();
             assert ( m_data != nullptr );
@@ -432,7 +434,7 @@ class TinyVector
             }
             else
             {
-                for ( uint32_t i = 0; i < count; ++i )
+                for ( size_type i = 0; i < count; ++i )
                 {
                     new ( &m_data[ i ] ) T ( first[ i ] );
                 }
@@ -442,13 +444,13 @@ class TinyVector
     }
 
 
-    [[nodiscard]] uint32_t size () const noexcept
+    [[nodiscard]] size_type size () const noexcept
     {
         auto* h = get_header ();
         return h ? h->size : 0;
     }
 
-    [[nodiscard]] uint32_t capacity () const noexcept
+    [[nodiscard]] size_type capacity () const noexcept
     {
         auto* h = get_header ();
         return h ? h->capacity : 0;
@@ -459,44 +461,32 @@ class TinyVector
         return size () == 0;
     }
 
-    void reserve ( uint32_t new_cap )
+    void reserve ( size_t requested )
     {
-        uint32_t cur_cap = capacity ();
+        const size_type new_cap = checked_count ( requested );
+        size_type cur_cap = capacity ();
         if ( new_cap <= cur_cap )
             return;
 
-        uint32_t sz = size ();
+        size_type sz = size ();
 
         if constexpr ( std::is_trivially_copyable_v< T > )
         {
-            void* old_raw = m_data ? ( reinterpret_cast< char* > ( m_data ) - TinyHeaderOffset ) : nullptr;
-            TinyHeader* old_h = get_header ();
-            uint32_t old_cap = old_h ? old_h->capacity : 0;
-
-            if ( old_cap <= 4 )
+            if ( !m_data )
             {
-                T* new_data = allocate ( new_cap );
-                if ( m_data )
-                {
-                    std::memcpy ( reinterpret_cast< void* > ( new_data ), reinterpret_cast< const void* > ( m_data ),
-                                  sz * sizeof ( T ) );
-                    deallocate ( m_data );
-                }
-                TinyHeader* new_h =
-                    reinterpret_cast< TinyHeader* > ( reinterpret_cast< char* > ( new_data ) - TinyHeaderOffset );
-                new_h->size = sz;
-                m_data = new_data;
+                m_data = allocate ( new_cap );
             }
             else
             {
-                size_t old_total_size = TinyHeaderOffset + static_cast< size_t > ( old_cap ) * sizeof ( T );
-                size_t new_total_size = TinyHeaderOffset + static_cast< size_t > ( new_cap ) * sizeof ( T );
-                // 🚀 核心增加 NOLINT 注释：告知分析器此处属于自定义偏移内存设计，并非内存泄漏
-                void* new_raw = ::StuCanvas::utils::detail::aligned_realloc_helper (
-                    old_raw, old_total_size, new_total_size,
+                void* old_raw = reinterpret_cast< char* > ( m_data ) - TinyHeaderOffset;
+                size_type old_cap = get_header ()->capacity;
+                const size_type fitted = fit_capacity ( new_cap );
+                // 🚀 同尺寸等级内原地返回，跨等级由池完成拷贝，超大块走系统 realloc
+                void* new_raw = ::StuCanvas::utils::detail::pool_realloc (
+                    old_raw, alloc_bytes ( old_cap ), alloc_bytes ( fitted ),
                     Alignment );   // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
                 TinyHeader* new_h = reinterpret_cast< TinyHeader* > ( new_raw );
-                new_h->capacity = new_cap;
+                new_h->capacity = fitted;
                 new_h->size = sz;
                 m_data = reinterpret_cast< T* > ( reinterpret_cast< char* > ( new_raw ) + TinyHeaderOffset );
             }
@@ -506,7 +496,7 @@ class TinyVector
             T* new_data = allocate ( new_cap );
             if ( m_data )
             {
-                for ( uint32_t i = 0; i < sz; ++i )
+                for ( size_type i = 0; i < sz; ++i )
                 {
                     if constexpr ( std::is_move_constructible_v< T > )
                     {
@@ -532,7 +522,7 @@ class TinyVector
         TinyHeader* h = get_header ();
         if ( h ) [[likely]]
         {
-            uint32_t sz = h->size;
+            size_type sz = h->size;
             if ( sz < h->capacity ) [[likely]]
             {
                 assert ( m_data != nullptr );   // 🚀 核心增加：消除分析器对空指针的可能警告
@@ -549,7 +539,7 @@ class TinyVector
         TinyHeader* h = get_header ();
         if ( h ) [[likely]]
         {
-            uint32_t sz = h->size;
+            size_type sz = h->size;
             if ( sz < h->capacity ) [[likely]]
             {
                 assert ( m_data != nullptr );   // 🚀 核心增加：消除空指针警报
@@ -567,7 +557,7 @@ class TinyVector
         TinyHeader* h = get_header ();
         if ( h ) [[likely]]
         {
-            uint32_t sz = h->size;
+            size_type sz = h->size;
             if ( sz < h->capacity ) [[likely]]
             {
                 assert ( m_data != nullptr );   // 🚀 核心增加：消除空指针警报
@@ -583,7 +573,7 @@ class TinyVector
 
     void pop_back () noexcept
     {
-        uint32_t sz = size ();
+        size_type sz = size ();
         if ( sz > 0 )
         {
             m_data[ sz - 1 ].~T ();
@@ -595,8 +585,8 @@ class TinyVector
     {
         if ( m_data )
         {
-            uint32_t sz = size ();
-            for ( uint32_t i = 0; i < sz; ++i )
+            size_type sz = size ();
+            for ( size_type i = 0; i < sz; ++i )
             {
                 m_data[ i ].~T ();
             }
@@ -606,8 +596,8 @@ class TinyVector
 
     void erase_unordered ( const T& val ) noexcept
     {
-        uint32_t sz = size ();
-        for ( uint32_t i = 0; i < sz; ++i )
+        size_type sz = size ();
+        for ( size_type i = 0; i < sz; ++i )
         {
             if ( m_data[ i ] == val )
             {
@@ -630,8 +620,12 @@ class TinyVector
             return;
         }
 
-        uint32_t cur_size = size ();
-        uint32_t new_size = cur_size + static_cast< uint32_t > ( view.size () );
+        size_type cur_size = size ();
+        if ( view.size () > static_cast< size_t > ( max_size () - cur_size ) ) [[unlikely]]
+        {
+            throw std::length_error ( "TinyVector: append exceeds max_size()" );
+        }
+        size_type new_size = cur_size + static_cast< size_type > ( view.size () );
 
         reserve ( new_size );
 
@@ -717,7 +711,7 @@ class TinyVector
         {
             size_t num_erased = l - f;
             std::move ( l, end_it, f );
-            get_header ()->size -= static_cast< uint32_t > ( num_erased );
+            get_header ()->size -= static_cast< size_type > ( num_erased );
         }
         return f;
     }
@@ -727,7 +721,7 @@ class TinyVector
 // 2. C++20/23 针对指针类型的偏特化实现（T*）
 // ─────────────────────────────────────────────────────────────────────────
 template < typename T >
-class TinyVector< T* >
+class TinyVector< T*, uint32_t >
 {
    private:
 
@@ -742,31 +736,6 @@ class TinyVector< T* >
 
     uintptr_t m_val = 0;
 
-    // 🚀 降级为非 TLS 纯静态无锁复用池，释放 TLS 字段查找开销
-    struct StaticCache
-    {
-        struct Node
-        {
-            Node* next;
-        };
-        Node* head = nullptr;
-        size_t count = 0;
-
-        ~StaticCache () noexcept
-        {
-            while ( head )
-            {
-                Node* next = head->next;
-                // 🚀 绝对路径定位
-                ::StuCanvas::utils::detail::aligned_free_helper ( head, Alignment );
-                head = next;
-            }
-        }
-    };
-
-    static thread_local inline StaticCache s_cache2;
-    static thread_local inline StaticCache s_cache4;
-
     [[nodiscard]] inline bool is_empty () const noexcept
     {
         return m_val == 0;
@@ -797,27 +766,24 @@ class TinyVector< T* >
         return reinterpret_cast< TinyHeader* > ( reinterpret_cast< char* > ( get_multi_array () ) - TinyHeaderOffset );
     }
 
+    [[nodiscard]] static constexpr size_t alloc_bytes ( uint32_t capacity ) noexcept
+    {
+        return TinyHeaderOffset + static_cast< size_t > ( capacity ) * sizeof ( T* );
+    }
+
+    [[nodiscard]] static uint32_t fit_capacity ( uint32_t capacity ) noexcept
+    {
+        const size_t usable = ::StuCanvas::utils::detail::pool_usable_size ( alloc_bytes ( capacity ), Alignment );
+        const size_t fit = ( usable - TinyHeaderOffset ) / sizeof ( T* );
+        return fit < std::numeric_limits< uint32_t >::max () ? static_cast< uint32_t > ( fit )
+                                                             : std::numeric_limits< uint32_t >::max ();
+    }
+
     static T** allocate_heap ( uint32_t capacity )
     {
-        size_t total_size = TinyHeaderOffset + static_cast< size_t > ( capacity ) * sizeof ( T* );
-        void* raw = nullptr;
-        if ( capacity == 2 && s_cache2.head )
-        {
-            raw = s_cache2.head;
-            s_cache2.head = s_cache2.head->next;
-            s_cache2.count--;
-        }
-        else if ( capacity == 4 && s_cache4.head )
-        {
-            raw = s_cache4.head;
-            s_cache4.head = s_cache4.head->next;
-            s_cache4.count--;
-        }
-        else
-        {
-            raw = ::StuCanvas::utils::detail::aligned_alloc_helper (
-                total_size, Alignment );   // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
-        }
+        capacity = fit_capacity ( capacity );
+        void* raw = ::StuCanvas::utils::detail::pool_alloc ( alloc_bytes ( capacity ),
+                                                             Alignment );   // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
         TinyHeader* h = reinterpret_cast< TinyHeader* > ( raw );
         h->capacity = capacity;
         h->size = 0;
@@ -830,31 +796,16 @@ class TinyVector< T* >
             return;
         void* raw = reinterpret_cast< char* > ( array ) - TinyHeaderOffset;
         TinyHeader* h = reinterpret_cast< TinyHeader* > ( raw );
-        uint32_t capacity = h->capacity;
-
-        if ( capacity == 2 && s_cache2.count < 128 )
-        {
-            auto* node = reinterpret_cast< StaticCache::Node* > ( raw );   // 🚀 修复：移除了冗余的 typename
-            node->next = s_cache2.head;
-            s_cache2.head = node;
-            s_cache2.count++;
-        }
-        else if ( capacity == 4 && s_cache4.count < 64 )
-        {
-            auto* node = reinterpret_cast< StaticCache::Node* > ( raw );   // 🚀 修复：移除了冗余的 typename
-            node->next = s_cache4.head;
-            s_cache4.head = node;
-            s_cache4.count++;
-        }
-        else
-        {
-            ::StuCanvas::utils::detail::aligned_free_helper ( raw, Alignment );
-        }
+        ::StuCanvas::utils::detail::pool_free ( raw, alloc_bytes ( h->capacity ), Alignment );
     }
 
     STUCANVAS_NOINLINE void grow_and_push ( T* val )
     {
         uint32_t sz = size ();
+        if ( sz > std::numeric_limits< uint32_t >::max () / 2 ) [[unlikely]]
+        {
+            throw std::length_error ( "TinyVector<T*>: capacity exhausted, use TinyVector64" );
+        }
         uint32_t next_cap = sz == 0 ? 2 : sz * 2;
         reserve ( next_cap );
         T** array = get_multi_array ();
@@ -1142,33 +1093,18 @@ class TinyVector< T* >
         uint32_t old_cap = old_h->capacity;
         uint32_t sz = old_h->size;
 
-        if ( old_cap <= 4 )
-        {
-            T** new_array = allocate_heap ( new_cap );
-            TinyHeader* new_h =
-                reinterpret_cast< TinyHeader* > ( reinterpret_cast< char* > ( new_array ) - TinyHeaderOffset );
-            new_h->size = sz;
+        // 🚀 同尺寸等级内原地返回，跨等级由池完成拷贝
+        const uint32_t fitted = fit_capacity ( new_cap );
+        void* new_raw = ::StuCanvas::utils::detail::pool_realloc (
+            old_raw, alloc_bytes ( old_cap ), alloc_bytes ( fitted ),
+            Alignment );   // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
 
-            std::memcpy ( new_array, old_array, sz * sizeof ( T* ) );
-            deallocate_heap ( old_array );
-            m_val = reinterpret_cast< uintptr_t > ( new_array ) | 1;
-        }
-        else
-        {
-            size_t old_total_size = TinyHeaderOffset + static_cast< size_t > ( old_cap ) * sizeof ( T* );
-            size_t new_total_size = TinyHeaderOffset + static_cast< size_t > ( new_cap ) * sizeof ( T* );
-            // 🚀 增加 NOLINT 抑制：告诉 Clang-Tidy 静态分析器，此处地址偏置不属于内存泄漏
-            void* new_raw = ::StuCanvas::utils::detail::aligned_realloc_helper (
-                old_raw, old_total_size, new_total_size,
-                Alignment );   // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
-
-            TinyHeader* new_h = reinterpret_cast< TinyHeader* > ( new_raw );
-            new_h->capacity = new_cap;
-            new_h->size = sz;
+        TinyHeader* new_h = reinterpret_cast< TinyHeader* > ( new_raw );
+        new_h->capacity = fitted;
+        new_h->size = sz;
 
-            T** new_array = reinterpret_cast< T** > ( reinterpret_cast< char* > ( new_raw ) + TinyHeaderOffset );
-            m_val = reinterpret_cast< uintptr_t > ( new_array ) | 1;
-        }
+        T** new_array = reinterpret_cast< T** > ( reinterpret_cast< char* > ( new_raw ) + TinyHeaderOffset );
+        m_val = reinterpret_cast< uintptr_t > ( new_array ) | 1;
     }
 
     inline void push_back ( T* val )
@@ -1416,13 +1352,22 @@ class TinyVector< T* >
         iterator f = const_cast< iterator > ( first );
         iterator l = const_cast< iterator > ( last );
         iterator end_it = end ();
-        if ( f >= begin () && l <= end_it && f <= l )
+        if ( f >= begin () && l <= end_it && f < l )
         {
             size_t num_erased = l - f;
+            if ( is_single () )
+            {
+                // 单元素内联态没有堆头：唯一元素被删除即回到空态
+                m_val = 0;
+                return begin ();
+            }
             std::move ( l, end_it, f );
             get_header ()->size -= static_cast< uint32_t > ( num_erased );
         }
         return f;
     }
 };
+// 64 位长度模式：句柄仍为 8 字节，面向超大稠密网格 / 点云 / 网格
+template < typename T >
+using TinyVector64 = TinyVector< T, uint64_t >;
 }   // namespace StuCanvas::utils
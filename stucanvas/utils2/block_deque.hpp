@@ -12,6 +12,11 @@
 #include <cstddef>
 #include <type_traits>
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <thread>
 #include "tiny_vector.hpp" // 复用我们先前实现的极致跨平台对齐内存分配器
 
 namespace StuCanvas::utils
@@ -51,36 +56,22 @@ namespace StuCanvas::utils
 
         T** m_blocks = nullptr;
 
-        // 🚀 极致性能：纯 static 静态复用池，消灭 TLS 段查找延迟
-        struct StaticBlockCache {
-            struct Node {
-                Node* next;
-            };
-            Node* head = nullptr;
-            size_t count = 0;
-
-            ~StaticBlockCache() noexcept {
-                while (head) {
-                    Node* next = head->next;
-                    ::StuCanvas::utils::detail::aligned_free_helper(head, ElementAlignment);
-                    head = next;
-                }
-            }
-        };
-
-        static thread_local inline StaticBlockCache s_block_cache;
-
         [[nodiscard]] inline Header* get_header() const noexcept
         {
             if (!m_blocks) return nullptr;
             return reinterpret_cast<Header*>(reinterpret_cast<char*>(m_blocks) - HeaderOffset);
         }
 
+        [[nodiscard]] static constexpr size_t array_bytes(uint32_t capacity) noexcept
+        {
+            return HeaderOffset + static_cast<size_t>(capacity) * sizeof(T*);
+        }
+
+        // 🚀 块指针数组与元素块都经共享小对象池分配：线程弹匣命中，跨线程释放归还给分配线程
         static T** allocate_blocks_array(uint32_t capacity)
         {
             if (capacity == 0) return nullptr;
-            size_t total_bytes = HeaderOffset + static_cast<size_t>(capacity) * sizeof(T*);
-            void* raw = ::StuCanvas::utils::detail::aligned_alloc_helper(total_bytes, ArrayAlignment); // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
+            void* raw = ::StuCanvas::utils::detail::pool_alloc(array_bytes(capacity), ArrayAlignment); // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
 
             Header* h = reinterpret_cast<Header*>(raw);
             h->capacity = capacity;
@@ -94,33 +85,18 @@ namespace StuCanvas::utils
         {
             if (!blocks) return;
             void* raw = reinterpret_cast<char*>(blocks) - HeaderOffset;
-            ::StuCanvas::utils::detail::aligned_free_helper(raw, ArrayAlignment);
+            ::StuCanvas::utils::detail::pool_free(raw, array_bytes(reinterpret_cast<Header*>(raw)->capacity), ArrayAlignment);
         }
 
         static T* allocate_element_block()
         {
-            if (s_block_cache.head) {
-                void* raw = s_block_cache.head;
-                s_block_cache.head = s_block_cache.head->next;
-                s_block_cache.count--;
-                return static_cast<T*>(raw);
-            }
-            size_t bytes = BlockSize * sizeof(T);
-            void* raw = ::StuCanvas::utils::detail::aligned_alloc_helper(bytes, ElementAlignment); // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
+            void* raw = ::StuCanvas::utils::detail::pool_alloc(BlockSize * sizeof(T), ElementAlignment); // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
             return static_cast<T*>(raw);
         }
 
         static void deallocate_element_block(T* ptr) noexcept
         {
-            if (!ptr) return;
-            if (s_block_cache.count < 32) {
-                auto* node = reinterpret_cast<StaticBlockCache::Node*>(ptr);
-                node->next = s_block_cache.head;
-                s_block_cache.head = node;
-                s_block_cache.count++;
-            } else {
-                ::StuCanvas::utils::detail::aligned_free_helper(ptr, ElementAlignment);
-            }
+            ::StuCanvas::utils::detail::pool_free(ptr, BlockSize * sizeof(T), ElementAlignment);
         }
 
         void reserve_blocks(uint32_t new_capacity)
@@ -549,35 +525,22 @@ namespace StuCanvas::utils
         // 🚀 核心优化：T 为 int*，因此 T** 是完美的 int***
         T** m_blocks = nullptr;
 
-        struct StaticBlockCache {
-            struct Node {
-                Node* next;
-            };
-            Node* head = nullptr;
-            size_t count = 0;
-
-            ~StaticBlockCache() noexcept {
-                while (head) {
-                    Node* next = head->next;
-                    ::StuCanvas::utils::detail::aligned_free_helper(head, ElementAlignment);
-                    head = next;
-                }
-            }
-        };
-
-        static inline StaticBlockCache s_block_cache;
-
         [[nodiscard]] inline Header* get_header() const noexcept
         {
             if (!m_blocks) return nullptr;
             return reinterpret_cast<Header*>(reinterpret_cast<char*>(m_blocks) - HeaderOffset);
         }
 
+        [[nodiscard]] static constexpr size_t array_bytes(uint32_t capacity) noexcept
+        {
+            return HeaderOffset + static_cast<size_t>(capacity) * sizeof(T*);
+        }
+
+        // 🚀 块指针数组与元素块都经共享小对象池分配：线程弹匣命中，跨线程释放归还给分配线程
         static T** allocate_blocks_array(uint32_t capacity)
         {
             if (capacity == 0) return nullptr;
-            size_t total_bytes = HeaderOffset + static_cast<size_t>(capacity) * sizeof(T);
-            void* raw = ::StuCanvas::utils::detail::aligned_alloc_helper(total_bytes, alignof(T)); // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
+            void* raw = ::StuCanvas::utils::detail::pool_alloc(array_bytes(capacity), alignof(T)); // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
 
             Header* h = reinterpret_cast<Header*>(raw);
             h->capacity = capacity;
@@ -591,33 +554,18 @@ namespace StuCanvas::utils
         {
             if (!blocks) return;
             void* raw = reinterpret_cast<char*>(blocks) - HeaderOffset;
-            ::StuCanvas::utils::detail::aligned_free_helper(raw, alignof(T));
+            ::StuCanvas::utils::detail::pool_free(raw, array_bytes(reinterpret_cast<Header*>(raw)->capacity), alignof(T));
         }
 
         static T* allocate_element_block()
         {
-            if (s_block_cache.head) {
-                void* raw = s_block_cache.head;
-                s_block_cache.head = s_block_cache.head->next;
-                s_block_cache.count--;
-                return static_cast<T*>(raw);
-            }
-            size_t bytes = BlockSize * sizeof(T);
-            void* raw = ::StuCanvas::utils::detail::aligned_alloc_helper(bytes, ElementAlignment); // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
+            void* raw = ::StuCanvas::utils::detail::pool_alloc(BlockSize * sizeof(T), ElementAlignment); // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
             return static_cast<T*>(raw);
         }
 
         static void deallocate_element_block(T* ptr) noexcept
         {
-            if (!ptr) return;
-            if (s_block_cache.count < 32) {
-                auto* node = reinterpret_cast<StaticBlockCache::Node*>(ptr); // 🚀 移除了多余的 typename
-                node->next = s_block_cache.head;
-                s_block_cache.head = node;
-                s_block_cache.count++;
-            } else {
-                ::StuCanvas::utils::detail::aligned_free_helper(ptr, ElementAlignment);
-            }
+            ::StuCanvas::utils::detail::pool_free(ptr, BlockSize * sizeof(T), ElementAlignment);
         }
 
         void reserve_blocks(uint32_t new_capacity)
@@ -973,4 +921,308 @@ namespace StuCanvas::utils
 
         [[nodiscard]] inline T* const* m_blocks_exposed() const noexcept { return m_blocks; }
     };
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // 3. 并发分段追加版 ConcurrentBlockDeque（多生产者同时追加，全部结束后统一消费）
+    // 🚀 面向并行绘图的结果收集，取代"线程局部缓冲 + 互斥锁合并"的串行尾巴：
+    //    - 块表是分段倍增的二级表：段指针用 CAS 安装，块槽地址永不移动，扩容无锁、无拷贝
+    //    - Writer：每个线程独占整块连续写入，块内零原子操作；写满才原子领取下一块
+    //    - push_back / emplace_back：共享尾块上的原子槽位领取，适合零散、低频的追加
+    // 💡 块内只有前 count 个元素有效（Writer 的最后一块通常未写满），消费时按块遍历；
+    //    元素的全局顺序是块的领取顺序，不同线程之间的先后不保证
+    // ─────────────────────────────────────────────────────────────────────────
+    template <typename T, size_t BlockSize = 1024>
+    class ConcurrentBlockDeque
+    {
+        static_assert((BlockSize & (BlockSize - 1)) == 0, "BlockSize must be a power of 2!");
+        static_assert(BlockSize < (size_t(1) << 31), "BlockSize must fit the 32-bit cursor offset!");
+
+    private:
+        struct BlockSlot {
+            T* data = nullptr;
+            std::atomic<uint32_t> count{0}; // 已构造元素数（块内前缀连续）
+        };
+
+        static constexpr size_t ElementAlignment = alignof(T) > 16 ? alignof(T) : 16;
+        static constexpr size_t FirstSegmentShift = 4; // 第 0 段 16 个块槽，之后每段翻倍
+        static constexpr size_t FirstSegmentSize = size_t(1) << FirstSegmentShift;
+        static constexpr size_t MaxSegments = 40;
+
+        std::atomic<BlockSlot*> m_segments[MaxSegments];
+        std::atomic<uint64_t> m_claimed_blocks{0};
+        // 共享尾块游标：高 32 位 = 块序号 + 1（0 表示尚无共享块），低 32 位 = 块内下一个槽位
+        std::atomic<uint64_t> m_shared_cursor{0};
+
+        static constexpr size_t segment_bytes(size_t seg) noexcept
+        {
+            return (FirstSegmentSize << seg) * sizeof(BlockSlot);
+        }
+
+        static T* allocate_element_block()
+        {
+            return static_cast<T*>(::StuCanvas::utils::detail::pool_alloc(BlockSize * sizeof(T), ElementAlignment));
+        }
+
+        static void deallocate_element_block(T* ptr) noexcept
+        {
+            ::StuCanvas::utils::detail::pool_free(ptr, BlockSize * sizeof(T), ElementAlignment);
+        }
+
+        STUCANVAS_NOINLINE BlockSlot* install_segment(size_t seg)
+        {
+            const size_t n = FirstSegmentSize << seg;
+            auto* fresh = static_cast<BlockSlot*>(::StuCanvas::utils::detail::pool_alloc(segment_bytes(seg), alignof(BlockSlot)));
+            for (size_t i = 0; i < n; ++i) {
+                new (&fresh[i]) BlockSlot();
+            }
+            BlockSlot* expected = nullptr;
+            if (m_segments[seg].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return fresh;
+            }
+            // 另一个线程抢先安装了同一段
+            ::StuCanvas::utils::detail::pool_free(fresh, segment_bytes(seg), alignof(BlockSlot));
+            return expected;
+        }
+
+        [[nodiscard]] BlockSlot& slot_at(uint64_t block)
+        {
+            const uint64_t v = block + FirstSegmentSize;
+            const size_t seg = static_cast<size_t>(std::bit_width(v)) - 1 - FirstSegmentShift;
+            BlockSlot* segment = m_segments[seg].load(std::memory_order_acquire);
+            if (!segment) [[unlikely]] {
+                segment = install_segment(seg);
+            }
+            return segment[v - (uint64_t(FirstSegmentSize) << seg)];
+        }
+
+        [[nodiscard]] const BlockSlot& slot_at(uint64_t block) const noexcept
+        {
+            const uint64_t v = block + FirstSegmentSize;
+            const size_t seg = static_cast<size_t>(std::bit_width(v)) - 1 - FirstSegmentShift;
+            return m_segments[seg].load(std::memory_order_acquire)[v - (uint64_t(FirstSegmentSize) << seg)];
+        }
+
+        // 原子领取一个新块并为其分配元素内存
+        uint64_t claim_block()
+        {
+            const uint64_t block = m_claimed_blocks.fetch_add(1, std::memory_order_relaxed);
+            slot_at(block).data = allocate_element_block();
+            return block;
+        }
+
+        void release_blocks() noexcept
+        {
+            const uint64_t blocks = m_claimed_blocks.load(std::memory_order_acquire);
+            for (uint64_t b = 0; b < blocks; ++b) {
+                const BlockSlot& s = slot_at(b);
+                if constexpr (!std::is_trivially_destructible_v<T>) {
+                    const uint32_t count = s.count.load(std::memory_order_relaxed);
+                    for (uint32_t i = 0; i < count; ++i) {
+                        s.data[i].~T();
+                    }
+                }
+                deallocate_element_block(s.data);
+            }
+        }
+
+    public:
+        // ─────────────────────────────────────────────────────────────────────
+        // 线程独占写入器：持有一个整块，写满后再去领取下一块
+        // 每个生产线程一个（例如放进 tbb::enumerable_thread_specific），不可跨线程共享
+        // ─────────────────────────────────────────────────────────────────────
+        class Writer
+        {
+        public:
+            Writer() noexcept = default;
+            explicit Writer(ConcurrentBlockDeque& owner) noexcept : m_owner(&owner) {}
+            ~Writer() noexcept { flush(); }
+
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+
+            Writer(Writer&& other) noexcept
+                : m_owner(other.m_owner), m_slot(other.m_slot), m_cur(other.m_cur), m_end(other.m_end)
+            {
+                other.m_slot = nullptr;
+                other.m_cur = other.m_end = nullptr;
+            }
+
+            Writer& operator=(Writer&& other) noexcept
+            {
+                if (this != &other) {
+                    flush();
+                    m_owner = other.m_owner;
+                    m_slot = other.m_slot;
+                    m_cur = other.m_cur;
+                    m_end = other.m_end;
+                    other.m_slot = nullptr;
+                    other.m_cur = other.m_end = nullptr;
+                }
+                return *this;
+            }
+
+            template <typename... Args>
+            T& emplace_back(Args&&... args)
+            {
+                if (m_cur == m_end) [[unlikely]] {
+                    next_block();
+                }
+                T* p = new (m_cur) T(std::forward<Args>(args)...);
+                ++m_cur;
+                return *p;
+            }
+
+            void push_back(const T& val) { emplace_back(val); }
+            void push_back(T&& val) { emplace_back(std::move(val)); }
+
+            // 整段拷贝：按块剩余空间切片，每片一次 uninitialized_copy
+            void append(const T* src, size_t count)
+            {
+                while (count != 0) {
+                    if (m_cur == m_end) {
+                        next_block();
+                    }
+                    const size_t n = std::min(count, static_cast<size_t>(m_end - m_cur));
+                    std::uninitialized_copy_n(src, n, m_cur);
+                    m_cur += n;
+                    src += n;
+                    count -= n;
+                }
+            }
+
+            // 公布当前块的写入进度（块仍归本写入器，可继续追加）；消费前必须调用或析构
+            void flush() noexcept
+            {
+                if (m_slot) {
+                    m_slot->count.store(static_cast<uint32_t>(m_cur - m_slot->data), std::memory_order_release);
+                }
+            }
+
+        private:
+            STUCANVAS_NOINLINE void next_block()
+            {
+                assert(m_owner != nullptr);
+                if (m_slot) {
+                    m_slot->count.store(static_cast<uint32_t>(BlockSize), std::memory_order_release);
+                }
+                m_slot = &m_owner->slot_at(m_owner->claim_block());
+                m_cur = m_slot->data;
+                m_end = m_cur + BlockSize;
+            }
+
+            ConcurrentBlockDeque* m_owner = nullptr;
+            BlockSlot* m_slot = nullptr;
+            T* m_cur = nullptr;
+            T* m_end = nullptr;
+        };
+
+        ConcurrentBlockDeque() noexcept = default;
+
+        ~ConcurrentBlockDeque() noexcept
+        {
+            release_blocks();
+            for (size_t seg = 0; seg < MaxSegments; ++seg) {
+                if (BlockSlot* segment = m_segments[seg].load(std::memory_order_relaxed)) {
+                    ::StuCanvas::utils::detail::pool_free(segment, segment_bytes(seg), alignof(BlockSlot));
+                }
+            }
+        }
+
+        ConcurrentBlockDeque(const ConcurrentBlockDeque&) = delete;
+        ConcurrentBlockDeque& operator=(const ConcurrentBlockDeque&) = delete;
+
+        [[nodiscard]] Writer writer() noexcept { return Writer(*this); }
+
+        // 线程安全：在共享尾块上原子领取一个槽位
+        // 恰好拿到溢出位置的线程负责领取新块并重置游标，其余越界线程让出 CPU 等待游标换块
+        template <typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            for (;;) {
+                const uint64_t cursor = m_shared_cursor.fetch_add(1, std::memory_order_acquire);
+                const uint64_t block = cursor >> 32;
+                const uint32_t offset = static_cast<uint32_t>(cursor);
+
+                if (block != 0 && offset < BlockSize) [[likely]] {
+                    BlockSlot& s = slot_at(block - 1);
+                    T* p = new (s.data + offset) T(std::forward<Args>(args)...);
+                    s.count.fetch_add(1, std::memory_order_release);
+                    return *p;
+                }
+
+                if (offset == (block == 0 ? 0u : static_cast<uint32_t>(BlockSize))) {
+                    const uint64_t fresh = claim_block();
+                    m_shared_cursor.store((fresh + 1) << 32, std::memory_order_release);
+                } else {
+                    while ((m_shared_cursor.load(std::memory_order_acquire) >> 32) == block) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+
+        void push_back(const T& val) { emplace_back(val); }
+        void push_back(T&& val) { emplace_back(std::move(val)); }
+
+        // ── 以下接口要求所有生产者已结束（已 join 且各 Writer 已 flush / 析构） ──
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            size_t total = 0;
+            const uint64_t blocks = m_claimed_blocks.load(std::memory_order_acquire);
+            for (uint64_t b = 0; b < blocks; ++b) {
+                total += slot_at(b).count.load(std::memory_order_acquire);
+            }
+            return total;
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+        [[nodiscard]] size_t block_count() const noexcept
+        {
+            return m_claimed_blocks.load(std::memory_order_acquire);
+        }
+
+        // 按块遍历有效元素：f(const T* run, size_t count, size_t first_index)
+        // first_index 是该段在紧凑输出中的起始下标，可直接据此写入预先 resize 好的 SoA 列
+        template <typename F>
+        void for_each_run(F&& f) const
+        {
+            size_t offset = 0;
+            const uint64_t blocks = m_claimed_blocks.load(std::memory_order_acquire);
+            for (uint64_t b = 0; b < blocks; ++b) {
+                const BlockSlot& s = slot_at(b);
+                const uint32_t count = s.count.load(std::memory_order_acquire);
+                if (count != 0) {
+                    f(static_cast<const T*>(s.data), static_cast<size_t>(count), offset);
+                    offset += count;
+                }
+            }
+        }
+
+        // 紧凑拷贝到连续数组（dst 至少容纳 size() 个元素），返回拷贝数
+        size_t copy_to(T* dst) const
+        {
+            size_t total = 0;
+            for_each_run([&](const T* run, size_t count, size_t first) {
+                std::uninitialized_copy_n(run, count, dst + first);
+                total = first + count;
+            });
+            return total;
+        }
+
+        // 非线程安全：析构全部元素并归还元素块，块表段保留以供复用
+        void clear() noexcept
+        {
+            release_blocks();
+            const uint64_t blocks = m_claimed_blocks.load(std::memory_order_relaxed);
+            for (uint64_t b = 0; b < blocks; ++b) {
+                BlockSlot& s = slot_at(b);
+                s.data = nullptr;
+                s.count.store(0, std::memory_order_relaxed);
+            }
+            m_claimed_blocks.store(0, std::memory_order_relaxed);
+            m_shared_cursor.store(0, std::memory_order_release);
+        }
+    };
 } // namespace StuCanvas::utils
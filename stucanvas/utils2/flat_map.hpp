@@ -19,6 +19,17 @@
 #include <functional>
 #include "tiny_vector.hpp" // 复用我们先前实现的极致跨平台对齐内存分配器
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STUCANVAS_FLATMAP_SSE2 1
+#endif
+
 // 针对 Windows MSVC 平台和 GCC 平台的极致控制与无别名 restrict 保护
 #if defined(_MSC_VER)
 #define STUCANVAS_NOINLINE __declspec(noinline)
@@ -30,10 +41,13 @@
 
 namespace StuCanvas::utils
 {
+    // 探查模式：Linear 为逐条目线性探查（默认），Swiss 为独立控制字节 + 16 槽分组探查
+    enum class FlatMapMode : uint8_t { Linear, Swiss };
+
     // ─────────────────────────────────────────────────────────────────────────
     // 1. 通用版 FlatMap 模版（支持所有类型，使用 State 标记）
     // ─────────────────────────────────────────────────────────────────────────
-    template <typename K, typename V>
+    template <typename K, typename V, FlatMapMode Mode = FlatMapMode::Linear>
     class FlatMap
     {
     public:
@@ -248,7 +262,7 @@ namespace StuCanvas::utils
     // ─────────────────────────────────────────────────────────────────────────
     template <typename K, typename V>
     requires std::is_pointer_v<K>
-    class FlatMap<K, V>
+    class FlatMap<K, V, FlatMapMode::Linear>
     {
     public:
         struct Entry { K first = nullptr; V second{}; };
@@ -415,4 +429,395 @@ namespace StuCanvas::utils
         }
         [[nodiscard]] size_t size() const noexcept { return m_table ? get_header()->size : 0; }
     };
-}
\ No newline at end of file
+
+    namespace detail
+    {
+        // ─────────────────────────────────────────────────────────────────────
+        // SwissTable 控制字节：高位为 1 表示空槽 / 墓碑，0..127 为满槽的 7 位哈希片段
+        // ─────────────────────────────────────────────────────────────────────
+        static constexpr int8_t kCtrlEmpty   = static_cast<int8_t>(-128); // 0b10000000
+        static constexpr int8_t kCtrlDeleted = static_cast<int8_t>(-2);   // 0b11111110
+        static constexpr size_t kCtrlGroupWidth = 16;
+
+        // 一次读取 16 个控制字节，返回逐槽位比较结果的位掩码（第 i 位对应第 i 个槽）
+        struct CtrlGroup
+        {
+#if defined(STUCANVAS_FLATMAP_SSE2)
+            __m128i ctrl;
+
+            explicit CtrlGroup(const int8_t* pos) noexcept
+                : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+            [[nodiscard]] uint32_t match(int8_t h2) const noexcept {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+            }
+            [[nodiscard]] uint32_t mask_empty() const noexcept {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(kCtrlEmpty), ctrl)));
+            }
+            // 空槽与墓碑的符号位都为 1，直接取符号位即可
+            [[nodiscard]] uint32_t mask_empty_or_deleted() const noexcept {
+                return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+            }
+#else
+            // 可移植回退：逐字节比较，主流编译器会自动向量化
+            int8_t ctrl[kCtrlGroupWidth];
+
+            explicit CtrlGroup(const int8_t* pos) noexcept { std::memcpy(ctrl, pos, kCtrlGroupWidth); }
+
+            [[nodiscard]] uint32_t match(int8_t h2) const noexcept {
+                uint32_t m = 0;
+                for (size_t i = 0; i < kCtrlGroupWidth; ++i) m |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+                return m;
+            }
+            [[nodiscard]] uint32_t mask_empty() const noexcept {
+                uint32_t m = 0;
+                for (size_t i = 0; i < kCtrlGroupWidth; ++i) m |= static_cast<uint32_t>(ctrl[i] == kCtrlEmpty) << i;
+                return m;
+            }
+            [[nodiscard]] uint32_t mask_empty_or_deleted() const noexcept {
+                uint32_t m = 0;
+                for (size_t i = 0; i < kCtrlGroupWidth; ++i) m |= static_cast<uint32_t>(ctrl[i] < 0) << i;
+                return m;
+            }
+#endif
+        };
+
+        [[nodiscard]] inline uint32_t ctrl_lowest_bit(uint32_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long idx; _BitScanForward(&idx, mask); return static_cast<uint32_t>(idx);
+#else
+            return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+        }
+
+        [[nodiscard]] inline uint32_t ctrl_highest_bit16(uint32_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long idx; _BitScanReverse(&idx, mask); return static_cast<uint32_t>(idx);
+#else
+            return static_cast<uint32_t>(31 - __builtin_clz(mask));
+#endif
+        }
+
+        // 原位重哈希的第一步：墓碑 -> 空槽，满槽 -> 墓碑（标记为“待重新安置”）
+        // 即 byte < 0 ? kCtrlEmpty : kCtrlDeleted，写成 0xFE ^ (special & 0x7E) 的无分支形式
+        inline void ctrl_convert_for_rehash(int8_t* ctrl, size_t capacity) noexcept
+        {
+            size_t i = 0;
+#if defined(__AVX2__)
+            const __m256i zero256 = _mm256_setzero_si256();
+            const __m256i deleted256 = _mm256_set1_epi8(kCtrlDeleted);
+            const __m256i flip256 = _mm256_set1_epi8(0x7E);
+            for (; i + 32 <= capacity; i += 32) {
+                __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ctrl + i));
+                __m256i special = _mm256_cmpgt_epi8(zero256, c);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(ctrl + i),
+                                    _mm256_xor_si256(deleted256, _mm256_and_si256(special, flip256)));
+            }
+#endif
+#if defined(STUCANVAS_FLATMAP_SSE2)
+            const __m128i zero128 = _mm_setzero_si128();
+            const __m128i deleted128 = _mm_set1_epi8(kCtrlDeleted);
+            const __m128i flip128 = _mm_set1_epi8(0x7E);
+            for (; i + 16 <= capacity; i += 16) {
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl + i));
+                __m128i special = _mm_cmpgt_epi8(zero128, c);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(ctrl + i),
+                                 _mm_xor_si128(deleted128, _mm_and_si128(special, flip128)));
+            }
+#endif
+            for (; i < capacity; ++i) ctrl[i] = ctrl[i] < 0 ? kCtrlEmpty : kCtrlDeleted;
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // 3. SwissTable 模式（任意键类型）：控制字节与条目分离，16 槽分组 SIMD 探查
+    // ─────────────────────────────────────────────────────────────────────────
+    // 💡 查找只在控制字节数组上做分组比较，7 位指纹命中后才触碰条目本身，未命中几乎不读条目；
+    //    负载上限 7/8，墓碑计入增长预算，墓碑堆积时优先原位重哈希清理而不是扩容，
+    //    长时间插入 / 删除交替也不会退化。用法：FlatMap<K, V, FlatMapMode::Swiss>
+    template <typename K, typename V>
+    class FlatMap<K, V, FlatMapMode::Swiss>
+    {
+    public:
+        struct Entry { K first{}; V second{}; };
+
+    private:
+        struct Header { uint32_t capacity; uint32_t size; uint32_t growth_left; uint32_t pad; };
+        static constexpr size_t Alignment = alignof(Entry) > 16 ? alignof(Entry) : 16;
+        static constexpr size_t HeaderOffset = (sizeof(Header) + Alignment - 1) & ~(Alignment - 1);
+        static constexpr size_t GroupWidth = detail::kCtrlGroupWidth;
+        static constexpr uint32_t MinCapacity = 16;
+
+        int8_t* m_ctrl = nullptr; // 控制字节数组（前面是 Header，后面是条目数组），8 字节栈开销
+
+        static size_t hash_key(const K& key) noexcept {
+            uint64_t x;
+            if constexpr (std::is_pointer_v<K>) {
+                x = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key)) * 0x9e3779b97f4a7c15ULL;
+            } else {
+                x = static_cast<uint64_t>(std::hash<K>{}(key));
+                x ^= x >> 33;
+                x *= 0xff51afd7ed558ccdULL;
+                x ^= x >> 33;
+            }
+            return static_cast<size_t>(x);
+        }
+        // 高 7 位作为控制字节指纹，其余位决定起始探查位置
+        static int8_t h2_of(size_t hash) noexcept { return static_cast<int8_t>(static_cast<uint64_t>(hash) >> 57); }
+        static size_t h1_of(size_t hash) noexcept { return hash >> 7; }
+
+        static uint32_t growth_of(uint32_t capacity) noexcept { return capacity - capacity / 8; }
+        static size_t ctrl_bytes(uint32_t capacity) noexcept {
+            return (capacity + GroupWidth + Alignment - 1) & ~(Alignment - 1); // 尾部克隆 16 字节供跨界分组读取
+        }
+
+        [[nodiscard]] Header* get_header() const noexcept {
+            return reinterpret_cast<Header*>(reinterpret_cast<char*>(m_ctrl) - HeaderOffset);
+        }
+        [[nodiscard]] Entry* slots() const noexcept {
+            return reinterpret_cast<Entry*>(reinterpret_cast<char*>(m_ctrl) + ctrl_bytes(get_header()->capacity));
+        }
+
+        static int8_t* allocate_table(uint32_t capacity) {
+            size_t total_size = HeaderOffset + ctrl_bytes(capacity) + static_cast<size_t>(capacity) * sizeof(Entry);
+            void* raw = detail::aligned_alloc_helper(total_size, Alignment); // NOLINT
+            Header* h = reinterpret_cast<Header*>(raw);
+            h->capacity = capacity; h->size = 0; h->growth_left = growth_of(capacity); h->pad = 0;
+            int8_t* ctrl = reinterpret_cast<int8_t*>(reinterpret_cast<char*>(raw) + HeaderOffset);
+            std::memset(ctrl, static_cast<unsigned char>(detail::kCtrlEmpty), capacity + GroupWidth);
+            Entry* table = reinterpret_cast<Entry*>(reinterpret_cast<char*>(ctrl) + ctrl_bytes(capacity));
+            for (uint32_t i = 0; i < capacity; ++i) { new (&table[i]) Entry(); }
+            return ctrl;
+        }
+
+        static void deallocate_table(int8_t* ctrl) noexcept {
+            if (!ctrl) return;
+            Header* h = reinterpret_cast<Header*>(reinterpret_cast<char*>(ctrl) - HeaderOffset);
+            Entry* table = reinterpret_cast<Entry*>(reinterpret_cast<char*>(ctrl) + ctrl_bytes(h->capacity));
+            for (uint32_t i = 0; i < h->capacity; ++i) { table[i].~Entry(); }
+            detail::aligned_free_helper(h, Alignment);
+        }
+
+        // 写控制字节，同时维护尾部克隆区（容量 >= 16，前 16 个字节在末尾有一份镜像）
+        void set_ctrl(size_t i, int8_t c) noexcept {
+            m_ctrl[i] = c;
+            if (i < GroupWidth) m_ctrl[get_header()->capacity + i] = c;
+        }
+
+        // 三角数分组探查：起点 h1，依次跳过 16、32、48... 个槽，容量为 2 的幂时必然遍历所有分组
+        struct ProbeSeq {
+            size_t offset, mask, index = 0;
+            ProbeSeq(size_t h1, size_t m) noexcept : offset(h1 & m), mask(m) {}
+            void next() noexcept { index += GroupWidth; offset = (offset + index) & mask; }
+        };
+
+        // 返回探查序列上第一个空槽或墓碑（负载上限保证一定存在）
+        size_t find_first_non_full(size_t hash) const noexcept {
+            ProbeSeq seq(h1_of(hash), get_header()->capacity - 1);
+            while (true) {
+                uint32_t m = detail::CtrlGroup(m_ctrl + seq.offset).mask_empty_or_deleted();
+                if (m) return (seq.offset + detail::ctrl_lowest_bit(m)) & seq.mask;
+                seq.next();
+            }
+        }
+
+        size_t find_index(const K& key, size_t hash) const noexcept {
+            Header* h = get_header();
+            Entry* STUCANVAS_RESTRICT table = slots();
+            const int8_t h2 = h2_of(hash);
+            ProbeSeq seq(h1_of(hash), h->capacity - 1);
+            while (true) {
+                detail::CtrlGroup g(m_ctrl + seq.offset);
+                for (uint32_t m = g.match(h2); m; m &= m - 1) {
+                    size_t idx = (seq.offset + detail::ctrl_lowest_bit(m)) & seq.mask;
+                    if (table[idx].first == key) return idx;
+                }
+                if (g.mask_empty()) return h->capacity; // 分组内有空槽：探查链到此终止
+                seq.next();
+            }
+        }
+
+        void resize(uint32_t new_capacity) {
+            int8_t* old_ctrl = m_ctrl;
+            Header* old_h = get_header();
+            Entry* old_table = slots();
+            uint32_t old_cap = old_h->capacity;
+            uint32_t old_size = old_h->size;
+
+            m_ctrl = allocate_table(new_capacity);
+            Entry* table = slots();
+            for (uint32_t i = 0; i < old_cap; ++i) {
+                if (old_ctrl[i] < 0) continue;
+                size_t hash = hash_key(old_table[i].first);
+                size_t pos = find_first_non_full(hash);
+                set_ctrl(pos, h2_of(hash));
+                table[pos] = std::move(old_table[i]);
+            }
+            Header* h = get_header();
+            h->size = old_size;
+            h->growth_left = growth_of(new_capacity) - old_size;
+            deallocate_table(old_ctrl);
+        }
+
+        // 🚀 墓碑感知的原位重哈希：不申请新内存，把满槽重新安置到各自探查序列上最靠前的位置，
+        //    墓碑全部回收为空槽，增长预算恢复为 7/8 容量减去元素数
+        void drop_deletes_without_resize() noexcept {
+            Header* h = get_header();
+            const uint32_t capacity = h->capacity;
+            const size_t mask = capacity - 1;
+            Entry* table = slots();
+
+            detail::ctrl_convert_for_rehash(m_ctrl, capacity);
+            std::memcpy(m_ctrl + capacity, m_ctrl, GroupWidth);
+
+            for (size_t i = 0; i < capacity; ++i) {
+                if (m_ctrl[i] != detail::kCtrlDeleted) continue;
+
+                const size_t hash = hash_key(table[i].first);
+                const size_t target = find_first_non_full(hash);
+                const size_t probe_start = h1_of(hash) & mask;
+                auto probe_group = [&](size_t pos) { return ((pos - probe_start) & mask) / GroupWidth; };
+
+                // 已在自己的首选分组内，原地保留
+                if (probe_group(target) == probe_group(i)) { set_ctrl(i, h2_of(hash)); continue; }
+
+                if (m_ctrl[target] == detail::kCtrlEmpty) {
+                    table[target] = std::move(table[i]);
+                    table[i] = Entry{};
+                    set_ctrl(target, h2_of(hash));
+                    set_ctrl(i, detail::kCtrlEmpty);
+                } else {
+                    // 目标位置是尚未安置的满槽：交换后重新处理当前位置
+                    std::swap(table[i], table[target]);
+                    set_ctrl(target, h2_of(hash));
+                    --i;
+                }
+            }
+            h->growth_left = growth_of(capacity) - h->size;
+        }
+
+        // 增长预算耗尽：墓碑多时原位清理，真正接近满载才翻倍扩容
+        void rehash_and_grow_if_necessary() {
+            Header* h = get_header();
+            if (static_cast<uint64_t>(h->size) * 32 <= static_cast<uint64_t>(h->capacity) * 25) {
+                drop_deletes_without_resize();
+            } else {
+                resize(h->capacity * 2);
+            }
+        }
+
+        // 查找或就位：返回 (槽位, 是否新插入)
+        std::pair<size_t, bool> find_or_prepare_insert(const K& key) {
+            const size_t hash = hash_key(key);
+            size_t idx = find_index(key, hash);
+            if (idx != get_header()->capacity) return { idx, false };
+
+            idx = find_first_non_full(hash);
+            if (get_header()->growth_left == 0 && m_ctrl[idx] != detail::kCtrlDeleted) {
+                rehash_and_grow_if_necessary();
+                idx = find_first_non_full(hash);
+            }
+            Header* h = get_header();
+            h->growth_left -= (m_ctrl[idx] == detail::kCtrlEmpty); // 复用墓碑不消耗增长预算
+            h->size++;
+            set_ctrl(idx, h2_of(hash));
+            slots()[idx].first = key;
+            return { idx, true };
+        }
+
+    public:
+        struct Iterator {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Entry;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Entry*;
+            using reference = Entry&;
+            const int8_t* ctrl;
+            pointer ptr;
+            pointer end_ptr;
+
+            Iterator(const int8_t* c, pointer p, pointer end) noexcept : ctrl(c), ptr(p), end_ptr(end) {
+                if (ptr != end_ptr && *ctrl < 0) { ++(*this); }
+            }
+            reference operator*() const noexcept { return *ptr; }
+            pointer operator->() const noexcept { return ptr; }
+            Iterator& operator++() noexcept {
+                do { ++ptr; ++ctrl; } while (ptr != end_ptr && *ctrl < 0);
+                return *this;
+            }
+            Iterator operator++(int) noexcept { Iterator tmp = *this; ++(*this); return tmp; }
+            bool operator==(const Iterator& other) const noexcept { return ptr == other.ptr; }
+            bool operator!=(const Iterator& other) const noexcept { return ptr != other.ptr; }
+        };
+
+        using iterator = Iterator;
+        using const_iterator = Iterator;
+
+        FlatMap(size_t initial_capacity = MinCapacity) {
+            size_t cap = MinCapacity; while (cap < initial_capacity) cap <<= 1;
+            m_ctrl = allocate_table(static_cast<uint32_t>(cap));
+        }
+        ~FlatMap() noexcept { deallocate_table(m_ctrl); }
+
+        FlatMap(FlatMap&& other) noexcept : m_ctrl(other.m_ctrl) { other.m_ctrl = nullptr; }
+        FlatMap& operator=(FlatMap&& other) noexcept {
+            if (this != &other) { deallocate_table(m_ctrl); m_ctrl = other.m_ctrl; other.m_ctrl = nullptr; }
+            return *this;
+        }
+
+        iterator begin() noexcept {
+            if (!m_ctrl) return end();
+            Entry* table = slots();
+            return Iterator(m_ctrl, table, table + get_header()->capacity);
+        }
+        iterator end() noexcept {
+            if (!m_ctrl) return Iterator(nullptr, nullptr, nullptr);
+            Entry* e = slots() + get_header()->capacity;
+            return Iterator(m_ctrl + get_header()->capacity, e, e);
+        }
+
+        void insert(const K& key, V value) {
+            auto [idx, inserted] = find_or_prepare_insert(key);
+            (void)inserted;
+            slots()[idx].second = std::move(value);
+        }
+
+        iterator find(const K& key) noexcept {
+            if (!m_ctrl) return end();
+            const size_t idx = find_index(key, hash_key(key));
+            const uint32_t capacity = get_header()->capacity;
+            if (idx == capacity) return end();
+            Entry* table = slots();
+            return Iterator(m_ctrl + idx, table + idx, table + capacity);
+        }
+
+        V& operator[](const K& key) {
+            const size_t idx = find_or_prepare_insert(key).first; // 可能触发重哈希，必须先于 slots() 求值
+            return slots()[idx].second;
+        }
+
+        // 删除：若该槽所在的 16 槽窗口从未被填满（前后都有空槽且跨度不足一组），
+        // 没有任何探查链经过它，可直接置空；否则留下墓碑
+        bool erase(const K& key) noexcept {
+            if (!m_ctrl) return false;
+            Header* h = get_header();
+            const size_t idx = find_index(key, hash_key(key));
+            if (idx == h->capacity) return false;
+
+            const size_t mask = h->capacity - 1;
+            const uint32_t empty_after = detail::CtrlGroup(m_ctrl + idx).mask_empty();
+            const uint32_t empty_before = detail::CtrlGroup(m_ctrl + ((idx - GroupWidth) & mask)).mask_empty();
+            const bool was_never_full = empty_after && empty_before &&
+                detail::ctrl_lowest_bit(empty_after) + (GroupWidth - 1 - detail::ctrl_highest_bit16(empty_before)) < GroupWidth;
+
+            set_ctrl(idx, was_never_full ? detail::kCtrlEmpty : detail::kCtrlDeleted);
+            h->growth_left += was_never_full;
+            slots()[idx] = Entry{};
+            h->size--;
+            return true;
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return m_ctrl ? get_header()->size : 0; }
+        [[nodiscard]] size_t capacity() const noexcept { return m_ctrl ? get_header()->capacity : 0; }
+    };
+}
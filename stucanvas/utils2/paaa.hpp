@@ -6,7 +6,11 @@
 #include <limits>
 #include <algorithm>
 #include <iomanip>
+#include <span>
 #include <Eigen/Dense>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_reduce.h>
+#include <oneapi/tbb/blocked_range.h>
 #include "function.hpp" // 引入闭包包装器
 
 namespace StuCanvas::utils
@@ -30,66 +34,197 @@ namespace StuCanvas::utils
         double f_c = 0.0;
         double df = 1.0;
 
+        static constexpr double kNodeMatchEps = 1e-14;   // 求值点与支撑节点重合的判定阈值
+        static constexpr int kBatchBlock = 64;           // 批量求值的分块行数 (Cauchy 矩阵按块构造)
+        static constexpr size_t kParallelBatch = 4096;   // 超过该点数时批量求值按块并行
+
         /**
-         * @brief 评估任意点处的函数值（支持 NaN/Inf 防御与自动尺度映射）
+         * @brief 单点求值的预分配工作区：同一线程反复求值时复用 Cauchy 向量缓冲，避免每点一次堆分配
          */
-        double evaluate(double x, double y) const
+        struct Workspace
+        {
+            std::vector<double> g_lam;
+            std::vector<double> g_mu;
+        };
+
+        /**
+         * @brief 评估任意点处的函数值（支持 NaN/Inf 防御与自动尺度映射），使用调用方提供的工作区
+         */
+        double evaluate(double x, double y, Workspace& ws) const
         {
             if (std::isnan(x) || std::isinf(x) || std::isnan(y) || std::isinf(y)) {
                 return std::numeric_limits<double>::quiet_NaN();
             }
 
-            double nx = (x - x_c) / dx;
-            double ny = (y - y_c) / dy;
-
             const int n = static_cast<int>(lambda.size());
             const int m = static_cast<int>(mu.size());
             if (n == 0 || m == 0) return f_c;
 
-            Eigen::VectorXd g_lam(n);
-            int x_match_idx = -1;
-            for (int i = 0; i < n; ++i) {
-                if (std::abs(nx - lambda[i]) < 1e-14) {
-                    x_match_idx = i;
-                    break;
+            ws.g_lam.resize(n);
+            ws.g_mu.resize(m);
+            cauchy_vector((x - x_c) / dx, lambda, ws.g_lam.data());
+            cauchy_vector((y - y_c) / dy, mu, ws.g_mu.data());
+
+            // 按列累加：beta / alpha 为列主序，每列与 g_lam 的点积是连续内存上的向量化内积
+            const Eigen::Map<const Eigen::VectorXd> g_lam(ws.g_lam.data(), n);
+            double num = 0.0;
+            double den = 0.0;
+            for (int j = 0; j < m; ++j) {
+                num += ws.g_mu[j] * beta.col(j).dot(g_lam);
+                den += ws.g_mu[j] * alpha.col(j).dot(g_lam);
+            }
+
+            return finalize(num, den);
+        }
+
+        /**
+         * @brief 评估任意点处的函数值（支持 NaN/Inf 防御与自动尺度映射）
+         */
+        double evaluate(double x, double y) const
+        {
+            thread_local Workspace ws; // 每线程一份，容量随最大阶数增长后不再分配
+            return evaluate(x, y, ws);
+        }
+
+        /**
+         * @brief 批量 SoA 求值：out[k] = evaluate(xs[k], ys[k])
+         * @details 每 kBatchBlock 个点构造一块 Cauchy 矩阵 G_λ (B×n)、G_μ (B×m)，
+         *          分子 / 分母化为 rowsum((G_λ·β) ∘ G_μ) 与 rowsum((G_λ·α) ∘ G_μ) 两次矩阵乘；
+         *          点数超过 kParallelBatch 时按块交给 TBB 并行。处理长度取三者最小值。
+         */
+        void evaluate(std::span<const double> xs, std::span<const double> ys, std::span<double> out) const
+        {
+            const size_t count = std::min({xs.size(), ys.size(), out.size()});
+            if (count == 0) return;
+
+            if (lambda.size() == 0 || mu.size() == 0) {
+                for (size_t k = 0; k < count; ++k) {
+                    const bool bad = std::isnan(xs[k]) || std::isinf(xs[k]) || std::isnan(ys[k]) || std::isinf(ys[k]);
+                    out[k] = bad ? std::numeric_limits<double>::quiet_NaN() : f_c;
                 }
+                return;
             }
-            if (x_match_idx != -1) {
-                g_lam.setZero();
-                g_lam[x_match_idx] = 1.0;
-            } else {
-                for (int i = 0; i < n; ++i) {
-                    g_lam[i] = 1.0 / (nx - lambda[i]);
+
+            const size_t blocks = (count + kBatchBlock - 1) / kBatchBlock;
+            auto run = [&](size_t block_begin, size_t block_end) {
+                BatchScratch scratch; // 每个任务区间只分配一次
+                for (size_t b = block_begin; b < block_end; ++b) {
+                    const size_t first = b * kBatchBlock;
+                    const int rows = static_cast<int>(std::min<size_t>(kBatchBlock, count - first));
+                    evaluate_block(xs.data() + first, ys.data() + first, out.data() + first, rows, scratch);
                 }
+            };
+
+            if (count < kParallelBatch) {
+                run(0, blocks);
+                return;
             }
 
-            Eigen::VectorXd g_mu_vec(m);
-            int y_match_idx = -1;
-            for (int j = 0; j < m; ++j) {
-                if (std::abs(ny - mu[j]) < 1e-14) {
-                    y_match_idx = j;
-                    break;
+            oneapi::tbb::parallel_for(oneapi::tbb::blocked_range<size_t>(0, blocks), [&](const oneapi::tbb::blocked_range<size_t>& range) {
+                run(range.begin(), range.end());
+            });
+        }
+
+        double operator()(double x, double y) const
+        {
+            return evaluate(x, y);
+        }
+
+    private:
+        /// 批量求值的分块缓冲 (列主序，行数固定为 kBatchBlock，阶数不变时反复复用)
+        struct BatchScratch
+        {
+            Eigen::MatrixXd g_lam;
+            Eigen::MatrixXd g_mu;
+            Eigen::MatrixXd num_proj;
+            Eigen::MatrixXd den_proj;
+        };
+
+        /// 一元 Cauchy 核向量 1 / (t - node_i)；与某节点重合时退化为该节点的单位向量 (重心插值的可去奇点)
+        static void cauchy_vector(double t, const Eigen::VectorXd& nodes, double* out)
+        {
+            const int count = static_cast<int>(nodes.size());
+            for (int i = 0; i < count; ++i) {
+                if (std::abs(t - nodes[i]) < kNodeMatchEps) {
+                    std::fill(out, out + count, 0.0);
+                    out[i] = 1.0;
+                    return;
                 }
             }
-            if (y_match_idx != -1) {
-                g_mu_vec.setZero();
-                g_mu_vec[y_match_idx] = 1.0;
-            } else {
-                for (int j = 0; j < m; ++j) {
-                    g_mu_vec[j] = 1.0 / (ny - mu[j]);
+            for (int i = 0; i < count; ++i) {
+                out[i] = 1.0 / (t - nodes[i]);
+            }
+        }
+
+        /// 按块填充 Cauchy 矩阵：外层遍历节点、内层遍历连续的求值点，可被编译器向量化
+        static void cauchy_block(const double* t, int rows, const Eigen::VectorXd& nodes, Eigen::MatrixXd& g)
+        {
+            const int count = static_cast<int>(nodes.size());
+            int match[kBatchBlock];
+            std::fill(match, match + rows, -1);
+
+            for (int i = 0; i < count; ++i) {
+                const double node = nodes[i];
+                double* col = g.col(i).data();
+                for (int p = 0; p < rows; ++p) {
+                    col[p] = 1.0 / (t[p] - node);
+                }
+            }
+            for (int i = count - 1; i >= 0; --i) {
+                for (int p = 0; p < rows; ++p) {
+                    if (std::abs(t[p] - nodes[i]) < kNodeMatchEps) match[p] = i; // 逆序扫描，保留首个重合节点
+                }
+            }
+            for (int p = 0; p < rows; ++p) {
+                if (match[p] >= 0) {
+                    g.row(p).setZero();
+                    g(p, match[p]) = 1.0;
                 }
             }
+        }
 
-            double num = 0.0;
-            double den = 0.0;
-            for (int i = 0; i < n; ++i) {
-                for (int j = 0; j < m; ++j) {
-                    double term_basis = g_lam[i] * g_mu_vec[j];
-                    num += beta(i, j) * term_basis;
-                    den += alpha(i, j) * term_basis;
+        void evaluate_block(const double* xs, const double* ys, double* out, int rows, BatchScratch& s) const
+        {
+            const int n = static_cast<int>(lambda.size());
+            const int m = static_cast<int>(mu.size());
+
+            // 相同尺寸时 resize 不会重新分配
+            s.g_lam.resize(kBatchBlock, n);
+            s.g_mu.resize(kBatchBlock, m);
+            s.num_proj.resize(kBatchBlock, m);
+            s.den_proj.resize(kBatchBlock, m);
+
+            double nx[kBatchBlock];
+            double ny[kBatchBlock];
+            bool bad[kBatchBlock];
+            for (int p = 0; p < rows; ++p) {
+                bad[p] = std::isnan(xs[p]) || std::isinf(xs[p]) || std::isnan(ys[p]) || std::isinf(ys[p]);
+                nx[p] = bad[p] ? 0.0 : (xs[p] - x_c) / dx;
+                ny[p] = bad[p] ? 0.0 : (ys[p] - y_c) / dy;
+            }
+
+            cauchy_block(nx, rows, lambda, s.g_lam);
+            cauchy_block(ny, rows, mu, s.g_mu);
+
+            const auto g_lam = s.g_lam.topRows(rows);
+            const auto g_mu = s.g_mu.topRows(rows);
+            s.num_proj.topRows(rows).noalias() = g_lam * beta;
+            s.den_proj.topRows(rows).noalias() = g_lam * alpha;
+
+            for (int p = 0; p < rows; ++p) {
+                if (bad[p]) {
+                    out[p] = std::numeric_limits<double>::quiet_NaN();
+                    continue;
                 }
+                const double num = s.num_proj.row(p).dot(g_mu.row(p));
+                const double den = s.den_proj.row(p).dot(g_mu.row(p));
+                out[p] = finalize(num, den);
             }
+        }
 
+        /// 分母退化或结果非有限时回退到数据中心值，否则映射回原始尺度
+        double finalize(double num, double den) const
+        {
             if (std::abs(den) < 1e-22) {
                 return f_c;
             }
@@ -101,12 +236,511 @@ namespace StuCanvas::utils
 
             return norm_z * df + f_c;
         }
+    };
 
-        double operator()(double x, double y) const
+    namespace detail
+    {
+        /**
+         * @brief p-AAA Loewner 最小二乘系统的增量正交分解
+         * @details 以节点对 (λ_i, μ_j) 的创建顺序为稳定列序，每个节点对贡献 F∘G_ij 与 G_ij 两列，维护 A = Q·S
+         *          (Q 列正交、S 为 c×c 小矩阵)：
+         *          - 新增节点只把新节点对的列作为一个块追加，BCGS2 (两轮块投影 + 块内正交化) 保证正交性；
+         *          - 样本点与新节点重合时其 Cauchy 行退化为单位向量，旧列上的该行整体归零，
+         *            用对称秩一修正 Q ← Q_z (I + δqqᵀ)、S ← (I - γqqᵀ) S 删除该行；
+         *          - 约束结构 M = A·T 只作用在列上，最小右奇异向量由 (S·T) 的 SVD 给出，代价与样本数无关；
+         *          - 近零空间不唯一时，把 S·T 的列换成逐轮重建时的扁平列序再做 QR，R 的行符号规范化后只由
+         *            MᵀM 决定 (与 Q 的更新历史无关)，对 R 做 SVD 即与显式 M 的完整求解一致。
+         */
+        class PaaaLoewnerSolver
         {
-            return evaluate(x, y);
+        public:
+            PaaaLoewnerSolver(const Eigen::VectorXd& x, const Eigen::VectorXd& y, const Eigen::VectorXd& f)
+                : xs(x), ys(y), fs(f), sample_count(static_cast<int>(x.size())),
+                  x_match(sample_count, -1), y_match(sample_count, -1)
+            {
+                order_x.resize(sample_count);
+                for (int p = 0; p < sample_count; ++p) order_x[p] = p;
+                std::stable_sort(order_x.begin(), order_x.end(), [&](int a, int b) { return xs[a] < xs[b]; });
+                sorted_x.resize(sample_count);
+                for (int k = 0; k < sample_count; ++k) sorted_x[k] = xs[order_x[k]];
+            }
+
+            const std::vector<double>& lambda() const { return lambda_nodes; }
+            const std::vector<double>& mu() const { return mu_nodes; }
+
+            void add_lambda(double value)
+            {
+                add_node(value, xs, lambda_nodes, c_lam, x_match);
+                const int i = static_cast<int>(lambda_nodes.size()) - 1;
+                const size_t first = pairs.size();
+                for (int j = 0; j < static_cast<int>(mu_nodes.size()); ++j) add_pair(i, j);
+                append_pairs(first);
+            }
+
+            void add_mu(double value)
+            {
+                add_node(value, ys, mu_nodes, c_mu, y_match);
+                const int j = static_cast<int>(mu_nodes.size()) - 1;
+                const size_t first = pairs.size();
+                for (int i = 0; i < static_cast<int>(lambda_nodes.size()); ++i) add_pair(i, j);
+                append_pairs(first);
+            }
+
+            /**
+             * @brief 求解当前节点集下的重心权重，输出 n×m 的 alpha / beta (列主序，与 BivariateBarycentricRational 一致)
+             * @details 先由增量分解 (S·T 的 SVD) 求零向量，再用显式 M 校验：
+             *          - ‖M·v‖ 与 σ_min(S·T) 不符说明 Q 已因删行修正失去正交性，整体重建后重解；
+             *          - 最小奇异值不是孤立的 (近零空间多于一维，拟合趋于收敛时很常见) 时零向量由 SVD 任意选取，
+             *            此时按完整求解的列序对 S·T 做 QR，再取 R 的最小右奇异向量 (R 与 M 右奇异向量相同)，
+             *            结果不依赖增量分解的历史，代价仍与样本数无关；
+             *          - 重建后仍不一致时才构造显式 M 完整求解，且只影响本轮。
+             */
+            void solve(Eigen::MatrixXd& alpha, Eigen::MatrixXd& beta)
+            {
+                if (dirty) rebuild();
+
+                const int P = static_cast<int>(pairs.size());
+                std::vector<int> beta_slot(P, -1);
+                int u_count = 0;
+                for (int k = 0; k < P; ++k) {
+                    if (!pairs[k].constrained) beta_slot[k] = u_count++;
+                }
+
+                Eigen::VectorXd v;
+                Check check = solve_incremental(beta_slot, u_count, v);
+                if (check == Check::Drifted) {
+                    rebuild();
+                    check = solve_incremental(beta_slot, u_count, v);
+                }
+                if (check == Check::Degenerate) {
+                    solve_canonical(beta_slot, u_count, alpha, beta);
+                    return;
+                }
+                if (check != Check::Trusted) {
+                    solve_full(alpha, beta);
+                    return;
+                }
+
+                alpha.setZero(static_cast<Eigen::Index>(lambda_nodes.size()), static_cast<Eigen::Index>(mu_nodes.size()));
+                beta.setZero(alpha.rows(), alpha.cols());
+                for (int k = 0; k < P; ++k) {
+                    const Pair& pr = pairs[k];
+                    alpha(pr.i, pr.j) = v[k];
+                    beta(pr.i, pr.j) = pr.constrained ? v[k] * pr.h : v[P + beta_slot[k]];
+                }
+            }
+
+        private:
+            struct Pair
+            {
+                int i;
+                int j;
+                bool constrained;   // 存在与 (λ_i, μ_j) 重合的样本点，beta 由插值条件消去
+                double h;           // 该样本点的归一化函数值 (无约束时为 0)
+            };
+
+            static constexpr double kMatchEps = 1e-14;        // Cauchy 核退化判定 (与 evaluate 一致)
+            static constexpr double kConstraintEps = 1e-12;   // 插值约束判定
+            static constexpr int kRowGrain = 2048;
+            static constexpr double kResidualTol = 1e-8;      // ‖M·v‖ 与 σ_min 的允许偏差 (相对 σ_max)
+            static constexpr double kGapTol = 1e-8;           // 最小奇异值与次小奇异值的最小间隔 (相对 σ_max)
+
+            enum class Check
+            {
+                Trusted,    // 增量零向量可用
+                Drifted,    // 分解与显式 M 不一致，需要重建
+                Degenerate  // 近零空间不唯一，需要完整求解
+            };
+
+            /// B = S·T：alpha_k 对应 (F∘G - h_k G) 列，无约束节点对的 beta 对应 -G 列 (节点对创建顺序)
+            /// 💡 秩亏列在 Q 中置零，S 的对应行恒为零，只保留非零行：B 的行数不超过 min(样本数, 2P)
+            Eigen::MatrixXd reduced_system(const std::vector<int>& beta_slot, int u_count) const
+            {
+                const int P = static_cast<int>(pairs.size());
+                std::vector<int> live_rows;
+                live_rows.reserve(cols);
+                for (int r = 0; r < cols; ++r) {
+                    if (s.row(r).head(cols).squaredNorm() > 0.0) live_rows.push_back(r);
+                }
+                const int rows = static_cast<int>(live_rows.size());
+                Eigen::MatrixXd S(rows, cols);
+                for (int r = 0; r < rows; ++r) S.row(r) = s.row(live_rows[r]).head(cols);
+
+                Eigen::MatrixXd B(rows, P + u_count);
+                for (int k = 0; k < P; ++k) {
+                    B.col(k) = S.col(2 * k) - pairs[k].h * S.col(2 * k + 1);
+                    if (beta_slot[k] >= 0) B.col(P + beta_slot[k]) = -S.col(2 * k + 1);
+                }
+                return B;
+            }
+
+            /// 增量路径：B 的最小右奇异向量；先用显式 M 的残差校验分解是否仍然可信，再判断零向量是否唯一
+            Check solve_incremental(const std::vector<int>& beta_slot, int u_count, Eigen::VectorXd& v) const
+            {
+                const Eigen::MatrixXd B = reduced_system(beta_slot, u_count);
+                const Eigen::Index last = B.cols() - 1;
+                const unsigned int options = B.rows() < B.cols() ? Eigen::ComputeFullV : Eigen::ComputeThinV;
+                Eigen::BDCSVD<Eigen::MatrixXd> svd(B, options);
+                v = svd.matrixV().col(last);
+
+                // 宽矩阵时奇异值个数少于列数，缺失的都视为 0
+                const Eigen::VectorXd& sv = svd.singularValues();
+                auto sigma = [&sv](Eigen::Index k) { return k < sv.size() ? sv[k] : 0.0; };
+                const double s_max = sigma(0);
+                const double s_min = sigma(last);
+                if (!(s_max > 0.0)) return Check::Degenerate;
+
+                const double residual = apply_m(v, beta_slot).norm();
+                if (std::abs(residual - s_min) > kResidualTol * s_max) return Check::Drifted;
+
+                return last > 0 && sigma(last - 1) - s_min <= kGapTol * s_max ? Check::Degenerate : Check::Trusted;
+            }
+
+            /// 退化路径：按 solve_full 的扁平列序排列 B 后做 QR，规范化 R 的行符号 (对角元非负)，
+            /// R 只由 BᵀB = MᵀM 决定，对 R 做 SVD 取最小右奇异向量
+            void solve_canonical(const std::vector<int>& beta_slot, int u_count, Eigen::MatrixXd& alpha, Eigen::MatrixXd& beta) const
+            {
+                const int n = static_cast<int>(lambda_nodes.size());
+                const int m = static_cast<int>(mu_nodes.size());
+                const int nm = n * m;
+                const Eigen::MatrixXd B = reduced_system(beta_slot, u_count);
+                const int P = static_cast<int>(pairs.size());
+
+                // 列重排：alpha 列按 i + j·n，beta 列按同一扁平顺序依次跳过受约束的节点对
+                std::vector<int> pair_of(nm, -1);
+                for (int k = 0; k < P; ++k) pair_of[pairs[k].i + pairs[k].j * n] = k;
+                std::vector<int> slot(nm, -1);
+                Eigen::MatrixXd B_flat(B.rows(), B.cols());
+                int flat_u = 0;
+                for (int idx = 0; idx < nm; ++idx) {
+                    const int k = pair_of[idx];
+                    B_flat.col(idx) = B.col(k);
+                    if (beta_slot[k] >= 0) {
+                        slot[idx] = flat_u;
+                        B_flat.col(nm + flat_u++) = B.col(P + beta_slot[k]);
+                    }
+                }
+
+                Eigen::HouseholderQR<Eigen::MatrixXd> qr(B_flat);
+                const Eigen::Index r_rows = std::min(B_flat.rows(), B_flat.cols());
+                Eigen::MatrixXd R = qr.matrixQR().topRows(r_rows).triangularView<Eigen::Upper>();
+                for (Eigen::Index row = 0; row < r_rows; ++row) {
+                    if (R(row, row) < 0.0) R.row(row) = -R.row(row);
+                }
+
+                const unsigned int options = R.rows() < R.cols() ? Eigen::ComputeFullV : Eigen::ComputeThinV;
+                Eigen::BDCSVD<Eigen::MatrixXd> svd(R, options);
+                const Eigen::VectorXd v = svd.matrixV().col(R.cols() - 1);
+
+                alpha.resize(n, m);
+                beta.resize(n, m);
+                for (int idx = 0; idx < nm; ++idx) {
+                    const Pair& pr = pairs[pair_of[idx]];
+                    alpha(pr.i, pr.j) = v[idx];
+                    beta(pr.i, pr.j) = pr.constrained ? v[idx] * pr.h : v[nm + slot[idx]];
+                }
+            }
+
+            /// 显式 M·v：M 的列为 F∘G_k - h_k G_k (alpha) 与 -G_k (无约束 beta)，逐行累加避免构造 M
+            Eigen::VectorXd apply_m(const Eigen::VectorXd& v, const std::vector<int>& beta_slot) const
+            {
+                const int P = static_cast<int>(pairs.size());
+                Eigen::VectorXd out(sample_count);
+                for_rows([&](int begin, int len) {
+                    Eigen::VectorXd scaled = Eigen::VectorXd::Zero(len);   // Σ v_k G_k
+                    Eigen::VectorXd shift = Eigen::VectorXd::Zero(len);    // Σ (-v_k h_k - β_k) G_k
+                    for (int k = 0; k < P; ++k) {
+                        const Pair& pr = pairs[k];
+                        const double b = beta_slot[k] >= 0 ? v[P + beta_slot[k]] : 0.0;
+                        const auto g = c_lam[pr.i].segment(begin, len).cwiseProduct(c_mu[pr.j].segment(begin, len));
+                        scaled += v[k] * g;
+                        shift -= (v[k] * pr.h + b) * g;
+                    }
+                    out.segment(begin, len) = fs.segment(begin, len).cwiseProduct(scaled) + shift;
+                });
+                return out;
+            }
+
+            /// 完整路径：按扁平下标 i + j·n 构造显式 M = [M1 | M2] 后直接 BDCSVD
+            void solve_full(Eigen::MatrixXd& alpha, Eigen::MatrixXd& beta) const
+            {
+                const int n = static_cast<int>(lambda_nodes.size());
+                const int m = static_cast<int>(mu_nodes.size());
+                const int nm = n * m;
+
+                std::vector<int> pair_of(nm, -1);
+                for (int k = 0; k < static_cast<int>(pairs.size()); ++k) pair_of[pairs[k].i + pairs[k].j * n] = k;
+
+                std::vector<int> slot(nm, -1);
+                int u_count = 0;
+                for (int idx = 0; idx < nm; ++idx) {
+                    if (!pairs[pair_of[idx]].constrained) slot[idx] = u_count++;
+                }
+
+                Eigen::MatrixXd M(sample_count, nm + u_count);
+                oneapi::tbb::parallel_for(0, nm, [&](int idx) {
+                    const Pair& pr = pairs[pair_of[idx]];
+                    const Eigen::VectorXd g = c_lam[pr.i].cwiseProduct(c_mu[pr.j]);
+                    M.col(idx) = fs.cwiseProduct(g) - pr.h * g;
+                    if (slot[idx] >= 0) M.col(nm + slot[idx]) = -g;
+                });
+
+                // 样本数少于未知数时 M 为宽矩阵，零空间向量需要完整 V
+                const unsigned int options = M.rows() < M.cols() ? Eigen::ComputeFullV : Eigen::ComputeThinV;
+                Eigen::BDCSVD<Eigen::MatrixXd> svd(M, options);
+                const Eigen::VectorXd v = svd.matrixV().col(M.cols() - 1);
+
+                alpha.resize(n, m);
+                beta.resize(n, m);
+                for (int idx = 0; idx < nm; ++idx) {
+                    const Pair& pr = pairs[pair_of[idx]];
+                    alpha(pr.i, pr.j) = v[idx];
+                    beta(pr.i, pr.j) = pr.constrained ? v[idx] * pr.h : v[nm + slot[idx]];
+                }
+            }
+
+            /// 追加一个节点的 Cauchy 核列；新重合的样本点在旧节点上的核值归零，并从分解中删除其旧行
+            void add_node(double value, const Eigen::VectorXd& coords, std::vector<double>& nodes,
+                          std::vector<Eigen::VectorXd>& kernel, std::vector<int>& match)
+            {
+                const int node = static_cast<int>(nodes.size());
+                nodes.push_back(value);
+
+                Eigen::VectorXd col(sample_count);
+                std::vector<int> newly_matched;
+                for (int p = 0; p < sample_count; ++p) {
+                    if (match[p] >= 0) {
+                        col[p] = 0.0;
+                    } else if (std::abs(coords[p] - value) < kMatchEps) {
+                        match[p] = node;
+                        col[p] = 1.0;
+                        newly_matched.push_back(p);
+                    } else {
+                        col[p] = 1.0 / (coords[p] - value);
+                    }
+                }
+
+                for (const int p : newly_matched) {
+                    for (int i = 0; i < node; ++i) kernel[i][p] = 0.0;
+                    delete_row(p);
+                }
+                kernel.push_back(std::move(col));
+            }
+
+            void add_pair(int i, int j)
+            {
+                Pair pr{i, j, false, 0.0};
+
+                // 按 x 排序后二分定位候选样本，取下标最小的重合样本作为插值约束
+                const double lam = lambda_nodes[i];
+                const double mu_j = mu_nodes[j];
+                auto it = std::lower_bound(sorted_x.begin(), sorted_x.end(), lam - kConstraintEps);
+                int best = -1;
+                for (size_t k = static_cast<size_t>(it - sorted_x.begin()); k < sorted_x.size() && sorted_x[k] < lam + kConstraintEps; ++k) {
+                    const int p = order_x[k];
+                    if (std::abs(xs[p] - lam) < kConstraintEps && std::abs(ys[p] - mu_j) < kConstraintEps && (best < 0 || p < best)) {
+                        best = p;
+                    }
+                }
+                if (best >= 0) {
+                    pr.constrained = true;
+                    pr.h = fs[best];
+                }
+                pairs.push_back(pr);
+            }
+
+            /// 将 pairs[first..] 的 F∘G / G 两列作为一个块追加进分解
+            void append_pairs(size_t first)
+            {
+                if (dirty || first >= pairs.size()) return;
+
+                const int b = static_cast<int>(2 * (pairs.size() - first));
+                Eigen::MatrixXd block(sample_count, b);
+                oneapi::tbb::parallel_for(size_t(first), pairs.size(), [&](size_t k) {
+                    const Pair& pr = pairs[k];
+                    const int col = static_cast<int>(2 * (k - first));
+                    block.col(col + 1) = c_lam[pr.i].cwiseProduct(c_mu[pr.j]);
+                    block.col(col) = block.col(col + 1).cwiseProduct(fs);
+                });
+                append_block(block);
+            }
+
+            /// 按行分块并行的 Qᵀ·A：各块部分和按固定顺序相加，结果与线程调度无关
+            Eigen::MatrixXd project(const Eigen::MatrixXd& a) const
+            {
+                const int chunks = (sample_count + kRowGrain - 1) / kRowGrain;
+                std::vector<Eigen::MatrixXd> partial(chunks);
+                oneapi::tbb::parallel_for(0, chunks, [&](int ch) {
+                    const int begin = ch * kRowGrain;
+                    const int len = std::min(kRowGrain, sample_count - begin);
+                    partial[ch].noalias() = q.block(begin, 0, len, cols).transpose() * a.middleRows(begin, len);
+                });
+                Eigen::MatrixXd sum = Eigen::MatrixXd::Zero(cols, a.cols());
+                for (const Eigen::MatrixXd& part : partial) sum += part;
+                return sum;
+            }
+
+            template <typename Body>
+            void for_rows(Body&& body) const
+            {
+                oneapi::tbb::parallel_for(oneapi::tbb::blocked_range<int>(0, sample_count, kRowGrain),
+                    [&](const oneapi::tbb::blocked_range<int>& range) { body(range.begin(), range.end() - range.begin()); });
+            }
+
+            /// 块内逐列两遍 Gram-Schmidt：a ← a_orth，返回上三角 T 使 a_in = a_orth·T (秩亏列置零、对角元为 0)
+            static Eigen::MatrixXd orthonormalize_columns(Eigen::MatrixXd& a, const Eigen::VectorXd& ref_norms)
+            {
+                const int b = static_cast<int>(a.cols());
+                Eigen::MatrixXd t = Eigen::MatrixXd::Zero(b, b);
+                for (int j = 0; j < b; ++j) {
+                    for (int pass = 0; pass < 2 && j > 0; ++pass) {
+                        const Eigen::VectorXd coeffs = a.leftCols(j).transpose() * a.col(j);
+                        a.col(j).noalias() -= a.leftCols(j) * coeffs;
+                        t.col(j).head(j) += coeffs;
+                    }
+                    const double rho = a.col(j).norm();
+                    if (rho > 1e-13 * ref_norms[j]) {
+                        a.col(j) /= rho;
+                        t(j, j) = rho;
+                    } else {
+                        a.col(j).setZero();
+                    }
+                }
+                return t;
+            }
+
+            /**
+             * @brief BCGS2 块追加：两轮 (对已有基的块投影 + 块内正交化)，每轮只读一遍 Q
+             * @details A = Q·R1 + Q1·T1，Q1 = Q·R2 + Q2·T2  ⇒  A = Q·(R1 + R2·T1) + Q2·(T2·T1)
+             */
+            void append_block(Eigen::MatrixXd& a)
+            {
+                const int c = cols;
+                const int b = static_cast<int>(a.cols());
+                const Eigen::VectorXd a_norms = a.colwise().norm().transpose();
+
+                auto project_out = [&](Eigen::MatrixXd& blk) {
+                    if (c == 0) return Eigen::MatrixXd(Eigen::MatrixXd::Zero(0, b));
+                    Eigen::MatrixXd coeffs = project(blk);
+                    for_rows([&](int begin, int len) {
+                        blk.middleRows(begin, len).noalias() -= q.block(begin, 0, len, c) * coeffs;
+                    });
+                    return coeffs;
+                };
+
+                const Eigen::MatrixXd r1 = project_out(a);
+                const Eigen::MatrixXd t1 = orthonormalize_columns(a, a_norms);
+                const Eigen::MatrixXd r2 = project_out(a);
+                const Eigen::MatrixXd t2 = orthonormalize_columns(a, Eigen::VectorXd::Ones(b));
+
+                reserve(c + b);
+                q.middleCols(c, b) = a;
+                if (c > 0) s.block(0, c, c, b) = r1 + r2 * t1;
+                s.block(c, 0, b, c).setZero();
+                s.block(c, c, b, b) = t2 * t1;
+                cols = c + b;
+            }
+
+            /// Q / S 容量倍增，避免每次追加都整体拷贝
+            void reserve(int needed)
+            {
+                if (q.cols() >= needed) return;
+                const Eigen::Index cap = std::max<Eigen::Index>(std::max<Eigen::Index>(64, 2 * q.cols()), needed);
+                q.conservativeResize(sample_count, cap);
+                s.conservativeResizeLike(Eigen::MatrixXd::Zero(cap, cap));
+            }
+
+            /// 将 A 的第 p 行在现有全部列上置零：Q_z = Q 去掉第 p 行，q = Q 的第 p 行，Q_zᵀQ_z = I - qqᵀ，
+            /// 取其对称平方根 I - γqqᵀ 重新正交化 (逆为 I + δqqᵀ)，S 左乘同一因子补偿
+            void delete_row(int p)
+            {
+                const int c = cols;
+                if (c == 0 || dirty) return;
+
+                const Eigen::VectorXd qp = q.row(p).head(c).transpose();
+                const double s2 = qp.squaredNorm();
+                if (s2 == 0.0) return;
+                if (1.0 - s2 < 1e-4) {
+                    dirty = true; // 该行几乎独占某一方向，秩一修正失稳，求解前整体重建
+                    return;
+                }
+
+                const double gamma = (1.0 - std::sqrt(1.0 - s2)) / s2;
+                const double delta = gamma / (1.0 - gamma * s2);
+
+                q.row(p).head(c).setZero();
+                for_rows([&](int begin, int len) {
+                    auto rows = q.block(begin, 0, len, c);
+                    const Eigen::VectorXd w = rows * qp;
+                    rows.noalias() += (delta * w) * qp.transpose();
+                });
+
+                auto S = s.topLeftCorner(c, c);
+                const Eigen::RowVectorXd t = qp.transpose() * S;
+                S.noalias() -= (gamma * qp) * t;
+            }
+
+            void rebuild()
+            {
+                cols = 0;
+                dirty = false;
+                append_pairs(0);
+            }
+
+            const Eigen::VectorXd& xs;
+            const Eigen::VectorXd& ys;
+            const Eigen::VectorXd& fs;
+            int sample_count;
+
+            std::vector<int> order_x;           // 按 x 升序的样本下标，约束查找用
+            std::vector<double> sorted_x;
+            std::vector<int> x_match;           // 每个样本首个重合的 λ 节点 (-1 表示无)
+            std::vector<int> y_match;           // 每个样本首个重合的 μ 节点
+
+            std::vector<double> lambda_nodes;
+            std::vector<double> mu_nodes;
+            std::vector<Eigen::VectorXd> c_lam; // 每个 λ 节点一列 Cauchy 核 (长度为样本数)
+            std::vector<Eigen::VectorXd> c_mu;
+            std::vector<Pair> pairs;
+
+            Eigen::MatrixXd q;                  // 正交基 (样本数 × 容量)，每个节点对两列，有效部分为前 cols 列
+            Eigen::MatrixXd s;                  // 系数矩阵 (容量 × 容量)，有效部分为左上 cols×cols
+            int cols = 0;
+            bool dirty = false;
+        };
+
+        struct PaaaResidualScan
+        {
+            int index = 0;
+            double max_err = -1.0;
+        };
+
+        /// 并行残差扫描：最大绝对误差及其首次出现的样本下标 (非有限的近似值按 0 误差计)
+        inline PaaaResidualScan scan_residuals(const Eigen::VectorXd& sF, const std::vector<double>& approx)
+        {
+            const int count = static_cast<int>(approx.size());
+            return oneapi::tbb::parallel_reduce(
+                oneapi::tbb::blocked_range<int>(0, count, 4096), PaaaResidualScan{},
+                [&](const oneapi::tbb::blocked_range<int>& range, PaaaResidualScan acc) {
+                    for (int p = range.begin(); p < range.end(); ++p) {
+                        const double approx_val = approx[p];
+                        double curr_err = 0.0;
+                        if (!std::isnan(approx_val) && !std::isinf(approx_val)) {
+                            curr_err = std::abs(sF[p] - approx_val);
+                        }
+                        if (curr_err > acc.max_err) {
+                            acc.max_err = curr_err;
+                            acc.index = p;
+                        }
+                    }
+                    return acc;
+                },
+                [](const PaaaResidualScan& a, const PaaaResidualScan& b) {
+                    if (a.max_err != b.max_err) return a.max_err > b.max_err ? a : b;
+                    return a.index <= b.index ? a : b;
+                });
         }
-    };
+    } // namespace detail
 
     /**
      * @brief 零异常版散点数据 p-AAA 拟合器 (由 BivariateBarycentricRational 独立驱动)
@@ -115,7 +749,7 @@ namespace StuCanvas::utils
     {
     public:
         static BivariateBarycentricRational fit(
-            const FfiFunction<double(double, double)>& f,
+            const StuFunction<double(double, double)>& f,
             const Eigen::VectorXd& X,
             const Eigen::VectorXd& Y,
             double tol = 1e-9,
@@ -184,195 +818,44 @@ namespace StuCanvas::utils
             r.alpha.resize(1, 1); r.alpha(0, 0) = 1.0;
             r.beta.resize(1, 1);  r.beta(0, 0) = sF_norm[0];
 
-            std::vector<double> lambda_list;
-            std::vector<double> mu_list;
+            detail::PaaaLoewnerSolver solver(sX_norm, sY_norm, sF_norm);
 
             double error = 1.0;
             int iter = 0;
 
-            while (error > tol && iter < max_iters) {
-                int idx_max = 0;
-                double max_err = -1.0;
-                for (int p = 0; p < valid_count; ++p) {
-                    double approx_val = r.evaluate(sX[p], sY[p]);
-                    double curr_err = 0.0;
-                    if (!std::isnan(approx_val) && !std::isinf(approx_val)) {
-                        curr_err = std::abs(sF[p] - approx_val);
-                    }
-                    if (curr_err > max_err) {
-                        max_err = curr_err;
-                        idx_max = p;
-                    }
-                }
+            // 全样本残差扫描走批量求值 + 并行归约；上一轮收敛检查的结果直接作为下一轮的贪心选点依据
+            const std::span<const double> span_X(sX.data(), valid_count);
+            const std::span<const double> span_Y(sY.data(), valid_count);
+            std::vector<double> approx(valid_count);
+            r.evaluate(span_X, span_Y, approx);
+            detail::PaaaResidualScan scan = detail::scan_residuals(sF, approx);
 
-                double lambda_star = sX_norm[idx_max];
-                double mu_star = sY_norm[idx_max];
+            while (error > tol && iter < max_iters) {
+                double lambda_star = sX_norm[scan.index];
+                double mu_star = sY_norm[scan.index];
 
-                auto add_unique = [](std::vector<double>& vec, double val) {
-                    auto it = std::find_if(vec.begin(), vec.end(), [val](double v) {
+                auto is_new = [](const std::vector<double>& vec, double val) {
+                    return std::none_of(vec.begin(), vec.end(), [val](double v) {
                         return std::abs(v - val) < 1e-14;
                     });
-                    if (it == vec.end()) {
-                        vec.push_back(val);
-                        return true;
-                    }
-                    return false;
                 };
 
-                bool added_lam = add_unique(lambda_list, lambda_star);
-                bool added_mu  = add_unique(mu_list, mu_star);
+                bool added_lam = is_new(solver.lambda(), lambda_star);
+                bool added_mu  = is_new(solver.mu(), mu_star);
 
                 if (!added_lam && !added_mu) break;
 
-                const int n = static_cast<int>(lambda_list.size());
-                const int m = static_cast<int>(mu_list.size());
-                const int nm = n * m;
-
-                std::vector<int> constrained_indices;
-                std::vector<double> interp_values;
-
-                for (int i = 0; i < n; ++i) {
-                    for (int j = 0; j < m; ++j) {
-                        for (int p = 0; p < valid_count; ++p) {
-                            if (std::abs(sX_norm[p] - lambda_list[i]) < 1e-12 &&
-                                std::abs(sY_norm[p] - mu_list[j]) < 1e-12)
-                            {
-                                constrained_indices.push_back(i + j * n);
-                                interp_values.push_back(sF_norm[p]);
-                                break;
-                            }
-                        }
-                    }
-                }
-
-                const int k_interp = static_cast<int>(constrained_indices.size());
-                const int u_count = nm - k_interp;
-
-                std::vector<int> unconstrained_indices;
-                for (int idx = 0; idx < nm; ++idx) {
-                    if (std::find(constrained_indices.begin(), constrained_indices.end(), idx) == constrained_indices.end()) {
-                        unconstrained_indices.push_back(idx);
-                    }
-                }
-
-                Eigen::MatrixXd C_lam(n, valid_count);
-                for (int p = 0; p < valid_count; ++p) {
-                    double xp = sX_norm[p];
-                    int match_idx = -1;
-                    for (int i = 0; i < n; ++i) {
-                        if (std::abs(xp - lambda_list[i]) < 1e-14) {
-                            match_idx = i;
-                            break;
-                        }
-                    }
-                    if (match_idx != -1) {
-                        C_lam.col(p).setZero();
-                        C_lam(match_idx, p) = 1.0;
-                    } else {
-                        for (int i = 0; i < n; ++i) {
-                            C_lam(i, p) = 1.0 / (xp - lambda_list[i]);
-                        }
-                    }
-                }
-
-                Eigen::MatrixXd C_mu(m, valid_count);
-                for (int p = 0; p < valid_count; ++p) {
-                    double yp = sY_norm[p];
-                    int match_idx = -1;
-                    for (int j = 0; j < m; ++j) {
-                        if (std::abs(yp - mu_list[j]) < 1e-14) {
-                            match_idx = j;
-                            break;
-                        }
-                    }
-                    if (match_idx != -1) {
-                        C_mu.col(p).setZero();
-                        C_mu(match_idx, p) = 1.0;
-                    } else {
-                        for (int j = 0; j < m; ++j) {
-                            C_mu(j, p) = 1.0 / (yp - mu_list[j]);
-                        }
-                    }
-                }
-
-                Eigen::MatrixXd G(valid_count, nm);
-                for (int p = 0; p < valid_count; ++p) {
-                    for (int i = 0; i < n; ++i) {
-                        for (int j = 0; j < m; ++j) {
-                            G(p, i + j * n) = C_lam(i, p) * C_mu(j, p);
-                        }
-                    }
-                }
-
-                Eigen::MatrixXd M1(valid_count, nm);
-                for (int p = 0; p < valid_count; ++p) {
-                    for (int idx = 0; idx < nm; ++idx) {
-                        double g_val = G(p, idx);
-                        double d_scaled = sF_norm[p] * g_val;
-
-                        double h_scaled = 0.0;
-                        auto it = std::find(constrained_indices.begin(), constrained_indices.end(), idx);
-                        if (it != constrained_indices.end()) {
-                            int r_pos = static_cast<int>(std::distance(constrained_indices.begin(), it));
-                            h_scaled = g_val * interp_values[r_pos];
-                        }
-                        M1(p, idx) = d_scaled - h_scaled;
-                    }
-                }
+                // 💡 只为新节点追加 Cauchy 核与节点对列，旧列的正交分解原样复用
+                if (added_lam) solver.add_lambda(lambda_star);
+                if (added_mu)  solver.add_mu(mu_star);
 
-                Eigen::MatrixXd M2(valid_count, u_count);
-                for (int s = 0; s < u_count; ++s) {
-                    int unconstrained_idx = unconstrained_indices[s];
-                    M2.col(s) = -G.col(unconstrained_idx);
-                }
+                solver.solve(r.alpha, r.beta);
+                r.lambda = Eigen::Map<const Eigen::VectorXd>(solver.lambda().data(), solver.lambda().size());
+                r.mu     = Eigen::Map<const Eigen::VectorXd>(solver.mu().data(), solver.mu().size());
 
-                Eigen::MatrixXd M_matrix;
-                if (u_count > 0) {
-                    M_matrix.resize(valid_count, nm + u_count);
-                    M_matrix.leftCols(nm) = M1;
-                    M_matrix.rightCols(u_count) = M2;
-                } else {
-                    M_matrix = M1;
-                }
-
-                Eigen::BDCSVD<Eigen::MatrixXd> svd(M_matrix, Eigen::ComputeThinV);
-                Eigen::VectorXd v_solution = svd.matrixV().col(M_matrix.cols() - 1);
-
-                Eigen::VectorXd alpha_vec = v_solution.head(nm);
-                Eigen::VectorXd beta_u = v_solution.tail(u_count);
-
-                Eigen::VectorXd beta_vec(nm);
-                for (int idx = 0; idx < nm; ++idx) {
-                    auto it = std::find(constrained_indices.begin(), constrained_indices.end(), idx);
-                    if (it != constrained_indices.end()) {
-                        int r_pos = static_cast<int>(std::distance(constrained_indices.begin(), it));
-                        beta_vec[idx] = alpha_vec[idx] * interp_values[r_pos];
-                    } else {
-                        auto it_u = std::find(unconstrained_indices.begin(), unconstrained_indices.end(), idx);
-                        int s_pos = static_cast<int>(std::distance(unconstrained_indices.begin(), it_u));
-                        beta_vec[idx] = beta_u[s_pos];
-                    }
-                }
-
-                r.lambda.resize(n);
-                for (int i = 0; i < n; ++i) r.lambda[i] = lambda_list[i];
-
-                r.mu.resize(m);
-                for (int j = 0; j < m; ++j) r.mu[j] = mu_list[j];
-
-                r.alpha = Eigen::Map<Eigen::MatrixXd>(alpha_vec.data(), n, m);
-                r.beta  = Eigen::Map<Eigen::MatrixXd>(beta_vec.data(), n, m);
-
-                double max_diff = 0.0;
-                for (int p = 0; p < valid_count; ++p) {
-                    double approx_val = r.evaluate(sX[p], sY[p]);
-                    double diff = 0.0;
-                    if (!std::isnan(approx_val) && !std::isinf(approx_val)) {
-                        diff = std::abs(sF[p] - approx_val);
-                    }
-                    max_diff = std::max(max_diff, diff);
-                }
-                error = max_diff / max_abs_F;
+                r.evaluate(span_X, span_Y, approx);
+                scan = detail::scan_residuals(sF, approx);
+                error = std::max(scan.max_err, 0.0) / max_abs_F;
 
                 iter++;
             }
@@ -425,7 +908,7 @@ namespace StuCanvas::utils
     {
     public:
         static BivariateHybridRationalLog fit(
-            const FfiFunction<double(double, double)>& f,
+            const StuFunction<double(double, double)>& f,
             const Eigen::VectorXd& X,
             const Eigen::VectorXd& Y,
             double tol = 1e-9,
@@ -659,7 +1142,7 @@ namespace StuCanvas::utils
                 return val;
             };
 
-            FfiFunction<double(double, double)> f_residue(f_residue_lambda);
+            StuFunction<double(double, double)> f_residue(f_residue_lambda);
 
             // 让原版 ScatteredPaaa 去解决被剥离后光滑得如同白纸的残差函数！
             BivariateBarycentricRational best_rational = ScatteredPaaa::fit(f_residue, sX, sY, tol, max_iters);
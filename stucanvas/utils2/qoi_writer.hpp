@@ -0,0 +1,315 @@
+/***************************************************************************
+ * Copyright (c) 2025-2026 Tian Yuxuan (Friendships666)                    *
+ *                                                                          *
+ * StuCanvas is licensed under Mulan PSL v2.                                *
+ * You can use this software according to the terms and conditions of the   *
+ * Mulan PSL v2.                                                            *
+ * You may obtain a copy of Mulan PSL v2 at:                                *
+ *          http://license.coscl.org.cn/MulanPSL2                           *
+ *                                                                          *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF     *
+ * ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO        *
+ * NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.      *
+ * See the Mulan PSL v2 for more details.                                   *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace StuCanvas
+{
+    namespace detail
+    {
+        constexpr uint8_t QOI_OP_INDEX = 0x00;
+        constexpr uint8_t QOI_OP_DIFF = 0x40;
+        constexpr uint8_t QOI_OP_LUMA = 0x80;
+        constexpr uint8_t QOI_OP_RUN = 0xc0;
+        constexpr uint8_t QOI_OP_RGB = 0xfe;
+        constexpr uint8_t QOI_OP_RGBA = 0xff;
+        constexpr uint8_t QOI_MASK_2 = 0xc0;
+
+        constexpr size_t qoi_header_size = 14;
+        constexpr size_t qoi_padding_size = 8;
+        constexpr size_t qoi_chunk_size = 64 * 1024;   ///< 编码游标所在的栈上分块大小
+        constexpr size_t qoi_max_op_size = 6;          ///< 单个像素最多产生的字节数 (RUN 收尾 1 + RGBA 5)
+
+        inline uint32_t qoiHash ( const uint8_t* px ) noexcept
+        {
+            return ( px[ 0 ] * 3u + px[ 1 ] * 5u + px[ 2 ] * 7u + px[ 3 ] * 11u ) % 64u;
+        }
+
+        /**
+         * @brief QOI 编码主体：游标写入栈上分块，分块将满时整块交给 sink (const uint8_t* begin, const uint8_t* end)
+         *
+         * 输出缓冲只按实际编码长度增长，不再预先按最坏情况 (每像素 5 字节) 分配并清零。
+         */
+        template < typename Sink >
+        inline void encodeQOIChunks ( const uint8_t* rgba, uint32_t width, uint32_t height, Sink&& sink )
+        {
+            uint8_t chunk[ qoi_chunk_size ];
+            uint8_t* p = chunk;
+            uint8_t* const flush_at = chunk + qoi_chunk_size - qoi_max_op_size;
+
+            auto write_u32 = [ &p ] ( uint32_t v )
+            {
+                *p++ = static_cast< uint8_t > ( v >> 24 );
+                *p++ = static_cast< uint8_t > ( v >> 16 );
+                *p++ = static_cast< uint8_t > ( v >> 8 );
+                *p++ = static_cast< uint8_t > ( v );
+            };
+
+            *p++ = 'q';
+            *p++ = 'o';
+            *p++ = 'i';
+            *p++ = 'f';
+            write_u32 ( width );
+            write_u32 ( height );
+            *p++ = 4;   // channels: RGBA
+            *p++ = 0;   // colorspace: sRGB + linear alpha
+
+            const size_t pixel_count = static_cast< size_t > ( width ) * height;
+
+            uint8_t index[ 64 ][ 4 ] = {};
+            uint8_t prev[ 4 ] = { 0, 0, 0, 255 };
+            uint32_t run = 0;
+
+            for ( size_t i = 0; i < pixel_count; ++i )
+            {
+                if ( p > flush_at ) [[unlikely]]
+                {
+                    sink ( static_cast< const uint8_t* > ( chunk ), static_cast< const uint8_t* > ( p ) );
+                    p = chunk;
+                }
+
+                const uint8_t* px = rgba + i * 4;
+
+                if ( std::memcmp ( px, prev, 4 ) == 0 )
+                {
+                    ++run;
+                    if ( run == 62 || i + 1 == pixel_count )
+                    {
+                        *p++ = static_cast< uint8_t > ( QOI_OP_RUN | ( run - 1 ) );
+                        run = 0;
+                    }
+                    continue;
+                }
+
+                if ( run > 0 )
+                {
+                    *p++ = static_cast< uint8_t > ( QOI_OP_RUN | ( run - 1 ) );
+                    run = 0;
+                }
+
+                const uint32_t hash = qoiHash ( px );
+
+                if ( std::memcmp ( index[ hash ], px, 4 ) == 0 )
+                {
+                    *p++ = static_cast< uint8_t > ( QOI_OP_INDEX | hash );
+                }
+                else
+                {
+                    std::memcpy ( index[ hash ], px, 4 );
+
+                    if ( px[ 3 ] == prev[ 3 ] )
+                    {
+                        const int8_t vr = static_cast< int8_t > ( px[ 0 ] - prev[ 0 ] );
+                        const int8_t vg = static_cast< int8_t > ( px[ 1 ] - prev[ 1 ] );
+                        const int8_t vb = static_cast< int8_t > ( px[ 2 ] - prev[ 2 ] );
+                        const int8_t vg_r = static_cast< int8_t > ( vr - vg );
+                        const int8_t vg_b = static_cast< int8_t > ( vb - vg );
+
+                        if ( vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2 )
+                        {
+                            *p++ = static_cast< uint8_t > ( QOI_OP_DIFF | ( vr + 2 ) << 4 | ( vg + 2 ) << 2 | ( vb + 2 ) );
+                        }
+                        else if ( vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8 )
+                        {
+                            *p++ = static_cast< uint8_t > ( QOI_OP_LUMA | ( vg + 32 ) );
+                            *p++ = static_cast< uint8_t > ( ( vg_r + 8 ) << 4 | ( vg_b + 8 ) );
+                        }
+                        else
+                        {
+                            *p++ = QOI_OP_RGB;
+                            *p++ = px[ 0 ];
+                            *p++ = px[ 1 ];
+                            *p++ = px[ 2 ];
+                        }
+                    }
+                    else
+                    {
+                        *p++ = QOI_OP_RGBA;
+                        *p++ = px[ 0 ];
+                        *p++ = px[ 1 ];
+                        *p++ = px[ 2 ];
+                        *p++ = px[ 3 ];
+                    }
+                }
+
+                std::memcpy ( prev, px, 4 );
+            }
+
+            if ( p + qoi_padding_size > chunk + qoi_chunk_size ) [[unlikely]]
+            {
+                sink ( static_cast< const uint8_t* > ( chunk ), static_cast< const uint8_t* > ( p ) );
+                p = chunk;
+            }
+
+            // 结束标记：7 个 0x00 + 1 个 0x01
+            for ( int k = 0; k < 7; ++k )
+            {
+                *p++ = 0;
+            }
+            *p++ = 1;
+
+            sink ( static_cast< const uint8_t* > ( chunk ), static_cast< const uint8_t* > ( p ) );
+        }
+    }   // namespace detail
+
+    /**
+     * @brief QOI (Quite OK Image) 无损编码器，仅支持 RGBA8 紧密排列输入
+     *
+     * QOI 的编码吞吐量比 zlib deflate 高一个数量级，适合离线序列帧导出时作为 PNG 的替代中间格式。
+     * 规范参见 https://qoiformat.org/qoi-specification.pdf
+     *
+     * @param rgba   紧密排列的 RGBA8 像素 (width * height * 4 字节)
+     * @param width  图像宽度
+     * @param height 图像高度
+     * @param out    输出字节流 (会被清空并复用其容量，按实际编码长度追加增长)
+     */
+    inline void encodeQOI ( const uint8_t* rgba, uint32_t width, uint32_t height, std::vector< uint8_t >& out )
+    {
+        out.clear ();
+        detail::encodeQOIChunks ( rgba, width, height,
+                                  [ &out ] ( const uint8_t* begin, const uint8_t* end )
+                                  { out.insert ( out.end (), begin, end ); } );
+    }
+
+    /**
+     * @brief QOI 解码器 (仅接受本编码器产出的 4 通道流)，用于导出结果校验
+     * @return 文件头或数据流非法时返回 false
+     */
+    inline bool decodeQOI ( const uint8_t* data, size_t size, std::vector< uint8_t >& rgba, uint32_t& width,
+                            uint32_t& height )
+    {
+        using namespace detail;
+
+        if ( size < qoi_header_size + qoi_padding_size || std::memcmp ( data, "qoif", 4 ) != 0 )
+        {
+            return false;
+        }
+
+        auto read_u32 = [ data ] ( size_t at )
+        {
+            return static_cast< uint32_t > ( data[ at ] ) << 24 | static_cast< uint32_t > ( data[ at + 1 ] ) << 16 |
+                   static_cast< uint32_t > ( data[ at + 2 ] ) << 8 | static_cast< uint32_t > ( data[ at + 3 ] );
+        };
+        width = read_u32 ( 4 );
+        height = read_u32 ( 8 );
+        if ( data[ 12 ] != 4 )
+        {
+            return false;
+        }
+
+        const size_t pixel_count = static_cast< size_t > ( width ) * height;
+        const size_t data_end = size - qoi_padding_size;
+        rgba.resize ( pixel_count * 4 );
+
+        uint8_t index[ 64 ][ 4 ] = {};
+        uint8_t px[ 4 ] = { 0, 0, 0, 255 };
+        size_t p = qoi_header_size;
+        uint32_t run = 0;
+
+        for ( size_t i = 0; i < pixel_count; ++i )
+        {
+            if ( run > 0 )
+            {
+                --run;
+            }
+            else
+            {
+                if ( p >= data_end )
+                {
+                    return false;
+                }
+
+                const uint8_t b1 = data[ p++ ];
+                if ( b1 == QOI_OP_RGB || b1 == QOI_OP_RGBA )
+                {
+                    const size_t n = b1 == QOI_OP_RGB ? 3 : 4;
+                    if ( p + n > data_end )
+                    {
+                        return false;
+                    }
+                    std::memcpy ( px, data + p, n );
+                    p += n;
+                }
+                else if ( ( b1 & QOI_MASK_2 ) == QOI_OP_INDEX )
+                {
+                    std::memcpy ( px, index[ b1 ], 4 );
+                }
+                else if ( ( b1 & QOI_MASK_2 ) == QOI_OP_DIFF )
+                {
+                    px[ 0 ] = static_cast< uint8_t > ( px[ 0 ] + ( ( b1 >> 4 ) & 0x03 ) - 2 );
+                    px[ 1 ] = static_cast< uint8_t > ( px[ 1 ] + ( ( b1 >> 2 ) & 0x03 ) - 2 );
+                    px[ 2 ] = static_cast< uint8_t > ( px[ 2 ] + ( b1 & 0x03 ) - 2 );
+                }
+                else if ( ( b1 & QOI_MASK_2 ) == QOI_OP_LUMA )
+                {
+                    if ( p >= data_end )
+                    {
+                        return false;
+                    }
+                    const uint8_t b2 = data[ p++ ];
+                    const int vg = ( b1 & 0x3f ) - 32;
+                    px[ 0 ] = static_cast< uint8_t > ( px[ 0 ] + vg - 8 + ( ( b2 >> 4 ) & 0x0f ) );
+                    px[ 1 ] = static_cast< uint8_t > ( px[ 1 ] + vg );
+                    px[ 2 ] = static_cast< uint8_t > ( px[ 2 ] + vg - 8 + ( b2 & 0x0f ) );
+                }
+                else
+                {
+                    run = b1 & 0x3f;
+                }
+
+                std::memcpy ( index[ qoiHash ( px ) ], px, 4 );
+            }
+
+            std::memcpy ( rgba.data () + i * 4, px, 4 );
+        }
+
+        static constexpr uint8_t padding[ qoi_padding_size ] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+        return p == data_end && std::memcmp ( data + data_end, padding, qoi_padding_size ) == 0;
+    }
+
+    /**
+     * @brief 将 RGBA8 像素以 QOI 格式写入磁盘
+     * @return 写入成功返回 true
+     */
+    inline bool writeQOI ( const std::string& file_path, const uint8_t* rgba, uint32_t width, uint32_t height )
+    {
+        // 编码缓冲区按线程复用，避免逐帧导出时反复申请数十 MB 的堆内存；
+        // 容量远超本帧所需时 (偶发的大分辨率帧之后) 收缩回本帧大小，不再永久占用峰值内存
+        constexpr size_t retain_slack = 4u << 20;
+        thread_local std::vector< uint8_t > encoded;
+        encodeQOI ( rgba, width, height, encoded );
+
+        std::ofstream out ( file_path, std::ios::binary );
+        bool ok = static_cast< bool > ( out );
+        if ( ok )
+        {
+            out.write ( reinterpret_cast< const char* > ( encoded.data () ),
+                        static_cast< std::streamsize > ( encoded.size () ) );
+            ok = static_cast< bool > ( out );
+        }
+
+        if ( encoded.capacity () > 2 * encoded.size () + retain_slack ) [[unlikely]]
+        {
+            encoded.shrink_to_fit ();
+        }
+        return ok;
+    }
+}   // namespace StuCanvas
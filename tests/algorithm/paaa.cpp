@@ -3,9 +3,10 @@
 #include <cmath>
 #include <random>
 #include <iomanip>
+#include <chrono>
 #include <Eigen/Dense>
 
-#include "stucanvas/utils/paaa.hpp"
+#include "stucanvas/utils2/paaa.hpp"
 
 using namespace StuCanvas::utils;
 
@@ -17,7 +18,46 @@ double test_transcendental_func(double x, double y) {
     return y - std::tan(x);
 }
 
+double test_smooth_func(double x, double y) {
+    return std::sin(x) * std::cos(y);
+}
+
+double test_pole_func(double x, double y) {
+    return std::exp(x * y) / (1.2 + x - 0.5 * y * y) + std::sin(3.0 * x);
+}
+
+// 💡 拟合精度回归：在独立测试点上取最大绝对误差，超出上限即判失败
+struct FitCheck {
+    double max_err = 0.0;
+    long nodes_x = 0;
+    long nodes_y = 0;
+};
+
+template <typename Fn>
+FitCheck fit_and_measure(Fn fn, int samples, double lo, double hi, double tol, int iters, std::mt19937& gen) {
+    std::uniform_real_distribution<double> dist(lo, hi);
+    Eigen::VectorXd X(samples), Y(samples);
+    for (int i = 0; i < samples; ++i) {
+        X[i] = dist(gen);
+        Y[i] = dist(gen);
+    }
+
+    StuFunction<double(double, double)> f([fn](double x, double y) { return fn(x, y); });
+    BivariateBarycentricRational r = ScatteredPaaa::fit(f, X, Y, tol, iters);
+
+    FitCheck check;
+    check.nodes_x = static_cast<long>(r.lambda.size());
+    check.nodes_y = static_cast<long>(r.mu.size());
+    for (int i = 0; i < 4000; ++i) {
+        double tx = dist(gen);
+        double ty = dist(gen);
+        check.max_err = std::max(check.max_err, std::abs(fn(tx, ty) - r(tx, ty)));
+    }
+    return check;
+}
+
 int main() {
+    int failures = 0;
     std::cout << "=========================================================" << std::endl;
     std::cout << "   ⚡ StuCanvas::utils::ScatteredPaaa 算法测试套件 ⚡   " << std::endl;
     std::cout << "=========================================================" << std::endl;
@@ -36,7 +76,7 @@ int main() {
         Y1[i] = dist_1(gen);
     }
 
-    FfiFunction<double(double, double)> f1([](double x, double y) {
+    StuFunction<double(double, double)> f1([](double x, double y) {
         return test_rational_func(x, y);
     });
 
@@ -51,6 +91,10 @@ int main() {
     }
     std::cout << std::scientific << std::setprecision(5);
     std::cout << "  > 测试点最大绝对误差: " << max_err_1 << std::endl;
+    if (!(max_err_1 < 1e-9)) {
+        std::cout << "  [FAIL] 有理函数应被精确还原" << std::endl;
+        ++failures;
+    }
 
     // ---------------------------------------------------------------------
     // 📌 测试二: 超越函数 y - ln(x) 拟合 (优化采样密度，压制虚假极点)
@@ -70,7 +114,7 @@ int main() {
         Y2[i] = dist_y2(gen);
     }
 
-    FfiFunction<double(double, double)> f2([](double x, double y) {
+    StuFunction<double(double, double)> f2([](double x, double y) {
         return test_transcendental_func(x, y);
     });
 
@@ -89,5 +133,61 @@ int main() {
 
     std::cout << "  > 2000 个随机渐近线测试点上的最大绝对误差: " << max_err_2 << std::endl;
 
-    return 0;
+    // ---------------------------------------------------------------------
+    // 📌 测试三: 光滑函数与近极点函数的拟合精度回归 (近零空间退化时零向量的选取)
+    // ---------------------------------------------------------------------
+    std::cout << "\n[测试 3] 拟合精度回归..." << std::endl;
+
+    const FitCheck smooth = fit_and_measure(test_smooth_func, 500, -1.0, 1.0, 1e-10, 40, gen);
+    std::cout << "  > sin(x)cos(y): 节点 " << smooth.nodes_x << "+" << smooth.nodes_y
+              << ", 最大绝对误差 " << smooth.max_err << std::endl;
+    if (!(smooth.max_err < 1e-5) || smooth.nodes_x > 16 || smooth.nodes_y > 16) {
+        std::cout << "  [FAIL] sin(x)cos(y) 拟合精度或节点数回退" << std::endl;
+        ++failures;
+    }
+
+    const FitCheck pole = fit_and_measure(test_pole_func, 500, -0.5, 0.5, 1e-10, 40, gen);
+    std::cout << "  > exp(xy)/(1.2+x-0.5y^2)+sin(3x): 节点 " << pole.nodes_x << "+" << pole.nodes_y
+              << ", 最大绝对误差 " << pole.max_err << std::endl;
+    if (!(pole.max_err < 1e-7) || pole.nodes_x > 16 || pole.nodes_y > 16) {
+        std::cout << "  [FAIL] 近极点函数拟合精度或节点数回退" << std::endl;
+        ++failures;
+    }
+
+    // ---------------------------------------------------------------------
+    // 📌 测试四: 大样本计时 (K = 50000，近零空间退化后仍走增量小系统，不再逐轮构造显式 M)
+    // ---------------------------------------------------------------------
+    std::cout << "\n[测试 4] 大样本增量求解计时..." << std::endl;
+    {
+        const int K4 = 50000;
+        const int iters4 = 12;
+        std::uniform_real_distribution<double> dist_4(-1.0, 1.0);
+        Eigen::VectorXd X4(K4), Y4(K4);
+        for (int i = 0; i < K4; ++i) {
+            X4[i] = dist_4(gen);
+            Y4[i] = dist_4(gen);
+        }
+        StuFunction<double(double, double)> f4([](double x, double y) { return test_smooth_func(x, y); });
+
+        const auto t0 = std::chrono::steady_clock::now();
+        BivariateBarycentricRational r4 = ScatteredPaaa::fit(f4, X4, Y4, 1e-13, iters4);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        double max_err_4 = 0.0;
+        for (int i = 0; i < 4000; ++i) {
+            double tx = dist_4(gen);
+            double ty = dist_4(gen);
+            max_err_4 = std::max(max_err_4, std::abs(test_smooth_func(tx, ty) - r4(tx, ty)));
+        }
+        std::cout << "  > sin(x)cos(y), K=" << K4 << ", " << iters4 << " 轮: 节点 " << r4.lambda.size() << "+" << r4.mu.size()
+                  << ", 耗时 " << std::fixed << std::setprecision(2) << seconds << " s"
+                  << std::scientific << std::setprecision(5) << ", 最大绝对误差 " << max_err_4 << std::endl;
+        if (!(max_err_4 < 1e-8)) {
+            std::cout << "  [FAIL] 大样本拟合精度回退" << std::endl;
+            ++failures;
+        }
+    }
+
+    std::cout << (failures ? "\nScatteredPaaa: FAILED" : "\nScatteredPaaa: all passed") << std::endl;
+    return failures ? 1 : 0;
 }
\ No newline at end of file
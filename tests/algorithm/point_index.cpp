@@ -0,0 +1,94 @@
+#include "../stucanvas/sobject/point_index.hpp"
+#include <iostream>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+using namespace StuCanvas;
+
+struct P2 { double x, y; };
+struct P3 { double x, y, z; };
+
+// k-d 树的最近邻 / k 近邻结果与暴力扫描逐一比对，返回不一致的查询数
+template <int Dim, typename P>
+int check_against_brute_force(const std::vector<P>& pts, std::mt19937& rng, int queries, size_t k) {
+    PointKdTree<double, Dim> tree(pts);
+    std::uniform_real_distribution<double> u(-3.0, 3.0);
+    std::vector<typename PointKdTree<double, Dim>::Neighbor> knn;
+    std::vector<double> dist2(pts.size());
+
+    int bad = 0;
+    for (int q = 0; q < queries; ++q) {
+        std::array<double, Dim> Q;
+        for (int a = 0; a < Dim; ++a) Q[a] = u(rng);
+
+        size_t best = 0;
+        for (size_t i = 0; i < pts.size(); ++i) {
+            double d = (pts[i].x - Q[0]) * (pts[i].x - Q[0]) + (pts[i].y - Q[1]) * (pts[i].y - Q[1]);
+            if constexpr (Dim == 3) d += (pts[i].z - Q[2]) * (pts[i].z - Q[2]);
+            dist2[i] = d;
+            if (d < dist2[best]) best = i;
+        }
+
+        if (pts.empty()) {
+            if (tree.nearest(Q) != PointKdTree<double, Dim>::npos) ++bad;
+        } else if (dist2[tree.nearest(Q)] != dist2[best]) {
+            ++bad; // 距离并列时下标可以不同，只比较距离
+        }
+
+        tree.k_nearest(Q, k, knn);
+        std::vector<double> sorted = dist2;
+        std::sort(sorted.begin(), sorted.end());
+        const size_t expect = std::min(k, pts.size());
+        if (knn.size() != expect) { ++bad; continue; }
+        for (size_t j = 0; j < expect; ++j) {
+            if (knn[j].dist2 != sorted[j] || dist2[knn[j].index] != sorted[j]) { ++bad; break; }
+        }
+    }
+    return bad;
+}
+
+int main() {
+    std::mt19937 rng(20240611);
+    std::normal_distribution<double> n(0.0, 1.0);
+    int failures = 0;
+
+    auto report = [&](const char* name, size_t count, int bad) {
+        std::cout << (bad ? "[FAIL] " : "[ OK ] ") << name << " n=" << count;
+        if (bad) std::cout << " mismatches=" << bad;
+        std::cout << "\n";
+        failures += bad;
+    };
+
+    for (int N : { 0, 1, 5, 33, 1000, 20000 }) {
+        std::vector<P2> cloud2(N);
+        for (auto& p : cloud2) p = { n(rng), n(rng) };
+        report("gaussian 2D", cloud2.size(), check_against_brute_force<2>(cloud2, rng, 200, 8));
+
+        std::vector<P3> cloud3(N);
+        for (auto& p : cloud3) p = { n(rng), n(rng), n(rng) };
+        report("gaussian 3D", cloud3.size(), check_against_brute_force<3>(cloud3, rng, 200, 8));
+
+        // 曲线采样（吸附 / 切线解算的典型输入：一维流形上的有序点列）
+        std::vector<P2> curve(N);
+        for (int i = 0; i < N; ++i) {
+            const double t = 6.283185307179586 * i / N;
+            curve[i] = { 2.0 * std::cos(3.0 * t), 2.0 * std::sin(2.0 * t) };
+        }
+        report("lissajous 2D", curve.size(), check_against_brute_force<2>(curve, rng, 200, 8));
+    }
+
+    // 大量重合点：划分无法分开时也必须正确返回
+    std::vector<P2> duplicates(500, P2{ 1.0, 1.0 });
+    report("duplicates 2D", duplicates.size(), check_against_brute_force<2>(duplicates, rng, 50, 8));
+
+    // k 大于点数时返回全部点
+    std::vector<P3> few(3);
+    for (auto& p : few) p = { n(rng), n(rng), n(rng) };
+    report("k > n 3D", few.size(), check_against_brute_force<3>(few, rng, 20, 16));
+
+    std::cout << (failures ? "point_index: FAILED" : "point_index: all passed") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,188 @@
+#include "../stucanvas/objects/dag/typst_tessellator.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <numbers>
+
+using namespace StuCanvas;
+
+using Verbs = std::vector<PathVerb>;
+using Points = std::vector<::Point2D>;
+
+// 三角网格的总面积：剖分结果互不重叠时应等于按填充规则计算的精确面积
+double fill_area(const DAGAssets::TriangleMesh3D_SoA& mesh) {
+    double area = 0.0;
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+        const uint32_t a = mesh.indices[t], b = mesh.indices[t + 1], c = mesh.indices[t + 2];
+        area += 0.5 * std::abs((mesh.x[b] - mesh.x[a]) * (mesh.y[c] - mesh.y[a]) -
+                               (mesh.x[c] - mesh.x[a]) * (mesh.y[b] - mesh.y[a]));
+    }
+    return area;
+}
+
+// 追加一个闭合多边形轮廓
+void add_polygon(Points& pts, Verbs& verbs, std::initializer_list<::Point2D> poly) {
+    bool first = true;
+    for (const ::Point2D& p : poly) {
+        pts.push_back(p);
+        verbs.push_back(first ? PathVerb::MoveTo : PathVerb::LineTo);
+        first = false;
+    }
+    verbs.push_back(PathVerb::Close);
+}
+
+void add_square(Points& pts, Verbs& verbs, double x0, double y0, double x1, double y1, bool ccw) {
+    if (ccw) add_polygon(pts, verbs, { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } });
+    else     add_polygon(pts, verbs, { { x0, y0 }, { x0, y1 }, { x1, y1 }, { x1, y0 } });
+}
+
+double area_of(const Points& pts, const Verbs& verbs, FillRule rule, double tol = 1e-3) {
+    TessellatedGeometry geom;
+    detail::typst_tess::tessellate({ pts, verbs }, tol, rule, geom);
+    return fill_area(geom.fill);
+}
+
+// 一个 Outline 视图：字段指向调用方持有的 vector，析构前置空，避免交给 Rust 侧释放
+struct OutlineView {
+    Outline outline;
+    OutlineView(std::vector<SharedGeometry>& geometries, std::vector<DrawInstance>& instances) {
+        outline.geometries = { geometries.data(), geometries.size(), geometries.size() };
+        outline.instances = { instances.data(), instances.size(), instances.size() };
+    }
+    ~OutlineView() {
+        outline.geometries = { nullptr, 0, 0 };
+        outline.instances = { nullptr, 0, 0 };
+    }
+};
+
+SharedGeometry make_rect(uint32_t id, double w, double h) {
+    SharedGeometry g{};
+    g.geometry_id = id;
+    g.geometry.ty = GeometryType::Rect;
+    g.geometry.data.rect.origin = { 0.0, 0.0 };
+    g.geometry.data.rect.width = w;
+    g.geometry.data.rect.height = h;
+    return g;
+}
+
+DrawInstance make_fill(uint32_t geometry_id) {
+    DrawInstance inst{};
+    inst.geometry_id = geometry_id;
+    inst.transform = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 };
+    inst.fill_paint.ty = PaintType::Solid;
+    inst.fill_rule = FillRule::NonZero;
+    return inst;
+}
+
+int main() {
+    int failures = 0;
+    auto check = [&](const char* name, double got, double expect, double eps = 1e-6) {
+        const bool ok = std::abs(got - expect) <= eps * std::max(1.0, std::abs(expect));
+        std::cout << (ok ? "[ OK ] " : "[FAIL] ") << name << " got=" << got << " expect=" << expect << "\n";
+        failures += ok ? 0 : 1;
+    };
+
+    // 1. 孔洞：内轮廓反向，两种规则都挖空
+    {
+        Points p; Verbs v;
+        add_square(p, v, 0, 0, 10, 10, true);
+        add_square(p, v, 3, 3, 7, 7, false);
+        check("hole (reversed) NonZero", area_of(p, v, FillRule::NonZero), 84.0);
+        check("hole (reversed) EvenOdd", area_of(p, v, FillRule::EvenOdd), 84.0);
+    }
+
+    // 2. 同向嵌套：NonZero 环绕数为 2 仍填充，EvenOdd 挖空
+    {
+        Points p; Verbs v;
+        add_square(p, v, 0, 0, 10, 10, true);
+        add_square(p, v, 3, 3, 7, 7, true);
+        check("nested (same dir) NonZero", area_of(p, v, FillRule::NonZero), 100.0);
+        check("nested (same dir) EvenOdd", area_of(p, v, FillRule::EvenOdd), 84.0);
+    }
+
+    // 3. 部分重叠：重叠区不得重复输出
+    {
+        Points p; Verbs v;
+        add_square(p, v, 0, 0, 10, 10, true);
+        add_square(p, v, 5, 5, 15, 15, true);
+        check("overlap NonZero", area_of(p, v, FillRule::NonZero), 175.0);
+        check("overlap EvenOdd", area_of(p, v, FillRule::EvenOdd), 150.0);
+    }
+
+    // 4. 自交 (蝴蝶结)：两片三角形环绕数分别为 ±1
+    {
+        Points p; Verbs v;
+        add_polygon(p, v, { { 0, 0 }, { 10, 10 }, { 10, 0 }, { 0, 10 } });
+        check("bowtie NonZero", area_of(p, v, FillRule::NonZero), 50.0);
+        check("bowtie EvenOdd", area_of(p, v, FillRule::EvenOdd), 50.0);
+    }
+
+    // 5. 五角星：中心五边形环绕数为 2，NonZero 填充、EvenOdd 挖空
+    {
+        const double R = 10.0, pi = std::numbers::pi;
+        Points p; Verbs v;
+        for (int k = 0; k < 5; ++k) {
+            const double a = pi / 2 + k * 4 * pi / 5;
+            p.push_back({ R * std::cos(a), R * std::sin(a) });
+            v.push_back(k == 0 ? PathVerb::MoveTo : PathVerb::LineTo);
+        }
+        v.push_back(PathVerb::Close);
+
+        const double r = R * std::cos(2 * pi / 5) / std::cos(pi / 5);
+        const double star = 5.0 * R * r * std::sin(pi / 5);
+        const double pentagon = 2.5 * r * r * std::sin(2 * pi / 5);
+        check("pentagram NonZero", area_of(p, v, FillRule::NonZero), star);
+        check("pentagram EvenOdd", area_of(p, v, FillRule::EvenOdd), star - pentagon);
+    }
+
+    // 6. 曲线展平：四段三次贝塞尔逼近的圆，面积误差受容差约束
+    {
+        const double R = 10.0, k = 0.5522847498307936 * R, tol = 1e-3;
+        Points p = { { R, 0 }, { R, k }, { k, R }, { 0, R }, { -k, R }, { -R, k }, { -R, 0 },
+                     { -R, -k }, { -k, -R }, { 0, -R }, { k, -R }, { R, -k }, { R, 0 } };
+        Verbs v = { PathVerb::MoveTo, PathVerb::CubicTo, PathVerb::CubicTo, PathVerb::CubicTo, PathVerb::CubicTo, PathVerb::Close };
+        // 贝塞尔圆本身与真圆的半径偏差约 2.7e-4·R
+        check("cubic circle NonZero", area_of(p, v, FillRule::NonZero, tol), std::numbers::pi * R * R,
+              2.0 * (tol + 2.8e-4 * R) / R);
+    }
+
+    // 7. 缓存：同一几何共享条目；超出预算时只淘汰更早帧的条目，空出的下标被复用
+    {
+        std::vector<SharedGeometry> geoms = { make_rect(0, 10, 10), make_rect(1, 20, 4), make_rect(2, 30, 2) };
+        std::vector<DrawInstance> frame0 = { make_fill(0), make_fill(0), make_fill(1) };
+        std::vector<DrawInstance> frame1 = { make_fill(2) };
+        std::vector<DrawInstance> frame2 = { make_fill(0) };
+
+        TypstTessellator tess(0.25, 1);
+        std::vector<TessellatedDraw> draws;
+        {
+            OutlineView view(geoms, frame0);
+            tess.tessellate(view.outline, 1.0, draws);
+        }
+        const bool shared = draws.size() == 3 && draws[0].geometry == draws[1].geometry && draws[0].geometry != draws[2].geometry;
+        check("cache shares geometry", shared ? 1.0 : 0.0, 1.0);
+        // 当前帧用到的条目即使超出预算也保留
+        check("cache keeps current frame", static_cast<double>(tess.cacheSize()), 2.0, 0.0);
+
+        tess.nextFrame();
+        draws.clear();
+        {
+            OutlineView view(geoms, frame1);
+            tess.tessellate(view.outline, 1.0, draws);
+        }
+        check("cache evicts older frames", static_cast<double>(tess.cacheSize()), 1.0, 0.0);
+        check("cache new entry", fill_area(tess.geometry(draws[0].geometry).fill), 60.0);
+
+        tess.nextFrame();
+        draws.clear();
+        {
+            OutlineView view(geoms, frame2);
+            tess.tessellate(view.outline, 1.0, draws);
+        }
+        check("cache reuses freed slot", draws[0].geometry < 3 ? 1.0 : 0.0, 1.0);
+        check("cache rebuilds evicted entry", fill_area(tess.geometry(draws[0].geometry).fill), 100.0);
+    }
+
+    std::cout << (failures ? "typst_tessellator: FAILED" : "typst_tessellator: all passed") << std::endl;
+    return failures ? 1 : 0;
+}
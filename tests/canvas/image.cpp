@@ -4,7 +4,9 @@
 #define VMA_IMPLEMENTATION
 
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <span>
 #include <vector>
 
@@ -121,6 +123,46 @@ int main ()
         queue.exportImage ( slot, out_file );
 
         std::cout << "🎉 测试成功！画面已完好写入到: " << out_file << "\n";
+
+        // =====================================================================
+        // 4. 🚀 异步流水线序列导出：渲染线程只负责录制与提交，回读与编码交给工作线程
+        // =====================================================================
+        std::cout << "正在以异步流水线导出 16 帧序列...\n";
+        for ( int f = 0; f < 16; ++f )
+        {
+            point_obj.data.point_3d.x = -1.0 + 0.125 * f;
+
+            queue.recordImage_DAGInst ( instances_to_render, slot, generic_camera );
+            queue.submitGraphics ();
+
+            std::string seq_file = "sequence_" + std::to_string ( f ) + ".qoi";
+            queue.exportImageAsync ( slot, seq_file, ImageExportFormat::QOI );
+            queue.exportImageAsync ( slot, "sequence_" + std::to_string ( f ) + ".raw", ImageExportFormat::RAW );
+        }
+        queue.flushExports ();
+
+        // 逐帧解码 QOI，并与同一帧的 RAW 回读像素逐字节比对
+        auto read_file = [] ( const std::string& path )
+        {
+            std::ifstream in ( path, std::ios::binary );
+            return std::vector< uint8_t > ( std::istreambuf_iterator< char > ( in ), std::istreambuf_iterator< char > () );
+        };
+        for ( int f = 0; f < 16; ++f )
+        {
+            const std::vector< uint8_t > encoded = read_file ( "sequence_" + std::to_string ( f ) + ".qoi" );
+            const std::vector< uint8_t > source = read_file ( "sequence_" + std::to_string ( f ) + ".raw" );
+
+            std::vector< uint8_t > decoded;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            if ( !decodeQOI ( encoded.data (), encoded.size (), decoded, width, height ) || width != 2560 ||
+                 height != 1600 || decoded != source )
+            {
+                std::cerr << "❌ 第 " << f << " 帧 QOI 解码结果与回读像素不一致\n";
+                return EXIT_FAILURE;
+            }
+        }
+        std::cout << "🎉 序列导出完成，16 帧 QOI 均与源像素逐字节一致！\n";
     }
     catch ( const std::exception& e )
     {
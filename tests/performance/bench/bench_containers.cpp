@@ -0,0 +1,702 @@
+/***************************************************************************
+* Copyright (c) 2026 Tian Yuxuan (Friendships666)                          *
+*                                                                          *
+* Distributed under the terms of the MIT License.                          *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+***************************************************************************/
+
+// 容器 / 内存 / 调度相关的基准用例（由原先零散的 tests/performance/*.cpp 移植而来）
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <taskflow/taskflow.hpp>
+
+#include "block_deque.hpp"
+#include "compact_string.hpp"
+#include "flat_map.hpp"
+#include "function.hpp"
+#include "intern_table.hpp"
+#include "pinned_vector.hpp"
+#include "small_object_pool.hpp"
+#include "tiny_vector.hpp"
+
+#include "stu_bench.hpp"
+
+using namespace StuCanvas::utils;
+using namespace StuCanvas::bench;
+
+namespace {
+    struct LargeData { double v[32]; }; // 256 B，对应 tiny_vector_test
+
+    struct Payload { uint64_t id; double x, y, z; };
+
+    // cpu_cache_test_1：热数据内联、冷数据外置 vs 冷热一起内联展开
+    constexpr size_t ColdSize = 2000;
+    struct ObjectUnexpanded { uint32_t type; double hot[8]; std::vector<double> cold; };
+    struct ObjectExpanded { uint32_t type; double hot[8]; double cold[ColdSize]; };
+
+    std::vector<int*> make_pointer_keys(size_t n, std::vector<std::unique_ptr<int>>& owner)
+    {
+        std::vector<int*> keys;
+        keys.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            owner.push_back(std::make_unique<int>(static_cast<int>(i)));
+            keys.push_back(owner.back().get());
+        }
+        return keys;
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// TinyVector
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("tiny_vector/push2_destroy_256B") {
+    const LargeData a{}, b{};
+    state.run([&] {
+        TinyVector<LargeData> vec;
+        vec.push_back(a);
+        vec.push_back(b);
+        do_not_optimize(vec);
+    });
+}
+
+STU_BENCH("std_vector/push2_destroy_256B") {
+    const LargeData a{}, b{};
+    state.run([&] {
+        std::vector<LargeData> vec;
+        vec.push_back(a);
+        vec.push_back(b);
+        do_not_optimize(vec);
+    });
+}
+
+STU_BENCH("tiny_vector/push_iterate_1k_double") {
+    state.set_items_per_iteration(1024);
+    state.run([&] {
+        TinyVector<double> vec;
+        for (int i = 0; i < 1024; ++i) vec.push_back(static_cast<double>(i));
+        double sum = 0;
+        for (size_t i = 0; i < vec.size(); ++i) sum += vec[i];
+        do_not_optimize(sum);
+    });
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// BlockDeque vs std::deque（指针偏特化）
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("block_deque/push_back_64k_ptr") {
+    state.set_items_per_iteration(65536);
+    state.run([&] {
+        BlockDeque<int*, 1024> deque;
+        for (uintptr_t i = 1; i <= 65536; ++i) deque.push_back(reinterpret_cast<int*>(i << 4));
+        do_not_optimize(deque);
+    });
+}
+
+STU_BENCH("std_deque/push_back_64k_ptr") {
+    state.set_items_per_iteration(65536);
+    state.run([&] {
+        std::deque<int*> deque;
+        for (uintptr_t i = 1; i <= 65536; ++i) deque.push_back(reinterpret_cast<int*>(i << 4));
+        do_not_optimize(deque);
+    });
+}
+
+STU_BENCH("block_deque/concurrent_writer_64k") {
+    state.set_items_per_iteration(65536);
+    state.run([&] {
+        ConcurrentBlockDeque<Payload> deque;
+        {
+            auto writer = deque.writer();
+            for (uint64_t i = 0; i < 65536; ++i) writer.push_back(Payload{ i, 0.0, 1.0, 2.0 });
+        }
+        do_not_optimize(deque);
+    });
+}
+
+// 并行收集绘图结果：任务写局部 SoA 后持锁合并（旧做法） vs 每线程一个 Writer 独占整块写入、结束后按块导出 SoA
+namespace {
+    constexpr size_t GatherTasks = 256;
+    constexpr size_t GatherPerTask = 2'000;
+
+    Payload gather_vertex(size_t task, size_t i) { return Payload{ task, double(task), double(i), double(task ^ i) }; }
+}
+
+STU_BENCH("block_deque/gather_mutex_merge") {
+    const unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    state.set_items_per_iteration(static_cast<double>(GatherTasks * GatherPerTask));
+    state.run([&] {
+        TinyVector<double> out_x, out_y, out_z;
+        std::mutex out_mutex;
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < workers; ++w) {
+            threads.emplace_back([&, w] {
+                for (size_t task = w; task < GatherTasks; task += workers) {
+                    TinyVector<double> lx, ly, lz;
+                    for (size_t i = 0; i < GatherPerTask; ++i) {
+                        const Payload v = gather_vertex(task, i);
+                        lx.push_back(v.x);
+                        ly.push_back(v.y);
+                        lz.push_back(v.z);
+                    }
+                    std::scoped_lock lock(out_mutex);
+                    out_x.append(lx);
+                    out_y.append(ly);
+                    out_z.append(lz);
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        do_not_optimize(out_x);
+    });
+}
+
+STU_BENCH("block_deque/gather_writers_soa_export") {
+    const unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    size_t gathered_total = 0;
+    state.set_items_per_iteration(static_cast<double>(GatherTasks * GatherPerTask));
+    state.run([&] {
+        ConcurrentBlockDeque<Payload> gathered;
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < workers; ++w) {
+            threads.emplace_back([&, w] {
+                auto writer = gathered.writer();
+                for (size_t task = w; task < GatherTasks; task += workers)
+                    for (size_t i = 0; i < GatherPerTask; ++i) writer.push_back(gather_vertex(task, i));
+            });
+        }
+        for (auto& th : threads) th.join();
+
+        TinyVector<double> out_x, out_y, out_z;
+        const size_t n = gathered.size();
+        out_x.resize(n);
+        out_y.resize(n);
+        out_z.resize(n);
+        gathered.for_each_run([&](const Payload* run, size_t count, size_t first) {
+            for (size_t i = 0; i < count; ++i) {
+                out_x[first + i] = run[i].x;
+                out_y[first + i] = run[i].y;
+                out_z[first + i] = run[i].z;
+            }
+        });
+        do_not_optimize(out_x);
+        gathered_total = n;
+    });
+    if (gathered_total != GatherTasks * GatherPerTask) {
+        throw std::runtime_error("block_deque/gather_writers_soa_export: lost elements");
+    }
+}
+
+// 共享尾块原子槽位：所有线程零散 push_back
+STU_BENCH("block_deque/concurrent_shared_push_back") {
+    const unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    state.set_items_per_iteration(static_cast<double>(workers) * 65536);
+    state.run([&] {
+        ConcurrentBlockDeque<uint64_t> shared;
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < workers; ++w) {
+            threads.emplace_back([&, w] {
+                for (uint64_t i = 0; i < 65536; ++i) shared.push_back((uint64_t(w) << 32) | i);
+            });
+        }
+        for (auto& th : threads) th.join();
+        do_not_optimize(shared);
+    });
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// FlatMap（指针键）
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("flat_map/insert_100k_ptr") {
+    std::vector<std::unique_ptr<int>> owner;
+    const std::vector<int*> keys = make_pointer_keys(100'000, owner);
+    state.set_items_per_iteration(static_cast<double>(keys.size()));
+    state.run([&] {
+        FlatMap<int*, uint64_t> map;
+        for (size_t i = 0; i < keys.size(); ++i) map.insert(keys[i], i);
+        do_not_optimize(map);
+    });
+}
+
+STU_BENCH("flat_map/find_100k_ptr_half_hits") {
+    std::vector<std::unique_ptr<int>> owner;
+    const std::vector<int*> keys = make_pointer_keys(200'000, owner);
+    FlatMap<int*, uint64_t> map;
+    for (size_t i = 0; i < keys.size(); i += 2) map.insert(keys[i], i);
+    std::vector<int*> lookups(keys.begin(), keys.begin() + 100'000);
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937(42));
+    state.set_items_per_iteration(static_cast<double>(lookups.size()));
+    state.run([&] {
+        uint64_t sum = 0;
+        for (int* k : lookups) {
+            auto it = map.find(k);
+            if (it != map.end()) sum += it->second;
+        }
+        do_not_optimize(sum);
+    });
+}
+
+// 线性探查与 SwissTable 控制字节两种模式：各自填到扩容阈值之下（Linear 约 0.69，Swiss 约 0.87），一半命中一半未命中
+namespace {
+    int* synthetic_key(size_t i) { return reinterpret_cast<int*>(0x10000000 + i * 16); }
+
+    template <FlatMapMode Mode>
+    void bench_high_load_find(State& state, size_t live)
+    {
+        constexpr size_t Capacity = 1u << 20;
+        std::mt19937 rng(1337);
+        std::vector<int*> keys(live);
+        for (size_t i = 0; i < live; ++i) keys[i] = synthetic_key(i);
+        std::shuffle(keys.begin(), keys.end(), rng);
+
+        FlatMap<int*, uint64_t, Mode> map(Capacity);
+        for (size_t i = 0; i < live; ++i) map.insert(keys[i], i);
+
+        std::vector<int*> lookups;
+        lookups.reserve(1'000'000);
+        for (size_t i = 0; i < 500'000; ++i) lookups.push_back(keys[i % live]);
+        for (size_t i = 0; i < 500'000; ++i) lookups.push_back(synthetic_key(0x1000000 + i));
+        std::shuffle(lookups.begin(), lookups.end(), rng);
+
+        state.set_items_per_iteration(static_cast<double>(lookups.size()));
+        state.run([&] {
+            uint64_t sum = 0;
+            for (int* k : lookups) {
+                auto it = map.find(k);
+                if (it != map.end()) sum += it->second;
+            }
+            do_not_optimize(sum);
+        });
+    }
+
+    // 滑动窗口增删 6 轮（300k 存活键）之后的失败查找：Linear 模式的墓碑不计入负载，探查链随之变长
+    template <FlatMapMode Mode>
+    void bench_miss_after_churn(State& state, size_t capacity)
+    {
+        constexpr size_t Live = 300'000;
+        constexpr size_t RoundSize = 100'000;
+        FlatMap<int*, uint64_t, Mode> map(capacity);
+        for (size_t i = 0; i < Live; ++i) map.insert(synthetic_key(i), i);
+        for (size_t i = 0; i < 6 * RoundSize; ++i) {
+            map.erase(synthetic_key(i));
+            map.insert(synthetic_key(i + Live), i);
+        }
+
+        std::vector<int*> misses(1'000'000);
+        for (size_t i = 0; i < misses.size(); ++i) misses[i] = synthetic_key(0x4000000 + i);
+        state.set_items_per_iteration(static_cast<double>(misses.size()));
+        state.run([&] {
+            uint64_t sum = 0;
+            for (int* k : misses) {
+                auto it = map.find(k);
+                if (it != map.end()) sum += it->second;
+            }
+            do_not_optimize(sum);
+        });
+    }
+}
+
+STU_BENCH("flat_map/linear_find_1M_load069") { bench_high_load_find<FlatMapMode::Linear>(state, (1u << 20) * 69 / 100); }
+STU_BENCH("flat_map/swiss_find_1M_load069") { bench_high_load_find<FlatMapMode::Swiss>(state, (1u << 20) * 69 / 100); }
+STU_BENCH("flat_map/swiss_find_1M_load087") { bench_high_load_find<FlatMapMode::Swiss>(state, (1u << 20) * 87 / 100); }
+
+STU_BENCH("flat_map/linear_miss_after_churn_1M") { bench_miss_after_churn<FlatMapMode::Linear>(state, 1u << 20); }
+STU_BENCH("flat_map/swiss_miss_after_churn_1M") { bench_miss_after_churn<FlatMapMode::Swiss>(state, 1u << 19); }
+
+// 小表高频增删（图谱缓存反复失效）：Swiss 依靠原位重哈希保持容量不变；Linear 的墓碑在恒定规模下永不回收，不参与
+STU_BENCH("flat_map/swiss_small_erase_reinsert_64k") {
+    FlatMap<int*, uint64_t, FlatMapMode::Swiss> map;
+    size_t next = 0;
+    for (; next < 48; ++next) map.insert(synthetic_key(next), next);
+    state.set_items_per_iteration(65536);
+    state.run([&] {
+        for (int i = 0; i < 65536; ++i, ++next) {
+            map.insert(synthetic_key(next), next);
+            map.erase(synthetic_key(next - 48));
+        }
+        do_not_optimize(map);
+    });
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// PinnedVector
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("pinned_vector/emplace_back_1M") {
+    state.set_items_per_iteration(1'000'000);
+    state.run([&] {
+        PinnedVector<Payload, 2> vec;
+        for (uint64_t i = 0; i < 1'000'000; ++i) vec.emplace_back(Payload{ i, 0.0, 1.0, 2.0 });
+        do_not_optimize(vec);
+    });
+}
+
+STU_BENCH("std_vector/emplace_back_1M") {
+    state.set_items_per_iteration(1'000'000);
+    state.run([&] {
+        std::vector<Payload> vec;
+        for (uint64_t i = 0; i < 1'000'000; ++i) vec.emplace_back(Payload{ i, 0.0, 1.0, 2.0 });
+        do_not_optimize(vec);
+    });
+}
+
+// 页面策略：200 万个 64 字节图节点（128 MB）串成随机环，随机指针追逐是最坏的 TLB 访问模式
+namespace {
+    struct alignas(64) ChaseNode {
+        uint32_t next = 0;
+        uint32_t payload[15]{};
+    };
+
+    template <PinnedPolicy Policy>
+    void bench_pointer_chase(State& state)
+    {
+        constexpr size_t N = 2u << 20;
+        std::vector<uint32_t> order(N);
+        std::iota(order.begin(), order.end(), 0u);
+        std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+        PinnedVector<ChaseNode, 1, Policy> pool;
+        for (size_t i = 0; i < N; ++i) pool.emplace_back();
+        for (size_t i = 0; i < N; ++i) pool[order[i]].next = order[(i + 1) % N];
+
+        uint32_t cur = order[0];
+        state.set_items_per_iteration(1 << 16);
+        state.run([&] {
+            for (int s = 0; s < (1 << 16); ++s) cur = pool[cur].next;
+            do_not_optimize(cur);
+        });
+    }
+}
+
+STU_BENCH("pinned_vector/chase_4k_pages") { bench_pointer_chase<PinnedPolicy{}>(state); }
+STU_BENCH("pinned_vector/chase_2m_thp") { bench_pointer_chase<PinnedPolicy{ .huge_pages = true }>(state); }
+STU_BENCH("pinned_vector/chase_2m_thp_prefault") { bench_pointer_chase<PinnedPolicy{ .huge_pages = true, .prefault = true }>(state); }
+STU_BENCH("pinned_vector/chase_4k_prefault_interleave") {
+    bench_pointer_chase<PinnedPolicy{ .prefault = true, .numa = NumaPlacement::Interleave }>(state);
+}
+STU_BENCH("pinned_vector/chase_2m_thp_prefault_interleave") {
+    bench_pointer_chase<PinnedPolicy{ .huge_pages = true, .prefault = true, .numa = NumaPlacement::Interleave }>(state);
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// CPU 缓存：热字段遍历，冷数据外置 vs 内联
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("cpu_cache/hot_scan_cold_outlined") {
+    std::vector<ObjectUnexpanded> objects(10'000);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        for (int j = 0; j < 8; ++j) objects[i].hot[j] = static_cast<double>(i + j);
+        objects[i].cold.resize(ColdSize, 1.0);
+    }
+    state.set_items_per_iteration(static_cast<double>(objects.size()));
+    state.run([&] {
+        double sum = 0;
+        for (const auto& o : objects)
+            for (double h : o.hot) sum += h;
+        do_not_optimize(sum);
+    });
+}
+
+STU_BENCH("cpu_cache/hot_scan_cold_inline") {
+    std::vector<ObjectExpanded> objects(10'000);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        for (int j = 0; j < 8; ++j) objects[i].hot[j] = static_cast<double>(i + j);
+        std::fill(std::begin(objects[i].cold), std::end(objects[i].cold), 1.0);
+    }
+    state.set_items_per_iteration(static_cast<double>(objects.size()));
+    state.run([&] {
+        double sum = 0;
+        for (const auto& o : objects)
+            for (double h : o.hot) sum += h;
+        do_not_optimize(sum);
+    });
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// 小对象池 / 闭包 / 符号驻留
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("small_object_pool/tiny_vector_mixed_capacity") {
+    std::mt19937 rng(7);
+    std::vector<uint32_t> sizes(4096);
+    for (auto& s : sizes) s = 1u + (rng() & 255u);
+    state.set_items_per_iteration(static_cast<double>(sizes.size()));
+    state.run([&] {
+        uint64_t sum = 0;
+        for (uint32_t n : sizes) {
+            TinyVector<double> v;
+            for (uint32_t k = 0; k < n; ++k) v.push_back(static_cast<double>(k));
+            sum += v.size();
+        }
+        do_not_optimize(sum);
+    });
+}
+
+// 绘图器模式：工作线程各自构建输出向量，主线程合并后统一释放；跨线程释放经归还链表回到工作线程
+STU_BENCH("small_object_pool/workers_alloc_main_frees") {
+    const unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<std::vector<TinyVector<double>>> outputs(workers);
+    state.set_items_per_iteration(static_cast<double>(workers) * 4096);
+    uint32_t round = 0;
+    state.run([&] {
+        ++round;
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < workers; ++w) {
+            threads.emplace_back([&, w] {
+                std::mt19937 rng(w * 131 + round);
+                auto& out = outputs[w];
+                out.resize(4096);
+                for (auto& v : out) {
+                    const uint32_t n = 2u + (rng() & 127u);
+                    for (uint32_t k = 0; k < n; ++k) v.push_back(k * 0.5);
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        for (auto& out : outputs) out.clear();
+    });
+}
+
+STU_BENCH("small_object_pool/compact_string_churn_10k") {
+    std::vector<CompactString> batch;
+    batch.reserve(10'000);
+    state.set_items_per_iteration(10'000);
+    state.run([&] {
+        batch.clear();
+        for (int i = 0; i < 10'000; ++i) {
+            CompactString s("label_");
+            s.append(std::to_string(i).c_str());
+            batch.push_back(std::move(s));
+        }
+        do_not_optimize(batch);
+    });
+}
+
+// 峰值过后归还内存：退出的工作线程留下约 100 MB 块，主线程全部释放，仓库越过高水位后整 chunk 归还系统
+STU_BENCH("small_object_pool/peak_100MB_then_release") {
+    const uint64_t released_before = small_pool_stats().chunks_released;
+    std::vector<TinyVector<double>> peak;
+    state.run([&] {
+        peak.resize(100'000);
+        std::thread([&] {
+            for (auto& v : peak)
+                for (uint32_t k = 0; k < 100; ++k) v.push_back(k);
+        }).join();
+        peak.clear();
+    });
+    if (small_pool_stats().chunks_released == released_before) {
+        throw std::runtime_error("small_object_pool/peak_100MB_then_release: no chunk was returned to the OS");
+    }
+}
+
+// 构造 + 移动进容器 + 销毁（每个资产 / 代价函数新建一个闭包），以及同一闭包的热调用
+namespace {
+    double plain_fn(double x, double y) { return x * y - 1.0; }
+
+    auto two_doubles(double a) { const double b = a * 0.5; return [a, b](double x, double y) { return a * x + b * y; }; }
+
+    auto capture_32B(double a)
+    {
+        const double c[4] = { a, a + 1, a + 2, a + 3 };
+        return [c](double x, double y) { return c[0] * x + c[1] * y + c[2] - c[3]; };
+    }
+
+    auto capture_64B(double a)
+    {
+        const double c[8] = { a, a + 1, a + 2, a + 3, a + 4, a + 5, a + 6, a + 7 };
+        return [c](double x, double y) { return c[0] * x + c[1] * y + c[2] - c[3] + c[4] * c[5] - c[6] * c[7]; };
+    }
+
+    template <typename Fn, typename Make>
+    void bench_construct_move(State& state, Make make)
+    {
+        std::vector<Fn> fns, moved;
+        fns.reserve(1024);
+        moved.reserve(1024);
+        state.set_items_per_iteration(1024);
+        state.run([&] {
+            fns.clear();
+            moved.clear();
+            for (int i = 0; i < 1024; ++i) fns.emplace_back(make(static_cast<double>(i)));
+            for (auto& f : fns) moved.push_back(std::move(f));
+            do_not_optimize(moved);
+        });
+    }
+
+    template <typename Fn>
+    void bench_call(State& state, const Fn& fn)
+    {
+        state.set_items_per_iteration(1024);
+        state.run([&] {
+            double acc = 0;
+            for (int i = 0; i < 1024; ++i) acc += fn(static_cast<double>(i), 0.5);
+            do_not_optimize(acc);
+        });
+    }
+
+    using SF = StuFunction<double(double, double)>;
+    using STD = std::function<double(double, double)>;
+}
+
+STU_BENCH("function/construct_move_inline") { bench_construct_move<SF>(state, two_doubles); }
+STU_BENCH("std_function/construct_move_inline") { bench_construct_move<STD>(state, two_doubles); }
+STU_BENCH("function/construct_move_captureless") { bench_construct_move<SF>(state, [](double) { return [](double x, double y) { return x + y; }; }); }
+STU_BENCH("std_function/construct_move_captureless") { bench_construct_move<STD>(state, [](double) { return [](double x, double y) { return x + y; }; }); }
+STU_BENCH("function/construct_move_32B") { bench_construct_move<SF>(state, capture_32B); }
+STU_BENCH("std_function/construct_move_32B") { bench_construct_move<STD>(state, capture_32B); }
+STU_BENCH("function/construct_move_64B_heap") { bench_construct_move<SF>(state, capture_64B); }
+STU_BENCH("std_function/construct_move_64B_heap") { bench_construct_move<STD>(state, capture_64B); }
+STU_BENCH("function/construct_move_fn_ptr") { bench_construct_move<SF>(state, [](double) { return &plain_fn; }); }
+STU_BENCH("std_function/construct_move_fn_ptr") { bench_construct_move<STD>(state, [](double) { return &plain_fn; }); }
+
+STU_BENCH("function/call_inline") {
+    SF fn = two_doubles(3.0);
+    {
+        // 内联闭包装箱交给 FFI 再接管回来，调用结果不变；空函数指针构造出空函数
+        SF boxed = two_doubles(3.0);
+        auto* block = boxed.release();
+        const double via_block = block->invoker(block->context, 1.0, 1.0);
+        SF back;
+        back.acquire(block);
+        double (*null_fn)(double, double) = nullptr;
+        const SF from_null = null_fn;
+        if (boxed || from_null || via_block != fn(1.0, 1.0) || back(1.0, 1.0) != fn(1.0, 1.0)) {
+            throw std::runtime_error("function/call_inline: FFI release / acquire round trip mismatch");
+        }
+    }
+    state.set_items_per_iteration(1024);
+    state.run([&] {
+        double acc = 0;
+        for (int i = 0; i < 1024; ++i) acc += fn(static_cast<double>(i), 0.5);
+        do_not_optimize(acc);
+    });
+}
+
+STU_BENCH("std_function/call_inline") { bench_call(state, STD(two_doubles(3.0))); }
+STU_BENCH("function/call_32B") { bench_call(state, SF(capture_32B(3.0))); }
+STU_BENCH("function/call_fn_ptr") { bench_call(state, SF(&plain_fn)); }
+STU_BENCH("std_function/call_fn_ptr") { bench_call(state, STD(&plain_fn)); }
+
+STU_BENCH("intern/lookup_hit_10k") {
+    std::vector<std::string> names;
+    for (int i = 0; i < 10'000; ++i) {
+        names.push_back("bench_obj_" + std::to_string(i));
+        (void)InternTable::global().intern(names.back());
+    }
+    state.set_items_per_iteration(static_cast<double>(names.size()));
+    state.run([&] {
+        uint64_t sum = 0;
+        for (const auto& n : names) sum += InternedString::lookup(n).id();
+        do_not_optimize(sum);
+    });
+}
+
+// DAG 场景的命名分布：大量节点沿用类型默认名，少量节点有唯一名；按名称全表扫描 = 逐节点字符串比较 vs 一次查表 + 整数比较
+namespace {
+    std::string dag_style_name(int i)
+    {
+        static const char* defaults[] = { "FreePoint2d", "Segment2d", "Circle2d", "MidPoint2d", "P1" };
+        if (i % 10 != 0) return defaults[i % 5];
+        return "user_point_" + std::to_string(i);
+    }
+}
+
+STU_BENCH("intern/assign_100k_compact_string") {
+    std::vector<std::string> names;
+    for (int i = 0; i < 100'000; ++i) names.push_back(dag_style_name(i));
+    std::vector<CompactString> handles(names.size());
+    state.set_items_per_iteration(static_cast<double>(names.size()));
+    state.run([&] {
+        for (size_t i = 0; i < names.size(); ++i) handles[i] = names[i].c_str();
+        do_not_optimize(handles);
+    });
+}
+
+STU_BENCH("intern/assign_100k_interned") {
+    std::vector<std::string> names;
+    for (int i = 0; i < 100'000; ++i) names.push_back(dag_style_name(i));
+    std::vector<InternedString> handles(names.size());
+    state.set_items_per_iteration(static_cast<double>(names.size()));
+    state.run([&] {
+        for (size_t i = 0; i < names.size(); ++i) handles[i] = names[i];
+        do_not_optimize(handles);
+    });
+}
+
+STU_BENCH("intern/find_by_name_string_compare_100k") {
+    std::vector<CompactString> nodes(100'000);
+    for (int i = 0; i < 100'000; ++i) nodes[i] = dag_style_name(i).c_str();
+    const std::string query = dag_style_name(37 * 30);
+    state.set_items_per_iteration(static_cast<double>(nodes.size()));
+    state.run([&] {
+        size_t hits = 0;
+        for (const auto& s : nodes) hits += static_cast<std::string_view>(s) == query;
+        do_not_optimize(hits);
+    });
+}
+
+STU_BENCH("intern/find_by_name_symbol_compare_100k") {
+    std::vector<InternedString> nodes(100'000);
+    for (int i = 0; i < 100'000; ++i) nodes[i] = dag_style_name(i);
+    const std::string query = dag_style_name(37 * 30);
+    state.set_items_per_iteration(static_cast<double>(nodes.size()));
+    state.run([&] {
+        const InternedString key = InternedString::lookup(query);
+        size_t hits = 0;
+        for (const auto& s : nodes) hits += s == key;
+        do_not_optimize(hits);
+    });
+}
+
+// 多线程并发驻留同一批名字；同名必须得到同一 id
+STU_BENCH("intern/concurrent_intern_10k") {
+    const unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<std::string> names;
+    for (int i = 0; i < 10'000; ++i) names.push_back("obj_" + std::to_string(i));
+    std::vector<std::vector<uint32_t>> ids(workers, std::vector<uint32_t>(names.size()));
+    state.set_items_per_iteration(static_cast<double>(workers * names.size()));
+    state.run([&] {
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < workers; ++w) {
+            threads.emplace_back([&, w] {
+                for (size_t i = 0; i < names.size(); ++i) ids[w][i] = InternTable::global().intern(names[i]);
+            });
+        }
+        for (auto& th : threads) th.join();
+    });
+    for (unsigned w = 1; w < workers; ++w) {
+        if (ids[w] != ids[0]) throw std::runtime_error("intern/concurrent_intern_10k: inconsistent ids across threads");
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// Taskflow：扇出 + 汇合（对应 taskflow_test 的分层图）
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("taskflow/fan_out_256") {
+    tf::Executor executor;
+    std::vector<double> slots(256);
+    state.set_items_per_iteration(static_cast<double>(slots.size()));
+    state.run([&] {
+        tf::Taskflow taskflow;
+        auto join = taskflow.emplace([&] { do_not_optimize(std::accumulate(slots.begin(), slots.end(), 0.0)); });
+        for (size_t i = 0; i < slots.size(); ++i) {
+            taskflow.emplace([&slots, i] {
+                double v = 0;
+                for (int k = 0; k < 64; ++k) v += std::sqrt(static_cast<double>(i * 64 + k));
+                slots[i] = v;
+            }).precede(join);
+        }
+        executor.run(taskflow).wait();
+    });
+}
@@ -0,0 +1,160 @@
+/***************************************************************************
+* Copyright (c) 2026 Tian Yuxuan (Friendships666)                          *
+*                                                                          *
+* Distributed under the terms of the MIT License.                          *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+***************************************************************************/
+
+// DAG 求值 / 隐函数绘图 / 优化器 / 区间算术的基准用例
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "interval.hpp"
+#include "l_shade.hpp"
+#include "stucanvas/objects/dag/graph.hpp"
+#include "stucanvas/objects/dag/plotter.hpp"
+
+#include "stu_bench.hpp"
+
+using namespace StuCanvas;
+using namespace StuCanvas::bench;
+
+namespace {
+    // 一层自由点 -> 相邻点对的中点 -> 中点之间的线段，共 3 层依赖
+    struct MidpointLattice {
+        DAGraph graph;
+        std::vector<DAGObject*> free_points;
+
+        explicit MidpointLattice(size_t n)
+        {
+            std::mt19937 rng(3);
+            std::uniform_real_distribution<double> u(-10.0, 10.0);
+            for (size_t i = 0; i < n; ++i) free_points.push_back(&graph.createFreePoint2D(u(rng), u(rng)));
+            std::vector<DAGObject*> mids;
+            for (size_t i = 0; i + 1 < n; ++i) mids.push_back(&graph.createMidPoint2D(*free_points[i], *free_points[i + 1]));
+            for (size_t i = 0; i + 1 < mids.size(); ++i) graph.createSegment2D(*mids[i], *mids[i + 1]);
+            graph.evaluate();
+        }
+    };
+
+    double rastrigin(double x, double y)
+    {
+        constexpr double two_pi = 6.283185307179586;
+        return 20.0 + x * x - 10.0 * std::cos(two_pi * x) + y * y - 10.0 * std::cos(two_pi * y);
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// DAGraph::evaluate：单点拖动（局部脏传播）与全量拖动
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("dag/evaluate_drag_one_point_10k") {
+    MidpointLattice lattice(10'000);
+    double t = 0;
+    state.run([&] {
+        t += 0.001;
+        lattice.graph.modifyFreePoint2D(*lattice.free_points[5'000], std::cos(t), std::sin(t));
+        lattice.graph.evaluate();
+    });
+}
+
+STU_BENCH("dag/evaluate_drag_all_points_2k") {
+    MidpointLattice lattice(2'000);
+    double t = 0;
+    state.set_items_per_iteration(static_cast<double>(lattice.free_points.size()));
+    state.run([&] {
+        t += 0.001;
+        for (DAGObject* p : lattice.free_points) lattice.graph.modifyFreePoint2D(*p, p->data.point_2d.x + t, p->data.point_2d.y);
+        lattice.graph.evaluate();
+    });
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// 隐函数绘图（与 /tests/algorithm 中的曲面 / 曲线一致）
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("plot/marching_squares_2d") {
+    const utils::StuFunction<double(double, double)> f = [](double x, double y) {
+        return std::sin(3 * x) * std::cos(2 * y) + 0.1 * x * y - 0.2;
+    };
+    DAGAssets::LineStrip2D_SoA strip;
+    state.run([&] {
+        marchingSquares2D(f, -5, 5, -5, 5, 0.01, 3, 0, strip);
+        do_not_optimize(strip);
+    });
+}
+
+STU_BENCH("plot/marching_cubes_3d") {
+    const utils::StuFunction<double(double, double, double)> f = [](double x, double y, double z) {
+        return x * x + y * y + z * z - 1.0 + 0.1 * std::sin(5 * x);
+    };
+    DAGAssets::TriangleMesh3D_SoA mesh;
+    state.run([&] {
+        marchingCubes3D(f, -1.5, 1.5, -1.5, 1.5, -1.5, 1.5, 0.02, 0, mesh);
+        do_not_optimize(mesh);
+    });
+}
+
+STU_BENCH("plot/implicit_2d_lshade") {
+    const utils::StuFunction<double(double, double)> f = [](double x, double y) {
+        return std::abs(x * x + y * y - 4.0);
+    };
+    utils::optimization::l_shade_parameters<double, 2> params;
+    params.lower_bounds = { -3.0, -3.0 };
+    params.upper_bounds = { 3.0, 3.0 };
+    params.NP_init = 40;
+    params.max_evaluations = 2'000;
+    params.seed = 42;
+    DAGAssets::PointCloud2D_SoA cloud;
+    state.run([&] {
+        cloud.x.clear();
+        cloud.y.clear();
+        plotImplicit2D(f, 0.25, 0.25, params, cloud);
+        do_not_optimize(cloud);
+    });
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// L-SHADE（Rastrigin，固定种子，评估次数收敛到几毫秒的量级）
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("optimization/l_shade_rastrigin_2d") {
+    utils::optimization::l_shade_parameters<double, 2> params;
+    params.lower_bounds = { -5.12, -5.12 };
+    params.upper_bounds = { 5.12, 5.12 };
+    params.NP_init = 60;
+    params.max_evaluations = 20'000;
+    params.seed = 7;
+    params.threads = 1;
+    state.set_items_per_iteration(static_cast<double>(params.max_evaluations));
+    state.run([&] {
+        auto best = utils::optimization::l_shade(rastrigin, params);
+        do_not_optimize(best);
+    });
+}
+
+// ─────────────────────────────────────────────────────────────────────────
+// 区间算术
+// ─────────────────────────────────────────────────────────────────────────
+STU_BENCH("interval/set_arith_div_1k") {
+    using utils::Interval;
+    using utils::IntervalSet;
+    std::vector<IntervalSet<double>> xs, ys;
+    for (int i = 0; i < 1024; ++i) {
+        const double c = -8.0 + i * (16.0 / 1024);
+        xs.emplace_back(Interval<double>(c, c + 0.05));
+        ys.emplace_back(IntervalSet<double>{ Interval<double>(-c - 1.0, -c - 0.5), Interval<double>(c, c + 0.25) });
+    }
+    state.set_items_per_iteration(static_cast<double>(xs.size()));
+    state.run([&] {
+        size_t pieces = 0;
+        for (size_t i = 0; i < xs.size(); ++i) {
+            // 分母跨零时除法会把结果拆成多段，覆盖 IntervalSet 的归并路径
+            const IntervalSet<double> r = (xs[i] * ys[i] + 0.5) / (ys[i] - xs[i]) - xs[i];
+            pieces += r.intervals.size();
+        }
+        do_not_optimize(pieces);
+    });
+}
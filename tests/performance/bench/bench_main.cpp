@@ -0,0 +1,403 @@
+/***************************************************************************
+* Copyright (c) 2026 Tian Yuxuan (Friendships666)                          *
+*                                                                          *
+* Distributed under the terms of the MIT License.                          *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+***************************************************************************/
+
+// stucanvas_bench 命令行入口
+//
+//   stucanvas_bench [--list] [--filter=SUBSTR] [--reps=N] [--warmup=N] [--min-time-ms=X]
+//                   [--pin=CPUS] [--json=OUT.json] [--compare=BASELINE.json] [--threshold=PCT]
+//                   [--trace=TRACE.json]
+//
+//   --pin=0 / --pin=0-3 / --pin=0,2   在创建任何工作线程之前绑定整个进程（之后的线程继承该亲和性）
+//   --json                            写出机器可读结果（可作为下次 --compare 的基线）
+//   --compare                         与基线逐项对比中位数；中位数变慢超过阈值、且本次最好成绩
+//                                     也慢于基线中位数时判为回归，进程以返回码 1 退出
+//   --trace                           导出 STU_PROFILE_ZONE 记录的 Chrome Trace（需以 STUCANVAS_PROFILING=ON 构建；
+//                                     每线程只保留最近的区段）
+//
+// 典型流程：升级前  stucanvas_bench --pin=2 --json=base.json
+//           升级后  stucanvas_bench --pin=2 --json=new.json --compare=base.json
+
+#include <cctype>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "profiling.hpp"
+#include "stu_bench.hpp"
+
+using namespace StuCanvas::bench;
+
+namespace
+{
+    struct Cli
+    {
+        Options options;
+        std::string filter;
+        std::string pin;
+        std::string json_out;
+        std::string compare;
+        std::string trace_out;
+        double threshold_pct = 5.0;
+        bool list = false;
+    };
+
+    bool parse_flag(std::string_view arg, std::string_view key, std::string& out)
+    {
+        if (arg.substr(0, key.size()) != key) return false;
+        out = std::string(arg.substr(key.size()));
+        return true;
+    }
+
+    Cli parse_cli(int argc, char** argv)
+    {
+        Cli cli;
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            std::string v;
+            if (arg == "--list") cli.list = true;
+            else if (parse_flag(arg, "--filter=", v)) cli.filter = v;
+            else if (parse_flag(arg, "--reps=", v)) cli.options.repetitions = static_cast<uint32_t>(std::max(1, std::atoi(v.c_str())));
+            else if (parse_flag(arg, "--warmup=", v)) cli.options.warmup = static_cast<uint32_t>(std::max(0, std::atoi(v.c_str())));
+            else if (parse_flag(arg, "--min-time-ms=", v)) cli.options.min_rep_ms = std::max(0.01, std::atof(v.c_str()));
+            else if (parse_flag(arg, "--pin=", v)) cli.pin = v;
+            else if (parse_flag(arg, "--json=", v)) cli.json_out = v;
+            else if (parse_flag(arg, "--compare=", v)) cli.compare = v;
+            else if (parse_flag(arg, "--threshold=", v)) cli.threshold_pct = std::atof(v.c_str());
+            else if (parse_flag(arg, "--trace=", v)) cli.trace_out = v;
+            else {
+                std::cerr << "unknown argument: " << arg << "\n";
+                std::exit(2);
+            }
+        }
+        return cli;
+    }
+
+    // "0-3,6" -> {0,1,2,3,6}
+    std::vector<int> parse_cpu_list(const std::string& spec)
+    {
+        std::vector<int> cpus;
+        std::stringstream ss(spec);
+        std::string part;
+        while (std::getline(ss, part, ',')) {
+            const size_t dash = part.find('-');
+            if (dash == std::string::npos) {
+                cpus.push_back(std::atoi(part.c_str()));
+            } else {
+                const int lo = std::atoi(part.substr(0, dash).c_str());
+                const int hi = std::atoi(part.substr(dash + 1).c_str());
+                for (int c = lo; c <= hi; ++c) cpus.push_back(c);
+            }
+        }
+        return cpus;
+    }
+
+    bool pin_process(const std::vector<int>& cpus)
+    {
+        if (cpus.empty()) return false;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c : cpus) CPU_SET(c, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+        DWORD_PTR mask = 0;
+        for (int c : cpus) mask |= DWORD_PTR(1) << c;
+        return SetProcessAffinityMask(GetCurrentProcess(), mask) != 0;
+#else
+        return false;
+#endif
+    }
+
+    std::string json_escape(std::string_view s)
+    {
+        std::string out;
+        for (char c : s) {
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default: out += c;
+            }
+        }
+        return out;
+    }
+
+    std::string compiler_id()
+    {
+#if defined(__clang__)
+        return "clang " + std::to_string(__clang_major__) + "." + std::to_string(__clang_minor__);
+#elif defined(__GNUC__)
+        return "gcc " + std::to_string(__GNUC__) + "." + std::to_string(__GNUC_MINOR__);
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    void write_json(const std::string& path, const Cli& cli, const std::vector<Result>& results)
+    {
+        std::ofstream out(path);
+        out << std::setprecision(17);
+        out << "{\n  \"context\": {\n";
+        out << "    \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n";
+        out << "    \"compiler\": \"" << json_escape(compiler_id()) << "\",\n";
+#if defined(NDEBUG)
+        out << "    \"assertions\": false,\n";
+#else
+        out << "    \"assertions\": true,\n";
+#endif
+        out << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"pin\": \"" << json_escape(cli.pin) << "\",\n";
+        out << "    \"repetitions\": " << cli.options.repetitions << ",\n";
+        out << "    \"warmup\": " << cli.options.warmup << ",\n";
+        out << "    \"min_rep_ms\": " << cli.options.min_rep_ms << "\n  },\n";
+        out << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << "    {\"name\": \"" << json_escape(r.name) << "\", \"iterations\": " << r.iterations
+                << ", \"repetitions\": " << r.repetitions << ", \"items_per_iteration\": " << r.items_per_iteration
+                << ", \"min_ns\": " << r.stats.min_ns << ", \"median_ns\": " << r.stats.median_ns
+                << ", \"mean_ns\": " << r.stats.mean_ns << ", \"stddev_ns\": " << r.stats.stddev_ns
+                << ", \"p90_ns\": " << r.stats.p90_ns << ", \"max_ns\": " << r.stats.max_ns << ", \"samples_ns\": [";
+            for (size_t k = 0; k < r.samples_ns.size(); ++k) out << (k ? ", " : "") << r.samples_ns[k];
+            out << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+    // ─────────────────────────────────────────────────────────────────────
+    // 极简 JSON 读取：只需从基线文件中取出 results[*].{name, min_ns, median_ns}
+    // ─────────────────────────────────────────────────────────────────────
+    class JsonScanner
+    {
+    public:
+        explicit JsonScanner(std::string text) : m_text(std::move(text)) {}
+
+        struct Baseline { double min_ns = 0, median_ns = 0; };
+
+        bool read_results(std::map<std::string, Baseline>& out)
+        {
+            const size_t key = m_text.find("\"results\"");
+            if (key == std::string::npos) return false;
+            m_pos = m_text.find('[', key);
+            if (m_pos == std::string::npos) return false;
+            ++m_pos;
+            for (;;) {
+                skip_ws();
+                if (peek() == ']') return true;
+                if (peek() == ',') { ++m_pos; continue; }
+                if (peek() != '{') return false;
+                ++m_pos;
+                std::string name;
+                Baseline b;
+                for (;;) {
+                    skip_ws();
+                    if (peek() == '}') { ++m_pos; break; }
+                    if (peek() == ',') { ++m_pos; continue; }
+                    std::string field;
+                    if (!read_string(field)) return false;
+                    skip_ws();
+                    if (peek() != ':') return false;
+                    ++m_pos;
+                    skip_ws();
+                    if (peek() == '"') {
+                        std::string value;
+                        if (!read_string(value)) return false;
+                        if (field == "name") name = value;
+                    } else if (peek() == '[') {
+                        m_pos = m_text.find(']', m_pos);
+                        if (m_pos == std::string::npos) return false;
+                        ++m_pos;
+                    } else {
+                        const double value = read_number();
+                        if (field == "min_ns") b.min_ns = value;
+                        else if (field == "median_ns") b.median_ns = value;
+                    }
+                }
+                if (!name.empty()) out[name] = b;
+            }
+        }
+
+    private:
+        char peek() const { return m_pos < m_text.size() ? m_text[m_pos] : '\0'; }
+
+        void skip_ws()
+        {
+            while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) ++m_pos;
+        }
+
+        bool read_string(std::string& out)
+        {
+            if (peek() != '"') return false;
+            ++m_pos;
+            while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+                if (m_text[m_pos] == '\\' && m_pos + 1 < m_text.size()) {
+                    ++m_pos;
+                    out += m_text[m_pos] == 'n' ? '\n' : m_text[m_pos];
+                } else {
+                    out += m_text[m_pos];
+                }
+                ++m_pos;
+            }
+            ++m_pos;
+            return true;
+        }
+
+        double read_number()
+        {
+            const char* begin = m_text.c_str() + m_pos;
+            char* end = nullptr;
+            const double v = std::strtod(begin, &end);
+            m_pos += static_cast<size_t>(end - begin);
+            if (end == begin) ++m_pos; // true / false / null：跳过首字符，其余由外层循环吞掉
+            while (std::isalpha(static_cast<unsigned char>(peek()))) ++m_pos;
+            return v;
+        }
+
+        std::string m_text;
+        size_t m_pos = 0;
+    };
+
+    std::string format_ns(double ns)
+    {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(2);
+        if (ns >= 1e9) os << ns / 1e9 << " s";
+        else if (ns >= 1e6) os << ns / 1e6 << " ms";
+        else if (ns >= 1e3) os << ns / 1e3 << " us";
+        else os << ns << " ns";
+        return os.str();
+    }
+
+    // 返回回归项数
+    int compare_with_baseline(const std::string& path, const std::vector<Result>& results, double threshold_pct)
+    {
+        std::ifstream in(path);
+        if (!in) {
+            std::cerr << "cannot open baseline " << path << "\n";
+            return -1;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        std::map<std::string, JsonScanner::Baseline> baseline;
+        if (!JsonScanner(buffer.str()).read_results(baseline)) {
+            std::cerr << "malformed baseline " << path << "\n";
+            return -1;
+        }
+
+        const double limit = 1.0 + threshold_pct / 100.0;
+        int regressions = 0, improvements = 0;
+        std::cout << "\n=== compare vs " << path << " (threshold " << threshold_pct << "%) ===\n";
+        for (const Result& r : results) {
+            auto it = baseline.find(r.name);
+            if (it == baseline.end() || it->second.median_ns <= 0) {
+                std::cout << "  [new]        " << r.name << "\n";
+                continue;
+            }
+            const double ratio = r.stats.median_ns / it->second.median_ns;
+            const char* verdict = "  [same]       ";
+            // 既要求中位数越过阈值，也要求本次最好成绩劣于基线中位数，降低噪声误报
+            if (ratio > limit && r.stats.min_ns > it->second.median_ns) {
+                verdict = "  [REGRESSION] ";
+                ++regressions;
+            } else if (ratio < 1.0 / limit && r.stats.min_ns < it->second.median_ns) {
+                verdict = "  [faster]     ";
+                ++improvements;
+            }
+            std::cout << verdict << std::left << std::setw(44) << r.name << std::right << std::setw(12)
+                      << format_ns(it->second.median_ns) << " -> " << std::setw(12) << format_ns(r.stats.median_ns)
+                      << "  (" << std::showpos << std::fixed << std::setprecision(1) << (ratio - 1.0) * 100.0
+                      << std::noshowpos << "%)\n";
+        }
+        std::cout << "  " << regressions << " regression(s), " << improvements << " improvement(s)\n";
+        return regressions;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const Cli cli = parse_cli(argc, argv);
+
+    if (cli.list) {
+        for (const Case& c : registry()) std::cout << c.name << "\n";
+        return 0;
+    }
+
+    if (!cli.pin.empty()) {
+        if (!pin_process(parse_cpu_list(cli.pin))) std::cerr << "warning: CPU pinning (" << cli.pin << ") failed\n";
+    }
+#if !defined(NDEBUG)
+    std::cerr << "warning: assertions are enabled; timings are not representative\n";
+#endif
+
+    std::vector<Result> results;
+    std::cout << std::left << std::setw(46) << "benchmark" << std::right << std::setw(12) << "median" << std::setw(12)
+              << "min" << std::setw(10) << "cv%" << std::setw(14) << "items/s" << std::setw(10) << "iters" << "\n";
+    for (const Case& c : registry()) {
+        if (!cli.filter.empty() && std::string_view(c.name).find(cli.filter) == std::string_view::npos) continue;
+
+        State state(cli.options);
+        c.fn(state);
+        if (!state.ran()) continue;
+
+        Result r;
+        r.name = c.name;
+        r.iterations = state.iterations();
+        r.repetitions = cli.options.repetitions;
+        r.items_per_iteration = state.items_per_iteration();
+        r.samples_ns = state.samples();
+        r.stats = Stats::from(r.samples_ns);
+
+        const double cv = r.stats.mean_ns > 0 ? 100.0 * r.stats.stddev_ns / r.stats.mean_ns : 0.0;
+        std::cout << std::left << std::setw(46) << r.name << std::right << std::setw(12) << format_ns(r.stats.median_ns)
+                  << std::setw(12) << format_ns(r.stats.min_ns) << std::setw(10) << std::fixed << std::setprecision(1)
+                  << cv << std::setw(14);
+        if (r.items_per_iteration > 0) {
+            std::cout << std::scientific << std::setprecision(3) << r.items_per_iteration * 1e9 / r.stats.median_ns;
+        } else {
+            std::cout << "-";
+        }
+        std::cout << std::defaultfloat << std::setw(10) << r.iterations << std::endl;
+        results.push_back(std::move(r));
+    }
+
+    if (!cli.json_out.empty()) {
+        write_json(cli.json_out, cli, results);
+        std::cout << "\nresults written to " << cli.json_out << "\n";
+    }
+
+    if (!cli.trace_out.empty()) {
+        if (StuCanvas::utils::profiling::export_chrome_trace(cli.trace_out.c_str())) {
+            std::cout << "trace written to " << cli.trace_out << "\n";
+        } else {
+            std::cerr << "warning: trace not written (built without STUCANVAS_PROFILING?)\n";
+        }
+    }
+
+    if (!cli.compare.empty()) {
+        const int regressions = compare_with_baseline(cli.compare, results, cli.threshold_pct);
+        if (regressions != 0) return regressions < 0 ? 2 : 1;
+    }
+    return 0;
+}
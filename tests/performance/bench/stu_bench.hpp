@@ -0,0 +1,174 @@
+/***************************************************************************
+* Copyright (c) 2026 Tian Yuxuan (Friendships666)                          *
+*                                                                          *
+* Distributed under the terms of the MIT License.                          *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+***************************************************************************/
+
+#pragma once
+// =========================================================================
+// 🚀 统一基准测试框架（stucanvas_bench）
+// =========================================================================
+// 💡 用法：
+//   STU_BENCH("group/case") {
+//       ... 准备数据（不计时）...
+//       state.run([&] { ... 被测热路径（每次迭代执行一次）... });
+//       state.set_items_per_iteration(n);   // 可选：据此输出吞吐
+//   }
+// 框架负责：迭代次数标定、预热、多次重复、统计量（min / median / mean / stddev / p90）、
+// CPU 绑定、JSON 输出，以及与基线 JSON 对比并标记回归（见 bench_main.cpp）。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace StuCanvas::bench
+{
+    template <typename T>
+    inline void do_not_optimize(const T& val)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&val) : "memory");
+#else
+        const volatile void* p = static_cast<const volatile void*>(&val);
+        (void)p;
+#endif
+    }
+
+    // 强制编译器认为内存已被读写（阻止跨迭代的死存储消除）
+    inline void clobber_memory()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#endif
+    }
+
+    struct Options
+    {
+        uint32_t warmup = 1;          // 预热重复次数（不计入统计）
+        uint32_t repetitions = 10;    // 计入统计的重复次数
+        double min_rep_ms = 20.0;     // 每次重复的最短时长，用于标定每次重复的迭代数
+    };
+
+    struct Stats
+    {
+        double min_ns = 0, median_ns = 0, mean_ns = 0, stddev_ns = 0, p90_ns = 0, max_ns = 0;
+
+        static Stats from(std::vector<double> samples)
+        {
+            Stats s;
+            if (samples.empty()) return s;
+            std::sort(samples.begin(), samples.end());
+            const size_t n = samples.size();
+            s.min_ns = samples.front();
+            s.max_ns = samples.back();
+            s.median_ns = n % 2 ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+            s.p90_ns = samples[std::min(n - 1, static_cast<size_t>(std::ceil(0.9 * n)) - 1)];
+            double sum = 0;
+            for (double v : samples) sum += v;
+            s.mean_ns = sum / n;
+            double var = 0;
+            for (double v : samples) var += (v - s.mean_ns) * (v - s.mean_ns);
+            s.stddev_ns = n > 1 ? std::sqrt(var / (n - 1)) : 0.0;
+            return s;
+        }
+    };
+
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations = 0;        // 每次重复的迭代数
+        uint32_t repetitions = 0;
+        double items_per_iteration = 0; // 0 表示未设置
+        Stats stats;                    // 单次迭代耗时（纳秒）
+        std::vector<double> samples_ns;
+    };
+
+    class State
+    {
+    public:
+        explicit State(const Options& options) : m_options(options) {}
+
+        // 标定 -> 预热 -> 重复计时；body 每次迭代调用一次
+        template <typename F>
+        void run(F&& body)
+        {
+            using clock = std::chrono::steady_clock;
+            auto time_iterations = [&](uint64_t iters) {
+                const auto t0 = clock::now();
+                for (uint64_t i = 0; i < iters; ++i) {
+                    body();
+                    clobber_memory();
+                }
+                return std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+            };
+
+            // 标定：翻倍直到一次重复达到 min_rep_ms 的 1/10，再按比例外推（首次调用兼作冷启动）
+            uint64_t iters = 1;
+            double elapsed = time_iterations(iters);
+            const double target_ns = m_options.min_rep_ms * 1e6;
+            while (elapsed < target_ns / 10 && iters < (uint64_t(1) << 40)) {
+                iters *= 2;
+                elapsed = time_iterations(iters);
+            }
+            const double per_iter = std::max(elapsed / static_cast<double>(iters), 1.0);
+            m_iterations = std::max<uint64_t>(1, static_cast<uint64_t>(target_ns / per_iter));
+
+            for (uint32_t w = 0; w < m_options.warmup; ++w) time_iterations(m_iterations);
+
+            m_samples.clear();
+            m_samples.reserve(m_options.repetitions);
+            for (uint32_t r = 0; r < m_options.repetitions; ++r) {
+                m_samples.push_back(time_iterations(m_iterations) / static_cast<double>(m_iterations));
+            }
+            m_ran = true;
+        }
+
+        void set_items_per_iteration(double items) { m_items = items; }
+
+        [[nodiscard]] bool ran() const { return m_ran; }
+        [[nodiscard]] uint64_t iterations() const { return m_iterations; }
+        [[nodiscard]] double items_per_iteration() const { return m_items; }
+        [[nodiscard]] const std::vector<double>& samples() const { return m_samples; }
+        [[nodiscard]] const Options& options() const { return m_options; }
+
+    private:
+        const Options& m_options;
+        std::vector<double> m_samples;
+        uint64_t m_iterations = 0;
+        double m_items = 0;
+        bool m_ran = false;
+    };
+
+    struct Case
+    {
+        const char* name;
+        void (*fn)(State&);
+    };
+
+    inline std::vector<Case>& registry()
+    {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    struct Registrar
+    {
+        Registrar(const char* name, void (*fn)(State&)) { registry().push_back({ name, fn }); }
+    };
+} // namespace StuCanvas::bench
+
+#define STU_BENCH_CONCAT_INNER(a, b) a##b
+#define STU_BENCH_CONCAT(a, b) STU_BENCH_CONCAT_INNER(a, b)
+#define STU_BENCH_IMPL(name, id)                                                                         \
+    static void STU_BENCH_CONCAT(stu_bench_fn_, id)(::StuCanvas::bench::State & state);                 \
+    static const ::StuCanvas::bench::Registrar STU_BENCH_CONCAT(stu_bench_reg_, id)(                     \
+        name, &STU_BENCH_CONCAT(stu_bench_fn_, id));                                                     \
+    static void STU_BENCH_CONCAT(stu_bench_fn_, id)([[maybe_unused]] ::StuCanvas::bench::State & state)
+#define STU_BENCH(name) STU_BENCH_IMPL(name, __COUNTER__)
@@ -7,10 +7,13 @@
 #include <iomanip>
 #include <thread>
 #include <concepts>
+#include <mutex>
 
 // 引入实现的 PinnedVector
 #include "pinned_vector.hpp"
 
+using namespace StuCanvas::utils;
+
 // 定义一个 16 字节对齐、64 字节大小的测试结构体
 struct alignas(16) Payload {
     uint64_t data[8]{}; 
@@ -260,6 +263,64 @@ int main() {
         std::cout << "  std::vector - Reserve 16 GB failed with std::bad_alloc (expected)" << std::endl;
     }
 
+    // ==========================================
+    // 测试 8：多线程并发追加到同一容器（线程局部收集 + 加锁合并 vs 原子占位直写）
+    // ==========================================
+    std::cout << "\n[8] Concurrent Append Into One Container:" << std::endl;
+    std::cout << "  Running 4 threads, each appending 1,000,000 elements to a shared result..." << std::endl;
+    {
+        std::vector<Payload> merged;
+        {
+            Timer t("std::vector - Thread-Local Collect + Mutex Merge");
+            std::mutex merge_mutex;
+            std::vector<std::thread> threads;
+            for (int i = 0; i < num_threads; ++i) {
+                threads.emplace_back([&]() {
+                    std::vector<Payload> local_vec;
+                    for (size_t j = 0; j < ThreadN; ++j) local_vec.emplace_back(j);
+                    std::lock_guard<std::mutex> lock(merge_mutex);
+                    merged.insert(merged.end(), local_vec.begin(), local_vec.end());
+                });
+            }
+            for (auto& th : threads) th.join();
+        }
+        do_not_optimize(merged[0]);
+    }
+    {
+        ConcurrentPinnedVector<Payload, 2> shared;
+        {
+            Timer t("ConcurrentPinnedVector - Per-Element emplace_back");
+            std::vector<std::thread> threads;
+            for (int i = 0; i < num_threads; ++i) {
+                threads.emplace_back([&]() {
+                    for (size_t j = 0; j < ThreadN; ++j) shared.emplace_back(j);
+                });
+            }
+            for (auto& th : threads) th.join();
+        }
+        std::cout << "  published size = " << shared.size() << std::endl;
+    }
+    {
+        ConcurrentPinnedVector<Payload, 2> shared;
+        {
+            Timer t("ConcurrentPinnedVector - Batched grow_by (4096)");
+            constexpr size_t Batch = 4096;
+            std::vector<std::thread> threads;
+            for (int i = 0; i < num_threads; ++i) {
+                threads.emplace_back([&]() {
+                    for (size_t j = 0; j < ThreadN; j += Batch) {
+                        const size_t n = std::min(Batch, ThreadN - j);
+                        shared.grow_by(n, [j](Payload* dst, size_t count) {
+                            for (size_t k = 0; k < count; ++k) new (dst + k) Payload(j + k);
+                        });
+                    }
+                });
+            }
+            for (auto& th : threads) th.join();
+        }
+        std::cout << "  published size = " << shared.size() << std::endl;
+    }
+
     std::cout << "==========================================================" << std::endl;
     return 0;
 }